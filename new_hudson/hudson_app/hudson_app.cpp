@@ -15,6 +15,13 @@ Hudson_App::Hudson_App(QWidget* p_parent) : QMainWindow(p_parent) {
 
 	mp_osm_widget = new Osm_Widget;
 	setCentralWidget(mp_osm_widget);
+	mp_progress = nullptr;
+	connect(mp_osm_widget, SIGNAL(signal_load_progress(qint64,qint64,int)),
+	        SLOT(slot_load_progress(qint64,qint64,int)));
+	connect(mp_osm_widget, SIGNAL(signal_load_finished(int)),
+	        SLOT(slot_load_finished(int)));
+	connect(mp_osm_widget, SIGNAL(signal_save_finished(int,QString)),
+	        SLOT(slot_save_finished(int,QString)));
 
 	/* Toolbar */
 	QList<QAction*> actions;
@@ -29,6 +36,15 @@ Hudson_App::Hudson_App(QWidget* p_parent) : QMainWindow(p_parent) {
 	        mp_osm_widget, SLOT(slot_select_tool_way()));
 	p_toolbar_draw->addActions(actions);
 
+	/* Rendering */
+	QAction* p_act_tiles = new QAction("Tiles");
+	p_act_tiles->setCheckable(true);
+	p_act_tiles->setToolTip("Renders the map into cached tiles in the background");
+	connect(p_act_tiles, SIGNAL(toggled(bool)),
+	        mp_osm_widget, SLOT(slot_set_tiled_rendering(bool)));
+	p_toolbar_draw->addSeparator();
+	p_toolbar_draw->addAction(p_act_tiles);
+
 
 	/* File menu */
 	p_act_load_xml->setText("Load...");
@@ -49,40 +65,95 @@ Hudson_App::Hudson_App(QWidget* p_parent) : QMainWindow(p_parent) {
 }
 
 /*================================================================*/
-/*                        Public methods                          */
+/*                       Private methods                          */
 /*================================================================*/
 
-void Hudson_App::slot_load_from_xml() {
-	Osm_Message msg;
-	int			errcode;
-	QString		filename = QFileDialog::getOpenFileName(this,
-	                                                    tr("Open File"),
-	                                                    "",
-	                                                    tr("*.osm"));
-	if (filename == "") {
+/* Progress is shown per mille of the file, which keeps it within int */
+void Hudson_App::slot_load_progress(qint64 bytes_read, qint64 bytes_total, int n_elements) {
+	if (mp_progress == nullptr) {
 		return;
 	}
-	if ((errcode = mp_osm_widget->load_from_xml(filename)) != OSM_OK) {
+	if (bytes_total > 0) {
+		mp_progress->setValue(static_cast<int>(bytes_read * 1000 / bytes_total));
+	}
+	mp_progress->setLabelText(tr("Loading... %1 elements").arg(n_elements));
+}
+
+void Hudson_App::slot_load_finished(int result_code) {
+	Osm_Message msg;
+
+	if (mp_progress != nullptr) {
+		mp_progress->deleteLater();
+		mp_progress = nullptr;
+	}
+	if (result_code != OSM_OK && result_code != OSM_ERROR_CANCELLED) {
 		QMessageBox* p_messagebox = new QMessageBox(QMessageBox::Warning,
 		                                            "Cannot load from file",
-		                                            msg(errcode),
+		                                            msg(result_code),
 		                                            QMessageBox::Ok);
 		p_messagebox->exec();
 	}
 }
 
-void Hudson_App::slot_save_to_xml() {
+void Hudson_App::slot_save_finished(int result_code, const QString& xml_path) {
 	Osm_Message msg;
-	int errcode;
-	QString filename = QFileDialog::getSaveFileName(this,
-	                                                tr("Save file"),
-	                                                "",
-	                                                tr("OSM-file (*.osm)"));
-	if ((errcode = mp_osm_widget->save_to_xml(filename)) != OSM_OK) {
-		QMessageBox* p_messagebox = new QMessageBox(QMessageBox::Warning,
-		                                            "Cannot save to file",
-		                                            msg(errcode),
-		                                            QMessageBox::Ok);
-		p_messagebox->exec();
+
+	if (result_code == OSM_OK) {
+		statusBar()->showMessage(tr("Saved to %1").arg(xml_path), 3000);
+		return;
+	}
+	QMessageBox* p_messagebox = new QMessageBox(QMessageBox::Warning,
+	                                            "Cannot save to file",
+	                                            msg(result_code),
+	                                            QMessageBox::Ok);
+	p_messagebox->exec();
+}
+
+/*================================================================*/
+/*                        Public methods                          */
+/*================================================================*/
+
+/* The map is parsed in the background; slot_load_finished reports the outcome */
+void Hudson_App::slot_load_from_xml() {
+	QString		filename;
+
+	if (mp_osm_widget->is_loading()) {
+		statusBar()->showMessage(tr("A file is still loading"), 3000);
+		return;
+	}
+	filename = QFileDialog::getOpenFileName(this,
+	                                        tr("Open File"),
+	                                        "",
+	                                        tr("*.osm"));
+	if (filename == "") {
+		return;
+	}
+	if (!mp_osm_widget->load_from_xml_async(filename)) {
+		return;
+	}
+	mp_progress = new QProgressDialog(tr("Loading..."), tr("Cancel"), 0, 1000, this);
+	mp_progress->setWindowModality(Qt::NonModal);
+	mp_progress->setAutoClose(false);
+	mp_progress->setAutoReset(false);
+	mp_progress->setMinimumDuration(300);
+	connect(mp_progress, SIGNAL(canceled()),
+	        mp_osm_widget, SLOT(slot_cancel_loading()));
+}
+
+/* Editing goes on while the file is written; slot_save_finished reports the outcome */
+void Hudson_App::slot_save_to_xml() {
+	QString		filename;
+
+	if (mp_osm_widget->is_saving()) {
+		statusBar()->showMessage(tr("The previous save is still running"), 3000);
+		return;
+	}
+	filename = QFileDialog::getSaveFileName(this,
+	                                        tr("Save file"),
+	                                        "",
+	                                        tr("OSM-file (*.osm)"));
+	if (filename == "") {
+		return;
 	}
+	mp_osm_widget->save_to_xml_async(filename);
 }
@@ -12,6 +12,11 @@ class Hudson_App : public QMainWindow {
 	Q_OBJECT
 private:
 	Osm_Widget* mp_osm_widget;
+	QProgressDialog* mp_progress;
+private slots:
+	void slot_load_progress(qint64 bytes_read, qint64 bytes_total, int n_elements);
+	void slot_load_finished(int result_code);
+	void slot_save_finished(int result_code, const QString& xml_path);
 public slots:
 	void slot_load_from_xml();
 	void slot_save_to_xml();
@@ -0,0 +1,251 @@
+#include "hudson_cli.h"
+
+using namespace ns_osm;
+
+/*================================================================*/
+/*                  Constructors, destructors                     */
+/*================================================================*/
+
+Hudson_Cli::Hudson_Cli() : m_out(stdout), m_err(stderr) {}
+
+/*================================================================*/
+/*                       Private methods                          */
+/*================================================================*/
+
+int Hudson_Cli::load(Osm_Map& map, const QString& path) {
+	Osm_Message	msg;
+	int			errcode = Xml_Handler(map).load_from_xml(path);
+
+	if (errcode != OSM_OK) {
+		m_err << path << ": " << msg(errcode) << endl;
+	}
+	return errcode;
+}
+
+int Hudson_Cli::save(Osm_Map& map, const QString& path) {
+	Osm_Message	msg;
+	int			errcode = Xml_Handler(map).save_to_xml(path);
+
+	if (errcode != OSM_OK) {
+		m_err << path << ": " << msg(errcode) << endl;
+	}
+	return errcode;
+}
+
+/* Drops everything outside the result, except the nodes kept ways need */
+void Hudson_Cli::keep(Osm_Map& map, const Osm_Query::Result& result) {
+	QSet<long long>			nodes = result.nodes;
+	QList<Osm_Relation*>	relations;
+	QList<Osm_Way*>			ways;
+	QList<Osm_Node*>		orphans;
+
+	for (auto it = map.crbegin(); it != map.crend(); ++it) {
+		if (!result.relations.contains((*it)->get_id())) {
+			relations.push_back(*it);
+		}
+	}
+	for (auto it = map.cwbegin(); it != map.cwend(); ++it) {
+		if (!result.ways.contains((*it)->get_id())) {
+			ways.push_back(*it);
+			continue;
+		}
+		for (auto it_node = (*it)->get_nodes_list().cbegin(); it_node != (*it)->get_nodes_list().cend(); ++it_node) {
+			nodes.insert((*it_node)->get_id());
+		}
+	}
+	for (auto it = map.cnbegin(); it != map.cnend(); ++it) {
+		if (!nodes.contains((*it)->get_id())) {
+			orphans.push_back(*it);
+		}
+	}
+	for (auto it = relations.cbegin(); it != relations.cend(); ++it) {
+		map.remove(*it);
+	}
+	for (auto it = ways.cbegin(); it != ways.cend(); ++it) {
+		map.remove(*it);
+	}
+	for (auto it = orphans.cbegin(); it != orphans.cend(); ++it) {
+		map.remove(*it);
+	}
+}
+
+int Hudson_Cli::fail(const QString& message) {
+	m_err << message << endl;
+	m_err << "Usage: hudson_cli convert|stats|filter|clip|validate|merge|generate <in.osm> [<out.osm>] [arguments]" << endl;
+	return OSM_ERROR;
+}
+
+int Hudson_Cli::run_convert(const QStringList& args) {
+	Osm_Map	map;
+	int		errcode;
+
+	if (args.size() != 2) {
+		return fail("convert: expected <in.osm> <out.osm>");
+	}
+	if ((errcode = load(map, args[0])) != OSM_OK) {
+		return errcode;
+	}
+	return save(map, args[1]);
+}
+
+/* --memory adds the bytes held per element kind and category */
+int Hudson_Cli::run_stats(const QStringList& arguments) {
+	Osm_Map		map;
+	QStringList	args = arguments;
+	bool		f_memory = args.removeAll("--memory") > 0;
+	QRectF		bound;
+	int			errcode;
+
+	if (args.size() != 1) {
+		return fail("stats: expected <in.osm> [--memory]");
+	}
+	if ((errcode = load(map, args[0])) != OSM_OK) {
+		return errcode;
+	}
+	bound = map.get_bound();
+	m_out << "nodes\t" << map.count_nodes() << endl;
+	m_out << "ways\t" << map.count_ways() << endl;
+	m_out << "relations\t" << map.count_relations() << endl;
+	m_out << "bound\t" << bound.bottom() << "," << bound.left() << "," << bound.top() << "," << bound.right() << endl;
+	if (f_memory) {
+		m_out << endl << map.get_memory_usage().to_text();
+		m_out.flush();
+	}
+	return OSM_OK;
+}
+
+int Hudson_Cli::run_query(const QString& in, const QString& out, const QString& query) {
+	Osm_Map		map;
+	Osm_Query	compiled;
+	int			errcode;
+
+	if (!compiled.compile(query)) {
+		return fail(compiled.get_error());
+	}
+	if ((errcode = load(map, in)) != OSM_OK) {
+		return errcode;
+	}
+	keep(map, compiled.run(map));
+	return save(map, out);
+}
+
+int Hudson_Cli::run_filter(const QStringList& args) {
+	if (args.size() != 3) {
+		return fail("filter: expected <in.osm> <out.osm> <query>");
+	}
+	return run_query(args[0], args[1], args[2]);
+}
+
+/* A way with a node inside is kept whole, a relation with a member inside is kept */
+int Hudson_Cli::run_clip(const QStringList& args) {
+	if (args.size() != 3 || args[2].split(',').size() != 4) {
+		return fail("clip: expected <in.osm> <out.osm> <south,west,north,east>");
+	}
+	return run_query(args[0], args[1], "nwr(" + args[2] + ");");
+}
+
+int Hudson_Cli::run_validate(const QStringList& args) {
+	Osm_Map						map;
+	Validator					validator;
+	QVector<Validator::Issue>	issues;
+	int							n_errors = 0;
+	int							errcode;
+
+	if (args.size() != 1) {
+		return fail("validate: expected <in.osm>");
+	}
+	if ((errcode = load(map, args[0])) != OSM_OK) {
+		return errcode;
+	}
+	validator.add_default_rules();
+	issues = validator.run(map);
+	for (auto it = issues.cbegin(); it != issues.cend(); ++it) {
+		n_errors += (it->severity == Validator::ERROR ? 1 : 0);
+		m_out << (it->severity == Validator::ERROR ? "error" : "warning") << "\t"
+		      << it->rule << "\t"
+		      << QString::number(it->lat, 'f', 7) << "," << QString::number(it->lon, 'f', 7) << "\t"
+		      << it->message << endl;
+	}
+	m_err << issues.size() << " issues, " << n_errors << " errors" << endl;
+	return n_errors > 0 ? OSM_ERROR : OSM_OK;
+}
+
+int Hudson_Cli::run_merge(const QStringList& args) {
+	Osm_Map		map;
+	Node_Merger	merger;
+	bool		f_ok = true;
+	int			errcode;
+
+	if (args.size() < 2 || args.size() > 3) {
+		return fail("merge: expected <in.osm> <out.osm> [tolerance in meters]");
+	}
+	if (args.size() == 3) {
+		merger.set_tolerance(args[2].toDouble(&f_ok));
+		if (!f_ok) {
+			return fail("merge: tolerance is not a number");
+		}
+	}
+	if ((errcode = load(map, args[0])) != OSM_OK) {
+		return errcode;
+	}
+	m_err << merger.merge(map) << " nodes merged" << endl;
+	return save(map, args[1]);
+}
+
+/* Streams the map, so the size is bounded by the disk only */
+int Hudson_Cli::run_generate(const QStringList& arguments) {
+	Map_Generator	generator;
+	Osm_Message		msg;
+	QStringList		args = arguments;
+	bool			f_ok = true;
+	long long		n_elements;
+
+	if (args.removeAll("--antimeridian") > 0) {
+		generator.set_antimeridian(true);
+	}
+	if (args.size() < 2 || args.size() > 3) {
+		return fail("generate: expected <out.osm> <elements> [seed] [--antimeridian]");
+	}
+	n_elements = args[1].toLongLong(&f_ok);
+	if (!f_ok || n_elements <= 0) {
+		return fail("generate: element count is not a positive number");
+	}
+	generator.set_target_size(n_elements);
+	if (args.size() == 3) {
+		generator.set_seed(args[2].toULongLong(&f_ok));
+		if (!f_ok) {
+			return fail("generate: seed is not a number");
+		}
+	}
+	if (!generator.write_osm(args[0])) {
+		m_err << args[0] << ": " << msg(OSM_ERROR_CANNOT_WRITE_FILE) << endl;
+		return OSM_ERROR_CANNOT_WRITE_FILE;
+	}
+	return OSM_OK;
+}
+
+/*================================================================*/
+/*                        Public methods                          */
+/*================================================================*/
+
+int Hudson_Cli::run(const QStringList& arguments) {
+	QString		command = arguments.value(0);
+	QStringList	args = arguments.mid(1);
+
+	if (command == "convert") {
+		return run_convert(args);
+	} else if (command == "stats") {
+		return run_stats(args);
+	} else if (command == "filter") {
+		return run_filter(args);
+	} else if (command == "clip") {
+		return run_clip(args);
+	} else if (command == "validate") {
+		return run_validate(args);
+	} else if (command == "merge") {
+		return run_merge(args);
+	} else if (command == "generate") {
+		return run_generate(args);
+	}
+	return fail(command.isEmpty() ? QString("No command given") : "Unknown command: " + command);
+}
@@ -0,0 +1,50 @@
+#ifndef HUDSON_CLI_H
+#define HUDSON_CLI_H
+
+#ifndef QT_CORE_H
+#define QT_CORE_H
+#include <QtCore>
+#endif /* Include guard QT_CORE_H */
+
+#include "osm_elements.h"
+#include "xml_handler.h"
+
+/* Hudson's engine without a display, for batch pipelines:
+ *
+ *   hudson_cli convert  <in.osm> <out.osm>
+ *   hudson_cli stats    <in.osm> [--memory]
+ *   hudson_cli filter   <in.osm> <out.osm> <query>
+ *   hudson_cli clip     <in.osm> <out.osm> <south,west,north,east>
+ *   hudson_cli validate <in.osm>
+ *   hudson_cli merge    <in.osm> <out.osm> [tolerance in meters]
+ *   hudson_cli generate <out.osm> <elements> [seed] [--antimeridian]
+ *
+ * Queries use the Osm_Query syntax. Validation, queries and merging run
+ * on a thread pool sized to the machine. The exit code is OSM_OK on
+ * success, a load or save result code, or OSM_ERROR for bad arguments and
+ * for error-level validation issues. */
+class Hudson_Cli {
+private:
+	QTextStream							m_out;
+	QTextStream							m_err;
+
+	int									load			(ns_osm::Osm_Map&, const QString& path);
+	int									save			(ns_osm::Osm_Map&, const QString& path);
+	void								keep			(ns_osm::Osm_Map&, const ns_osm::Osm_Query::Result&);
+	int									fail			(const QString& message);
+	int									run_convert		(const QStringList& args);
+	int									run_stats		(const QStringList& args);
+	int									run_filter		(const QStringList& args);
+	int									run_clip		(const QStringList& args);
+	int									run_validate	(const QStringList& args);
+	int									run_merge		(const QStringList& args);
+	int									run_generate	(const QStringList& args);
+	int									run_query		(const QString& in, const QString& out, const QString& query);
+public:
+	int									run				(const QStringList& arguments); /* Without the program name */
+	                                    Hudson_Cli		();
+										Hudson_Cli		(const Hudson_Cli&) = delete;
+	Hudson_Cli&							operator=		(const Hudson_Cli&) = delete;
+};
+
+#endif // HUDSON_CLI_H
@@ -0,0 +1,31 @@
+TEMPLATE = app
+
+TARGET = hudson_cli
+
+QT += core xml
+QT -= gui
+
+CONFIG += c++11 \
+    console
+CONFIG -= app_bundle
+
+INCLUDEPATH += \
+$$PWD/../osm_widget \
+$$PWD/../osm_widget/xml_handler \
+$$PWD/../osm_elements
+
+LIBS += -L$$PWD/../intermediate_libs/ -losm_elements
+
+# The I/O code is built here rather than linked from osm_widget, which needs QtWidgets
+HEADERS += \
+    hudson_cli.h \
+    ../osm_widget/osm_message.h \
+    ../osm_widget/xml_handler/xml_handler.h \
+    ../osm_widget/xml_handler/osm_xml.h
+
+SOURCES += \
+    hudson_cli.cpp \
+    main.cpp \
+    ../osm_widget/osm_message.cpp \
+    ../osm_widget/xml_handler/xml_handler.cpp \
+    ../osm_widget/xml_handler/osm_xml.cpp
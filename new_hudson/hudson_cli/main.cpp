@@ -0,0 +1,9 @@
+#include <QCoreApplication>
+#include "hudson_cli.h"
+
+int main(int argc, char* argv[]) {
+	QCoreApplication a(argc, argv);
+	Hudson_Cli cli;
+
+	return cli.run(a.arguments().mid(1));
+}
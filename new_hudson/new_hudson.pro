@@ -9,9 +9,11 @@ QMAKE_CXXFLAGS += \
 SUBDIRS += \
     osm_elements    \
     osm_widget      \
-    hudson_app
+    hudson_app      \
+    hudson_cli
 #    tests \
 
 osm_widget.depends = osm_elements
+hudson_cli.depends = osm_elements
 tests.depends = osm_elements
 tests.depends = osm_widget
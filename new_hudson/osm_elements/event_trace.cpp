@@ -0,0 +1,207 @@
+#include "event_trace.h"
+
+using namespace ns_osm;
+
+/*================================================================*/
+/*                        Static members                          */
+/*================================================================*/
+
+const int							Event_Trace::N_EVENT_SLOTS = MAP_EVENT_END;
+QElapsedTimer						Event_Trace::s_clock;
+QVector<Event_Trace::Counter>		Event_Trace::s_counters(Event_Trace::N_EVENT_SLOTS);
+QVector<Event_Trace::Span>			Event_Trace::s_spans;
+int									Event_Trace::sn_max_spans(0);
+long long							Event_Trace::sn_dropped(0);
+int									Event_Trace::sn_depth(0);
+qint64								Event_Trace::sn_nested_ns(0);
+bool								Event_Trace::f_recording(false);
+
+/*================================================================*/
+/*                  Constructors, destructors                     */
+/*================================================================*/
+
+Event_Trace::Counter::Counter() {
+	n_emits = 0;
+	n_deliveries = 0;
+	max_fan_out = 0;
+	max_depth = 0;
+	total_ns = 0;
+	self_ns = 0;
+}
+
+Event_Trace::Scope::Scope(Event event, bool f_del) {
+	m_event = event;
+	f_delete = f_del;
+	mn_deliveries = 0;
+	if (!f_recording) {
+		m_start_ns = -1;
+		return;
+	}
+	m_outer_nested_ns = sn_nested_ns;
+	sn_nested_ns = 0;
+	++sn_depth;
+	m_start_ns = s_clock.nsecsElapsed();
+}
+
+/* Nested scopes have already closed, so sn_depth is this scope's depth */
+Event_Trace::Scope::~Scope() {
+	if (m_start_ns < 0) {
+		return;
+	}
+	qint64		duration = s_clock.nsecsElapsed() - m_start_ns;
+	Counter&	counter = s_counters[m_event < N_EVENT_SLOTS ? m_event : NONE];
+
+	++counter.n_emits;
+	counter.n_deliveries += mn_deliveries;
+	counter.max_fan_out = qMax(counter.max_fan_out, mn_deliveries);
+	counter.max_depth = qMax(counter.max_depth, sn_depth);
+	counter.total_ns += duration;
+	counter.self_ns += duration - sn_nested_ns;
+	if (s_spans.size() < sn_max_spans) {
+		s_spans.push_back(Span{m_event, f_delete, sn_depth, mn_deliveries, m_start_ns, duration});
+	} else {
+		++sn_dropped;
+	}
+	--sn_depth;
+	sn_nested_ns = m_outer_nested_ns + duration;
+}
+
+/*================================================================*/
+/*                        Public methods                          */
+/*================================================================*/
+
+bool Event_Trace::is_available() {
+#ifdef OSM_EVENT_TRACE
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool Event_Trace::is_recording() {
+	return f_recording;
+}
+
+/* Keeps what was recorded before; reset() drops it */
+void Event_Trace::start(int max_spans) {
+	if (!is_available()) {
+		return;
+	}
+	if (!s_clock.isValid()) {
+		s_clock.start();
+	}
+	sn_max_spans = qMax(0, max_spans);
+	s_spans.reserve(qMin(sn_max_spans, 1 << 16));
+	f_recording = true;
+}
+
+void Event_Trace::stop() {
+	f_recording = false;
+}
+
+void Event_Trace::reset() {
+	s_counters.fill(Counter());
+	s_spans.clear();
+	sn_dropped = 0;
+}
+
+QMap<Event, Event_Trace::Counter> Event_Trace::get_counters() {
+	QMap<Event, Counter> counters;
+
+	for (int i = 0; i < N_EVENT_SLOTS; ++i) {
+		if (s_counters[i].n_emits > 0) {
+			counters.insert(static_cast<Event>(i), s_counters[i]);
+		}
+	}
+	return counters;
+}
+
+long long Event_Trace::count_dropped() {
+	return sn_dropped;
+}
+
+QString Event_Trace::event_name(Event event) {
+	switch (event) {
+	case NONE:						return "NONE";
+	case RELATION_MEMBER_ROLE_SET:	return "RELATION_MEMBER_ROLE_SET";
+	case NODE_ADDED:				return "NODE_ADDED";
+	case NODE_ADDED_FRONT:			return "NODE_ADDED_FRONT";
+	case NODE_ADDED_BACK:			return "NODE_ADDED_BACK";
+	case NODE_ADDED_AFTER:			return "NODE_ADDED_AFTER";
+	case NODE_UPDATED:				return "NODE_UPDATED";
+	case NODE_DELETED:				return "NODE_DELETED";
+	case NODE_DELETED_FRONT:		return "NODE_DELETED_FRONT";
+	case NODE_DELETED_BACK:			return "NODE_DELETED_BACK";
+	case NODE_DELETED_AFTER:		return "NODE_DELETED_AFTER";
+	case WAY_ADDED:					return "WAY_ADDED";
+	case WAY_UPDATED:				return "WAY_UPDATED";
+	case WAY_DELETED:				return "WAY_DELETED";
+	case RELATION_ADDED:			return "RELATION_ADDED";
+	case RELATION_UPDATED:			return "RELATION_UPDATED";
+	case RELATION_DELETED:			return "RELATION_DELETED";
+	case MAP_EVENT:					return "MAP_EVENT";
+	case MAP_CLEARED:				return "MAP_CLEARED";
+	case MAP_DELETED:				return "MAP_DELETED";
+	case MAP_NODE_ADDED:			return "MAP_NODE_ADDED";
+	case MAP_NODE_UPDATED:			return "MAP_NODE_UPDATED";
+	case MAP_WAY_ADDED:				return "MAP_WAY_ADDED";
+	case MAP_RELATION_ADDED:		return "MAP_RELATION_ADDED";
+	case MAP_TAGS_UPDATED:			return "MAP_TAGS_UPDATED";
+	case MAP_WAY_UPDATED:			return "MAP_WAY_UPDATED";
+	case MAP_RELATION_UPDATED:		return "MAP_RELATION_UPDATED";
+	case MAP_NODE_REMOVED:			return "MAP_NODE_REMOVED";
+	case MAP_WAY_REMOVED:			return "MAP_WAY_REMOVED";
+	case MAP_RELATION_REMOVED:		return "MAP_RELATION_REMOVED";
+	case MAP_RELOADED:				return "MAP_RELOADED";
+	case MAP_EVENT_END:				break;
+	}
+	return QString::number(event);
+}
+
+/* Complete ("X") events in microseconds, one thread; the counters go in
+ * the metadata */
+QByteArray Event_Trace::to_chrome_json() {
+	QJsonArray		events;
+	QJsonObject		counters;
+	QJsonObject		root;
+	auto			all = get_counters();
+
+	for (auto it = s_spans.cbegin(); it != s_spans.cend(); ++it) {
+		QJsonObject event;
+		QJsonObject args;
+		args["fan_out"] = it->fan_out;
+		args["depth"] = it->depth;
+		event["name"] = event_name(it->event);
+		event["cat"] = QString(it->f_delete ? "delete" : "update");
+		event["ph"] = QString("X");
+		event["ts"] = it->start_ns / 1000.0;
+		event["dur"] = it->duration_ns / 1000.0;
+		event["pid"] = 1;
+		event["tid"] = 1;
+		event["args"] = args;
+		events.append(event);
+	}
+	for (auto it = all.cbegin(); it != all.cend(); ++it) {
+		QJsonObject counter;
+		counter["emits"] = static_cast<double>(it->n_emits);
+		counter["deliveries"] = static_cast<double>(it->n_deliveries);
+		counter["max_fan_out"] = it->max_fan_out;
+		counter["max_depth"] = it->max_depth;
+		counter["total_us"] = it->total_ns / 1000.0;
+		counter["self_us"] = it->self_ns / 1000.0;
+		counters[event_name(it.key())] = counter;
+	}
+	root["traceEvents"] = events;
+	root["displayTimeUnit"] = QString("ns");
+	root["otherData"] = QJsonObject{{"counters", counters}, {"dropped", static_cast<double>(sn_dropped)}};
+	return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+bool Event_Trace::write_chrome_json(const QString& path) {
+	QFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly)) {
+		return false;
+	}
+	return file.write(to_chrome_json()) >= 0;
+}
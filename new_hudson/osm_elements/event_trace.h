@@ -0,0 +1,100 @@
+#ifndef EVENT_TRACE_H
+#define EVENT_TRACE_H
+
+#ifndef QT_CORE_H
+#define QT_CORE_H
+#include <QtCore>
+#endif /* Include guard QT_CORE_H */
+
+#include "meta.h"
+
+namespace ns_osm {
+
+/* Counters and a timeline for emit_update / emit_delete. The hooks exist
+ * only when the library is built with
+ *
+ *   qmake CONFIG+=event_trace
+ *
+ * which defines OSM_EVENT_TRACE; otherwise OSM_TRACE_EMIT and
+ * OSM_TRACE_DELIVERY expand to nothing and start() records nothing.
+ *
+ * Each emit is one span: its concrete event, the subscribers it reached,
+ * the cascade depth (1 for an emit outside any handler) and the time until
+ * the last handler returned, with and without nested emits. Counters are
+ * kept per event; spans go to a buffer of bounded size and export as
+ * Chrome trace-event JSON, for chrome://tracing or Perfetto. Like the
+ * event system itself, recording is for one thread. */
+class Event_Trace {
+public:
+	struct Counter {
+		long long	n_emits;
+		long long	n_deliveries;
+		int			max_fan_out;
+		int			max_depth;
+		qint64		total_ns;	/* Including nested emits */
+		qint64		self_ns;	/* Excluding them */
+		            Counter();
+	};
+	class Scope;
+private:
+	struct Span {
+		Event		event;
+		bool		f_delete;
+		int			depth;
+		int			fan_out;
+		qint64		start_ns;
+		qint64		duration_ns;
+	};
+
+	static const int						N_EVENT_SLOTS;
+	static QElapsedTimer					s_clock;
+	static QVector<Counter>					s_counters; /* By event */
+	static QVector<Span>					s_spans;
+	static int								sn_max_spans;
+	static long long						sn_dropped;
+	static int								sn_depth;
+	static qint64							sn_nested_ns; /* Spent in emits nested in the current one */
+	static bool								f_recording;
+public:
+	static bool								is_available	(); /* Built with OSM_EVENT_TRACE */
+	static bool								is_recording	();
+	static void								start			(int max_spans = 1000000);
+	static void								stop			();
+	static void								reset			();
+	static QMap<Event, Counter>				get_counters	(); /* Events seen only */
+	static long long						count_dropped	(); /* Spans beyond the buffer */
+	static QString							event_name		(Event);
+	static QByteArray						to_chrome_json	();
+	static bool								write_chrome_json(const QString& path);
+};
+
+/*================================================================*/
+/*                     Event_Trace::Scope                         */
+/*================================================================*/
+
+class Event_Trace::Scope {
+private:
+	Event									m_event;
+	bool									f_delete;
+	int										mn_deliveries;
+	qint64									m_start_ns; /* -1 when not recording */
+	qint64									m_outer_nested_ns;
+public:
+	void									deliver			() { ++mn_deliveries; }
+	                                        Scope			(Event, bool f_delete);
+	                                        ~Scope			();
+											Scope			(const Scope&) = delete;
+	Scope&									operator=		(const Scope&) = delete;
+};
+
+}
+
+#ifdef OSM_EVENT_TRACE
+#define OSM_TRACE_EMIT(event, f_delete) ns_osm::Event_Trace::Scope osm_trace_scope(event, f_delete)
+#define OSM_TRACE_DELIVERY() osm_trace_scope.deliver()
+#else
+#define OSM_TRACE_EMIT(event, f_delete)
+#define OSM_TRACE_DELIVERY()
+#endif
+
+#endif // EVENT_TRACE_H
@@ -0,0 +1,32 @@
+#include "geo.h"
+
+#ifndef CMATH_H
+#define CMATH_H
+#include <cmath>
+#endif /* Include guard CMATH_H */
+
+#ifndef ALGORITHM_H
+#define ALGORITHM_H
+#include <algorithm>
+#endif /* Include guard ALGORITHM_H */
+
+using namespace ns_osm;
+
+/*================================================================*/
+/*                        Static members                          */
+/*================================================================*/
+
+const double Geo::EARTH_RADIUS = 6371000.0;
+
+/*================================================================*/
+/*                        Public methods                          */
+/*================================================================*/
+
+double Geo::haversine(double lat1, double lon1, double lat2, double lon2) {
+	double d_lat = (lat2 - lat1) * M_PI / 180.0;
+	double d_lon = (lon2 - lon1) * M_PI / 180.0;
+	double a = std::sin(d_lat / 2) * std::sin(d_lat / 2) +
+	           std::cos(lat1 * M_PI / 180.0) * std::cos(lat2 * M_PI / 180.0) * std::sin(d_lon / 2) * std::sin(d_lon / 2);
+
+	return 2.0 * EARTH_RADIUS * std::asin(std::min(1.0, std::sqrt(a)));
+}
@@ -0,0 +1,23 @@
+#ifndef GEO_H
+#define GEO_H
+
+#ifndef QT_CORE_H
+#define QT_CORE_H
+#include <QtCore>
+#endif /* Include guard QT_CORE_H */
+
+namespace ns_osm {
+
+/* Distances on the sphere, for code that measures the map without
+ * projecting it. Coordinates are in degrees. */
+class Geo {
+private:
+	static const double						EARTH_RADIUS; /* Meters, mean */
+public:
+	static double							haversine		(double lat1, double lon1, double lat2, double lon2); /* Meters */
+	                                        Geo				() = delete;
+};
+
+}
+
+#endif // GEO_H
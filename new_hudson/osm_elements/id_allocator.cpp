@@ -0,0 +1,60 @@
+#include "id_allocator.h"
+
+using namespace ns_osm;
+
+/*================================================================*/
+/*                        Static members                          */
+/*================================================================*/
+
+const int Id_Allocator::Block::DEFAULT_SIZE = 1024;
+
+/*================================================================*/
+/*                  Constructors, destructors                     */
+/*================================================================*/
+
+Id_Allocator::Id_Allocator() : m_next(-1) {}
+
+Id_Allocator::Block::Block(Id_Allocator& allocator, int n_ids) {
+	mp_allocator = &allocator;
+	m_next = 0;
+	mn_left = 0;
+	m_size = qMax(1, n_ids);
+}
+
+/*================================================================*/
+/*                        Public methods                          */
+/*================================================================*/
+
+Id_Allocator& Id_Allocator::get_default() {
+	static Id_Allocator s_default;
+
+	return s_default;
+}
+
+long long Id_Allocator::acquire() {
+	return m_next.fetchAndAddRelaxed(-1);
+}
+
+long long Id_Allocator::acquire_block(int n_ids) {
+	return m_next.fetchAndAddRelaxed(-static_cast<qint64>(n_ids));
+}
+
+/* Positive ids are the server's and never collide with new ones */
+void Id_Allocator::reserve(long long id) {
+	qint64 next = m_next.loadAcquire();
+
+	while (next >= id && !m_next.testAndSetOrdered(next, id - 1, next)) {}
+}
+
+long long Id_Allocator::get_next() const {
+	return m_next.loadAcquire();
+}
+
+long long Id_Allocator::Block::acquire() {
+	if (mn_left == 0) {
+		m_next = mp_allocator->acquire_block(m_size);
+		mn_left = m_size;
+	}
+	--mn_left;
+	return m_next--;
+}
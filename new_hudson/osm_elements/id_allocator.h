@@ -0,0 +1,58 @@
+#ifndef ID_ALLOCATOR_H
+#define ID_ALLOCATOR_H
+
+#ifndef QT_CORE_H
+#define QT_CORE_H
+#include <QtCore>
+#endif /* Include guard QT_CORE_H */
+
+namespace ns_osm {
+
+/* Hands out ids for elements the server has not seen yet: -1, -2 and on
+ * down. Every map has one of its own and keeps it clear of the negative
+ * ids it holds, so maps do not take ids from each other. Allocators count
+ * independently, so Osm_Map::add() gives an element a new id of the map's
+ * when another already holds its negative id. acquire() and reserve() are
+ * lock-free and may be called from any thread.
+ *
+ * A worker making many elements takes a Block, which draws ids from the
+ * allocator a batch at a time and hands them out with no atomics at all.
+ * Ids are then unique but not consecutive across threads. */
+class Id_Allocator {
+public:
+	class Block;
+private:
+	QAtomicInteger<qint64>					m_next; /* Next id handed out */
+public:
+	static Id_Allocator&					get_default		(); /* For elements made outside any map */
+	long long								acquire			();
+	long long								acquire_block	(int n_ids); /* First of n, the rest follow downwards */
+	void									reserve			(long long id); /* Later ids stay below it */
+	long long								get_next		() const;
+	                                        Id_Allocator	();
+											Id_Allocator	(const Id_Allocator&) = delete;
+	Id_Allocator&							operator=		(const Id_Allocator&) = delete;
+};
+
+/*================================================================*/
+/*                     Id_Allocator::Block                        */
+/*================================================================*/
+
+/* For one thread; not to be shared */
+class Id_Allocator::Block {
+private:
+	static const int						DEFAULT_SIZE;
+	Id_Allocator*							mp_allocator;
+	long long								m_next;
+	int										mn_left;
+	int										m_size;
+public:
+	long long								acquire			();
+	                                        Block			(Id_Allocator&, int n_ids = DEFAULT_SIZE);
+											Block			(const Block&) = delete;
+	Block&									operator=		(const Block&) = delete;
+};
+
+}
+
+#endif // ID_ALLOCATOR_H
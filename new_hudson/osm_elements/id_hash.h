@@ -0,0 +1,701 @@
+#ifndef ID_HASH_H
+#define ID_HASH_H
+
+#ifndef QT_CORE_H
+#define QT_CORE_H
+#include <QtCore>
+#endif /* Include guard QT_CORE_H */
+
+#ifdef __SSE2__
+#ifndef EMMINTRIN_H
+#define EMMINTRIN_H
+#include <emmintrin.h>
+#endif /* Include guard EMMINTRIN_H */
+#endif
+
+namespace ns_osm {
+
+/* Flat table of values by OSM id, for the id lookups of Osm_Map.
+ * While ids only grow, which is how an .osm file lists them, the items
+ * sit in one sorted array and a lookup is an interpolation search over it.
+ * The first id out of order, or the first removal but of the last id,
+ * turns the table into an open-addressing hash: the items stay in a flat
+ * array of slots and a byte per slot holds 7 bits of the hash of its id,
+ * or marks it empty or deleted. A lookup compares GROUP_WIDTH such bytes
+ * at a time, with SSE2 where the compiler has it, and reads the id of a
+ * slot only on a match. Iterators follow slot order, which is id order
+ * while the table is sorted; any insert or remove invalidates them. */
+template <typename V>
+class Id_Hash {
+private:
+	struct Slot {
+		long long							key;
+		V									value;
+	};
+	static const int						GROUP_WIDTH = 16;
+	static const int						MIN_CAPACITY = 16;
+	static const qint8						CTRL_EMPTY = -128;
+	static const qint8						CTRL_DELETED = -2; /* Full slots hold 0..127 */
+	QVector<Slot>							m_slots; /* Sorted: the items; hashed: a power of two of slots */
+	QVector<qint8>							m_ctrl; /* Hashed only, the first GROUP_WIDTH bytes repeated at the end */
+	int										mn_items;
+	int										mn_deleted;
+	bool									f_sorted;
+
+	static quint64							get_hash		(long long key);
+	static int								get_capacity	(int n_items); /* Keeps an eighth of the slots empty */
+	static int								lowest_bit		(quint32 mask);
+	static quint32							match_byte		(const qint8* p_group, qint8 ctrl);
+	static quint32							match_free		(const qint8* p_group); /* Empty or deleted */
+	int										find_sorted		(long long key) const;
+	int										find_hashed		(long long key) const;
+	int										find_index		(long long key) const; /* -1 when absent */
+	void									set_ctrl		(int index, qint8 ctrl);
+	int										insert_hashed	(long long key); /* The key must be absent */
+	void									rehash			(int capacity); /* Leaves the sorted mode */
+	Slot&									get_slot		(long long key); /* Inserts V() when absent */
+public:
+	class const_iterator;
+
+	class iterator {
+		friend class Id_Hash;
+		friend class const_iterator;
+		Slot*								p_slot;
+		Slot*								p_end;
+		const qint8*						p_ctrl; /* Null in the sorted mode */
+
+		void								skip_free		();
+		                                    iterator		(Slot* p_slot, Slot* p_end, const qint8* p_ctrl);
+	public:
+		long long							key				() const;
+		V&									value			() const;
+		V&									operator*		() const;
+		iterator&							operator++		();
+		iterator							operator++		(int);
+		bool								operator==		(const iterator&) const;
+		bool								operator!=		(const iterator&) const;
+		                                    iterator		();
+	};
+
+	class const_iterator {
+		friend class Id_Hash;
+		const Slot*							p_slot;
+		const Slot*							p_end;
+		const qint8*						p_ctrl;
+
+		void								skip_free		();
+		                                    const_iterator	(const Slot* p_slot, const Slot* p_end, const qint8* p_ctrl);
+	public:
+		long long							key				() const;
+		const V&							value			() const;
+		const V&							operator*		() const;
+		const_iterator&						operator++		();
+		const_iterator						operator++		(int);
+		bool								operator==		(const const_iterator&) const;
+		bool								operator!=		(const const_iterator&) const;
+		                                    const_iterator	();
+		                                    const_iterator	(const iterator&);
+	};
+
+	int										size			() const;
+	int										count			() const;
+	bool									isEmpty			() const;
+	bool									is_sorted		() const;
+	bool									contains		(long long key) const;
+	V										value			(long long key, const V& fallback = V()) const;
+	QList<long long>						keys			() const; /* In slot order */
+	QList<V>								values			() const;
+	void									insert			(long long key, const V&);
+	int										remove			(long long key); /* The number of items removed */
+	void									clear			();
+	void									swap			(Id_Hash&);
+	qint64									get_bytes		() const; /* Slot and control arrays, for Memory_Usage */
+	V&										operator[]		(long long key);
+	iterator								find			(long long key);
+	const_iterator							find			(long long key) const;
+	iterator								begin			();
+	iterator								end				();
+	const_iterator							begin			() const;
+	const_iterator							end				() const;
+	const_iterator							cbegin			() const;
+	const_iterator							cend			() const;
+	                                        Id_Hash			();
+};
+
+/*================================================================*/
+/*                  Constructors, destructors                     */
+/*================================================================*/
+
+template <typename V>
+Id_Hash<V>::Id_Hash() {
+	mn_items = 0;
+	mn_deleted = 0;
+	f_sorted = true;
+}
+
+template <typename V>
+Id_Hash<V>::iterator::iterator(Slot* p_slot, Slot* p_end, const qint8* p_ctrl)
+                               :
+                                 p_slot(p_slot),
+                                 p_end(p_end),
+                                 p_ctrl(p_ctrl)
+{
+}
+
+template <typename V>
+Id_Hash<V>::iterator::iterator() : p_slot(nullptr), p_end(nullptr), p_ctrl(nullptr) {
+}
+
+template <typename V>
+Id_Hash<V>::const_iterator::const_iterator(const Slot* p_slot, const Slot* p_end, const qint8* p_ctrl)
+                                           :
+                                             p_slot(p_slot),
+                                             p_end(p_end),
+                                             p_ctrl(p_ctrl)
+{
+}
+
+template <typename V>
+Id_Hash<V>::const_iterator::const_iterator() : p_slot(nullptr), p_end(nullptr), p_ctrl(nullptr) {
+}
+
+template <typename V>
+Id_Hash<V>::const_iterator::const_iterator(const iterator& it)
+                                           :
+                                             p_slot(it.p_slot),
+                                             p_end(it.p_end),
+                                             p_ctrl(it.p_ctrl)
+{
+}
+
+/*================================================================*/
+/*                       Private methods                          */
+/*================================================================*/
+
+/* Fibonacci hashing; the low bits pick the slot, the top 7 the control byte */
+template <typename V>
+quint64 Id_Hash<V>::get_hash(long long key) {
+	quint64 hash = static_cast<quint64>(key) * Q_UINT64_C(0x9E3779B97F4A7C15);
+
+	return hash ^ (hash >> 32);
+}
+
+template <typename V>
+int Id_Hash<V>::get_capacity(int n_items) {
+	qint64 capacity = MIN_CAPACITY;
+
+	while (static_cast<qint64>(n_items) * 8 >= capacity * 7) {
+		capacity *= 2;
+	}
+	return static_cast<int>(capacity);
+}
+
+template <typename V>
+int Id_Hash<V>::lowest_bit(quint32 mask) {
+#if defined(__GNUC__)
+	return __builtin_ctz(mask);
+#else
+	int bit = 0;
+
+	while ((mask & 1) == 0) {
+		mask >>= 1;
+		++bit;
+	}
+	return bit;
+#endif
+}
+
+template <typename V>
+quint32 Id_Hash<V>::match_byte(const qint8* p_group, qint8 ctrl) {
+#ifdef __SSE2__
+	__m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_group));
+
+	return static_cast<quint32>(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(ctrl))));
+#else
+	quint32 mask = 0;
+
+	for (int i = 0; i < GROUP_WIDTH; ++i) {
+		if (p_group[i] == ctrl) {
+			mask |= 1u << i;
+		}
+	}
+	return mask;
+#endif
+}
+
+/* Both free markers are negative, full slots are not */
+template <typename V>
+quint32 Id_Hash<V>::match_free(const qint8* p_group) {
+#ifdef __SSE2__
+	return static_cast<quint32>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p_group))));
+#else
+	quint32 mask = 0;
+
+	for (int i = 0; i < GROUP_WIDTH; ++i) {
+		if (p_group[i] < 0) {
+			mask |= 1u << i;
+		}
+	}
+	return mask;
+#endif
+}
+
+/* Interpolation steps alternate with halvings, so that a skewed run of ids
+ * costs no more than twice a binary search */
+template <typename V>
+int Id_Hash<V>::find_sorted(long long key) const {
+	const Slot*	p_slots = m_slots.constData();
+	int			lo = 0;
+	int			hi = mn_items - 1;
+	bool		f_interpolate = true;
+
+	while (lo <= hi) {
+		long long	key_lo = p_slots[lo].key;
+		long long	key_hi = p_slots[hi].key;
+		int			mid;
+
+		if (key < key_lo || key > key_hi) {
+			return -1;
+		}
+		if (f_interpolate && key_hi > key_lo) {
+			double ratio = static_cast<double>(key - key_lo) / static_cast<double>(key_hi - key_lo);
+			mid = lo + static_cast<int>(ratio * (hi - lo));
+			mid = qBound(lo, mid, hi);
+		} else {
+			mid = lo + (hi - lo) / 2;
+		}
+		f_interpolate = !f_interpolate;
+		if (p_slots[mid].key == key) {
+			return mid;
+		}
+		if (p_slots[mid].key < key) {
+			lo = mid + 1;
+		} else {
+			hi = mid - 1;
+		}
+	}
+	return -1;
+}
+
+/* Groups are probed at triangular steps, which reaches every group of a
+ * power-of-two table; an empty byte in a group ends the search */
+template <typename V>
+int Id_Hash<V>::find_hashed(long long key) const {
+	const qint8*	p_ctrl = m_ctrl.constData();
+	const Slot*		p_slots = m_slots.constData();
+	quint64			hash = get_hash(key);
+	qint8			h2 = static_cast<qint8>(hash >> 57);
+	int				mask = m_slots.size() - 1;
+	int				pos = static_cast<int>(hash & mask);
+
+	for (int step = GROUP_WIDTH; ; step += GROUP_WIDTH) {
+		quint32 matches = match_byte(p_ctrl + pos, h2);
+		while (matches != 0) {
+			int index = (pos + lowest_bit(matches)) & mask;
+			if (p_slots[index].key == key) {
+				return index;
+			}
+			matches &= matches - 1;
+		}
+		if (match_byte(p_ctrl + pos, CTRL_EMPTY) != 0) {
+			return -1;
+		}
+		pos = (pos + step) & mask;
+	}
+}
+
+template <typename V>
+int Id_Hash<V>::find_index(long long key) const {
+	if (mn_items == 0) {
+		return -1;
+	}
+	return f_sorted ? find_sorted(key) : find_hashed(key);
+}
+
+template <typename V>
+void Id_Hash<V>::set_ctrl(int index, qint8 ctrl) {
+	qint8* p_ctrl = m_ctrl.data();
+
+	p_ctrl[index] = ctrl;
+	if (index < GROUP_WIDTH) {
+		p_ctrl[m_slots.size() + index] = ctrl;
+	}
+}
+
+template <typename V>
+int Id_Hash<V>::insert_hashed(long long key) {
+	if (static_cast<qint64>(mn_items + mn_deleted + 1) * 8 >= static_cast<qint64>(m_slots.size()) * 7) {
+		rehash(get_capacity(mn_items + 1));
+	}
+
+	const qint8*	p_ctrl = m_ctrl.constData();
+	quint64			hash = get_hash(key);
+	int				mask = m_slots.size() - 1;
+	int				pos = static_cast<int>(hash & mask);
+	int				index;
+
+	for (int step = GROUP_WIDTH; ; step += GROUP_WIDTH) {
+		quint32 free = match_free(p_ctrl + pos);
+		if (free != 0) {
+			index = (pos + lowest_bit(free)) & mask;
+			break;
+		}
+		pos = (pos + step) & mask;
+	}
+	if (p_ctrl[index] == CTRL_DELETED) {
+		--mn_deleted;
+	}
+	set_ctrl(index, static_cast<qint8>(hash >> 57));
+	Slot& slot = m_slots[index];
+	slot.key = key;
+	slot.value = V();
+	++mn_items;
+	return index;
+}
+
+template <typename V>
+void Id_Hash<V>::rehash(int capacity) {
+	QVector<Slot>	slots;
+	QVector<qint8>	ctrl;
+	bool			f_was_sorted = f_sorted;
+	int				n_items = mn_items;
+
+	slots.swap(m_slots);
+	ctrl.swap(m_ctrl);
+	m_slots.resize(capacity);
+	m_ctrl.fill(static_cast<qint8>(CTRL_EMPTY), capacity + GROUP_WIDTH);
+	mn_items = 0;
+	mn_deleted = 0;
+	f_sorted = false;
+	for (int i = 0; i < slots.size(); ++i) {
+		if (f_was_sorted ? i < n_items : ctrl.at(i) >= 0) {
+			m_slots[insert_hashed(slots.at(i).key)].value = slots.at(i).value;
+		}
+	}
+}
+
+template <typename V>
+typename Id_Hash<V>::Slot& Id_Hash<V>::get_slot(long long key) {
+	int index = find_index(key);
+
+	if (index >= 0) {
+		return m_slots[index];
+	}
+	if (f_sorted) {
+		if (mn_items == 0 || key > m_slots.at(mn_items - 1).key) {
+			Slot slot;
+			slot.key = key;
+			slot.value = V();
+			m_slots.append(slot);
+			++mn_items;
+			return m_slots.last();
+		}
+		rehash(get_capacity(mn_items + 1));
+	}
+	return m_slots[insert_hashed(key)];
+}
+
+/*================================================================*/
+/*                        Public methods                          */
+/*================================================================*/
+
+template <typename V>
+int Id_Hash<V>::size() const {
+	return mn_items;
+}
+
+template <typename V>
+int Id_Hash<V>::count() const {
+	return mn_items;
+}
+
+template <typename V>
+bool Id_Hash<V>::isEmpty() const {
+	return mn_items == 0;
+}
+
+template <typename V>
+bool Id_Hash<V>::is_sorted() const {
+	return f_sorted;
+}
+
+template <typename V>
+bool Id_Hash<V>::contains(long long key) const {
+	return find_index(key) >= 0;
+}
+
+template <typename V>
+V Id_Hash<V>::value(long long key, const V& fallback) const {
+	int index = find_index(key);
+
+	return index >= 0 ? m_slots.at(index).value : fallback;
+}
+
+template <typename V>
+QList<long long> Id_Hash<V>::keys() const {
+	QList<long long> keys;
+
+	keys.reserve(mn_items);
+	for (auto it = cbegin(); it != cend(); ++it) {
+		keys.push_back(it.key());
+	}
+	return keys;
+}
+
+template <typename V>
+QList<V> Id_Hash<V>::values() const {
+	QList<V> values;
+
+	values.reserve(mn_items);
+	for (auto it = cbegin(); it != cend(); ++it) {
+		values.push_back(it.value());
+	}
+	return values;
+}
+
+template <typename V>
+void Id_Hash<V>::insert(long long key, const V& value) {
+	get_slot(key).value = value;
+}
+
+/* Dropping the last id keeps the order; the table shrinks once it is
+ * mostly free, so that iterating a drained table stays cheap */
+template <typename V>
+int Id_Hash<V>::remove(long long key) {
+	int index = find_index(key);
+
+	if (index < 0) {
+		return 0;
+	}
+	if (f_sorted) {
+		if (index == mn_items - 1) {
+			m_slots.removeLast();
+			--mn_items;
+			return 1;
+		}
+		rehash(get_capacity(mn_items));
+		index = find_hashed(key);
+	}
+	set_ctrl(index, CTRL_DELETED);
+	m_slots[index].value = V();
+	--mn_items;
+	++mn_deleted;
+	if (m_slots.size() > MIN_CAPACITY && mn_items * 16 < m_slots.size()) {
+		rehash(get_capacity(mn_items * 2));
+	}
+	return 1;
+}
+
+template <typename V>
+void Id_Hash<V>::clear() {
+	m_slots.clear();
+	m_ctrl.clear();
+	mn_items = 0;
+	mn_deleted = 0;
+	f_sorted = true;
+}
+
+template <typename V>
+void Id_Hash<V>::swap(Id_Hash& other) {
+	m_slots.swap(other.m_slots);
+	m_ctrl.swap(other.m_ctrl);
+	qSwap(mn_items, other.mn_items);
+	qSwap(mn_deleted, other.mn_deleted);
+	qSwap(f_sorted, other.f_sorted);
+}
+
+template <typename V>
+qint64 Id_Hash<V>::get_bytes() const {
+	qint64 n_bytes = 0;
+
+	if (m_slots.capacity() > 0) {
+		n_bytes += sizeof(QArrayData) + m_slots.capacity() * sizeof(Slot);
+	}
+	if (m_ctrl.capacity() > 0) {
+		n_bytes += sizeof(QArrayData) + m_ctrl.capacity();
+	}
+	return n_bytes;
+}
+
+template <typename V>
+V& Id_Hash<V>::operator[](long long key) {
+	return get_slot(key).value;
+}
+
+template <typename V>
+typename Id_Hash<V>::iterator Id_Hash<V>::find(long long key) {
+	int index = find_index(key);
+
+	if (index < 0) {
+		return end();
+	}
+	Slot* p_slots = m_slots.data();
+	return iterator(p_slots + index, p_slots + m_slots.size(), f_sorted ? nullptr : m_ctrl.constData() + index);
+}
+
+template <typename V>
+typename Id_Hash<V>::const_iterator Id_Hash<V>::find(long long key) const {
+	int index = find_index(key);
+
+	if (index < 0) {
+		return cend();
+	}
+	const Slot* p_slots = m_slots.constData();
+	return const_iterator(p_slots + index, p_slots + m_slots.size(), f_sorted ? nullptr : m_ctrl.constData() + index);
+}
+
+template <typename V>
+typename Id_Hash<V>::iterator Id_Hash<V>::begin() {
+	Slot*		p_slots = m_slots.data();
+	iterator	it(p_slots, p_slots + m_slots.size(), f_sorted ? nullptr : m_ctrl.constData());
+
+	it.skip_free();
+	return it;
+}
+
+template <typename V>
+typename Id_Hash<V>::iterator Id_Hash<V>::end() {
+	Slot* p_end = m_slots.data() + m_slots.size();
+
+	return iterator(p_end, p_end, nullptr);
+}
+
+template <typename V>
+typename Id_Hash<V>::const_iterator Id_Hash<V>::begin() const {
+	return cbegin();
+}
+
+template <typename V>
+typename Id_Hash<V>::const_iterator Id_Hash<V>::end() const {
+	return cend();
+}
+
+template <typename V>
+typename Id_Hash<V>::const_iterator Id_Hash<V>::cbegin() const {
+	const Slot*		p_slots = m_slots.constData();
+	const_iterator	it(p_slots, p_slots + m_slots.size(), f_sorted ? nullptr : m_ctrl.constData());
+
+	it.skip_free();
+	return it;
+}
+
+template <typename V>
+typename Id_Hash<V>::const_iterator Id_Hash<V>::cend() const {
+	const Slot* p_end = m_slots.constData() + m_slots.size();
+
+	return const_iterator(p_end, p_end, nullptr);
+}
+
+/*================================================================*/
+/*                         Iterators                              */
+/*================================================================*/
+
+template <typename V>
+void Id_Hash<V>::iterator::skip_free() {
+	if (p_ctrl != nullptr) {
+		while (p_slot != p_end && *p_ctrl < 0) {
+			++p_slot;
+			++p_ctrl;
+		}
+	}
+}
+
+template <typename V>
+long long Id_Hash<V>::iterator::key() const {
+	return p_slot->key;
+}
+
+template <typename V>
+V& Id_Hash<V>::iterator::value() const {
+	return p_slot->value;
+}
+
+template <typename V>
+V& Id_Hash<V>::iterator::operator*() const {
+	return p_slot->value;
+}
+
+template <typename V>
+typename Id_Hash<V>::iterator& Id_Hash<V>::iterator::operator++() {
+	++p_slot;
+	if (p_ctrl != nullptr) {
+		++p_ctrl;
+		skip_free();
+	}
+	return *this;
+}
+
+template <typename V>
+typename Id_Hash<V>::iterator Id_Hash<V>::iterator::operator++(int) {
+	iterator it = *this;
+
+	++(*this);
+	return it;
+}
+
+template <typename V>
+bool Id_Hash<V>::iterator::operator==(const iterator& other) const {
+	return p_slot == other.p_slot;
+}
+
+template <typename V>
+bool Id_Hash<V>::iterator::operator!=(const iterator& other) const {
+	return p_slot != other.p_slot;
+}
+
+template <typename V>
+void Id_Hash<V>::const_iterator::skip_free() {
+	if (p_ctrl != nullptr) {
+		while (p_slot != p_end && *p_ctrl < 0) {
+			++p_slot;
+			++p_ctrl;
+		}
+	}
+}
+
+template <typename V>
+long long Id_Hash<V>::const_iterator::key() const {
+	return p_slot->key;
+}
+
+template <typename V>
+const V& Id_Hash<V>::const_iterator::value() const {
+	return p_slot->value;
+}
+
+template <typename V>
+const V& Id_Hash<V>::const_iterator::operator*() const {
+	return p_slot->value;
+}
+
+template <typename V>
+typename Id_Hash<V>::const_iterator& Id_Hash<V>::const_iterator::operator++() {
+	++p_slot;
+	if (p_ctrl != nullptr) {
+		++p_ctrl;
+		skip_free();
+	}
+	return *this;
+}
+
+template <typename V>
+typename Id_Hash<V>::const_iterator Id_Hash<V>::const_iterator::operator++(int) {
+	const_iterator it = *this;
+
+	++(*this);
+	return it;
+}
+
+template <typename V>
+bool Id_Hash<V>::const_iterator::operator==(const const_iterator& other) const {
+	return p_slot == other.p_slot;
+}
+
+template <typename V>
+bool Id_Hash<V>::const_iterator::operator!=(const const_iterator& other) const {
+	return p_slot != other.p_slot;
+}
+
+}
+
+#endif // ID_HASH_H
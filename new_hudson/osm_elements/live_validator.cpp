@@ -0,0 +1,468 @@
+#include "live_validator.h"
+
+using namespace ns_osm;
+
+/*================================================================*/
+/*                        Static members                          */
+/*================================================================*/
+
+const double Live_Validator::CELL_SIZE = 0.01;
+
+/*================================================================*/
+/*                  Constructors, destructors                     */
+/*================================================================*/
+
+Live_Validator::Live_Validator() {
+	mp_map = nullptr;
+	m_next_issue = 0;
+	m_validator.add_default_rules();
+}
+
+Live_Validator::~Live_Validator() {}
+
+/*================================================================*/
+/*                       Private methods                          */
+/*================================================================*/
+
+quint64 Live_Validator::get_position(const Osm_Node& node) {
+	return (static_cast<quint64>(static_cast<quint32>(qRound64(node.get_lat() * 1e7))) << 32)
+	        | static_cast<quint32>(qRound64(node.get_lon() * 1e7));
+}
+
+quint64 Live_Validator::get_cell(double lat, double lon) {
+	return (static_cast<quint64>(static_cast<quint32>(qFloor(lat / CELL_SIZE))) << 32)
+	        | static_cast<quint32>(qFloor(lon / CELL_SIZE));
+}
+
+QVector<quint64> Live_Validator::get_cells(double lat1, double lon1, double lat2, double lon2) {
+	QVector<quint64>	cells;
+	int					row_last = qFloor(qMax(lat1, lat2) / CELL_SIZE);
+	int					col_last = qFloor(qMax(lon1, lon2) / CELL_SIZE);
+
+	for (int row = qFloor(qMin(lat1, lat2) / CELL_SIZE); row <= row_last; ++row) {
+		for (int col = qFloor(qMin(lon1, lon2) / CELL_SIZE); col <= col_last; ++col) {
+			cells.push_back(get_cell((row + 0.5) * CELL_SIZE, (col + 0.5) * CELL_SIZE));
+		}
+	}
+	return cells;
+}
+
+QVector<quint64> Live_Validator::get_cells(const Osm_Way& way, int segment) {
+	const Osm_Node& first = *way.get_nodes_list()[segment];
+	const Osm_Node& second = *way.get_nodes_list()[segment + 1];
+
+	return get_cells(first.get_lat(), first.get_lon(), second.get_lat(), second.get_lon());
+}
+
+void Live_Validator::index(const Osm_Node& node) {
+	unindex_node(node.get_id());
+	m_node_positions.insert(node.get_id(), get_position(node));
+	m_position_nodes.insert(get_position(node), node.get_id());
+}
+
+void Live_Validator::index(const Osm_Way& way) {
+	QSet<quint64> cells;
+
+	unindex_way(way.get_id());
+	for (int i = 0; i + 1 < way.get_nodes_list().size(); ++i) {
+		QVector<quint64> segment_cells = get_cells(way, i);
+		for (auto it = segment_cells.cbegin(); it != segment_cells.cend(); ++it) {
+			cells.insert(*it);
+		}
+	}
+	for (auto it = cells.cbegin(); it != cells.cend(); ++it) {
+		m_cell_ways.insert(*it, way.get_id());
+		m_way_cells[way.get_id()].push_back(*it);
+	}
+	for (auto it = way.get_nodes_list().cbegin(); it != way.get_nodes_list().cend(); ++it) {
+		m_node_ways.insert((*it)->get_id(), way.get_id());
+		m_way_nodes[way.get_id()].push_back((*it)->get_id());
+	}
+}
+
+void Live_Validator::unindex_node(long long id_node) {
+	auto it = m_node_positions.find(id_node);
+
+	if (it != m_node_positions.end()) {
+		m_position_nodes.remove(it.value(), id_node);
+		m_node_positions.erase(it);
+	}
+}
+
+void Live_Validator::unindex_way(long long id_way) {
+	const QVector<quint64>		cells = m_way_cells.take(id_way);
+	const QVector<long long>	nodes = m_way_nodes.take(id_way);
+
+	for (auto it = cells.cbegin(); it != cells.cend(); ++it) {
+		m_cell_ways.remove(*it, id_way);
+	}
+	for (auto it = nodes.cbegin(); it != nodes.cend(); ++it) {
+		m_node_ways.remove(*it, id_way);
+	}
+}
+
+void Live_Validator::add_issue(const Validator::Issue& issue) {
+	int key = m_next_issue++;
+
+	m_issues.insert(key, issue);
+	for (auto it = issue.nodes.cbegin(); it != issue.nodes.cend(); ++it) {
+		m_node_issues.insert(*it, key);
+	}
+	for (auto it = issue.ways.cbegin(); it != issue.ways.cend(); ++it) {
+		m_way_issues.insert(*it, key);
+	}
+	for (auto it = issue.relations.cbegin(); it != issue.relations.cend(); ++it) {
+		m_relation_issues.insert(*it, key);
+	}
+}
+
+void Live_Validator::remove_issue(int key) {
+	const Validator::Issue issue = m_issues.take(key);
+
+	for (auto it = issue.nodes.cbegin(); it != issue.nodes.cend(); ++it) {
+		m_node_issues.remove(*it, key);
+	}
+	for (auto it = issue.ways.cbegin(); it != issue.ways.cend(); ++it) {
+		m_way_issues.remove(*it, key);
+	}
+	for (auto it = issue.relations.cbegin(); it != issue.relations.cend(); ++it) {
+		m_relation_issues.remove(*it, key);
+	}
+}
+
+QSet<int> Live_Validator::find_issues(const QSet<long long>& nodes,
+                                      const QSet<long long>& ways,
+                                      const QSet<long long>& relations) const {
+	QSet<int> keys;
+
+	for (auto it = nodes.cbegin(); it != nodes.cend(); ++it) {
+		for (auto it_key = m_node_issues.constFind(*it); it_key != m_node_issues.cend() && it_key.key() == *it; ++it_key) {
+			keys.insert(it_key.value());
+		}
+	}
+	for (auto it = ways.cbegin(); it != ways.cend(); ++it) {
+		for (auto it_key = m_way_issues.constFind(*it); it_key != m_way_issues.cend() && it_key.key() == *it; ++it_key) {
+			keys.insert(it_key.value());
+		}
+	}
+	for (auto it = relations.cbegin(); it != relations.cend(); ++it) {
+		for (auto it_key = m_relation_issues.constFind(*it); it_key != m_relation_issues.cend() && it_key.key() == *it; ++it_key) {
+			keys.insert(it_key.value());
+		}
+	}
+	return keys;
+}
+
+/* Positions are those of nodes that moved away, their old group is redone too */
+void Live_Validator::recheck(const QSet<long long>& nodes,
+                             const QSet<long long>& ways,
+                             const QSet<long long>& relations,
+                             QSet<quint64> positions) {
+	Validator::Partition	partition;
+	QSet<long long>			near_nodes;
+	QSet<long long>			near_ways;
+	QSet<quint64>			way_cells;
+	QVector<Validator::Issue> found;
+	auto					is_rechecked = [&](const Validator::Issue& issue) {
+		for (auto it = issue.nodes.cbegin(); it != issue.nodes.cend(); ++it) {
+			if (nodes.contains(*it)) {
+				return true;
+			}
+		}
+		for (auto it = issue.ways.cbegin(); it != issue.ways.cend(); ++it) {
+			if (ways.contains(*it)) {
+				return true;
+			}
+		}
+		for (auto it = issue.relations.cbegin(); it != issue.relations.cend(); ++it) {
+			if (relations.contains(*it)) {
+				return true;
+			}
+		}
+		if (issue.nodes.isEmpty() || !issue.ways.isEmpty() || !issue.relations.isEmpty()) {
+			return false;
+		}
+		for (auto it = issue.nodes.cbegin(); it != issue.nodes.cend(); ++it) {
+			if (!near_nodes.contains(*it)) {
+				return false;
+			}
+		}
+		return true;
+	};
+
+	partition.p_map = mp_map;
+	for (auto it = nodes.cbegin(); it != nodes.cend(); ++it) {
+		if (m_node_positions.contains(*it)) {
+			positions.insert(m_node_positions.value(*it));
+		}
+	}
+	for (auto it = positions.cbegin(); it != positions.cend(); ++it) {
+		for (auto it_node = m_position_nodes.constFind(*it); it_node != m_position_nodes.cend() && it_node.key() == *it; ++it_node) {
+			near_nodes.insert(it_node.value());
+		}
+	}
+	for (auto it = near_nodes.cbegin(); it != near_nodes.cend(); ++it) {
+		Osm_Node* p_node = mp_map->get_node(*it);
+		if (p_node != nullptr) {
+			partition.nodes.push_back(p_node);
+		}
+	}
+
+	for (auto it = ways.cbegin(); it != ways.cend(); ++it) {
+		Osm_Way* p_way = mp_map->get_way(*it);
+		if (p_way == nullptr) {
+			continue;
+		}
+		partition.ways.push_back(p_way);
+		for (int i = 0; i + 1 < p_way->get_nodes_list().size(); ++i) {
+			partition.segments.push_back(Validator::Segment{p_way, i});
+		}
+		const QVector<quint64> cells = m_way_cells.value(*it);
+		for (auto it_cell = cells.cbegin(); it_cell != cells.cend(); ++it_cell) {
+			way_cells.insert(*it_cell);
+		}
+	}
+	for (auto it = way_cells.cbegin(); it != way_cells.cend(); ++it) {
+		for (auto it_way = m_cell_ways.constFind(*it); it_way != m_cell_ways.cend() && it_way.key() == *it; ++it_way) {
+			if (!ways.contains(it_way.value())) {
+				near_ways.insert(it_way.value());
+			}
+		}
+	}
+	for (auto it = near_ways.cbegin(); it != near_ways.cend(); ++it) {
+		Osm_Way* p_way = mp_map->get_way(*it);
+		if (p_way == nullptr) {
+			continue;
+		}
+		for (int i = 0; i + 1 < p_way->get_nodes_list().size(); ++i) {
+			QVector<quint64> cells = get_cells(*p_way, i);
+			for (auto it_cell = cells.cbegin(); it_cell != cells.cend(); ++it_cell) {
+				if (way_cells.contains(*it_cell)) {
+					partition.segments.push_back(Validator::Segment{p_way, i});
+					break;
+				}
+			}
+		}
+	}
+
+	for (auto it = relations.cbegin(); it != relations.cend(); ++it) {
+		Osm_Relation* p_rel = mp_map->get_relation(*it);
+		if (p_rel != nullptr) {
+			partition.relations.push_back(p_rel);
+		}
+	}
+
+	QSet<int> old_keys = find_issues(nodes + near_nodes, ways, relations);
+	for (auto it = old_keys.cbegin(); it != old_keys.cend(); ++it) {
+		if (is_rechecked(m_issues.value(*it))) {
+			remove_issue(*it);
+		}
+	}
+	found = m_validator.check(partition);
+	for (auto it = found.cbegin(); it != found.cend(); ++it) {
+		if (is_rechecked(*it)) {
+			add_issue(*it);
+		}
+	}
+}
+
+void Live_Validator::reset() {
+	m_position_nodes.clear();
+	m_node_positions.clear();
+	m_cell_ways.clear();
+	m_way_cells.clear();
+	m_node_ways.clear();
+	m_way_nodes.clear();
+	m_issues.clear();
+	m_node_issues.clear();
+	m_way_issues.clear();
+	m_relation_issues.clear();
+	m_next_issue = 0;
+}
+
+/*================================================================*/
+/*                      Protected methods                         */
+/*================================================================*/
+
+void Live_Validator::handle_event_update(Osm_Object&) {
+	Osm_Object*		p_subject = get_meta().get_subject();
+	QSet<long long>	nodes;
+	QSet<long long>	ways;
+	QSet<long long>	relations;
+	QSet<quint64>	positions;
+	Meta::Ids		ids;
+	Osm_Node*		p_node;
+	Osm_Way*		p_way;
+	long long		id;
+
+	switch (get_meta().get_event()) {
+	case MAP_NODE_ADDED:
+	case MAP_NODE_UPDATED:
+		p_node = static_cast<Osm_Node*>(p_subject);
+		if (m_node_positions.contains(p_node->get_id())) {
+			positions.insert(m_node_positions.value(p_node->get_id()));
+		}
+		index(*p_node);
+		nodes.insert(p_node->get_id());
+		/* Their segments moved with it, the map sends no MAP_WAY_UPDATED for that */
+		for (auto it = m_node_ways.constFind(p_node->get_id()); it != m_node_ways.cend() && it.key() == p_node->get_id(); ++it) {
+			ways.insert(it.value());
+		}
+		for (auto it = ways.cbegin(); it != ways.cend(); ++it) {
+			if ((p_way = mp_map->get_way(*it)) != nullptr) {
+				index(*p_way);
+			}
+		}
+		break;
+	case MAP_WAY_ADDED:
+	case MAP_WAY_UPDATED:
+		p_way = static_cast<Osm_Way*>(p_subject);
+		index(*p_way);
+		ways.insert(p_way->get_id());
+		break;
+	case MAP_RELATION_ADDED:
+	case MAP_RELATION_UPDATED:
+		relations.insert(static_cast<Osm_Relation*>(p_subject)->get_id());
+		break;
+	case MAP_NODE_REMOVED:
+		id = static_cast<Osm_Node*>(p_subject)->get_id();
+		nodes.insert(id);
+		if (find_issues(nodes, ways, relations).isEmpty()) {
+			unindex_node(id);
+			return;
+		}
+		/* Whoever shared its position may be left alone */
+		positions.insert(m_node_positions.value(id));
+		unindex_node(id);
+		break;
+	case MAP_WAY_REMOVED:
+		id = static_cast<Osm_Way*>(p_subject)->get_id();
+		ways.insert(id);
+		unindex_way(id);
+		break;
+	case MAP_RELATION_REMOVED:
+		relations.insert(static_cast<Osm_Relation*>(p_subject)->get_id());
+		break;
+	case MAP_TAGS_UPDATED:
+		/* Tags move nothing, the position and cell indexes stay as they are */
+		ids = get_meta().get_ids();
+		if (ids.is_empty()) {
+			return;
+		}
+		for (auto it = ids.nodes.cbegin(); it != ids.nodes.cend(); ++it) {
+			nodes.insert(*it);
+		}
+		for (auto it = ids.ways.cbegin(); it != ids.ways.cend(); ++it) {
+			ways.insert(*it);
+		}
+		for (auto it = ids.relations.cbegin(); it != ids.relations.cend(); ++it) {
+			relations.insert(*it);
+		}
+		break;
+	case MAP_CLEARED:
+		reset();
+		return;
+	case MAP_RELOADED:
+		revalidate();
+		return;
+	default:
+		return;
+	}
+	recheck(nodes, ways, relations, positions);
+}
+
+void Live_Validator::handle_event_delete(Osm_Object&) {
+	if (get_meta().get_event() == MAP_DELETED) {
+		mp_map = nullptr;
+		reset();
+	}
+}
+
+/*================================================================*/
+/*                        Public methods                          */
+/*================================================================*/
+
+Validator& Live_Validator::get_validator() {
+	return m_validator;
+}
+
+void Live_Validator::follow(Osm_Map& map) {
+	unfollow();
+	mp_map = &map;
+	subscribe(map);
+	revalidate();
+}
+
+void Live_Validator::unfollow() {
+	unsubscribe();
+	mp_map = nullptr;
+	reset();
+}
+
+bool Live_Validator::is_following() const {
+	return mp_map != nullptr;
+}
+
+void Live_Validator::revalidate() {
+	QVector<Validator::Issue> issues;
+
+	reset();
+	if (mp_map == nullptr) {
+		return;
+	}
+	for (auto it = mp_map->cnbegin(); it != mp_map->cnend(); ++it) {
+		index(**it);
+	}
+	for (auto it = mp_map->cwbegin(); it != mp_map->cwend(); ++it) {
+		index(**it);
+	}
+	issues = m_validator.run(*mp_map);
+	for (auto it = issues.cbegin(); it != issues.cend(); ++it) {
+		add_issue(*it);
+	}
+}
+
+int Live_Validator::count_issues() const {
+	return m_issues.size();
+}
+
+QVector<Validator::Issue> Live_Validator::get_issues() const {
+	QVector<Validator::Issue> issues;
+
+	issues.reserve(m_issues.size());
+	for (auto it = m_issues.cbegin(); it != m_issues.cend(); ++it) {
+		issues.push_back(it.value());
+	}
+	std::sort(issues.begin(), issues.end(), Validator::is_before);
+	return issues;
+}
+
+QVector<Validator::Issue> Live_Validator::find_node_issues(long long id_node) const {
+	QVector<Validator::Issue> issues;
+
+	for (auto it = m_node_issues.constFind(id_node); it != m_node_issues.cend() && it.key() == id_node; ++it) {
+		issues.push_back(m_issues.value(it.value()));
+	}
+	std::sort(issues.begin(), issues.end(), Validator::is_before);
+	return issues;
+}
+
+QVector<Validator::Issue> Live_Validator::find_way_issues(long long id_way) const {
+	QVector<Validator::Issue> issues;
+
+	for (auto it = m_way_issues.constFind(id_way); it != m_way_issues.cend() && it.key() == id_way; ++it) {
+		issues.push_back(m_issues.value(it.value()));
+	}
+	std::sort(issues.begin(), issues.end(), Validator::is_before);
+	return issues;
+}
+
+QVector<Validator::Issue> Live_Validator::find_relation_issues(long long id_relation) const {
+	QVector<Validator::Issue> issues;
+
+	for (auto it = m_relation_issues.constFind(id_relation); it != m_relation_issues.cend() && it.key() == id_relation; ++it) {
+		issues.push_back(m_issues.value(it.value()));
+	}
+	std::sort(issues.begin(), issues.end(), Validator::is_before);
+	return issues;
+}
@@ -0,0 +1,80 @@
+#ifndef LIVE_VALIDATOR_H
+#define LIVE_VALIDATOR_H
+
+#ifndef QT_CORE_H
+#define QT_CORE_H
+#include <QtCore>
+#endif /* Include guard QT_CORE_H */
+
+#include "validator.h"
+
+namespace ns_osm {
+
+/* Keeps the issues of a map current while it is edited. follow() runs the
+ * validator once; after that every map event rechecks only the elements
+ * it names, together with their neighbours: the nodes at the position of a
+ * touched node and the way segments sharing a grid cell with a touched way.
+ * A moved node touches the ways through it as well.
+ * An edit therefore costs the same on a small map and on a large one.
+ *
+ * Of the rechecked issues, only those naming a touched element, or naming
+ * nothing but neighbour nodes, replace the stored ones; the others were
+ * not looked at in full and stay as they are. */
+class Live_Validator : public Osm_Subscriber {
+private:
+	static const double						CELL_SIZE; /* Degrees */
+	Osm_Map*								mp_map;
+	Validator								m_validator;
+	QMultiHash<quint64, long long>			m_position_nodes;
+	QHash<long long, quint64>				m_node_positions;
+	QMultiHash<quint64, long long>			m_cell_ways;
+	QHash<long long, QVector<quint64>>		m_way_cells;
+	QMultiHash<long long, long long>		m_node_ways; /* A moved node brings its ways along */
+	QHash<long long, QVector<long long>>	m_way_nodes;
+	QHash<int, Validator::Issue>			m_issues;
+	QMultiHash<long long, int>				m_node_issues;
+	QMultiHash<long long, int>				m_way_issues;
+	QMultiHash<long long, int>				m_relation_issues;
+	int										m_next_issue;
+
+	static quint64							get_position	(const Osm_Node&); /* At the duplicate rule's precision */
+	static quint64							get_cell		(double lat, double lon);
+	static QVector<quint64>					get_cells		(double lat1, double lon1, double lat2, double lon2);
+	static QVector<quint64>					get_cells		(const Osm_Way&, int segment);
+	void									index			(const Osm_Node&);
+	void									index			(const Osm_Way&);
+	void									unindex_node	(long long id_node);
+	void									unindex_way		(long long id_way);
+	void									add_issue		(const Validator::Issue&);
+	void									remove_issue	(int key);
+	QSet<int>								find_issues		(const QSet<long long>& nodes,
+	                                                         const QSet<long long>& ways,
+	                                                         const QSet<long long>& relations) const;
+	void									recheck			(const QSet<long long>& nodes,
+	                                                         const QSet<long long>& ways,
+	                                                         const QSet<long long>& relations,
+	                                                         QSet<quint64> positions);
+	void									reset			();
+protected:
+	void									handle_event_update	(Osm_Object&) override;
+	void									handle_event_delete	(Osm_Object&) override;
+public:
+	Validator&								get_validator	(); /* Rules; call revalidate() after changing them */
+	void									follow			(Osm_Map&);
+	void									unfollow		();
+	bool									is_following	() const;
+	void									revalidate		(); /* Full run */
+	int										count_issues	() const;
+	QVector<Validator::Issue>				get_issues		() const; /* Sorted by Validator::is_before */
+	QVector<Validator::Issue>				find_node_issues(long long id_node) const;
+	QVector<Validator::Issue>				find_way_issues	(long long id_way) const;
+	QVector<Validator::Issue>				find_relation_issues(long long id_relation) const;
+	                                        Live_Validator	();
+											Live_Validator	(const Live_Validator&) = delete;
+	Live_Validator&							operator=		(const Live_Validator&) = delete;
+	virtual									~Live_Validator	();
+};
+
+}
+
+#endif // LIVE_VALIDATOR_H
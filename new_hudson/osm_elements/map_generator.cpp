@@ -0,0 +1,485 @@
+#include "map_generator.h"
+
+using namespace ns_osm;
+
+/*================================================================*/
+/*                     Map_Generator::Town                        */
+/*================================================================*/
+
+/* Elements refer to each other by index within the town */
+struct Map_Generator::Town {
+	struct Node {
+		double				lat;
+		double				lon;
+		Tags				tags;
+	};
+	struct Way {
+		QVector<int>		nodes;
+		Tags				tags;
+	};
+	struct Relation {
+		QVector<int>		ways;
+		QVector<QString>	roles;
+		Tags				tags;
+	};
+	QVector<Node>			nodes;
+	QVector<Way>			ways;
+	QVector<Relation>		relations;
+};
+
+/*================================================================*/
+/*                    Map_Generator::Random                       */
+/*================================================================*/
+
+/* SplitMix64: the same sequence everywhere, unlike the std distributions */
+class Map_Generator::Random {
+	quint64		m_state;
+public:
+	quint64		next		();
+	double		uniform		(); /* [0, 1) */
+	int			below		(int n);
+	bool		chance		(double p);
+	            Random		(quint64 seed, int stream);
+};
+
+Map_Generator::Random::Random(quint64 seed, int stream) {
+	m_state = seed ^ (static_cast<quint64>(stream) * Q_UINT64_C(0xD1B54A32D192ED03));
+	next();
+}
+
+quint64 Map_Generator::Random::next() {
+	quint64 z = (m_state += Q_UINT64_C(0x9E3779B97F4A7C15));
+
+	z = (z ^ (z >> 30)) * Q_UINT64_C(0xBF58476D1CE4E5B9);
+	z = (z ^ (z >> 27)) * Q_UINT64_C(0x94D049BB133111EB);
+	return z ^ (z >> 31);
+}
+
+double Map_Generator::Random::uniform() {
+	return (next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+int Map_Generator::Random::below(int n) {
+	return static_cast<int>(uniform() * n);
+}
+
+bool Map_Generator::Random::chance(double p) {
+	return uniform() < p;
+}
+
+/*================================================================*/
+/*                        Static members                          */
+/*================================================================*/
+
+const int Map_Generator::TOWNS_PER_ROW = 256;
+const double Map_Generator::STREET_LAT = 0.0015;
+const double Map_Generator::STREET_LON = 0.002;
+const double Map_Generator::TOWN_GAP = 0.005;
+
+namespace {
+
+const double		BASE_LAT = 45.0;
+const double		BASE_LON = 5.0;
+const char* const	STREET_NAMES[] = {"Linden", "Mill", "Church", "Station", "Garden", "Market", "Castle",
+                                      "River", "School", "Bridge", "Forest", "Meadow", "Harbour", "Oak"};
+const char* const	BUILDINGS[] = {"yes", "yes", "house", "house", "residential", "apartments",
+                                   "detached", "commercial", "retail", "garage", "shed"};
+const char* const	AMENITIES[] = {"cafe", "restaurant", "pharmacy", "bank", "school", "kindergarten",
+                                   "fuel", "post_office", "bar", "fast_food", "library", "parking"};
+const char* const	SHOPS[] = {"bakery", "supermarket", "convenience", "butcher", "clothes", "hairdresser",
+                               "kiosk", "florist", "hardware", "books"};
+const char* const	EXTRA_KEYS[] = {"opening_hours", "website", "phone", "wheelchair", "operator", "level",
+                                    "cuisine", "brand", "contact:email", "internet_access", "outdoor_seating",
+                                    "payment:cash", "payment:cards", "check_date", "description", "note"};
+const char* const	EXTRA_VALUES[] = {"yes", "no", "limited", "Mo-Fr 08:00-18:00", "Mo-Sa 09:00-20:00", "0", "1",
+                                      "regional", "https://example.org", "+49 228 000000", "wlan", "2020-05-01"};
+
+template <typename T, int N>
+int count_of(T (&)[N]) {
+	return N;
+}
+
+}
+
+/*================================================================*/
+/*                  Constructors, destructors                     */
+/*================================================================*/
+
+Map_Generator::Map_Generator() {
+	m_seed = 1;
+	m_target_size = 100000;
+	m_town_size = 12;
+	m_tag_density = 3.0;
+	f_antimeridian = false;
+}
+
+/*================================================================*/
+/*                       Private methods                          */
+/*================================================================*/
+
+double Map_Generator::wrap_lon(double lon) {
+	return lon >= 180.0 ? lon - 360.0 : lon;
+}
+
+void Map_Generator::make_town(int index, Town& town) const {
+	const int		N = m_town_size;
+	Random			rng(m_seed, index);
+	double			south = BASE_LAT + (index / TOWNS_PER_ROW) * ((N - 1) * STREET_LAT + TOWN_GAP);
+	double			west = BASE_LON + (index % TOWNS_PER_ROW) * ((N - 1) * STREET_LON + TOWN_GAP);
+	QVector<QString> row_names;
+	auto			add_node = [&town](double lat, double lon) {
+		town.nodes.push_back(Town::Node{lat, wrap_lon(lon), Tags()});
+		return town.nodes.size() - 1;
+	};
+	/* Closed way around a box, as a new way */
+	auto			add_ring = [&town, &add_node](double s, double w, double n, double e) {
+		Town::Way	way;
+		int			first = add_node(s, w);
+		way.nodes << first << add_node(s, e) << add_node(n, e) << add_node(n, w) << first;
+		town.ways.push_back(way);
+		return town.ways.size() - 1;
+	};
+
+	town.nodes.clear();
+	town.ways.clear();
+	town.relations.clear();
+	if (f_antimeridian && index == 0) {
+		west = 180.0 - (N - 1) * STREET_LON / 2;
+	}
+
+	/* Street grid, crossings slightly off the lines */
+	for (int row = 0; row < N; ++row) {
+		for (int col = 0; col < N; ++col) {
+			add_node(south + row * STREET_LAT + (rng.uniform() - 0.5) * STREET_LAT * 0.1,
+			         west + col * STREET_LON + (rng.uniform() - 0.5) * STREET_LON * 0.1);
+		}
+	}
+	for (int row = 0; row < N; ++row) {
+		Town::Way way;
+		for (int col = 0; col < N; ++col) {
+			way.nodes.push_back(row * N + col);
+		}
+		row_names.push_back(QString(STREET_NAMES[rng.below(count_of(STREET_NAMES))]) + " Street");
+		way.tags << qMakePair(QString("highway"), QString(row % 4 == 0 ? "secondary" : "residential"))
+		         << qMakePair(QString("name"), row_names.back());
+		if (row % 4 == 0) {
+			way.tags << qMakePair(QString("maxspeed"), QString("50")) << qMakePair(QString("lanes"), QString("2"));
+		}
+		town.ways.push_back(way);
+	}
+	for (int col = 0; col < N; ++col) {
+		Town::Way way;
+		for (int row = 0; row < N; ++row) {
+			way.nodes.push_back(row * N + col);
+		}
+		way.tags << qMakePair(QString("highway"), QString(col % 4 == 0 ? "secondary" : "residential"))
+		         << qMakePair(QString("name"), QString(STREET_NAMES[rng.below(count_of(STREET_NAMES))]) + " Avenue");
+		if (col % 4 == 0) {
+			way.tags << qMakePair(QString("maxspeed"), QString("50")) << qMakePair(QString("lanes"), QString("2"));
+		}
+		town.ways.push_back(way);
+	}
+
+	/* Blocks: a courtyard building, or a few plain ones, and maybe a point of interest */
+	for (int row = 0; row + 1 < N; ++row) {
+		for (int col = 0; col + 1 < N; ++col) {
+			double s = south + row * STREET_LAT;
+			double w = west + col * STREET_LON;
+			if (rng.chance(0.06)) {
+				Town::Relation relation;
+				relation.ways << add_ring(s + STREET_LAT * 0.15, w + STREET_LON * 0.15,
+				                          s + STREET_LAT * 0.85, w + STREET_LON * 0.85)
+				              << add_ring(s + STREET_LAT * 0.4, w + STREET_LON * 0.4,
+				                          s + STREET_LAT * 0.6, w + STREET_LON * 0.6);
+				relation.roles << "outer" << "inner";
+				relation.tags << qMakePair(QString("type"), QString("multipolygon"))
+				              << qMakePair(QString("building"), QString("apartments"))
+				              << qMakePair(QString("building:levels"), QString::number(3 + rng.below(6)));
+				town.relations.push_back(relation);
+			} else {
+				int		n_buildings = 1 + rng.below(3);
+				double	slot = STREET_LON * 0.8 / n_buildings;
+				for (int i = 0; i < n_buildings; ++i) {
+					double	e = w + STREET_LON * 0.1 + (i + 1) * slot;
+					int		way = add_ring(s + STREET_LAT * 0.15, e - slot * 0.9, s + STREET_LAT * 0.45, e - slot * 0.1);
+					town.ways[way].tags << qMakePair(QString("building"), QString(BUILDINGS[rng.below(count_of(BUILDINGS))]));
+					if (rng.chance(0.5)) {
+						town.ways[way].tags << qMakePair(QString("addr:street"), row_names[row])
+						                    << qMakePair(QString("addr:housenumber"), QString::number(1 + col * 4 + i));
+					}
+				}
+			}
+			if (rng.chance(0.3)) {
+				int		poi = add_node(s + STREET_LAT * 0.7, w + STREET_LON * 0.5);
+				Tags&	tags = town.nodes[poi].tags;
+				int		n_extra = static_cast<int>(m_tag_density) + (rng.chance(m_tag_density - qFloor(m_tag_density)) ? 1 : 0);
+				if (rng.chance(0.5)) {
+					tags << qMakePair(QString("amenity"), QString(AMENITIES[rng.below(count_of(AMENITIES))]));
+				} else {
+					tags << qMakePair(QString("shop"), QString(SHOPS[rng.below(count_of(SHOPS))]));
+				}
+				tags << qMakePair(QString("name"), QString("%1 %2").arg(STREET_NAMES[rng.below(count_of(STREET_NAMES))]).arg(index));
+				for (int i = 0; i < n_extra; ++i) {
+					tags << qMakePair(QString(EXTRA_KEYS[rng.below(count_of(EXTRA_KEYS))]),
+					                  QString(EXTRA_VALUES[rng.below(count_of(EXTRA_VALUES))]));
+				}
+			}
+		}
+	}
+}
+
+/*================================================================*/
+/*                        Public methods                          */
+/*================================================================*/
+
+void Map_Generator::set_seed(quint64 seed) {
+	m_seed = seed;
+}
+
+void Map_Generator::set_target_size(long long n_elements) {
+	m_target_size = n_elements;
+}
+
+void Map_Generator::set_town_size(int n_streets) {
+	m_town_size = qBound(2, n_streets, 1000);
+}
+
+void Map_Generator::set_tag_density(double n_tags) {
+	m_tag_density = qMax(0.0, n_tags);
+}
+
+void Map_Generator::set_antimeridian(bool f) {
+	f_antimeridian = f;
+}
+
+/* One pass to count and bound, then one per section. The bound is taken over
+ * unwrapped longitudes, so with the antimeridian town west ends up east of
+ * east, the way .osm bounds cross longitude 180 */
+long long Map_Generator::generate(Sink& sink) const {
+	Town		town;
+	int			n_towns = 0;
+	long long	n_elements = 0;
+	long long	node_base = 0;
+	long long	way_base = 0;
+	long long	relation_base = 0;
+	double		south = 90.0;
+	double		west = 180.0;
+	double		north = -90.0;
+	double		east = -180.0;
+
+	do {
+		make_town(n_towns++, town);
+		n_elements += town.nodes.size() + town.ways.size() + town.relations.size();
+		for (auto it = town.nodes.cbegin(); it != town.nodes.cend(); ++it) {
+			/* Only the antimeridian town has nodes past 180, and only those come out negative */
+			double lon = (f_antimeridian && n_towns == 1 && it->lon < 0.0) ? it->lon + 360.0 : it->lon;
+			south = qMin(south, it->lat);
+			north = qMax(north, it->lat);
+			west = qMin(west, lon);
+			east = qMax(east, lon);
+		}
+	} while (n_elements < m_target_size);
+	sink.begin(south, west, north, wrap_lon(east));
+
+	for (int i = 0; i < n_towns; ++i) {
+		make_town(i, town);
+		for (int j = 0; j < town.nodes.size(); ++j) {
+			sink.add_node(node_base + j + 1, town.nodes[j].lat, town.nodes[j].lon, town.nodes[j].tags);
+		}
+		node_base += town.nodes.size();
+	}
+	node_base = 0;
+	for (int i = 0; i < n_towns; ++i) {
+		make_town(i, town);
+		for (int j = 0; j < town.ways.size(); ++j) {
+			QVector<long long> nodes;
+			nodes.reserve(town.ways[j].nodes.size());
+			for (auto it = town.ways[j].nodes.cbegin(); it != town.ways[j].nodes.cend(); ++it) {
+				nodes.push_back(node_base + *it + 1);
+			}
+			sink.add_way(way_base + j + 1, nodes, town.ways[j].tags);
+		}
+		node_base += town.nodes.size();
+		way_base += town.ways.size();
+	}
+	way_base = 0;
+	for (int i = 0; i < n_towns; ++i) {
+		make_town(i, town);
+		for (int j = 0; j < town.relations.size(); ++j) {
+			QVector<Member> members;
+			for (int k = 0; k < town.relations[j].ways.size(); ++k) {
+				members.push_back(Member{way_base + town.relations[j].ways[k] + 1, town.relations[j].roles[k]});
+			}
+			sink.add_relation(relation_base + j + 1, members, town.relations[j].tags);
+		}
+		way_base += town.ways.size();
+		relation_base += town.relations.size();
+	}
+	sink.end();
+	return n_elements;
+}
+
+long long Map_Generator::generate(Osm_Map& map) const {
+	Map_Sink sink(map);
+
+	return generate(sink);
+}
+
+bool Map_Generator::write_osm(const QString& path) const {
+	QFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly)) {
+		return false;
+	}
+	Xml_Sink sink(&file);
+	generate(sink);
+	return !sink.has_error();
+}
+
+/*================================================================*/
+/*                     Map_Generator::Sink                        */
+/*================================================================*/
+
+Map_Generator::Sink::~Sink() {}
+
+void Map_Generator::Sink::begin(double, double, double, double) {}
+
+void Map_Generator::Sink::end() {}
+
+/*================================================================*/
+/*                   Map_Generator::Xml_Sink                      */
+/*================================================================*/
+
+Map_Generator::Xml_Sink::Xml_Sink(QIODevice* p_device) {
+	m_writer.setDevice(p_device);
+	m_writer.setAutoFormatting(true);
+}
+
+void Map_Generator::Xml_Sink::write_tags(const Tags& tags) {
+	for (auto it = tags.cbegin(); it != tags.cend(); ++it) {
+		m_writer.writeEmptyElement("tag");
+		m_writer.writeAttribute("k", it->first);
+		m_writer.writeAttribute("v", it->second);
+	}
+}
+
+void Map_Generator::Xml_Sink::begin(double south, double west, double north, double east) {
+	m_writer.writeStartDocument();
+	m_writer.writeStartElement("osm");
+	m_writer.writeAttribute("version", "0.6");
+	m_writer.writeAttribute("generator", "Hudson");
+	m_writer.writeEmptyElement("bounds");
+	m_writer.writeAttribute("minlat", QString::number(south, 'f', 7));
+	m_writer.writeAttribute("minlon", QString::number(west, 'f', 7));
+	m_writer.writeAttribute("maxlat", QString::number(north, 'f', 7));
+	m_writer.writeAttribute("maxlon", QString::number(east, 'f', 7));
+}
+
+void Map_Generator::Xml_Sink::add_node(long long id, double lat, double lon, const Tags& tags) {
+	if (tags.isEmpty()) {
+		m_writer.writeEmptyElement("node");
+	} else {
+		m_writer.writeStartElement("node");
+	}
+	m_writer.writeAttribute("id", QString::number(id));
+	m_writer.writeAttribute("visible", "true");
+	m_writer.writeAttribute("version", "1");
+	m_writer.writeAttribute("lat", QString::number(lat, 'f', 7));
+	m_writer.writeAttribute("lon", QString::number(lon, 'f', 7));
+	if (!tags.isEmpty()) {
+		write_tags(tags);
+		m_writer.writeEndElement();
+	}
+}
+
+void Map_Generator::Xml_Sink::add_way(long long id, const QVector<long long>& nodes, const Tags& tags) {
+	m_writer.writeStartElement("way");
+	m_writer.writeAttribute("id", QString::number(id));
+	m_writer.writeAttribute("visible", "true");
+	m_writer.writeAttribute("version", "1");
+	for (auto it = nodes.cbegin(); it != nodes.cend(); ++it) {
+		m_writer.writeEmptyElement("nd");
+		m_writer.writeAttribute("ref", QString::number(*it));
+	}
+	write_tags(tags);
+	m_writer.writeEndElement();
+}
+
+void Map_Generator::Xml_Sink::add_relation(long long id, const QVector<Member>& members, const Tags& tags) {
+	m_writer.writeStartElement("relation");
+	m_writer.writeAttribute("id", QString::number(id));
+	m_writer.writeAttribute("visible", "true");
+	m_writer.writeAttribute("version", "1");
+	for (auto it = members.cbegin(); it != members.cend(); ++it) {
+		m_writer.writeEmptyElement("member");
+		m_writer.writeAttribute("type", "way");
+		m_writer.writeAttribute("ref", QString::number(it->way_id));
+		m_writer.writeAttribute("role", it->role);
+	}
+	write_tags(tags);
+	m_writer.writeEndElement();
+}
+
+void Map_Generator::Xml_Sink::end() {
+	m_writer.writeEndElement();
+	m_writer.writeEndDocument();
+}
+
+bool Map_Generator::Xml_Sink::has_error() const {
+	return m_writer.hasError();
+}
+
+/*================================================================*/
+/*                   Map_Generator::Map_Sink                      */
+/*================================================================*/
+
+Map_Generator::Map_Sink::Map_Sink(Osm_Map& map) : m_map(map) {}
+
+/* Same orientation as a bound loaded from XML */
+void Map_Generator::Map_Sink::begin(double south, double west, double north, double east) {
+	QRectF bound;
+
+	bound.setLeft(west);
+	bound.setBottom(south);
+	bound.setRight(east);
+	bound.setTop(north);
+	m_map.set_bound(bound);
+	m_map.begin_batch();
+}
+
+void Map_Generator::Map_Sink::end() {
+	m_map.end_batch();
+}
+
+void Map_Generator::Map_Sink::add_node(long long id, double lat, double lon, const Tags& tags) {
+	Osm_Node* p_node = new Osm_Node(QString::number(id), QString::number(lat, 'f', 7), QString::number(lon, 'f', 7));
+
+	for (auto it = tags.cbegin(); it != tags.cend(); ++it) {
+		p_node->set_tag(it->first, it->second);
+	}
+	m_map.add(p_node);
+}
+
+void Map_Generator::Map_Sink::add_way(long long id, const QVector<long long>& nodes, const Tags& tags) {
+	Osm_Way* p_way = new Osm_Way(QString::number(id));
+
+	for (auto it = nodes.cbegin(); it != nodes.cend(); ++it) {
+		p_way->push_node(m_map.get_node(*it));
+	}
+	for (auto it = tags.cbegin(); it != tags.cend(); ++it) {
+		p_way->set_tag(it->first, it->second);
+	}
+	m_map.add(p_way);
+}
+
+void Map_Generator::Map_Sink::add_relation(long long id, const QVector<Member>& members, const Tags& tags) {
+	Osm_Relation* p_rel = new Osm_Relation(QString::number(id));
+
+	for (auto it = members.cbegin(); it != members.cend(); ++it) {
+		p_rel->add(m_map.get_way(it->way_id), it->role);
+	}
+	for (auto it = tags.cbegin(); it != tags.cend(); ++it) {
+		p_rel->set_tag(it->first, it->second);
+	}
+	m_map.add(p_rel);
+}
@@ -0,0 +1,113 @@
+#ifndef MAP_GENERATOR_H
+#define MAP_GENERATOR_H
+
+#ifndef QT_CORE_H
+#define QT_CORE_H
+#include <QtCore>
+#endif /* Include guard QT_CORE_H */
+
+#include "osm_map.h"
+
+namespace ns_osm {
+
+/* Builds a synthetic map of about a target number of elements from a seed;
+ * the same seed and settings give the same map on every platform. The map
+ * is a row-major array of towns, each a street grid with secondary roads,
+ * buildings in the blocks, courtyard buildings as multipolygon relations
+ * and tagged points of interest. With the antimeridian option the first
+ * town straddles longitude 180.
+ *
+ * Output goes to a Sink in OSM order: bounds, all nodes, all ways, all
+ * relations. Towns are regenerated for every section rather than kept, so
+ * memory stays at one town whatever the target; Xml_Sink streams .osm
+ * XML, Map_Sink fills an Osm_Map. */
+class Map_Generator {
+public:
+	typedef QVector<QPair<QString, QString>>	Tags;
+	struct Member {
+		long long	way_id;
+		QString		role;
+	};
+	class Sink;
+	class Xml_Sink;
+	class Map_Sink;
+private:
+	struct Town;
+	class Random;
+
+	static const int						TOWNS_PER_ROW;
+	static const double						STREET_LAT; /* Degrees between streets */
+	static const double						STREET_LON;
+	static const double						TOWN_GAP;
+	quint64									m_seed;
+	long long								m_target_size;
+	int										m_town_size;
+	double									m_tag_density;
+	bool									f_antimeridian;
+
+	void									make_town		(int index, Town&) const;
+	static double							wrap_lon		(double lon);
+public:
+	void									set_seed		(quint64);
+	void									set_target_size	(long long n_elements);
+	void									set_town_size	(int n_streets); /* Streets each way, 12 by default */
+	void									set_tag_density	(double n_tags); /* Extra tags per point of interest, on average */
+	void									set_antimeridian(bool f);
+	long long								generate		(Sink&) const; /* Elements written */
+	long long								generate		(Osm_Map&) const;
+	bool									write_osm		(const QString& path) const;
+	                                        Map_Generator	();
+};
+
+/*================================================================*/
+/*                     Map_Generator::Sink                        */
+/*================================================================*/
+
+class Map_Generator::Sink {
+public:
+	virtual void						begin			(double south, double west, double north, double east);
+	virtual void						add_node		(long long id, double lat, double lon, const Tags&) = 0;
+	virtual void						add_way			(long long id, const QVector<long long>& nodes, const Tags&) = 0;
+	virtual void						add_relation	(long long id, const QVector<Member>&, const Tags&) = 0;
+	virtual void						end				();
+	virtual								~Sink			();
+};
+
+/*================================================================*/
+/*                   Map_Generator::Xml_Sink                      */
+/*================================================================*/
+
+class Map_Generator::Xml_Sink : public Sink {
+private:
+	QXmlStreamWriter					m_writer;
+
+	void								write_tags		(const Tags&);
+public:
+	void								begin			(double south, double west, double north, double east) override;
+	void								add_node		(long long id, double lat, double lon, const Tags&) override;
+	void								add_way			(long long id, const QVector<long long>& nodes, const Tags&) override;
+	void								add_relation	(long long id, const QVector<Member>&, const Tags&) override;
+	void								end				() override;
+	bool								has_error		() const;
+	                                    Xml_Sink		(QIODevice*);
+};
+
+/*================================================================*/
+/*                   Map_Generator::Map_Sink                      */
+/*================================================================*/
+
+class Map_Generator::Map_Sink : public Sink {
+private:
+	Osm_Map&							m_map;
+public:
+	void								begin			(double south, double west, double north, double east) override;
+	void								add_node		(long long id, double lat, double lon, const Tags&) override;
+	void								add_way			(long long id, const QVector<long long>& nodes, const Tags&) override;
+	void								add_relation	(long long id, const QVector<Member>&, const Tags&) override;
+	void								end				() override;
+	                                    Map_Sink		(Osm_Map&);
+};
+
+}
+
+#endif // MAP_GENERATOR_H
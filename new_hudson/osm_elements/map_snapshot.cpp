@@ -0,0 +1,100 @@
+#include "map_snapshot.h"
+
+using namespace ns_osm;
+
+/*================================================================*/
+/*                  Constructors, destructors                     */
+/*================================================================*/
+
+Map_Snapshot::Map_Snapshot() {
+	m_version = 0;
+}
+
+Map_Snapshot::Map_Snapshot(const Osm_Map& map) {
+	m_version = 0;
+	m_bound = map.get_bound();
+	for (auto it = map.cnbegin(); it != map.cnend(); ++it) {
+		m_nodes.insert(it.key(), make_node(**it));
+	}
+	for (auto it = map.cwbegin(); it != map.cwend(); ++it) {
+		m_ways.insert(it.key(), make_way(**it));
+	}
+	for (auto it = map.crbegin(); it != map.crend(); ++it) {
+		m_relations.insert(it.key(), make_relation(**it));
+	}
+}
+
+/*================================================================*/
+/*                       Private methods                          */
+/*================================================================*/
+
+/* Shares the maps rather than copying their contents */
+void Map_Snapshot::copy_info(const Osm_Info& info, Element& element) {
+	element.id = info.get_id();
+	element.attrs = info.get_attr_map();
+	element.tags = info.get_tag_map();
+}
+
+Map_Snapshot::Node Map_Snapshot::make_node(const Osm_Node& osm_node) {
+	Node node;
+
+	copy_info(osm_node, node);
+	node.lat = osm_node.get_lat();
+	node.lon = osm_node.get_lon();
+	return node;
+}
+
+Map_Snapshot::Way Map_Snapshot::make_way(const Osm_Way& osm_way) {
+	Way way;
+
+	copy_info(osm_way, way);
+	way.nodes.reserve(osm_way.get_nodes_list().size());
+	for (Osm_Node* p_node : osm_way.get_nodes_list()) {
+		way.nodes.push_back(p_node->get_id());
+	}
+	return way;
+}
+
+Map_Snapshot::Relation Map_Snapshot::make_relation(const Osm_Relation& osm_rel) {
+	Relation rel;
+
+	copy_info(osm_rel, rel);
+	for (Osm_Node* p_node : osm_rel.get_nodes()) {
+		rel.members.push_back(Member{NODE, p_node->get_id(), osm_rel.get_role(p_node)});
+	}
+	for (Osm_Way* p_way : osm_rel.get_ways()) {
+		rel.members.push_back(Member{WAY, p_way->get_id(), osm_rel.get_role(p_way)});
+	}
+	for (Osm_Relation* p_member : osm_rel.get_relations()) {
+		rel.members.push_back(Member{RELATION, p_member->get_id(), osm_rel.get_role(p_member)});
+	}
+	return rel;
+}
+
+/*================================================================*/
+/*                        Public methods                          */
+/*================================================================*/
+
+QRectF Map_Snapshot::get_bound() const {
+	return m_bound;
+}
+
+const Shared_Table<Map_Snapshot::Node>& Map_Snapshot::get_nodes() const {
+	return m_nodes;
+}
+
+const Shared_Table<Map_Snapshot::Way>& Map_Snapshot::get_ways() const {
+	return m_ways;
+}
+
+const Shared_Table<Map_Snapshot::Relation>& Map_Snapshot::get_relations() const {
+	return m_relations;
+}
+
+quint64 Map_Snapshot::get_version() const {
+	return m_version;
+}
+
+bool Map_Snapshot::is_empty() const {
+	return m_nodes.count() == 0 && m_ways.count() == 0 && m_relations.count() == 0;
+}
@@ -0,0 +1,78 @@
+#ifndef MAP_SNAPSHOT_H
+#define MAP_SNAPSHOT_H
+
+#ifndef QT_CORE_H
+#define QT_CORE_H
+#include <QtCore>
+#endif /* Include guard QT_CORE_H */
+
+#include "osm_map.h"
+#include "shared_table.h"
+
+namespace ns_osm {
+
+/* A frozen, pointer-free copy of a map: bound, and for every element its
+ * id, attributes, tags and the ids of its nodes or members. Attribute and
+ * tag maps are Qt's implicitly shared containers, so taking a snapshot
+ * copies a reference per element and leaves the strings alone; an edit
+ * made afterwards detaches the edited map only. Taking one must happen on
+ * the thread owning the map, but the snapshot itself can then be read on
+ * any thread while the map keeps changing.
+ *
+ * Snapshots are values and copying one is cheap as well. A Map_Versioner
+ * keeps one up to date with its map, so that taking the next one costs
+ * only the elements changed since. */
+class Map_Snapshot {
+	friend class Map_Versioner;
+public:
+	enum Member_Type {NODE, WAY, RELATION};
+
+	struct Element {
+		long long				id;
+		QMap<QString, QString>	attrs;
+		QMap<QString, QString>	tags;
+	};
+
+	struct Node : Element {
+		double					lat;
+		double					lon;
+	};
+
+	struct Way : Element {
+		QVector<long long>		nodes; /* In way order */
+	};
+
+	struct Member {
+		Member_Type				type;
+		long long				id;
+		QString					role;
+	};
+
+	struct Relation : Element {
+		QVector<Member>			members; /* Nodes, then ways, then relations */
+	};
+private:
+	QRectF									m_bound;
+	Shared_Table<Node>						m_nodes;
+	Shared_Table<Way>						m_ways;
+	Shared_Table<Relation>					m_relations;
+	quint64									m_version;
+
+	static void								copy_info		(const Osm_Info&, Element&);
+	static Node								make_node		(const Osm_Node&);
+	static Way								make_way		(const Osm_Way&);
+	static Relation							make_relation	(const Osm_Relation&);
+public:
+	QRectF									get_bound		() const;
+	const Shared_Table<Node>&				get_nodes		() const;
+	const Shared_Table<Way>&				get_ways		() const;
+	const Shared_Table<Relation>&			get_relations	() const;
+	quint64									get_version		() const; /* Increases with every change seen by a versioner */
+	bool									is_empty		() const;
+	                                        Map_Snapshot	();
+	explicit								Map_Snapshot	(const Osm_Map&); /* Full capture, O(map) */
+};
+
+}
+
+#endif // MAP_SNAPSHOT_H
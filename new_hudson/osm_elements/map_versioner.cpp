@@ -0,0 +1,184 @@
+#include "map_versioner.h"
+
+using namespace ns_osm;
+
+/*================================================================*/
+/*                  Constructors, destructors                     */
+/*================================================================*/
+
+Map_Versioner::Map_Versioner() {
+	mp_map = nullptr;
+	f_stale = false;
+}
+
+Map_Versioner::~Map_Versioner() {}
+
+/*================================================================*/
+/*                       Private methods                          */
+/*================================================================*/
+
+/* The version goes on counting, so snapshots from before compare lower */
+void Map_Versioner::capture() {
+	quint64 version = m_current.m_version;
+
+	m_current = (mp_map != nullptr ? Map_Snapshot(*mp_map) : Map_Snapshot());
+	m_current.m_version = version + 1;
+	f_stale = false;
+}
+
+void Map_Versioner::update(Osm_Object& object) {
+	Osm_Node*		p_node;
+	Osm_Way*		p_way;
+	Osm_Relation*	p_rel;
+
+	if ((p_node = dynamic_cast<Osm_Node*>(&object)) != nullptr) {
+		m_current.m_nodes.insert(p_node->get_id(), Map_Snapshot::make_node(*p_node));
+	} else if ((p_way = dynamic_cast<Osm_Way*>(&object)) != nullptr) {
+		m_current.m_ways.insert(p_way->get_id(), Map_Snapshot::make_way(*p_way));
+	} else if ((p_rel = dynamic_cast<Osm_Relation*>(&object)) != nullptr) {
+		m_current.m_relations.insert(p_rel->get_id(), Map_Snapshot::make_relation(*p_rel));
+	} else {
+		return;
+	}
+	++m_current.m_version;
+}
+
+/* One version for the whole edit, however many elements it touched */
+void Map_Versioner::update(const Meta::Ids& ids) {
+	Osm_Node*		p_node;
+	Osm_Way*		p_way;
+	Osm_Relation*	p_rel;
+
+	if (ids.is_empty()) {
+		return;
+	}
+	for (auto it = ids.nodes.cbegin(); it != ids.nodes.cend(); ++it) {
+		if ((p_node = mp_map->get_node(*it)) != nullptr) {
+			m_current.m_nodes.insert(*it, Map_Snapshot::make_node(*p_node));
+		}
+	}
+	for (auto it = ids.ways.cbegin(); it != ids.ways.cend(); ++it) {
+		if ((p_way = mp_map->get_way(*it)) != nullptr) {
+			m_current.m_ways.insert(*it, Map_Snapshot::make_way(*p_way));
+		}
+	}
+	for (auto it = ids.relations.cbegin(); it != ids.relations.cend(); ++it) {
+		if ((p_rel = mp_map->get_relation(*it)) != nullptr) {
+			m_current.m_relations.insert(*it, Map_Snapshot::make_relation(*p_rel));
+		}
+	}
+	++m_current.m_version;
+}
+
+void Map_Versioner::remove(Osm_Object& object) {
+	Osm_Node*		p_node;
+	Osm_Way*		p_way;
+	Osm_Relation*	p_rel;
+
+	if ((p_node = dynamic_cast<Osm_Node*>(&object)) != nullptr) {
+		m_current.m_nodes.remove(p_node->get_id());
+	} else if ((p_way = dynamic_cast<Osm_Way*>(&object)) != nullptr) {
+		m_current.m_ways.remove(p_way->get_id());
+	} else if ((p_rel = dynamic_cast<Osm_Relation*>(&object)) != nullptr) {
+		m_current.m_relations.remove(p_rel->get_id());
+	} else {
+		return;
+	}
+	++m_current.m_version;
+}
+
+/*================================================================*/
+/*                      Protected methods                         */
+/*================================================================*/
+
+void Map_Versioner::handle_event_update(Osm_Object&) {
+	Osm_Object* p_subject = get_meta().get_subject();
+
+	switch (get_meta().get_event()) {
+	case MAP_NODE_ADDED:
+	case MAP_NODE_UPDATED:
+	case MAP_WAY_ADDED:
+	case MAP_WAY_UPDATED:
+	case MAP_RELATION_ADDED:
+	case MAP_RELATION_UPDATED:
+		if (f_stale || p_subject == nullptr) {
+			f_stale = true;
+			++m_current.m_version;
+		} else {
+			update(*p_subject);
+		}
+		break;
+	case MAP_TAGS_UPDATED:
+		if (f_stale) {
+			++m_current.m_version;
+		} else {
+			update(get_meta().get_ids());
+		}
+		break;
+	case MAP_NODE_REMOVED:
+	case MAP_WAY_REMOVED:
+	case MAP_RELATION_REMOVED:
+		if (f_stale || p_subject == nullptr) {
+			f_stale = true;
+			++m_current.m_version;
+		} else {
+			remove(*p_subject);
+		}
+		break;
+	case MAP_CLEARED:
+		m_current.m_nodes.clear();
+		m_current.m_ways.clear();
+		m_current.m_relations.clear();
+		++m_current.m_version;
+		break;
+	case MAP_RELOADED:
+		f_stale = true;
+		++m_current.m_version;
+		break;
+	default:
+		break;
+	}
+}
+
+void Map_Versioner::handle_event_delete(Osm_Object&) {
+	if (get_meta().get_event() == MAP_DELETED) {
+		mp_map = nullptr;
+		capture();
+	}
+}
+
+/*================================================================*/
+/*                        Public methods                          */
+/*================================================================*/
+
+void Map_Versioner::follow(Osm_Map& map) {
+	unfollow();
+	mp_map = &map;
+	subscribe(map);
+	capture();
+}
+
+void Map_Versioner::unfollow() {
+	unsubscribe();
+	mp_map = nullptr;
+	capture();
+}
+
+bool Map_Versioner::is_following() const {
+	return mp_map != nullptr;
+}
+
+/* The bound is not evented and cheap to read, so it is taken here */
+Map_Snapshot Map_Versioner::get_snapshot() {
+	if (f_stale) {
+		capture();
+	}
+	if (mp_map != nullptr) {
+		m_current.m_bound = mp_map->get_bound();
+	}
+	return m_current;
+}
+
+quint64 Map_Versioner::get_version() const {
+	return m_current.m_version;
+}
@@ -0,0 +1,50 @@
+#ifndef MAP_VERSIONER_H
+#define MAP_VERSIONER_H
+
+#ifndef QT_CORE_H
+#define QT_CORE_H
+#include <QtCore>
+#endif /* Include guard QT_CORE_H */
+
+#include "map_snapshot.h"
+
+namespace ns_osm {
+
+/* Hands out immutable snapshots of a map that keeps being edited. The
+ * versioner follows the map's events and applies each change to a
+ * snapshot of its own; get_snapshot() returns a copy of it, which shares
+ * everything. The next change then detaches only the part of the tables
+ * it lands in, so the price of a snapshot is proportional to the
+ * elements changed after it, not to the map.
+ *
+ * Snapshots are taken on the map's thread and read anywhere: validation,
+ * tile rendering, export and routing can run on one while editing goes
+ * on. */
+class Map_Versioner : public Osm_Subscriber {
+private:
+	Osm_Map*								mp_map;
+	Map_Snapshot							m_current;
+	bool									f_stale; /* Changes not tracked, recapture before handing out */
+
+	void									capture			();
+	void									update			(Osm_Object&);
+	void									update			(const Meta::Ids&);
+	void									remove			(Osm_Object&);
+protected:
+	void									handle_event_update	(Osm_Object&) override;
+	void									handle_event_delete	(Osm_Object&) override;
+public:
+	void									follow			(Osm_Map&);
+	void									unfollow		();
+	bool									is_following	() const;
+	Map_Snapshot							get_snapshot	();
+	quint64									get_version		() const;
+	                                        Map_Versioner	();
+											Map_Versioner	(const Map_Versioner&) = delete;
+	Map_Versioner&							operator=		(const Map_Versioner&) = delete;
+	virtual									~Map_Versioner	();
+};
+
+}
+
+#endif // MAP_VERSIONER_H
@@ -0,0 +1,147 @@
+#include "memory_usage.h"
+
+using namespace ns_osm;
+
+/*================================================================*/
+/*                  Constructors, destructors                     */
+/*================================================================*/
+
+Memory_Usage::Memory_Usage() {
+	for (int kind = 0; kind < KIND_COUNT; ++kind) {
+		mn_elements[kind] = 0;
+		for (int category = 0; category < CATEGORY_COUNT; ++category) {
+			m_bytes[kind][category] = 0;
+		}
+	}
+}
+
+/*================================================================*/
+/*                        Public methods                          */
+/*================================================================*/
+
+qint64 Memory_Usage::bytes_of(const QString& string) {
+	return string.capacity() > 0 ? sizeof(QArrayData) + (string.capacity() + 1) * sizeof(QChar) : 0;
+}
+
+qint64 Memory_Usage::bytes_of(const QMap<QString, QString>& map) {
+	qint64 n_bytes;
+
+	if (map.isEmpty()) {
+		return 0;
+	}
+	n_bytes = sizeof(QMapDataBase) + map.size() * sizeof(QMapNode<QString, QString>);
+	for (auto it = map.cbegin(); it != map.cend(); ++it) {
+		n_bytes += bytes_of(it.key()) + bytes_of(it.value());
+	}
+	return n_bytes;
+}
+
+QString Memory_Usage::kind_name(Kind kind) {
+	switch (kind) {
+	case NODE:			return "nodes";
+	case WAY:			return "ways";
+	case RELATION:		return "relations";
+	case MAP:			return "map";
+	case VIEW:			return "view";
+	case KIND_COUNT:	break;
+	}
+	return QString();
+}
+
+QString Memory_Usage::category_name(Category category) {
+	switch (category) {
+	case OBJECT:			return "object";
+	case ATTRIBUTES:		return "attributes";
+	case TAGS:				return "tags";
+	case SUBSCRIPTIONS:		return "subscriptions";
+	case META:				return "meta";
+	case MEMBERS:			return "members";
+	case INDEXES:			return "indexes";
+	case SCENE_ITEMS:		return "scene_items";
+	case TILES:				return "tiles";
+	case CATEGORY_COUNT:	break;
+	}
+	return QString();
+}
+
+void Memory_Usage::add(Kind kind, Category category, qint64 bytes) {
+	m_bytes[kind][category] += bytes;
+}
+
+void Memory_Usage::add_elements(Kind kind, qint64 n) {
+	mn_elements[kind] += n;
+}
+
+qint64 Memory_Usage::get_bytes(Kind kind, Category category) const {
+	return m_bytes[kind][category];
+}
+
+qint64 Memory_Usage::get_bytes(Kind kind) const {
+	qint64 n_bytes = 0;
+
+	for (int category = 0; category < CATEGORY_COUNT; ++category) {
+		n_bytes += m_bytes[kind][category];
+	}
+	return n_bytes;
+}
+
+qint64 Memory_Usage::get_bytes(Category category) const {
+	qint64 n_bytes = 0;
+
+	for (int kind = 0; kind < KIND_COUNT; ++kind) {
+		n_bytes += m_bytes[kind][category];
+	}
+	return n_bytes;
+}
+
+qint64 Memory_Usage::get_total() const {
+	qint64 n_bytes = 0;
+
+	for (int kind = 0; kind < KIND_COUNT; ++kind) {
+		n_bytes += get_bytes(static_cast<Kind>(kind));
+	}
+	return n_bytes;
+}
+
+qint64 Memory_Usage::count_elements(Kind kind) const {
+	return mn_elements[kind];
+}
+
+/* Kinds with nothing accounted are left out */
+QString Memory_Usage::to_text() const {
+	QString		text;
+	QTextStream	stream(&text);
+
+	stream << "kind\telements";
+	for (int category = 0; category < CATEGORY_COUNT; ++category) {
+		stream << "\t" << category_name(static_cast<Category>(category));
+	}
+	stream << "\ttotal\n";
+	for (int kind = 0; kind < KIND_COUNT; ++kind) {
+		if (get_bytes(static_cast<Kind>(kind)) == 0) {
+			continue;
+		}
+		stream << kind_name(static_cast<Kind>(kind)) << "\t" << mn_elements[kind];
+		for (int category = 0; category < CATEGORY_COUNT; ++category) {
+			stream << "\t" << m_bytes[kind][category];
+		}
+		stream << "\t" << get_bytes(static_cast<Kind>(kind)) << "\n";
+	}
+	stream << "total\t";
+	for (int category = 0; category < CATEGORY_COUNT; ++category) {
+		stream << "\t" << get_bytes(static_cast<Category>(category));
+	}
+	stream << "\t" << get_total() << "\n";
+	stream.flush();
+	return text;
+}
+
+Memory_Usage& Memory_Usage::operator+=(const Memory_Usage& other) {
+	for (int kind = 0; kind < KIND_COUNT; ++kind) {
+		mn_elements[kind] += other.mn_elements[kind];
+		for (int category = 0; category < CATEGORY_COUNT; ++category) {
+			m_bytes[kind][category] += other.m_bytes[kind][category];
+		}
+	}
+	return *this;
+}
@@ -0,0 +1,102 @@
+#ifndef MEMORY_USAGE_H
+#define MEMORY_USAGE_H
+
+#ifndef QT_CORE_H
+#define QT_CORE_H
+#include <QtCore>
+#endif /* Include guard QT_CORE_H */
+
+#include "id_hash.h"
+
+namespace ns_osm {
+
+/* Bytes held by the object graph, by element kind and category, as
+ * reported by Osm_Map::get_memory_usage and View_Handler::get_memory_usage.
+ * Container sizes are estimated from the Qt 5 layouts: header, capacity
+ * and one node per entry, without the allocator's rounding. A string
+ * shared between elements counts for each of them, as it will once they
+ * diverge; literals and empty strings count nothing. */
+class Memory_Usage {
+public:
+	enum Kind {NODE, WAY, RELATION, MAP, VIEW, KIND_COUNT};
+	enum Category {
+		OBJECT,			/* The C++ objects themselves */
+		ATTRIBUTES,
+		TAGS,
+		SUBSCRIPTIONS,	/* Subscriber, source and active lists */
+		META,			/* Subjects kept with the last event received */
+		MEMBERS,		/* Way nodes, relation members and roles */
+		INDEXES,		/* Id hashes, tag and spatial indexes */
+		SCENE_ITEMS,
+		TILES,
+		CATEGORY_COUNT
+	};
+private:
+	qint64									m_bytes[KIND_COUNT][CATEGORY_COUNT];
+	qint64									mn_elements[KIND_COUNT];
+public:
+	static qint64							bytes_of		(const QString&);
+	static qint64							bytes_of		(const QMap<QString, QString>&); /* With the strings */
+	template <typename T>
+	static qint64							bytes_of		(const QVector<T>&);
+	template <typename T>
+	static qint64							bytes_of		(const QList<T>&); /* Without what the items point to */
+	template <typename K, typename V>
+	static qint64							bytes_of		(const QHash<K, V>&);
+	template <typename T>
+	static qint64							bytes_of		(const QSet<T>&);
+	template <typename V>
+	static qint64							bytes_of		(const Id_Hash<V>&);
+	static QString							kind_name		(Kind);
+	static QString							category_name	(Category);
+	void									add				(Kind, Category, qint64 bytes);
+	void									add_elements	(Kind, qint64 n);
+	qint64									get_bytes		(Kind, Category) const;
+	qint64									get_bytes		(Kind) const;
+	qint64									get_bytes		(Category) const;
+	qint64									get_total		() const;
+	qint64									count_elements	(Kind) const;
+	QString									to_text			() const; /* Tab-separated bytes, a row per kind */
+	Memory_Usage&							operator+=		(const Memory_Usage&);
+	                                        Memory_Usage	();
+};
+
+template <typename T>
+qint64 Memory_Usage::bytes_of(const QVector<T>& vector) {
+	return vector.capacity() > 0 ? sizeof(QArrayData) + vector.capacity() * sizeof(T) : 0;
+}
+
+template <typename T>
+qint64 Memory_Usage::bytes_of(const QList<T>& list) {
+	qint64 n_bytes = list.isEmpty() ? 0 : sizeof(QListData::Data) + list.size() * sizeof(void*);
+
+	if (QTypeInfo<T>::isLarge || QTypeInfo<T>::isStatic) {
+		n_bytes += list.size() * sizeof(T);
+	}
+	return n_bytes;
+}
+
+template <typename K, typename V>
+qint64 Memory_Usage::bytes_of(const QHash<K, V>& hash) {
+	if (hash.capacity() == 0) {
+		return 0;
+	}
+	return sizeof(QHashData) + hash.capacity() * sizeof(void*) + hash.size() * sizeof(QHashNode<K, V>);
+}
+
+template <typename T>
+qint64 Memory_Usage::bytes_of(const QSet<T>& set) {
+	if (set.capacity() == 0) {
+		return 0;
+	}
+	return sizeof(QHashData) + set.capacity() * sizeof(void*) + set.size() * sizeof(QHashNode<T, QHashDummyValue>);
+}
+
+template <typename V>
+qint64 Memory_Usage::bytes_of(const Id_Hash<V>& hash) {
+	return hash.get_bytes();
+}
+
+}
+
+#endif // MEMORY_USAGE_H
@@ -12,6 +12,18 @@ Meta::Subj::Subj() {
 	p_object = nullptr;
 }
 
+/*================================================================*/
+/*                          Meta::Ids                             */
+/*================================================================*/
+
+bool Meta::Ids::is_empty() const {
+	return nodes.isEmpty() && ways.isEmpty() && relations.isEmpty();
+}
+
+int Meta::Ids::count() const {
+	return nodes.size() + ways.size() + relations.size();
+}
+
 /*================================================================*/
 /*           Constructors, destructors, arithm. ops.              */
 /*================================================================*/
@@ -30,18 +42,21 @@ Meta::Meta(const Meta& meta) {
 	m_event = meta.m_event;
 	mp_primary_subject = meta.mp_primary_subject;
 	m_additional_subjects = meta.m_additional_subjects;
+	mp_ids = meta.mp_ids;
 }
 
 Meta::Meta(Meta&& meta) {
 	m_event = meta.m_event;
 	mp_primary_subject = meta.mp_primary_subject;
 	m_additional_subjects = meta.m_additional_subjects;
+	mp_ids = meta.mp_ids;
 }
 
 Meta& Meta::operator=(const Meta& meta) {
 	m_event = meta.m_event;
 	mp_primary_subject = meta.mp_primary_subject;
 	m_additional_subjects = meta.m_additional_subjects;
+	mp_ids = meta.mp_ids;
 	return *this;
 }
 
@@ -49,6 +64,7 @@ Meta& Meta::operator=(Meta&& meta) {
 	m_event = meta.m_event;
 	mp_primary_subject = meta.mp_primary_subject;
 	m_additional_subjects = meta.m_additional_subjects;
+	mp_ids = meta.mp_ids;
 	return *this;
 }
 
@@ -138,6 +154,15 @@ Osm_Object* Meta::get_subject(Subject sub) const {
 	return m_additional_subjects[sub].p_object;
 }
 
+Meta& Meta::set_ids(const Ids& ids) {
+	mp_ids = QSharedPointer<const Ids>(new Ids(ids));
+	return *this;
+}
+
+Meta::Ids Meta::get_ids() const {
+	return mp_ids.isNull() ? Ids() : *mp_ids;
+}
+
 int Meta::get_pos(Subject sub) const {
 	return m_additional_subjects[sub].object_pos;
 }
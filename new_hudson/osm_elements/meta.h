@@ -38,8 +38,17 @@ enum Event {
 	MAP_NODE_ADDED,
 	MAP_NODE_UPDATED,
 	MAP_WAY_ADDED,
-	MAP_RELATION_ADDED
+	MAP_RELATION_ADDED,
+	MAP_TAGS_UPDATED,		/* Tags changed through the map, one event per edit of any size: get_ids() lists
+							 * the map's own elements touched; set_tags() also names its element as subject */
+	MAP_WAY_UPDATED,		/* Nodes of the subject way added or removed; a moved node is MAP_NODE_UPDATED only */
+	MAP_RELATION_UPDATED,	/* Members or roles of the subject relation changed */
+	MAP_NODE_REMOVED,		/* Subject still alive, already out of the map */
+	MAP_WAY_REMOVED,
+	MAP_RELATION_REMOVED,
+	MAP_RELOADED,			/* Every element replaced at once, rebuild from the map */
 	//MAP_SCENE_SHRINKED
+	MAP_EVENT_END			/* One past the last map event, not emitted */
 };
 
 /*================================================================*/
@@ -49,23 +58,28 @@ enum Event {
 class Osm_Object;
 
 class Meta {
+	friend class Osm_Map;
 public:
 	enum Subject {
 		SUBJECT_PRIMARY,
 		SUBJECT_BEFORE,
 		SUBJECT_AFTER
 	};
+	struct Ids;
 private:
 	struct Subj;
 	QMap<Subject, Subj>			m_additional_subjects;
 	Event						m_event;
 	Osm_Object*					mp_primary_subject;
+	QSharedPointer<const Ids>	mp_ids; /* Null unless set, copies share it */
 public:
 	bool						is_generic_event() const; /* As opposed to a concrete event */
 	Meta&						set_event		(Event);
 	Meta&						set_pos			(unsigned short subject_position, Subject);
 	Meta&						set_subject		(Osm_Object& subject, Subject = SUBJECT_PRIMARY);
 	Osm_Object*					get_subject		(Subject = SUBJECT_PRIMARY) const;
+	Meta&						set_ids			(const Ids&);
+	Ids							get_ids			() const; /* Empty unless set */
 	int							get_pos			(Subject) const;
 	Event						get_event		() const;
 	Event						get_event_group	() const;
@@ -92,6 +106,20 @@ struct Meta::Subj {
 	            Subj();
 };
 
+/*================================================================*/
+/*                          Meta::Ids                             */
+/*================================================================*/
+
+/* Elements an event is about, by kind, when there are more than a subject can name */
+struct Meta::Ids {
+	QVector<long long>	nodes;
+	QVector<long long>	ways;
+	QVector<long long>	relations;
+
+	bool				is_empty		() const;
+	int					count			() const;
+};
+
 } /* namespace */
 
 #endif // META_H
@@ -0,0 +1,212 @@
+#include "node_merger.h"
+#include "geo.h"
+
+using namespace ns_osm;
+
+/*================================================================*/
+/*                   Node_Merger::Range_Task                      */
+/*================================================================*/
+
+class Node_Merger::Range_Task : public QRunnable {
+	const std::function<void(int, int)>*	mp_work;
+	int										m_first;
+	int										m_last;
+public:
+	void									run			() override;
+	                                        Range_Task	(const std::function<void(int, int)>& work, int first, int last);
+};
+
+Node_Merger::Range_Task::Range_Task(const std::function<void(int, int)>& work, int first, int last) {
+	mp_work = &work;
+	m_first = first;
+	m_last = last;
+}
+
+void Node_Merger::Range_Task::run() {
+	(*mp_work)(m_first, m_last);
+}
+
+/*================================================================*/
+/*                        Static members                          */
+/*================================================================*/
+
+const double Node_Merger::DEFAULT_TOLERANCE = 0.05;
+/* Keeps cell coordinates within 32 bits */
+const double Node_Merger::MIN_TOLERANCE = 0.01;
+const double Node_Merger::METERS_PER_DEGREE = 111319.49;
+const int Node_Merger::CHUNK_SIZE = 16384;
+
+/*================================================================*/
+/*                  Constructors, destructors                     */
+/*================================================================*/
+
+Node_Merger::Node_Merger() {
+	m_tolerance = DEFAULT_TOLERANCE;
+}
+
+Node_Merger::~Node_Merger() {
+	m_pool.waitForDone();
+}
+
+/*================================================================*/
+/*                       Private methods                          */
+/*================================================================*/
+
+quint64 Node_Merger::get_key(int row, int col) {
+	return (static_cast<quint64>(static_cast<quint32>(row)) << 32) | static_cast<quint32>(col);
+}
+
+bool Node_Merger::is_survivor(const Osm_Node& node, const Osm_Node& other) {
+	if ((node.get_id() >= 0) != (other.get_id() >= 0)) {
+		return node.get_id() >= 0;
+	}
+	/* New elements count down from -1 */
+	return node.get_id() >= 0 ? node.get_id() < other.get_id() : node.get_id() > other.get_id();
+}
+
+/* Chunk i covers [i * CHUNK_SIZE, (i + 1) * CHUNK_SIZE), so work can index its output by chunk */
+void Node_Merger::for_chunks(int n_items, const std::function<void(int first, int last)>& work) const {
+	if (n_items <= CHUNK_SIZE) {
+		work(0, n_items);
+		return;
+	}
+	for (int first = 0; first < n_items; first += CHUNK_SIZE) {
+		m_pool.start(new Range_Task(work, first, qMin(n_items, first + CHUNK_SIZE)));
+	}
+	m_pool.waitForDone();
+}
+
+/*================================================================*/
+/*                        Public methods                          */
+/*================================================================*/
+
+void Node_Merger::set_tolerance(double meters) {
+	m_tolerance = qMax(MIN_TOLERANCE, meters);
+}
+
+double Node_Merger::get_tolerance() const {
+	return m_tolerance;
+}
+
+QVector<QVector<Osm_Node*>> Node_Merger::find(const Osm_Map& map) const {
+	QVector<Osm_Node*>					nodes;
+	QVector<double>						lats;
+	QVector<double>						lons;
+	QVector<quint64>					keys;
+	QVector<int>						order;
+	QHash<quint64, QPair<int, int>>		cells; /* Range in order */
+	QVector<QVector<QPair<int, int>>>	chunk_pairs;
+	QVector<QVector<int>>				neighbours;
+	QVector<int>						candidates; /* Nodes with neighbours, best survivor first */
+	QVector<bool>						f_taken;
+	QVector<QVector<Osm_Node*>>			groups;
+	double								max_lat = 0.0;
+	double								cell_lat;
+	double								cell_lon;
+
+	nodes.reserve(map.count_nodes());
+	lats.reserve(map.count_nodes());
+	lons.reserve(map.count_nodes());
+	for (auto it = map.cnbegin(); it != map.cnend(); ++it) {
+		nodes.push_back(*it);
+		lats.push_back((*it)->get_lat());
+		lons.push_back((*it)->get_lon());
+		max_lat = qMax(max_lat, qAbs((*it)->get_lat()));
+	}
+	if (nodes.size() < 2) {
+		return groups;
+	}
+	/* A cell is at least a tolerance wide everywhere in the map */
+	cell_lat = m_tolerance / METERS_PER_DEGREE;
+	cell_lon = cell_lat / qMax(0.01, std::cos(qMin(90.0, max_lat) * M_PI / 180.0));
+
+	keys.resize(nodes.size());
+	for_chunks(nodes.size(), [&](int first, int last) {
+		for (int i = first; i < last; ++i) {
+			keys[i] = get_key(qFloor(lats[i] / cell_lat), qFloor(lons[i] / cell_lon));
+		}
+	});
+	order.resize(nodes.size());
+	for (int i = 0; i < order.size(); ++i) {
+		order[i] = i;
+	}
+	std::sort(order.begin(), order.end(), [&keys](int first, int second) {
+		return keys[first] != keys[second] ? keys[first] < keys[second] : first < second;
+	});
+	for (int first = 0, last = 0; first < order.size(); first = last) {
+		while (last < order.size() && keys[order[last]] == keys[order[first]]) {
+			++last;
+		}
+		cells.insert(keys[order[first]], qMakePair(first, last));
+	}
+
+	chunk_pairs.resize((nodes.size() + CHUNK_SIZE - 1) / CHUNK_SIZE);
+	for_chunks(nodes.size(), [&](int first, int last) {
+		QVector<QPair<int, int>>& pairs = chunk_pairs[first / CHUNK_SIZE];
+		for (int i = first; i < last; ++i) {
+			int row = qFloor(lats[i] / cell_lat);
+			int col = qFloor(lons[i] / cell_lon);
+			for (int d_row = -1; d_row <= 1; ++d_row) {
+				for (int d_col = -1; d_col <= 1; ++d_col) {
+					auto it_cell = cells.constFind(get_key(row + d_row, col + d_col));
+					if (it_cell == cells.cend()) {
+						continue;
+					}
+					for (int k = it_cell->first; k < it_cell->second; ++k) {
+						int j = order[k];
+						if (j > i && Geo::haversine(lats[i], lons[i], lats[j], lons[j]) <= m_tolerance) {
+							pairs.push_back(qMakePair(i, j));
+						}
+					}
+				}
+			}
+		}
+	});
+
+	neighbours.resize(nodes.size());
+	for (auto it = chunk_pairs.cbegin(); it != chunk_pairs.cend(); ++it) {
+		for (auto it_pair = it->cbegin(); it_pair != it->cend(); ++it_pair) {
+			neighbours[it_pair->first].push_back(it_pair->second);
+			neighbours[it_pair->second].push_back(it_pair->first);
+		}
+	}
+	for (int i = 0; i < neighbours.size(); ++i) {
+		if (!neighbours[i].isEmpty()) {
+			candidates.push_back(i);
+		}
+	}
+	std::sort(candidates.begin(), candidates.end(), [&nodes](int first, int second) {
+		return is_survivor(*nodes[first], *nodes[second]);
+	});
+
+	/* Joining a survivor rather than a chain keeps every group within a tolerance of it */
+	f_taken.fill(false, nodes.size());
+	for (auto it = candidates.cbegin(); it != candidates.cend(); ++it) {
+		QVector<Osm_Node*> group;
+		if (f_taken[*it]) {
+			continue;
+		}
+		f_taken[*it] = true;
+		group.push_back(nodes[*it]);
+		for (auto it_near = neighbours[*it].cbegin(); it_near != neighbours[*it].cend(); ++it_near) {
+			if (!f_taken[*it_near]) {
+				f_taken[*it_near] = true;
+				group.push_back(nodes[*it_near]);
+			}
+		}
+		if (group.size() > 1) {
+			std::sort(group.begin() + 1, group.end(), [](const Osm_Node* p_first, const Osm_Node* p_second) {
+				return is_survivor(*p_first, *p_second);
+			});
+			groups.push_back(group);
+		}
+	}
+	std::sort(groups.begin(), groups.end(), [](const QVector<Osm_Node*>& first, const QVector<Osm_Node*>& second) {
+		return first.front()->get_id() < second.front()->get_id();
+	});
+	return groups;
+}
+
+int Node_Merger::merge(Osm_Map& map) const {
+	return map.merge_nodes(find(map));
+}
@@ -0,0 +1,55 @@
+#ifndef NODE_MERGER_H
+#define NODE_MERGER_H
+
+#ifndef QT_CORE_H
+#define QT_CORE_H
+#include <QtCore>
+#endif /* Include guard QT_CORE_H */
+
+#ifndef FUNCTIONAL_H
+#define FUNCTIONAL_H
+#include <functional>
+#endif /* Include guard FUNCTIONAL_H */
+
+#include "osm_map.h"
+
+namespace ns_osm {
+
+/* Finds nodes lying within a tolerance of each other and merges them.
+ * Coordinates are copied into flat arrays and hashed into cells one
+ * tolerance wide, so each node is compared only with the nodes of its
+ * own and the eight surrounding cells; hashing and comparing run on a
+ * thread pool.
+ *
+ * Survivors are picked greedily: the node with the lowest id already known
+ * to the server, or the oldest new node when none is, takes every free node
+ * within a tolerance of it, then the next free node does. No member lies
+ * further than a tolerance from its survivor, however nodes are chained. */
+class Node_Merger {
+private:
+	class Range_Task;
+
+	static const double						DEFAULT_TOLERANCE; /* Meters */
+	static const double						MIN_TOLERANCE;
+	static const double						METERS_PER_DEGREE;
+	static const int						CHUNK_SIZE;
+	double									m_tolerance;
+	mutable QThreadPool						m_pool;
+
+	static quint64							get_key			(int row, int col);
+	static bool								is_survivor		(const Osm_Node&, const Osm_Node& other); /* Over the other */
+	void									for_chunks		(int n_items, const std::function<void(int first, int last)>&) const;
+public:
+	void									set_tolerance	(double meters);
+	double									get_tolerance	() const;
+	QVector<QVector<Osm_Node*>>				find			(const Osm_Map&) const; /* Survivor first, ordered by survivor id */
+	int										merge			(Osm_Map&) const; /* Nodes removed */
+	                                        Node_Merger		();
+											Node_Merger		(const Node_Merger&) = delete;
+	Node_Merger&							operator=		(const Node_Merger&) = delete;
+	virtual									~Node_Merger	();
+};
+
+}
+
+#endif // NODE_MERGER_H
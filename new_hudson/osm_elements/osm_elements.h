@@ -6,5 +6,20 @@
 #include "osm_way.h"
 #include "osm_relation.h"
 #include "osm_map.h"
+#include "tag_index.h"
+#include "osm_query.h"
+#include "routing_graph.h"
+#include "validator.h"
+#include "validation_rules.h"
+#include "live_validator.h"
+#include "node_merger.h"
+#include "map_generator.h"
+#include "event_trace.h"
+#include "memory_usage.h"
+#include "map_snapshot.h"
+#include "map_versioner.h"
+#include "id_allocator.h"
+#include "id_hash.h"
+#include "geo.h"
 
 #endif // OSM_ELEMENTS_H
@@ -13,6 +13,11 @@ CONFIG += c++11 \
 
 DESTDIR = $$PWD/../intermediate_libs/
 
+# qmake CONFIG+=event_trace builds the Event_Trace hooks in
+event_trace {
+    DEFINES += OSM_EVENT_TRACE
+}
+
 SOURCES += \
         osm_object.cpp \
         osm_node.cpp \
@@ -21,7 +26,21 @@ SOURCES += \
     osm_map.cpp \
     osm_subscriber.cpp \
     osm_info.cpp \
-    meta.cpp
+    meta.cpp \
+    tag_index.cpp \
+    osm_query.cpp \
+    routing_graph.cpp \
+    validator.cpp \
+    validation_rules.cpp \
+    live_validator.cpp \
+    node_merger.cpp \
+    map_generator.cpp \
+    event_trace.cpp \
+    memory_usage.cpp \
+    map_snapshot.cpp \
+    map_versioner.cpp \
+    id_allocator.cpp \
+    geo.cpp
 
 HEADERS += \
         osm_elements.h \
@@ -32,4 +51,21 @@ HEADERS += \
     osm_map.h \
     osm_subscriber.h \
     osm_info.h \
-    meta.h
+    meta.h \
+    tag_index.h \
+    spatial_index.h \
+    osm_query.h \
+    routing_graph.h \
+    validator.h \
+    validation_rules.h \
+    live_validator.h \
+    node_merger.h \
+    map_generator.h \
+    event_trace.h \
+    memory_usage.h \
+    map_snapshot.h \
+    shared_table.h \
+    map_versioner.h \
+    id_allocator.h \
+    id_hash.h \
+    geo.h
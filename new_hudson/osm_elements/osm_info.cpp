@@ -2,45 +2,87 @@
 
 using namespace ns_osm;
 
-/*================================================================*/
-/*                        Static members                          */
-/*================================================================*/
-
-long long Osm_Info::s_osm_id_bound = -1;
-
 /*================================================================*/
 /*          Constructors, destructors, arithmetic ops.            */
 /*================================================================*/
 
-Osm_Info::Osm_Info() : OSM_ID(s_osm_id_bound--) {
-	m_attrmap[QString("id")] = QString::number(OSM_ID);
-}
+Osm_Info::Osm_Info() : Osm_Info(Id_Allocator::get_default()) {}
 
-Osm_Info::Osm_Info(const QString& id) : OSM_ID(id.toLongLong()) {
-	m_attrmap[QString("id")] = QString::number(OSM_ID);
-	if (s_osm_id_bound >= OSM_ID) {
-		s_osm_id_bound = OSM_ID - 1;
-	}
+Osm_Info::Osm_Info(Id_Allocator& allocator) : m_id(allocator.acquire()) {
+	mp_tag_index = nullptr;
+	m_index_kind = Tag_Index::NODE;
+	m_attrmap[QString("id")] = QString::number(m_id);
 }
 
-Osm_Info::Osm_Info(long long id) : OSM_ID(id) {
-	m_attrmap[QString("id")] = QString::number(OSM_ID);
-	if (s_osm_id_bound >= OSM_ID) {
-		s_osm_id_bound = OSM_ID - 1;
+/* Known ids are only kept clear of in the default allocator, for elements
+ * made without a map; a map reserves the ids of what it is given */
+Osm_Info::Osm_Info(const QString& id) : Osm_Info(id.toLongLong()) {}
+
+Osm_Info::Osm_Info(long long id) : m_id(id) {
+	mp_tag_index = nullptr;
+	m_index_kind = Tag_Index::NODE;
+	m_attrmap[QString("id")] = QString::number(m_id);
+	if (m_id < 0) {
+		Id_Allocator::get_default().reserve(m_id);
 	}
 }
 
-Osm_Info::Osm_Info(const Osm_Info& info) : OSM_ID(s_osm_id_bound--) {
+/* Not indexed until a map takes it */
+Osm_Info::Osm_Info(const Osm_Info& info) : m_id(info.m_id) {
 	m_tagmap = info.m_tagmap;
 	m_attrmap = info.m_attrmap;
+	mp_tag_index = nullptr;
+	m_index_kind = Tag_Index::NODE;
 }
 
 Osm_Info& Osm_Info::operator=(const Osm_Info& info) {
+	Tag_Index* p_index = mp_tag_index;
+
+	if (this == &info) {
+		return *this;
+	}
+	detach_tag_index();
 	m_tagmap = info.m_tagmap;
 	m_attrmap = info.m_attrmap;
+	attach_tag_index(p_index, m_index_kind);
 	return *this;
 }
 
+Osm_Info::~Osm_Info() {
+	detach_tag_index();
+}
+
+/*================================================================*/
+/*                       Private methods                          */
+/*================================================================*/
+
+void Osm_Info::set_id(long long id) {
+	m_id = id;
+	m_attrmap[QString("id")] = QString::number(m_id);
+}
+
+void Osm_Info::attach_tag_index(Tag_Index* p_index, Tag_Index::Kind kind) {
+	detach_tag_index();
+	mp_tag_index = p_index;
+	m_index_kind = kind;
+	if (mp_tag_index == nullptr) {
+		return;
+	}
+	for (auto it = m_tagmap.cbegin(); it != m_tagmap.cend(); ++it) {
+		mp_tag_index->insert(m_index_kind, m_id, it.key(), it.value());
+	}
+}
+
+void Osm_Info::detach_tag_index() {
+	if (mp_tag_index == nullptr) {
+		return;
+	}
+	for (auto it = m_tagmap.cbegin(); it != m_tagmap.cend(); ++it) {
+		mp_tag_index->remove(m_index_kind, m_id, it.key(), it.value());
+	}
+	mp_tag_index = nullptr;
+}
+
 /*================================================================*/
 /*                        Public methods                          */
 /*================================================================*/
@@ -62,10 +104,21 @@ const QMap<QString, QString>& Osm_Info::get_attr_map() const {
 }
 
 long long Osm_Info::get_id() const {
-	return OSM_ID;
+	return m_id;
 }
 
 void Osm_Info::set_tag(const QString &key, const QString &value) {
+	auto it = m_tagmap.find(key);
+
+	if (it != m_tagmap.end() && it.value() == value) {
+		return;
+	}
+	if (mp_tag_index != nullptr) {
+		if (it != m_tagmap.end()) {
+			mp_tag_index->remove(m_index_kind, m_id, key, it.value());
+		}
+		mp_tag_index->insert(m_index_kind, m_id, key, value);
+	}
 	m_tagmap[key] = value;
 }
 
@@ -76,9 +129,22 @@ void Osm_Info::set_attr(const QString &key, const QString &value) {
 }
 
 void Osm_Info::remove_tag(const QString &key) {
-	m_tagmap.remove(key);
+	auto it = m_tagmap.find(key);
+
+	if (it == m_tagmap.end()) {
+		return;
+	}
+	if (mp_tag_index != nullptr) {
+		mp_tag_index->remove(m_index_kind, m_id, key, it.value());
+	}
+	m_tagmap.erase(it);
 }
 
 void Osm_Info::clear_tags() {
+	if (mp_tag_index != nullptr) {
+		for (auto it = m_tagmap.cbegin(); it != m_tagmap.cend(); ++it) {
+			mp_tag_index->remove(m_index_kind, m_id, it.key(), it.value());
+		}
+	}
 	m_tagmap.clear();
 }
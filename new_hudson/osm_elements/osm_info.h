@@ -6,13 +6,22 @@
 #include <QtCore>
 #endif /* Include guard QT_CORE_H */
 
+#include "tag_index.h"
+#include "id_allocator.h"
+
 namespace ns_osm {
 
 class Osm_Info{
+	friend class Osm_Map;
 	QMap<QString, QString>			m_attrmap;
 	QMap<QString, QString>			m_tagmap;
-	const long long					OSM_ID;
-	static long long				s_osm_id_bound;
+	long long						m_id;
+	Tag_Index*						mp_tag_index; /* Set while the element is held by a map */
+	Tag_Index::Kind					m_index_kind;
+
+	void							attach_tag_index(Tag_Index*, Tag_Index::Kind);
+	void							detach_tag_index();
+	void							set_id			(long long); /* Before a map takes it only */
 public:
 	QString							get_attr_value	(const QString& key) const;
 	QString							get_tag_value	(const QString& key) const;
@@ -23,12 +32,13 @@ public:
 	void							set_attr		(const QString& key, const QString& value);
 	void							remove_tag		(const QString& key);
 	void							clear_tags		();
-	                                Osm_Info		();
+	                                Osm_Info		(); /* New id from Id_Allocator::get_default() */
+									Osm_Info		(Id_Allocator&); /* New id, usually from the map's */
 									Osm_Info		(const QString& id);
 									Osm_Info		(long long id);
-									Osm_Info		(const Osm_Info&);
+									Osm_Info		(const Osm_Info&); /* Same element, same id */
 	Osm_Info&						operator=		(const Osm_Info&);
-	virtual							~Osm_Info		() = default;
+	virtual							~Osm_Info		();
 };
 
 }
@@ -10,6 +10,7 @@ Osm_Map::Osm_Map() {
 	f_destruct_physically = true;
 	f_remove_orphaned_nodes = true;
 	f_remove_one_node_ways = true;
+	mn_freezes.store(0);
 }
 
 Osm_Map::~Osm_Map() {
@@ -31,6 +32,8 @@ void Osm_Map::handle_event_update(Osm_Node& node) {
 }
 
 void Osm_Map::handle_event_update(Osm_Way& way) {
+	const long long ID = way.get_id();
+
 	switch (get_meta()) {
 	case NODE_ADDED:
 		if (get_meta().get_subject() != nullptr) {
@@ -64,6 +67,13 @@ void Osm_Map::handle_event_update(Osm_Way& way) {
 			//stop_broadcast();
 		}
 		break;
+	default:
+		/* A node of it moved: MAP_NODE_UPDATED tells, the node list is as it was */
+		return;
+	}
+	/* The way is gone if it shrank to one node */
+	if (m_ways_hash.value(ID) == &way) {
+		emit_update(Meta(MAP_WAY_UPDATED).set_subject(way));
 	}
 }
 
@@ -111,11 +121,20 @@ void Osm_Map::handle_event_update(Osm_Relation& relation) {
 				break;
 			}
 		}
+		break;
+	case NODE_UPDATED:
+	case WAY_UPDATED:
+	case RELATION_UPDATED:
+		/* A member changed, not the member list; the member's own event tells */
+		return;
 	}
+	emit_update(Meta(MAP_RELATION_UPDATED).set_subject(relation));
 }
 
 void Osm_Map::handle_event_delete(Osm_Node& node) {
 	m_nodes_hash.remove(node.get_id());
+	unindex(node);
+	emit_update(Meta(MAP_NODE_REMOVED).set_subject(node));
 }
 
 void Osm_Map::handle_event_delete(Osm_Way& way) {
@@ -123,6 +142,8 @@ void Osm_Map::handle_event_delete(Osm_Way& way) {
 	QList<Osm_Node*> l_nodes_to_delete;
 
 	m_ways_hash.remove(way.get_id());
+	unindex(way);
+	emit_update(Meta(MAP_WAY_REMOVED).set_subject(way));
 	if (!f_remove_orphaned_nodes) {
 		return;
 	}
@@ -141,6 +162,161 @@ void Osm_Map::handle_event_delete(Osm_Way& way) {
 
 void Osm_Map::handle_event_delete(Osm_Relation& rel) {
 	m_relations_hash.remove(rel.get_id());
+	unindex(rel);
+	emit_update(Meta(MAP_RELATION_REMOVED).set_subject(rel));
+}
+
+void Osm_Map::unindex(Osm_Info& info) {
+	if (info.mp_tag_index == &m_tag_index) {
+		info.detach_tag_index();
+	}
+}
+
+/* A negative id held twice came from two allocators, the default one and this
+ * map's say; the newcomer takes a fresh id of the map's. A server id is the
+ * element's identity, so a second element with it is refused */
+bool Osm_Map::claim_id(Osm_Info& info) {
+	if (info.get_id() >= 0) {
+		return false;
+	}
+	info.detach_tag_index();
+	info.set_id(m_id_allocator.acquire());
+	return true;
+}
+
+template <typename T>
+QList<T*> Osm_Map::find_elements(const Id_Hash<T*>& hash, Tag_Index::Kind kind,
+                                 const QString& key, const QString& value) const {
+	const QVector<long long>&	ids = (value.isNull() ? m_tag_index.find(kind, key) : m_tag_index.find(kind, key, value));
+	QList<T*>					elements;
+
+	elements.reserve(ids.size());
+	for (auto it = ids.cbegin(); it != ids.cend(); ++it) {
+		T* p_element = hash.value(*it, nullptr);
+		if (p_element != nullptr) {
+			elements.push_back(p_element);
+		}
+	}
+	return elements;
+}
+
+Osm_Object* Osm_Map::find_object(Osm_Info& info) const {
+	Osm_Node*		p_node;
+	Osm_Way*		p_way;
+	Osm_Relation*	p_rel;
+
+	if (info.mp_tag_index != &m_tag_index) {
+		return nullptr;
+	}
+	/* An element of the same id that isn't this one gets no event */
+	switch (info.m_index_kind) {
+	case Tag_Index::NODE:
+		p_node = m_nodes_hash.value(info.get_id(), nullptr);
+		return p_node == &info ? p_node : nullptr;
+	case Tag_Index::WAY:
+		p_way = m_ways_hash.value(info.get_id(), nullptr);
+		return p_way == &info ? p_way : nullptr;
+	case Tag_Index::RELATION:
+		p_rel = m_relations_hash.value(info.get_id(), nullptr);
+		return p_rel == &info ? p_rel : nullptr;
+	default:
+		return nullptr;
+	}
+}
+
+/* After the batch is merged, so subscribers looking up the index see the edits */
+void Osm_Map::emit_tags_updated(const QList<Osm_Info*>& changed, Osm_Object* p_subject) {
+	Meta		meta(MAP_TAGS_UPDATED);
+	Meta::Ids	ids;
+
+	for (auto it = changed.cbegin(); it != changed.cend(); ++it) {
+		if (find_object(**it) == nullptr) {
+			continue;
+		}
+		switch ((*it)->m_index_kind) {
+		case Tag_Index::NODE:
+			ids.nodes.push_back((*it)->get_id());
+			break;
+		case Tag_Index::WAY:
+			ids.ways.push_back((*it)->get_id());
+			break;
+		case Tag_Index::RELATION:
+			ids.relations.push_back((*it)->get_id());
+			break;
+		default:
+			break;
+		}
+	}
+	if (p_subject != nullptr) {
+		meta.set_subject(*p_subject);
+	} else if (ids.is_empty()) {
+		return;
+	}
+	emit_update(meta.set_ids(ids));
+}
+
+bool Osm_Map::write_tags(Osm_Info& info, const QMap<QString, QString>& tags, const QStringList& removed_keys) {
+	bool f_changed = false;
+
+	for (auto it = removed_keys.cbegin(); it != removed_keys.cend(); ++it) {
+		if (info.get_tag_map().contains(*it)) {
+			info.remove_tag(*it);
+			f_changed = true;
+		}
+	}
+	for (auto it = tags.cbegin(); it != tags.cend(); ++it) {
+		auto it_tag = info.get_tag_map().constFind(it.key());
+		if (!it.key().isEmpty() && (it_tag == info.get_tag_map().cend() || it_tag.value() != it.value())) {
+			info.set_tag(it.key(), it.value());
+			f_changed = true;
+		}
+	}
+	return f_changed;
+}
+
+void Osm_Map::add_object_usage(Memory_Usage& usage, Memory_Usage::Kind kind, const Osm_Object& object) {
+	usage.add(kind, Memory_Usage::SUBSCRIPTIONS,
+	          Memory_Usage::bytes_of(object.m_subscribers) + Memory_Usage::bytes_of(object.m_active_stack));
+}
+
+void Osm_Map::add_subscriber_usage(Memory_Usage& usage, Memory_Usage::Kind kind, const Osm_Subscriber& subscriber) {
+	const QMap<Meta::Subject, Meta::Subj>& subjects = subscriber.m_meta.m_additional_subjects;
+
+	usage.add(kind, Memory_Usage::SUBSCRIPTIONS, Memory_Usage::bytes_of(subscriber.m_sources));
+	if (!subjects.isEmpty()) {
+		usage.add(kind, Memory_Usage::META,
+		          sizeof(QMapDataBase) + subjects.size() * sizeof(QMapNode<Meta::Subject, Meta::Subj>));
+	}
+}
+
+void Osm_Map::add_info_usage(Memory_Usage& usage, Memory_Usage::Kind kind, const Osm_Info& info) {
+	usage.add(kind, Memory_Usage::ATTRIBUTES, Memory_Usage::bytes_of(info.m_attrmap));
+	usage.add(kind, Memory_Usage::TAGS, Memory_Usage::bytes_of(info.m_tagmap));
+}
+
+qint64 Osm_Map::get_usage(const Id_Set& ids) {
+	return Memory_Usage::bytes_of(ids.m_ids) + Memory_Usage::bytes_of(ids.m_pending);
+}
+
+qint64 Osm_Map::get_usage(const Tag_Index& index) {
+	qint64 n_bytes = Memory_Usage::bytes_of(index.m_by_key) + Memory_Usage::bytes_of(index.m_by_tag);
+
+	for (auto it = index.m_by_key.cbegin(); it != index.m_by_key.cend(); ++it) {
+		n_bytes += Memory_Usage::bytes_of(it.key());
+		for (int kind = 0; kind < Tag_Index::KIND_COUNT; ++kind) {
+			n_bytes += get_usage(it->ids[kind]);
+		}
+	}
+	for (auto it = index.m_by_tag.cbegin(); it != index.m_by_tag.cend(); ++it) {
+		n_bytes += Memory_Usage::bytes_of(it.key()) + Memory_Usage::bytes_of(it.value());
+		for (auto it_value = it->cbegin(); it_value != it->cend(); ++it_value) {
+			n_bytes += Memory_Usage::bytes_of(it_value.key());
+			for (int kind = 0; kind < Tag_Index::KIND_COUNT; ++kind) {
+				n_bytes += get_usage(it_value->ids[kind]);
+			}
+		}
+	}
+	return n_bytes;
 }
 
 
@@ -168,6 +344,18 @@ int Osm_Map::count_parents() const {
 	return mn_parents;
 }
 
+int Osm_Map::count_nodes() const {
+	return m_nodes_hash.size();
+}
+
+int Osm_Map::count_ways() const {
+	return m_ways_hash.size();
+}
+
+int Osm_Map::count_relations() const {
+	return m_relations_hash.size();
+}
+
 void Osm_Map::adopt() {
 	mn_parents++;
 }
@@ -177,8 +365,9 @@ void Osm_Map::orphan() {
 }
 
 void Osm_Map::add(Osm_Node* p_node) {
-	if (p_node != nullptr) {
-		if (has(p_node)) {
+	if (p_node != nullptr && !is_frozen()) {
+		Osm_Node* p_held = m_nodes_hash.value(p_node->get_id(), nullptr);
+		if (p_held == p_node || (p_held != nullptr && !claim_id(*p_node))) {
 			return;
 		}
 		if (!(p_node->is_valid())) {
@@ -186,36 +375,45 @@ void Osm_Map::add(Osm_Node* p_node) {
 		}
 
 		m_nodes_hash[p_node->get_id()] = p_node;
+		m_id_allocator.reserve(p_node->get_id());
+		p_node->attach_tag_index(&m_tag_index, Tag_Index::NODE);
 		subscribe(*p_node);
 		emit_update(Meta(MAP_NODE_ADDED).set_subject(*p_node));
 	}
 }
 
 void Osm_Map::add(Osm_Way* p_way) {
-	if (p_way != nullptr) {
-		if (has(p_way)) {
+	if (p_way != nullptr && !is_frozen()) {
+		Osm_Way* p_held = m_ways_hash.value(p_way->get_id(), nullptr);
+		if (p_held == p_way || (p_held != nullptr && !claim_id(*p_way))) {
 			return;
 		}
 		if (!(p_way->is_valid())) {
 			set_valid(false);
 		}
+		m_tag_index.begin_batch();
 		for (auto it = p_way->get_nodes_list().cbegin(); it != p_way->get_nodes_list().cend(); ++it) {
 			add(const_cast<Osm_Node*>(*it));
 		}
+		m_tag_index.end_batch();
 		m_ways_hash[p_way->get_id()] = p_way;
+		m_id_allocator.reserve(p_way->get_id());
+		p_way->attach_tag_index(&m_tag_index, Tag_Index::WAY);
 		subscribe(*p_way);
 		emit_update(Meta(MAP_WAY_ADDED).set_subject(*p_way));
 	}
 }
 
 void Osm_Map::add(Osm_Relation* p_rel) {
-	if (p_rel != nullptr) {
-		if (has(p_rel)) {
+	if (p_rel != nullptr && !is_frozen()) {
+		Osm_Relation* p_held = m_relations_hash.value(p_rel->get_id(), nullptr);
+		if (p_held == p_rel || (p_held != nullptr && !claim_id(*p_rel))) {
 			return;
 		}
 		if (!(p_rel->is_valid())) {
 			set_valid(false);
 		}
+		m_tag_index.begin_batch();
 		for (auto it = p_rel->get_nodes().cbegin(); it != p_rel->get_nodes().cend(); ++it) {
 			add(const_cast<Osm_Node*>(*it));
 		}
@@ -225,7 +423,10 @@ void Osm_Map::add(Osm_Relation* p_rel) {
 		for (auto it = p_rel->get_relations().cbegin(); it != p_rel->get_relations().cend(); ++it) {
 			add(const_cast<Osm_Relation*>(*it));
 		}
+		m_tag_index.end_batch();
 		m_relations_hash[p_rel->get_id()] = p_rel;
+		m_id_allocator.reserve(p_rel->get_id());
+		p_rel->attach_tag_index(&m_tag_index, Tag_Index::RELATION);
 		subscribe(*p_rel);
 		emit_update(Meta(MAP_RELATION_ADDED).set_subject(*p_rel));
 	}
@@ -235,7 +436,7 @@ bool Osm_Map::has(Osm_Node* p_node) const {
 	if (p_node == nullptr) {
 		return false;
 	}
-	return m_nodes_hash.contains(p_node->get_id());
+	return m_nodes_hash.value(p_node->get_id(), nullptr) == p_node;
 }
 
 bool Osm_Map::has(Osm_Way* p_way) const {
@@ -243,7 +444,7 @@ bool Osm_Map::has(Osm_Way* p_way) const {
 		return false;
 	}
 
-	return m_ways_hash.contains(p_way->get_id());
+	return m_ways_hash.value(p_way->get_id(), nullptr) == p_way;
 }
 
 bool Osm_Map::has(Osm_Relation* p_rel) const {
@@ -251,15 +452,19 @@ bool Osm_Map::has(Osm_Relation* p_rel) const {
 		return false;
 	}
 
-	return m_relations_hash.contains(p_rel->get_id());
+	return m_relations_hash.value(p_rel->get_id(), nullptr) == p_rel;
 }
 
 void Osm_Map::remove(Osm_Node* p_node) {
-	if (p_node == nullptr) {
+	if (p_node == nullptr || is_frozen()) {
 		return;
 	}
-	m_nodes_hash.remove(p_node->get_id());
+	if (m_nodes_hash.value(p_node->get_id(), nullptr) == p_node) {
+		m_nodes_hash.remove(p_node->get_id());
+	}
+	unindex(*p_node);
 	unsubscribe(*p_node);
+	emit_update(Meta(MAP_NODE_REMOVED).set_subject(*p_node));
 	if (f_destruct_physically) {
 		delete p_node;
 	} else {
@@ -268,11 +473,15 @@ void Osm_Map::remove(Osm_Node* p_node) {
 }
 
 void Osm_Map::remove(Osm_Way* p_way) {
-	if (p_way == nullptr) {
+	if (p_way == nullptr || is_frozen()) {
 		return;
 	}
-	m_ways_hash.remove(p_way->get_id());
+	if (m_ways_hash.value(p_way->get_id(), nullptr) == p_way) {
+		m_ways_hash.remove(p_way->get_id());
+	}
+	unindex(*p_way);
 	unsubscribe(*p_way);
+	emit_update(Meta(MAP_WAY_REMOVED).set_subject(*p_way));
 	if (f_destruct_physically) {
 		delete p_way;
 	} else {
@@ -281,11 +490,15 @@ void Osm_Map::remove(Osm_Way* p_way) {
 }
 
 void Osm_Map::remove(Osm_Relation* p_rel) {
-	if (p_rel == nullptr) {
+	if (p_rel == nullptr || is_frozen()) {
 		return;
 	}
-	m_relations_hash.remove(p_rel->get_id());
+	if (m_relations_hash.value(p_rel->get_id(), nullptr) == p_rel) {
+		m_relations_hash.remove(p_rel->get_id());
+	}
+	unindex(*p_rel);
 	unsubscribe(*p_rel);
+	emit_update(Meta(MAP_RELATION_REMOVED).set_subject(*p_rel));
 	if (f_destruct_physically) {
 		delete p_rel;
 	} else {
@@ -293,20 +506,35 @@ void Osm_Map::remove(Osm_Relation* p_rel) {
 	}
 }
 
+/* A removal may take other elements along, hence the lookups by id */
 void Osm_Map::clear() {
-	node_iterator it_node;
-	way_iterator it_way;
-	relation_iterator it_rel;
+	QList<long long>	relation_ids = m_relations_hash.keys();
+	QList<long long>	way_ids = m_ways_hash.keys();
+	QList<long long>	node_ids = m_nodes_hash.keys();
 
+	if (is_frozen()) {
+		return;
+	}
 	unsubscribe();
-	while ((it_rel = rbegin()) != rend()) {
-		remove(*it_rel);
+	/* Dropped wholesale rather than id by id */
+	m_tag_index.clear();
+	for (auto it = m_nodes_hash.begin(); it != m_nodes_hash.end(); ++it) {
+		it.value()->mp_tag_index = nullptr;
 	}
-	while ((it_way = wbegin()) != wend()) {
-		remove(*it_way);
+	for (auto it = m_ways_hash.begin(); it != m_ways_hash.end(); ++it) {
+		it.value()->mp_tag_index = nullptr;
 	}
-	while ((it_node = nbegin()) != nend()) {
-		remove(*it_node);
+	for (auto it = m_relations_hash.begin(); it != m_relations_hash.end(); ++it) {
+		it.value()->mp_tag_index = nullptr;
+	}
+	for (auto it = relation_ids.cbegin(); it != relation_ids.cend(); ++it) {
+		remove(m_relations_hash.value(*it, nullptr));
+	}
+	for (auto it = way_ids.cbegin(); it != way_ids.cend(); ++it) {
+		remove(m_ways_hash.value(*it, nullptr));
+	}
+	for (auto it = node_ids.cbegin(); it != node_ids.cend(); ++it) {
+		remove(m_nodes_hash.value(*it, nullptr));
 	}
 	m_nodes_hash.clear();
 	m_ways_hash.clear();
@@ -314,10 +542,304 @@ void Osm_Map::clear() {
 	emit_update(MAP_CLEARED);
 }
 
+void Osm_Map::take(Osm_Map& source) {
+	if (&source == this || is_frozen() || source.is_frozen()) {
+		return;
+	}
+	clear();
+	m_nodes_hash.swap(source.m_nodes_hash);
+	m_ways_hash.swap(source.m_ways_hash);
+	m_relations_hash.swap(source.m_relations_hash);
+	m_tag_index.swap(source.m_tag_index);
+	/* Subscriptions and index pointers move over without a lookup or an event each */
+	for (auto it = source.m_sources.cbegin(); it != source.m_sources.cend(); ++it) {
+		(*it)->remove_subscriber(source);
+		(*it)->add_subscriber(*this);
+	}
+	m_sources.swap(source.m_sources);
+	for (auto it = m_nodes_hash.begin(); it != m_nodes_hash.end(); ++it) {
+		it.value()->mp_tag_index = &m_tag_index;
+	}
+	for (auto it = m_ways_hash.begin(); it != m_ways_hash.end(); ++it) {
+		it.value()->mp_tag_index = &m_tag_index;
+	}
+	for (auto it = m_relations_hash.begin(); it != m_relations_hash.end(); ++it) {
+		it.value()->mp_tag_index = &m_tag_index;
+	}
+	m_id_allocator.reserve(source.m_id_allocator.get_next() + 1);
+	if (!source.is_valid()) {
+		set_valid(false);
+	}
+	set_bound(source.get_bound());
+	source.emit_update(MAP_CLEARED);
+	emit_update(MAP_RELOADED);
+}
+
+int Osm_Map::merge_nodes(const QVector<QVector<Osm_Node*>>& groups) {
+	QHash<Osm_Node*, Osm_Node*>	replacements;
+	QList<Osm_Way*>				ways;
+	QList<Osm_Relation*>		relations;
+	QList<Osm_Info*>			retagged; /* Survivors */
+	QList<Osm_Way*>				shrunk; /* Down to one node */
+
+	if (is_frozen()) {
+		return 0;
+	}
+	m_tag_index.begin_batch();
+	for (auto it = groups.cbegin(); it != groups.cend(); ++it) {
+		Osm_Node* p_survivor = it->isEmpty() ? nullptr : it->front();
+		if (!has(p_survivor)) {
+			continue;
+		}
+		for (auto it_node = it->cbegin() + 1; it_node != it->cend(); ++it_node) {
+			if (*it_node == p_survivor || !has(*it_node)) {
+				continue;
+			}
+			replacements.insert(*it_node, p_survivor);
+			for (auto it_tag = (*it_node)->get_tag_map().cbegin(); it_tag != (*it_node)->get_tag_map().cend(); ++it_tag) {
+				if (!p_survivor->get_tag_map().contains(it_tag.key())) {
+					p_survivor->set_tag(it_tag.key(), it_tag.value());
+					if (retagged.isEmpty() || retagged.back() != p_survivor) {
+						retagged.push_back(p_survivor);
+					}
+				}
+			}
+		}
+	}
+	m_tag_index.end_batch();
+	if (replacements.isEmpty()) {
+		return 0;
+	}
+
+	/* Collected before rewiring, whose events may reach code that edits the map */
+	for (auto it = m_ways_hash.cbegin(); it != m_ways_hash.cend(); ++it) {
+		for (auto it_node = (*it)->get_nodes_list().cbegin(); it_node != (*it)->get_nodes_list().cend(); ++it_node) {
+			if (replacements.contains(*it_node)) {
+				ways.push_back(*it);
+				break;
+			}
+		}
+	}
+	for (auto it = m_relations_hash.cbegin(); it != m_relations_hash.cend(); ++it) {
+		for (auto it_node = (*it)->get_nodes().cbegin(); it_node != (*it)->get_nodes().cend(); ++it_node) {
+			if (replacements.contains(*it_node)) {
+				relations.push_back(*it);
+				break;
+			}
+		}
+	}
+
+	for (auto it = ways.cbegin(); it != ways.cend(); ++it) {
+		if (!has(*it)) {
+			continue;
+		}
+		(*it)->replace_nodes(replacements);
+		if ((*it)->get_size() < 2) {
+			shrunk.push_back(*it);
+		}
+	}
+	for (auto it = relations.cbegin(); it != relations.cend(); ++it) {
+		if (!has(*it)) {
+			continue;
+		}
+		const QList<Osm_Node*> members = (*it)->get_nodes();
+		for (auto it_node = members.cbegin(); it_node != members.cend(); ++it_node) {
+			if (replacements.contains(*it_node)) {
+				(*it)->replace(*it_node, replacements.value(*it_node));
+			}
+		}
+	}
+	for (auto it = replacements.cbegin(); it != replacements.cend(); ++it) {
+		if (has(it.key())) {
+			remove(it.key());
+		}
+	}
+	/* Merging the ends of a short way leaves a way of one node, which a lost node would have removed too */
+	for (auto it = shrunk.cbegin(); it != shrunk.cend() && f_remove_one_node_ways; ++it) {
+		if (has(*it)) {
+			remove(*it);
+		}
+	}
+	emit_tags_updated(retagged);
+	return replacements.size();
+}
+
+bool Osm_Map::set_tags(Osm_Node& node, const QMap<QString, QString>& tags, const QStringList& removed_keys) {
+	if (is_frozen() || !write_tags(node, tags, removed_keys)) {
+		return false;
+	}
+	emit_tags_updated(QList<Osm_Info*>() << &node, &node);
+	return true;
+}
+
+bool Osm_Map::set_tags(Osm_Way& way, const QMap<QString, QString>& tags, const QStringList& removed_keys) {
+	if (is_frozen() || !write_tags(way, tags, removed_keys)) {
+		return false;
+	}
+	emit_tags_updated(QList<Osm_Info*>() << &way, &way);
+	return true;
+}
+
+bool Osm_Map::set_tags(Osm_Relation& rel, const QMap<QString, QString>& tags, const QStringList& removed_keys) {
+	if (is_frozen() || !write_tags(rel, tags, removed_keys)) {
+		return false;
+	}
+	emit_tags_updated(QList<Osm_Info*>() << &rel, &rel);
+	return true;
+}
+
+void Osm_Map::set_tag(const QList<Osm_Info*>& elements, const QString& key, const QString& value) {
+	QList<Osm_Info*> changed;
+
+	if (key.isEmpty() || is_frozen()) {
+		return;
+	}
+	m_tag_index.begin_batch();
+	for (auto it = elements.cbegin(); it != elements.cend(); ++it) {
+		auto it_tag = (*it)->get_tag_map().constFind(key);
+		if (it_tag != (*it)->get_tag_map().cend() && it_tag.value() == value) {
+			continue;
+		}
+		(*it)->set_tag(key, value);
+		changed.push_back(*it);
+	}
+	m_tag_index.end_batch();
+	emit_tags_updated(changed);
+}
+
+void Osm_Map::remove_tag(const QList<Osm_Info*>& elements, const QString& key) {
+	QList<Osm_Info*> changed;
+
+	if (is_frozen()) {
+		return;
+	}
+	m_tag_index.begin_batch();
+	for (auto it = elements.cbegin(); it != elements.cend(); ++it) {
+		if (!(*it)->get_tag_map().contains(key)) {
+			continue;
+		}
+		(*it)->remove_tag(key);
+		changed.push_back(*it);
+	}
+	m_tag_index.end_batch();
+	emit_tags_updated(changed);
+}
+
+int Osm_Map::rename_tag(const QList<Osm_Info*>& elements, const QString& old_key, const QString& new_key) {
+	QList<Osm_Info*>	changed;
+	int					n_conflicts = 0;
+
+	if (old_key == new_key || new_key.isEmpty() || is_frozen()) {
+		return 0;
+	}
+	m_tag_index.begin_batch();
+	for (auto it = elements.cbegin(); it != elements.cend(); ++it) {
+		auto it_tag = (*it)->get_tag_map().constFind(old_key);
+		if (it_tag == (*it)->get_tag_map().cend()) {
+			continue;
+		}
+		if ((*it)->get_tag_map().contains(new_key)) {
+			n_conflicts++;
+			continue;
+		}
+		QString value = it_tag.value();
+		(*it)->remove_tag(old_key);
+		(*it)->set_tag(new_key, value);
+		changed.push_back(*it);
+	}
+	m_tag_index.end_batch();
+	emit_tags_updated(changed);
+	return n_conflicts;
+}
+
 QRectF Osm_Map::get_bound() const {
 	return m_bounding_rect;
 }
 
+void Osm_Map::freeze() const {
+	mn_freezes.ref();
+}
+
+void Osm_Map::thaw() const {
+	mn_freezes.deref();
+}
+
+bool Osm_Map::is_frozen() const {
+	return mn_freezes.load() > 0;
+}
+
+void Osm_Map::begin_batch() {
+	m_tag_index.begin_batch();
+}
+
+void Osm_Map::end_batch() {
+	m_tag_index.end_batch();
+}
+
+const Tag_Index& Osm_Map::get_tag_index() const {
+	return m_tag_index;
+}
+
+Id_Allocator& Osm_Map::get_id_allocator() {
+	return m_id_allocator;
+}
+
+Memory_Usage Osm_Map::get_memory_usage() const {
+	Memory_Usage usage;
+
+	usage.add_elements(Memory_Usage::NODE, m_nodes_hash.size());
+	for (auto it = m_nodes_hash.cbegin(); it != m_nodes_hash.cend(); ++it) {
+		usage.add(Memory_Usage::NODE, Memory_Usage::OBJECT, sizeof(Osm_Node));
+		add_object_usage(usage, Memory_Usage::NODE, **it);
+		add_info_usage(usage, Memory_Usage::NODE, **it);
+	}
+	usage.add_elements(Memory_Usage::WAY, m_ways_hash.size());
+	for (auto it = m_ways_hash.cbegin(); it != m_ways_hash.cend(); ++it) {
+		const Osm_Way& way = **it;
+		usage.add(Memory_Usage::WAY, Memory_Usage::OBJECT, sizeof(Osm_Way));
+		add_object_usage(usage, Memory_Usage::WAY, way);
+		add_subscriber_usage(usage, Memory_Usage::WAY, way);
+		add_info_usage(usage, Memory_Usage::WAY, way);
+		usage.add(Memory_Usage::WAY, Memory_Usage::MEMBERS,
+		          Memory_Usage::bytes_of(way.m_nodes) + Memory_Usage::bytes_of(way.m_set));
+	}
+	usage.add_elements(Memory_Usage::RELATION, m_relations_hash.size());
+	for (auto it = m_relations_hash.cbegin(); it != m_relations_hash.cend(); ++it) {
+		const Osm_Relation& relation = **it;
+		qint64 n_member_bytes = Memory_Usage::bytes_of(relation.m_nodes_list)
+		                        + Memory_Usage::bytes_of(relation.m_ways_list)
+		                        + Memory_Usage::bytes_of(relation.m_relations_list)
+		                        + Memory_Usage::bytes_of(relation.m_roles_hash);
+		for (auto it_role = relation.m_roles_hash.cbegin(); it_role != relation.m_roles_hash.cend(); ++it_role) {
+			n_member_bytes += Memory_Usage::bytes_of(*it_role);
+		}
+		usage.add(Memory_Usage::RELATION, Memory_Usage::OBJECT, sizeof(Osm_Relation));
+		add_object_usage(usage, Memory_Usage::RELATION, relation);
+		add_subscriber_usage(usage, Memory_Usage::RELATION, relation);
+		add_info_usage(usage, Memory_Usage::RELATION, relation);
+		usage.add(Memory_Usage::RELATION, Memory_Usage::MEMBERS, n_member_bytes);
+	}
+	usage.add(Memory_Usage::MAP, Memory_Usage::OBJECT, sizeof(Osm_Map));
+	add_object_usage(usage, Memory_Usage::MAP, *this);
+	add_subscriber_usage(usage, Memory_Usage::MAP, *this);
+	usage.add(Memory_Usage::MAP, Memory_Usage::INDEXES,
+	          Memory_Usage::bytes_of(m_nodes_hash) + Memory_Usage::bytes_of(m_ways_hash)
+	          + Memory_Usage::bytes_of(m_relations_hash) + get_usage(m_tag_index));
+	return usage;
+}
+
+QList<Osm_Node*> Osm_Map::find_nodes(const QString& key, const QString& value) const {
+	return find_elements(m_nodes_hash, Tag_Index::NODE, key, value);
+}
+
+QList<Osm_Way*> Osm_Map::find_ways(const QString& key, const QString& value) const {
+	return find_elements(m_ways_hash, Tag_Index::WAY, key, value);
+}
+
+QList<Osm_Relation*> Osm_Map::find_relations(const QString& key, const QString& value) const {
+	return find_elements(m_relations_hash, Tag_Index::RELATION, key, value);
+}
+
 Osm_Node* Osm_Map::get_node(long long id) {
 	node_iterator it = m_nodes_hash.find(id);
 	if (it == nend() || it.key() != id) {
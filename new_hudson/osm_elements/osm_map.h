@@ -5,6 +5,9 @@
 #include "osm_node.h"
 #include "osm_way.h"
 #include "osm_relation.h"
+#include "tag_index.h"
+#include "memory_usage.h"
+#include "id_hash.h"
 
 #ifndef CMATH_H
 #define CMATH_H
@@ -16,13 +19,16 @@ namespace ns_osm {
 class Osm_Map : public Osm_Subscriber, public Osm_Object {
 private:
 	int										mn_parents;
-	QHash<long long, ns_osm::Osm_Node*>		m_nodes_hash;
-	QHash<long long, ns_osm::Osm_Way*>		m_ways_hash;
-	QHash<long long, ns_osm::Osm_Relation*> m_relations_hash;
+	Id_Hash<ns_osm::Osm_Node*>				m_nodes_hash;
+	Id_Hash<ns_osm::Osm_Way*>				m_ways_hash;
+	Id_Hash<ns_osm::Osm_Relation*>			m_relations_hash;
 	QRectF									m_bounding_rect;
 	bool									f_destruct_physically;
 	bool									f_remove_orphaned_nodes;
 	bool									f_remove_one_node_ways;
+	Tag_Index								m_tag_index;
+	Id_Allocator							m_id_allocator; /* Kept below every negative id held */
+	mutable QAtomicInt						mn_freezes;
 
 	void									handle_event_update			(Osm_Node&) override;
 	void									handle_event_update			(Osm_Way&) override;
@@ -30,20 +36,42 @@ private:
 	void									handle_event_delete			(Osm_Node&) override;
 	void									handle_event_delete			(Osm_Way&) override;
 	void									handle_event_delete			(Osm_Relation&) override;
+	void									unindex						(Osm_Info&); /* Drops the element from this map's tag index */
+	bool									claim_id					(Osm_Info&); /* For an element whose id another one holds */
+	static void								add_object_usage			(Memory_Usage&, Memory_Usage::Kind, const Osm_Object&);
+	static void								add_subscriber_usage		(Memory_Usage&, Memory_Usage::Kind, const Osm_Subscriber&);
+	static void								add_info_usage				(Memory_Usage&, Memory_Usage::Kind, const Osm_Info&);
+	static qint64							get_usage					(const Id_Set&);
+	static qint64							get_usage					(const Tag_Index&);
+	Osm_Object*								find_object					(Osm_Info&) const; /* nullptr unless held by this map */
+	/* One MAP_TAGS_UPDATED naming those the map holds; none if that's nobody and no subject */
+	void									emit_tags_updated			(const QList<Osm_Info*>& changed,
+	                                                                     Osm_Object* p_subject = nullptr);
+	static bool								write_tags					(Osm_Info&,
+	                                                                     const QMap<QString, QString>& tags,
+	                                                                     const QStringList& removed_keys);
+	template <typename T>
+	QList<T*>								find_elements				(const Id_Hash<T*>&,
+	                                                                     Tag_Index::Kind,
+	                                                                     const QString& key,
+	                                                                     const QString& value) const;
 	                                        Osm_Map						(const Osm_Map&) = delete;
 	Osm_Map&								operator=					(const Osm_Map&) = delete;
 public:
-	typedef QHash<long long, ns_osm::Osm_Node*>::iterator				node_iterator;
-	typedef QHash<long long, ns_osm::Osm_Way*>::iterator				way_iterator;
-	typedef QHash<long long, ns_osm::Osm_Relation*>::iterator			relation_iterator;
-	typedef QHash<long long, ns_osm::Osm_Node*>::const_iterator			cnode_iterator;
-	typedef QHash<long long, ns_osm::Osm_Way*>::const_iterator			cway_iterator;
-	typedef QHash<long long, ns_osm::Osm_Relation*>::const_iterator		crelation_iterator;
+	typedef Id_Hash<ns_osm::Osm_Node*>::iterator						node_iterator;
+	typedef Id_Hash<ns_osm::Osm_Way*>::iterator							way_iterator;
+	typedef Id_Hash<ns_osm::Osm_Relation*>::iterator					relation_iterator;
+	typedef Id_Hash<ns_osm::Osm_Node*>::const_iterator					cnode_iterator;
+	typedef Id_Hash<ns_osm::Osm_Way*>::const_iterator					cway_iterator;
+	typedef Id_Hash<ns_osm::Osm_Relation*>::const_iterator				crelation_iterator;
 
 	void									set_remove_physically		(bool f); /* True by default */
 	void									set_remove_orphaned_nodes	(bool f); /* True by default */
 	void									set_remove_one_node_ways	(bool f); /* True by default */
 	int										count_parents				() const;
+	int										count_nodes					() const;
+	int										count_ways					() const;
+	int										count_relations				() const;
 	void									set_bound					(const QRectF&);
 	void									adopt						();
 	void									orphan						();
@@ -57,7 +85,54 @@ public:
 	void									remove						(ns_osm::Osm_Way*);
 	void									remove						(ns_osm::Osm_Relation*);
 	void									clear						();
+	/* Swaps in the elements and bound of a map built apart, say on a worker thread, leaving it
+	 * empty. Subscribers see MAP_CLEARED for the old elements, then one MAP_RELOADED */
+	void									take						(Osm_Map& source);
+	/* Each group's first node survives and takes over the others' places in ways and relations,
+	 * and their tags it lacks; the others leave the map, and so do ways left with one node
+	 * unless set_remove_one_node_ways(false). Groups must not share nodes */
+	int										merge_nodes					(const QVector<QVector<ns_osm::Osm_Node*>>& groups);
+	/* Write only the keys that differ, then emit MAP_TAGS_UPDATED with the element as subject,
+	 * and in get_ids() if the map holds it. The element itself emits nothing: its tags are the
+	 * map's business. False if nothing changed */
+	bool									set_tags					(ns_osm::Osm_Node&,
+	                                                                     const QMap<QString, QString>& tags,
+	                                                                     const QStringList& removed_keys);
+	bool									set_tags					(ns_osm::Osm_Way&,
+	                                                                     const QMap<QString, QString>& tags,
+	                                                                     const QStringList& removed_keys);
+	bool									set_tags					(ns_osm::Osm_Relation&,
+	                                                                     const QMap<QString, QString>& tags,
+	                                                                     const QStringList& removed_keys);
+	/* Batched tag edits: the elements emit nothing, the map emits one MAP_TAGS_UPDATED for the lot,
+	 * listing in get_ids() the elements of its own that changed, and no subject */
+	void									set_tag						(const QList<Osm_Info*>&,
+	                                                                     const QString& key,
+	                                                                     const QString& value);
+	void									remove_tag					(const QList<Osm_Info*>&, const QString& key);
+	/* Elements already holding new_key keep both tags untouched; returns how many were skipped */
+	int										rename_tag					(const QList<Osm_Info*>&,
+	                                                                     const QString& old_key,
+	                                                                     const QString& new_key);
+	/* For loading: the tag index takes the adds in between at once at end_batch, instead of
+	 * one sorted insert each, and find_* only sees them from then on. Nests */
+	void									begin_batch					();
+	void									end_batch					();
+	/* While frozen, add, remove, clear, take, merge_nodes and the tag edits refuse and change
+	 * nothing, so other threads may read the map. Const: the content stays as it is. Edits made
+	 * straight on held elements are not caught; only the freezing thread may make any. Nests */
+	void									freeze						() const;
+	void									thaw						() const;
+	bool									is_frozen					() const;
 	QRectF									get_bound					() const;
+	const Tag_Index&						get_tag_index				() const;
+	/* Ids for new elements meant for this map; safe from any thread, see Id_Allocator::Block */
+	Id_Allocator&							get_id_allocator			();
+	Memory_Usage							get_memory_usage			() const; /* Walks every element, O(n) */
+	/* Elements carrying the key, or key=value when the value is not null */
+	QList<ns_osm::Osm_Node*>				find_nodes					(const QString& key, const QString& value = QString()) const;
+	QList<ns_osm::Osm_Way*>					find_ways					(const QString& key, const QString& value = QString()) const;
+	QList<ns_osm::Osm_Relation*>			find_relations				(const QString& key, const QString& value = QString()) const;
 	ns_osm::Osm_Node*						get_node					(long long id_node);
 	ns_osm::Osm_Way*						get_way						(long long id_way);
 	ns_osm::Osm_Relation*					get_relation				(long long id_relation);
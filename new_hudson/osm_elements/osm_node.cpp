@@ -38,6 +38,17 @@ Osm_Node::Osm_Node(const double& latitude, const double& longitude) :
 	correct();
 }
 
+Osm_Node::Osm_Node(const double& latitude, const double& longitude, Id_Allocator& allocator) :
+	Osm_Object(Osm_Object::Type::NODE),
+	Osm_Info(allocator)
+{
+	m_lat = latitude;
+	m_lon = longitude;
+	set_attr("lat", QString(QString::number(m_lat)));
+	set_attr("lon", QString(QString::number(m_lon)));
+	correct();
+}
+
 Osm_Node::~Osm_Node() {
 	emit_delete();
 }
@@ -73,14 +84,14 @@ double Osm_Node::get_lon() const {
 void Osm_Node::set_lat(const double &latitude) {
 	m_lat = latitude;
 	set_attr(QString("lat"), QString(QString::number(m_lat)));
-	emit_update();
+	emit_update(NODE_UPDATED);
 }
 
 void Osm_Node::set_lon(const double &longitude) {
 	m_lon = longitude;
 	correct();
 	set_attr(QString("lon"), QString(QString::number(m_lon)));
-	emit_update();
+	emit_update(NODE_UPDATED);
 }
 
 void Osm_Node::set_lat_lon(const double &latitude, const double &longitude) {
@@ -89,5 +100,5 @@ void Osm_Node::set_lat_lon(const double &latitude, const double &longitude) {
 	correct();
 	set_attr(QString("lat"), QString(QString::number(m_lat)));
 	set_attr(QString("lon"), QString(QString::number(m_lon)));
-	emit_update();
+	emit_update(NODE_UPDATED);
 }
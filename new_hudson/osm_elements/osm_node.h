@@ -25,6 +25,7 @@ public:
 				                 const QString& latitude,
 				                 const QString& longitude);
 				Osm_Node		(const double& latitude, const double& longitude);
+				Osm_Node		(const double& latitude, const double& longitude, Id_Allocator&);
 	virtual		~Osm_Node		();
 };
 
@@ -2,6 +2,7 @@
 #include "osm_node.h"
 #include "osm_way.h"
 #include "osm_relation.h"
+#include "event_trace.h"
 
 using namespace ns_osm;
 
@@ -10,27 +11,30 @@ using namespace ns_osm;
 /*================================================================*/
 
 //long long				Osm_Object::s_osm_id_bound(-1);
-long long				Osm_Object::s_inner_id_bound(0xFFFFFFFFFFFFFFFF);
-QHash<long long, bool>	Osm_Object::s_id_to_lifestage;
+QAtomicInteger<qint64>				Osm_Object::s_inner_id_bound(0);
+Osm_Object::Lifestage_Shard			Osm_Object::s_lifestage_shards[Osm_Object::N_LIFESTAGE_SHARDS];
 
 /*================================================================*/
 /*                  Constructors, destructors                     */
 /*================================================================*/
 
 Osm_Object::Osm_Object(const Osm_Object::Type type) :
-	INNER_ID(s_inner_id_bound++),
+	INNER_ID(acquire_inner_id()),
 	TYPE(type)
 {
 	f_is_valid = true;
 	//m_attrmap[QString("id")] = QString::number(OSM_ID);
 	mn_subscribers = 0;
 	mn_osm_object_subscribers = 0;
-	s_id_to_lifestage[INNER_ID] = true;
 	//reg_osm_object(this);
 }
 
 Osm_Object::~Osm_Object() {
-	s_id_to_lifestage[INNER_ID] = false;
+	Lifestage_Shard& shard = get_lifestage_shard(INNER_ID);
+
+	shard.mutex.lock();
+	shard.alive.remove(INNER_ID);
+	shard.mutex.unlock();
 	while (!m_subscribers.empty()) {
 		m_subscribers.front()->unsubscribe(*this);
 	}
@@ -49,12 +53,37 @@ bool Osm_Object::is_osm_object(Osm_Subscriber* p_subscriber) const {
 	return false;
 }
 
+/* Ids are never reused, so a destructed object stays locked for good */
+long long Osm_Object::acquire_inner_id() {
+	static thread_local long long	s_next = 0;
+	static thread_local long long	s_end = 0;
+	long long						id;
+
+	if (s_next == s_end) {
+		s_next = s_inner_id_bound.fetchAndAddRelaxed(INNER_ID_BLOCK);
+		s_end = s_next + INNER_ID_BLOCK;
+	}
+	id = s_next++;
+
+	Lifestage_Shard& shard = get_lifestage_shard(id);
+	QMutexLocker locker(&shard.mutex);
+	shard.alive.insert(id);
+	return id;
+}
+
+Osm_Object::Lifestage_Shard& Osm_Object::get_lifestage_shard(long long inner_id) {
+	return s_lifestage_shards[(inner_id / INNER_ID_BLOCK) % N_LIFESTAGE_SHARDS];
+}
+
 /*================================================================*/
 /*                      Protected methods                         */
 /*================================================================*/
 
 bool Osm_Object::is_locked(long long id) {
-	return !s_id_to_lifestage[id];
+	Lifestage_Shard&	shard = get_lifestage_shard(id);
+	QMutexLocker		locker(&shard.mutex);
+
+	return !shard.alive.contains(id);
 }
 
 const Osm_Object::Type Osm_Object::get_type() const {
@@ -74,8 +103,10 @@ void Osm_Object::emit_delete(Meta meta) {
 	m_active_stack = m_subscribers;
 	Osm_Subscriber* p_current_subscriber;
 	Type type = get_type();
+	OSM_TRACE_EMIT(meta.get_event(), true);
 	while (!m_active_stack.empty()) {
 		p_current_subscriber = m_active_stack.front();
+		OSM_TRACE_DELIVERY();
 		p_current_subscriber->m_meta = meta;
 		switch (type) {
 		case Type::NODE:
@@ -108,8 +139,10 @@ void Osm_Object::emit_update(Meta meta) {
 	m_active_stack = m_subscribers;
 	Osm_Subscriber* p_current_subscriber;
 	Type type = get_type();
+	OSM_TRACE_EMIT(meta.get_event(), false);
 	while (!m_active_stack.empty()) {
 		p_current_subscriber = m_active_stack.front();
+		OSM_TRACE_DELIVERY();
 		p_current_subscriber->m_meta = meta;
 		switch (type) {
 		case Type::NODE:
@@ -16,10 +16,16 @@ protected:
 	enum class Type;
 	friend class Osm_Map;
 private:
-	static QHash<long long, bool>	s_id_to_lifestage; /* true - exists, false - destructed */
+	struct Lifestage_Shard;
+
+	/* Inner ids are drawn in blocks per thread and the live ones are kept in shards by
+	 * block, so threads making elements side by side rarely meet on a lock */
+	static const int				INNER_ID_BLOCK = 4096;
+	static const int				N_LIFESTAGE_SHARDS = 64;
+	static Lifestage_Shard			s_lifestage_shards[N_LIFESTAGE_SHARDS]; /* Ids of objects alive */
+	static QAtomicInteger<qint64>	s_inner_id_bound;
 	const long long					INNER_ID;
 	const Type						TYPE;
-	static long long				s_inner_id_bound;
 	QList<Osm_Subscriber*>			m_subscribers;
 	QList<Osm_Subscriber*>			m_active_stack;
 	int								mn_subscribers;
@@ -27,6 +33,8 @@ private:
 	bool							f_is_valid;
 
 	bool							is_osm_object			(Osm_Subscriber*) const;
+	static long long				acquire_inner_id		(); /* Marked alive */
+	static Lifestage_Shard&			get_lifestage_shard		(long long inner_id);
 //	                                Osm_Object				() = delete;
 protected:
 	enum class Type {NODE, WAY, RELATION, GENERIC_EMITTER};
@@ -49,6 +57,11 @@ public:
 	virtual							~Osm_Object				();
 };	// class Osm_Object
 
+struct Osm_Object::Lifestage_Shard {
+	QMutex							mutex;
+	QSet<long long>					alive;
+};
+
 }
 
 #endif // include guard OSM_OBJECT_H
@@ -0,0 +1,684 @@
+#include "osm_query.h"
+
+using namespace ns_osm;
+
+/*================================================================*/
+/*                     Osm_Query::Scan_Task                       */
+/*================================================================*/
+
+template <typename T>
+class Osm_Query::Scan_Task : public QRunnable {
+	const Osm_Query*	mp_query;
+	const Statement*	mp_statement;
+	T* const*			mp_begin;
+	T* const*			mp_end;
+	QVector<long long>*	mp_ids;
+public:
+	void				run			() override;
+	                    Scan_Task	(const Osm_Query&,
+	                                 const Statement&,
+	                                 T* const* p_begin,
+	                                 T* const* p_end,
+	                                 QVector<long long>& ids);
+};
+
+template <typename T>
+Osm_Query::Scan_Task<T>::Scan_Task(const Osm_Query& query,
+                                   const Statement& statement,
+                                   T* const* p_begin,
+                                   T* const* p_end,
+                                   QVector<long long>& ids) {
+	mp_query = &query;
+	mp_statement = &statement;
+	mp_begin = p_begin;
+	mp_end = p_end;
+	mp_ids = &ids;
+}
+
+/* Runs on a pool thread: reads elements only, writes only its own id vector */
+template <typename T>
+void Osm_Query::Scan_Task<T>::run() {
+	for (T* const* p = mp_begin; p != mp_end; ++p) {
+		if (mp_query->matches(*mp_statement, **p)) {
+			mp_ids->push_back((*p)->get_id());
+		}
+	}
+}
+
+/*================================================================*/
+/*                        Static members                          */
+/*================================================================*/
+
+const int Osm_Query::PARALLEL_THRESHOLD = 16384;
+
+/*================================================================*/
+/*                  Constructors, destructors                     */
+/*================================================================*/
+
+Osm_Query::Osm_Query() {
+	m_pos = 0;
+	mp_spatial_index = nullptr;
+}
+
+Osm_Query::Osm_Query(const QString& text) {
+	m_pos = 0;
+	mp_spatial_index = nullptr;
+	compile(text);
+}
+
+Osm_Query::~Osm_Query() {
+	m_pool.waitForDone();
+}
+
+/*================================================================*/
+/*                   Private methods: parsing                     */
+/*================================================================*/
+
+bool Osm_Query::fail(const QString& message) {
+	m_error = QString("%1 at position %2").arg(message).arg(m_pos);
+	return false;
+}
+
+void Osm_Query::skip_spaces() {
+	while (m_pos < m_text.size() && m_text[m_pos].isSpace()) {
+		m_pos++;
+	}
+}
+
+bool Osm_Query::accept(const QString& token) {
+	skip_spaces();
+	if (!m_text.midRef(m_pos).startsWith(token)) {
+		return false;
+	}
+	m_pos += token.size();
+	return true;
+}
+
+bool Osm_Query::parse() {
+	Statement statement;
+
+	skip_spaces();
+	while (m_pos < m_text.size()) {
+		if (!parse_statement(statement)) {
+			return false;
+		}
+		m_statements.push_back(statement);
+		skip_spaces();
+		if (m_pos < m_text.size() && !accept(";")) {
+			return fail("Expected ';'");
+		}
+		skip_spaces();
+	}
+	if (m_statements.isEmpty()) {
+		return fail("Empty query");
+	}
+	return true;
+}
+
+bool Osm_Query::parse_statement(Statement& statement) {
+	QString type;
+
+	statement = Statement{0, QVector<Tag_Filter>(), false, 0.0, 0.0, 0.0, 0.0, QVector<QPointF>()};
+	if (accept(">")) {
+		return true;
+	}
+	if (!parse_string(type, "element type")) {
+		return false;
+	}
+	type = type.toLower();
+	if (type == "node") {
+		statement.type_mask = NODE;
+	} else if (type == "way") {
+		statement.type_mask = WAY;
+	} else if (type == "relation" || type == "rel") {
+		statement.type_mask = RELATION;
+	} else if (type == "nwr") {
+		statement.type_mask = NODE | WAY | RELATION;
+	} else {
+		return fail(QString("Unknown element type '%1'").arg(type));
+	}
+	for (;;) {
+		if (accept("[")) {
+			Tag_Filter tag_filter;
+			if (!parse_tag_filter(tag_filter)) {
+				return false;
+			}
+			statement.tag_filters.push_back(tag_filter);
+		} else if (accept("(")) {
+			if (statement.f_has_area) {
+				return fail("Only one area filter per statement");
+			}
+			if (!parse_area(statement)) {
+				return false;
+			}
+		} else {
+			return true;
+		}
+	}
+}
+
+bool Osm_Query::parse_tag_filter(Tag_Filter& tag_filter) {
+	if (accept("!")) {
+		tag_filter.op = NOT_EXISTS;
+		if (!parse_string(tag_filter.key, "key")) {
+			return false;
+		}
+	} else {
+		if (!parse_string(tag_filter.key, "key")) {
+			return false;
+		}
+		if (accept("=")) {
+			tag_filter.op = EQUALS;
+		} else if (accept("!=")) {
+			tag_filter.op = NOT_EQUALS;
+		} else if (accept("!~")) {
+			tag_filter.op = NOT_MATCHES;
+		} else if (accept("~")) {
+			tag_filter.op = MATCHES;
+		} else {
+			tag_filter.op = EXISTS;
+		}
+		if (tag_filter.op != EXISTS && !parse_string(tag_filter.value, "value")) {
+			return false;
+		}
+	}
+	if (tag_filter.op == MATCHES || tag_filter.op == NOT_MATCHES) {
+		tag_filter.regex.setPattern(tag_filter.value);
+		if (!tag_filter.regex.isValid()) {
+			return fail(QString("Invalid regular expression: %1").arg(tag_filter.regex.errorString()));
+		}
+		tag_filter.regex.optimize();
+	}
+	if (!accept("]")) {
+		return fail("Expected ']'");
+	}
+	return true;
+}
+
+bool Osm_Query::parse_area(Statement& statement) {
+	QString		text;
+	QStringList	numbers;
+	double*		bounds[] = {&statement.south, &statement.west, &statement.north, &statement.east};
+
+	if (accept("poly:")) {
+		if (!parse_string(text, "polygon")) {
+			return false;
+		}
+		numbers = text.simplified().split(' ', QString::SkipEmptyParts);
+		if (numbers.size() < 6 || numbers.size() % 2 != 0) {
+			return fail("A polygon needs at least three lat lon pairs");
+		}
+		for (int i = 0; i < numbers.size(); i += 2) {
+			bool f_lat_ok;
+			bool f_lon_ok;
+			QPointF point(numbers[i + 1].toDouble(&f_lon_ok), numbers[i].toDouble(&f_lat_ok));
+			if (!f_lat_ok || !f_lon_ok) {
+				return fail("Expected number in polygon");
+			}
+			statement.polygon.push_back(point);
+		}
+		/* The polygon's bounding box lets it use the spatial index */
+		statement.south = statement.north = statement.polygon.front().y();
+		statement.west = statement.east = statement.polygon.front().x();
+		for (auto it = statement.polygon.cbegin(); it != statement.polygon.cend(); ++it) {
+			statement.south = qMin(statement.south, it->y());
+			statement.north = qMax(statement.north, it->y());
+			statement.west = qMin(statement.west, it->x());
+			statement.east = qMax(statement.east, it->x());
+		}
+	} else {
+		for (int i = 0; i < 4; ++i) {
+			if (i > 0 && !accept(",")) {
+				return fail("Expected ','");
+			}
+			if (!parse_number(*bounds[i])) {
+				return false;
+			}
+		}
+		if (statement.south > statement.north) {
+			return fail("South is above north");
+		}
+	}
+	if (!accept(")")) {
+		return fail("Expected ')'");
+	}
+	statement.f_has_area = true;
+	return true;
+}
+
+bool Osm_Query::parse_string(QString& text, const char* p_what) {
+	static const QString DELIMITERS("[]()=!~;,\">");
+
+	text.clear();
+	if (accept("\"")) {
+		while (m_pos < m_text.size() && m_text[m_pos] != '"') {
+			if (m_text[m_pos] == '\\' && m_pos + 1 < m_text.size()) {
+				m_pos++;
+			}
+			text += m_text[m_pos++];
+		}
+		if (m_pos >= m_text.size()) {
+			return fail("Unterminated string");
+		}
+		m_pos++;
+		return true;
+	}
+	while (m_pos < m_text.size() && !m_text[m_pos].isSpace() && !DELIMITERS.contains(m_text[m_pos])) {
+		text += m_text[m_pos++];
+	}
+	if (text.isEmpty()) {
+		return fail(QString("Expected %1").arg(p_what));
+	}
+	return true;
+}
+
+bool Osm_Query::parse_number(double& number) {
+	QString	text;
+	bool	f_ok;
+
+	if (!parse_string(text, "number")) {
+		return false;
+	}
+	number = text.toDouble(&f_ok);
+	if (!f_ok) {
+		return fail(QString("Expected number, got '%1'").arg(text));
+	}
+	return true;
+}
+
+/*================================================================*/
+/*                  Private methods: matching                     */
+/*================================================================*/
+
+Tag_Index::Kind Osm_Query::get_kind(Type type) {
+	switch (type) {
+	case NODE:
+		return Tag_Index::NODE;
+	case WAY:
+		return Tag_Index::WAY;
+	default:
+		return Tag_Index::RELATION;
+	}
+}
+
+/* Filters only elements carrying the key can pass */
+bool Osm_Query::is_positive(const Tag_Filter& tag_filter) {
+	return tag_filter.op == EXISTS || tag_filter.op == EQUALS || tag_filter.op == MATCHES;
+}
+
+bool Osm_Query::in_area(const Statement& statement, double lat, double lon) const {
+	bool f_inside = false;
+
+	if (lat < statement.south || lat > statement.north) {
+		return false;
+	}
+	if (statement.polygon.isEmpty()) {
+		/* West above east crosses the antimeridian */
+		if (statement.west <= statement.east) {
+			return lon >= statement.west && lon <= statement.east;
+		}
+		return lon >= statement.west || lon <= statement.east;
+	}
+	if (lon < statement.west || lon > statement.east) {
+		return false;
+	}
+	/* Even-odd rule */
+	const QVector<QPointF>& polygon = statement.polygon;
+	for (int i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+		if ((polygon[i].y() > lat) != (polygon[j].y() > lat) &&
+		    lon < (polygon[j].x() - polygon[i].x()) * (lat - polygon[i].y()) / (polygon[j].y() - polygon[i].y()) + polygon[i].x()) {
+			f_inside = !f_inside;
+		}
+	}
+	return f_inside;
+}
+
+bool Osm_Query::matches_tags(const Statement& statement, const Osm_Info& info) const {
+	const QMap<QString, QString>& tags = info.get_tag_map();
+
+	for (auto it = statement.tag_filters.cbegin(); it != statement.tag_filters.cend(); ++it) {
+		auto	it_tag = tags.constFind(it->key);
+		bool	f_has = (it_tag != tags.cend());
+
+		switch (it->op) {
+		case EXISTS:
+			if (!f_has) return false;
+			break;
+		case NOT_EXISTS:
+			if (f_has) return false;
+			break;
+		case EQUALS:
+			if (!f_has || it_tag.value() != it->value) return false;
+			break;
+		case NOT_EQUALS:
+			if (f_has && it_tag.value() == it->value) return false;
+			break;
+		case MATCHES:
+			if (!f_has || !it->regex.match(it_tag.value()).hasMatch()) return false;
+			break;
+		case NOT_MATCHES:
+			if (f_has && it->regex.match(it_tag.value()).hasMatch()) return false;
+			break;
+		}
+	}
+	return true;
+}
+
+bool Osm_Query::matches(const Statement& statement, const Osm_Node& node) const {
+	if (!matches_tags(statement, node)) {
+		return false;
+	}
+	return !statement.f_has_area || in_area(statement, node.get_lat(), node.get_lon());
+}
+
+bool Osm_Query::in_area(const Statement& statement, const Osm_Way& way) const {
+	for (auto it = way.get_nodes_list().cbegin(); it != way.get_nodes_list().cend(); ++it) {
+		if (in_area(statement, (*it)->get_lat(), (*it)->get_lon())) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool Osm_Query::matches(const Statement& statement, const Osm_Way& way) const {
+	if (!matches_tags(statement, way)) {
+		return false;
+	}
+	return !statement.f_has_area || in_area(statement, way);
+}
+
+/* Member relations are not descended into for the area test */
+bool Osm_Query::matches(const Statement& statement, const Osm_Relation& relation) const {
+	if (!matches_tags(statement, relation)) {
+		return false;
+	}
+	if (!statement.f_has_area) {
+		return true;
+	}
+	for (auto it = relation.get_nodes().cbegin(); it != relation.get_nodes().cend(); ++it) {
+		if (in_area(statement, (*it)->get_lat(), (*it)->get_lon())) {
+			return true;
+		}
+	}
+	for (auto it = relation.get_ways().cbegin(); it != relation.get_ways().cend(); ++it) {
+		if (in_area(statement, **it)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*================================================================*/
+/*                 Private methods: planning, running             */
+/*================================================================*/
+
+/* Per statement and element type, the candidate source is the smallest
+ * tag index posting list among the filters that require a key, else the
+ * spatial index for an area, else the whole map. Candidates are then
+ * checked against every filter. */
+QVector<Osm_Query::Step> Osm_Query::plan(Osm_Map& map) const {
+	const Type			types[] = {NODE, WAY, RELATION};
+	QVector<Step>		steps;
+
+	for (int i = 0; i < m_statements.size(); ++i) {
+		const Statement& statement = m_statements[i];
+		for (Type type : types) {
+			if (!(statement.type_mask & type)) {
+				continue;
+			}
+			Step step{i, type, SCAN, -1, -1};
+			for (int j = 0; j < statement.tag_filters.size(); ++j) {
+				const Tag_Filter& tag_filter = statement.tag_filters[j];
+				if (!is_positive(tag_filter)) {
+					continue;
+				}
+				int n_candidates = (tag_filter.op == EQUALS ?
+				                    map.get_tag_index().find(get_kind(type), tag_filter.key, tag_filter.value) :
+				                    map.get_tag_index().find(get_kind(type), tag_filter.key)).size();
+				if (step.source != TAG_INDEX || n_candidates < step.n_candidates) {
+					step.source = TAG_INDEX;
+					step.tag_filter = j;
+					step.n_candidates = n_candidates;
+				}
+			}
+			if (step.source == SCAN && statement.f_has_area && mp_spatial_index != nullptr &&
+			    type != RELATION && statement.west <= statement.east) {
+				step.source = SPATIAL_INDEX;
+			}
+			if (step.source == SCAN) {
+				step.n_candidates = (type == NODE ? map.count_nodes() :
+				                     type == WAY ? map.count_ways() : map.count_relations());
+			}
+			steps.push_back(step);
+		}
+	}
+	return steps;
+}
+
+template <typename T>
+void Osm_Query::filter(const Statement& statement, const QVector<T*>& candidates, QSet<long long>& ids) const {
+	QVector<QVector<long long>>	chunk_ids;
+	int							n_chunks;
+	int							chunk_size;
+
+	if (candidates.size() < PARALLEL_THRESHOLD) {
+		for (auto it = candidates.cbegin(); it != candidates.cend(); ++it) {
+			if (matches(statement, **it)) {
+				ids.insert((*it)->get_id());
+			}
+		}
+		return;
+	}
+	n_chunks = qMax(1, m_pool.maxThreadCount());
+	chunk_size = (candidates.size() + n_chunks - 1) / n_chunks;
+	chunk_ids.resize(n_chunks);
+	for (int i = 0; i < n_chunks; ++i) {
+		int first = i * chunk_size;
+		int last = qMin(candidates.size(), first + chunk_size);
+		if (first >= last) {
+			break;
+		}
+		m_pool.start(new Scan_Task<T>(*this,
+		                              statement,
+		                              candidates.constData() + first,
+		                              candidates.constData() + last,
+		                              chunk_ids[i]));
+	}
+	m_pool.waitForDone();
+	for (auto it = chunk_ids.cbegin(); it != chunk_ids.cend(); ++it) {
+		for (auto it_id = it->cbegin(); it_id != it->cend(); ++it_id) {
+			ids.insert(*it_id);
+		}
+	}
+}
+
+void Osm_Query::run_step(const Step& step, Osm_Map& map, Result& result) const {
+	const Statement&		statement = m_statements[step.statement];
+	QVector<Osm_Node*>		nodes;
+	QVector<Osm_Way*>		ways;
+	QVector<Osm_Relation*>	relations;
+
+	switch (step.source) {
+	case TAG_INDEX: {
+		const Tag_Filter& tag_filter = statement.tag_filters[step.tag_filter];
+		const QVector<long long>& ids = (tag_filter.op == EQUALS ?
+		                                 map.get_tag_index().find(get_kind(step.type), tag_filter.key, tag_filter.value) :
+		                                 map.get_tag_index().find(get_kind(step.type), tag_filter.key));
+		for (auto it = ids.cbegin(); it != ids.cend(); ++it) {
+			if (step.type == NODE) {
+				nodes.push_back(map.get_node(*it));
+			} else if (step.type == WAY) {
+				ways.push_back(map.get_way(*it));
+			} else {
+				relations.push_back(map.get_relation(*it));
+			}
+		}
+		nodes.removeAll(nullptr);
+		ways.removeAll(nullptr);
+		relations.removeAll(nullptr);
+		break;
+	}
+	case SPATIAL_INDEX:
+		mp_spatial_index->find(QRectF(QPointF(statement.west, statement.south), QPointF(statement.east, statement.north)),
+		                       nodes,
+		                       ways);
+		break;
+	case SCAN:
+		if (step.type == NODE) {
+			nodes.reserve(map.count_nodes());
+			for (auto it = map.cnbegin(); it != map.cnend(); ++it) {
+				nodes.push_back(it.value());
+			}
+		} else if (step.type == WAY) {
+			ways.reserve(map.count_ways());
+			for (auto it = map.cwbegin(); it != map.cwend(); ++it) {
+				ways.push_back(it.value());
+			}
+		} else {
+			relations.reserve(map.count_relations());
+			for (auto it = map.crbegin(); it != map.crend(); ++it) {
+				relations.push_back(it.value());
+			}
+		}
+		break;
+	}
+
+	switch (step.type) {
+	case NODE:
+		filter(statement, nodes, result.nodes);
+		break;
+	case WAY:
+		filter(statement, ways, result.ways);
+		break;
+	case RELATION:
+		filter(statement, relations, result.relations);
+		break;
+	}
+}
+
+/* way -> nodes, relation -> members, down to the last nested relation */
+void Osm_Query::add_members(Osm_Map& map, Result& result) const {
+	QList<long long> relation_queue = result.relations.values();
+	QList<long long> way_queue = result.ways.values();
+
+	while (!relation_queue.isEmpty()) {
+		Osm_Relation* p_relation = map.get_relation(relation_queue.takeFirst());
+		if (p_relation == nullptr) {
+			continue;
+		}
+		for (auto it = p_relation->get_nodes().cbegin(); it != p_relation->get_nodes().cend(); ++it) {
+			result.nodes.insert((*it)->get_id());
+		}
+		for (auto it = p_relation->get_ways().cbegin(); it != p_relation->get_ways().cend(); ++it) {
+			if (!result.ways.contains((*it)->get_id())) {
+				result.ways.insert((*it)->get_id());
+				way_queue.push_back((*it)->get_id());
+			}
+		}
+		for (auto it = p_relation->get_relations().cbegin(); it != p_relation->get_relations().cend(); ++it) {
+			if (!result.relations.contains((*it)->get_id())) {
+				result.relations.insert((*it)->get_id());
+				relation_queue.push_back((*it)->get_id());
+			}
+		}
+	}
+	for (auto it = way_queue.cbegin(); it != way_queue.cend(); ++it) {
+		Osm_Way* p_way = map.get_way(*it);
+		if (p_way == nullptr) {
+			continue;
+		}
+		for (auto it_node = p_way->get_nodes_list().cbegin(); it_node != p_way->get_nodes_list().cend(); ++it_node) {
+			result.nodes.insert((*it_node)->get_id());
+		}
+	}
+}
+
+/*================================================================*/
+/*                        Public methods                          */
+/*================================================================*/
+
+bool Osm_Query::compile(const QString& text) {
+	m_text = text;
+	m_pos = 0;
+	m_error.clear();
+	m_statements.clear();
+	if (!parse()) {
+		m_statements.clear();
+		return false;
+	}
+	return true;
+}
+
+bool Osm_Query::is_valid() const {
+	return m_error.isEmpty() && !m_statements.isEmpty();
+}
+
+QString Osm_Query::get_error() const {
+	return m_error;
+}
+
+void Osm_Query::set_spatial_index(Spatial_Index* p_index) {
+	mp_spatial_index = p_index;
+}
+
+QStringList Osm_Query::explain(Osm_Map& map) const {
+	static const char*	TYPE_NAMES[] = {"", "node", "way", "", "relation"};
+	static const char*	OP_NAMES[] = {"", "!", "=", "!=", "~", "!~"};
+	QVector<Step>		steps = plan(map);
+	QStringList			lines;
+
+	for (auto it = steps.cbegin(); it != steps.cend(); ++it) {
+		QString line = QString("%1 %2: ").arg(it->statement).arg(TYPE_NAMES[it->type]);
+		switch (it->source) {
+		case TAG_INDEX: {
+			const Tag_Filter& tag_filter = m_statements[it->statement].tag_filters[it->tag_filter];
+			line += QString("tag index [%1%2%3]").arg(tag_filter.key).arg(OP_NAMES[tag_filter.op]).arg(tag_filter.value);
+			break;
+		}
+		case SPATIAL_INDEX:
+			line += "spatial index";
+			break;
+		case SCAN:
+			line += (it->n_candidates >= PARALLEL_THRESHOLD ? "parallel scan" : "scan");
+			break;
+		}
+		if (it->n_candidates >= 0) {
+			line += QString(", %1 candidates").arg(it->n_candidates);
+		}
+		lines.push_back(line);
+	}
+	return lines;
+}
+
+Osm_Query::Result Osm_Query::run(Osm_Map& map) const {
+	Result			result;
+	QVector<Step>	steps;
+	int				i_step = 0;
+
+	if (!is_valid()) {
+		return result;
+	}
+	steps = plan(map);
+	for (int i = 0; i < m_statements.size(); ++i) {
+		if (m_statements[i].type_mask == 0) {
+			add_members(map, result);
+			continue;
+		}
+		for (; i_step < steps.size() && steps[i_step].statement == i; ++i_step) {
+			run_step(steps[i_step], map, result);
+		}
+	}
+	return result;
+}
+
+/*================================================================*/
+/*                       Osm_Query::Result                        */
+/*================================================================*/
+
+bool Osm_Query::Result::is_empty() const {
+	return nodes.isEmpty() && ways.isEmpty() && relations.isEmpty();
+}
+
+int Osm_Query::Result::size() const {
+	return nodes.size() + ways.size() + relations.size();
+}
@@ -0,0 +1,122 @@
+#ifndef OSM_QUERY_H
+#define OSM_QUERY_H
+
+#ifndef QT_CORE_H
+#define QT_CORE_H
+#include <QtCore>
+#endif /* Include guard QT_CORE_H */
+
+#include "osm_map.h"
+#include "spatial_index.h"
+
+namespace ns_osm {
+
+/* Overpass-style query over a loaded map.
+ *
+ *   query     := statement { ';' statement } [';']
+ *   statement := type { filter } | '>'
+ *   type      := 'node' | 'way' | 'relation' | 'rel' | 'nwr'
+ *   filter    := '[' ['!'] key ']' | '[' key op value ']' | '(' area ')'
+ *   op        := '=' | '!=' | '~' | '!~'
+ *   area      := south ',' west ',' north ',' east | 'poly:' '"' lat lon lat lon ... '"'
+ *
+ * Keys and values are bare words or double-quoted strings. Statements are
+ * united; '>' adds the members of everything found so far, recursively.
+ * Ways and relations are inside an area if one of their nodes is, e.g.
+ *
+ *   way[highway=residential][!name](50.7,7.1,50.8,7.2); >;
+ */
+class Osm_Query {
+public:
+	enum Type {NODE = 1, WAY = 2, RELATION = 4};
+	struct Result;
+private:
+	enum Tag_Op {EXISTS, NOT_EXISTS, EQUALS, NOT_EQUALS, MATCHES, NOT_MATCHES};
+	enum Source {SCAN, TAG_INDEX, SPATIAL_INDEX};
+	struct Tag_Filter {
+		Tag_Op				op;
+		QString				key;
+		QString				value;
+		QRegularExpression	regex;
+	};
+	struct Statement {
+		int						type_mask; /* 0 for '>' */
+		QVector<Tag_Filter>		tag_filters;
+		bool					f_has_area;
+		double					south;
+		double					west;
+		double					north;
+		double					east;
+		QVector<QPointF>		polygon; /* x is longitude; empty for a bbox */
+	};
+	struct Step {
+		int			statement;
+		Type		type;
+		Source		source;
+		int			tag_filter; /* Drives the TAG_INDEX source */
+		int			n_candidates; /* -1 if unknown before running */
+	};
+	template <typename T> class Scan_Task;
+
+	static const int						PARALLEL_THRESHOLD;
+	QString									m_text;
+	int										m_pos;
+	QString									m_error;
+	QVector<Statement>						m_statements;
+	Spatial_Index*							mp_spatial_index;
+	mutable QThreadPool						m_pool;
+
+	bool									fail			(const QString& message);
+	void									skip_spaces		();
+	bool									accept			(const QString& token);
+	bool									parse			();
+	bool									parse_statement	(Statement&);
+	bool									parse_tag_filter(Tag_Filter&);
+	bool									parse_area		(Statement&);
+	bool									parse_string	(QString&, const char* p_what);
+	bool									parse_number	(double&);
+	static Tag_Index::Kind					get_kind		(Type);
+	static bool								is_positive		(const Tag_Filter&);
+	bool									in_area			(const Statement&, double lat, double lon) const;
+	bool									in_area			(const Statement&, const Osm_Way&) const; /* A node inside */
+	bool									matches_tags	(const Statement&, const Osm_Info&) const;
+	bool									matches			(const Statement&, const Osm_Node&) const;
+	bool									matches			(const Statement&, const Osm_Way&) const;
+	bool									matches			(const Statement&, const Osm_Relation&) const;
+	QVector<Step>							plan			(Osm_Map&) const;
+	template <typename T>
+	void									filter			(const Statement&,
+	                                                         const QVector<T*>& candidates,
+	                                                         QSet<long long>& ids) const;
+	void									run_step		(const Step&, Osm_Map&, Result&) const;
+	void									add_members		(Osm_Map&, Result&) const;
+public:
+	bool									compile			(const QString& text); /* False on a syntax error */
+	bool									is_valid		() const;
+	QString									get_error		() const;
+	void									set_spatial_index(Spatial_Index*); /* nullptr to scan */
+	QStringList								explain			(Osm_Map&) const; /* One line per plan step */
+	Result									run				(Osm_Map&) const;
+	                                        Osm_Query		();
+											Osm_Query		(const QString& text);
+											Osm_Query		(const Osm_Query&) = delete;
+	Osm_Query&								operator=		(const Osm_Query&) = delete;
+	virtual									~Osm_Query		();
+};
+
+/*================================================================*/
+/*                       Osm_Query::Result                        */
+/*================================================================*/
+
+struct Osm_Query::Result {
+	QSet<long long>		nodes;
+	QSet<long long>		ways;
+	QSet<long long>		relations;
+
+	bool				is_empty	() const;
+	int					size		() const;
+};
+
+}
+
+#endif // OSM_QUERY_H
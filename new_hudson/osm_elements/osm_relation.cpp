@@ -24,6 +24,15 @@ Osm_Relation::Osm_Relation() : Osm_Object(Osm_Object::Type::RELATION) {
 	//reg_osm_object(this);
 }
 
+Osm_Relation::Osm_Relation(Id_Allocator& allocator)
+    : Osm_Object(Osm_Object::Type::RELATION),
+      Osm_Info(allocator)
+{
+	mn_nodes = 0;
+	mn_ways = 0;
+	mn_relations = 0;
+}
+
 Osm_Relation::~Osm_Relation() {
 	//unreg_osm_object(this);
 	emit_delete();
@@ -154,6 +163,28 @@ void Osm_Relation::remove(Osm_Relation* ptr_rel) {
 	emit_update(Meta(RELATION_DELETED).set_subject(*ptr_rel));
 }
 
+bool Osm_Relation::replace(Osm_Node* p_old, Osm_Node* p_new) {
+	QString role;
+
+	if (p_old == nullptr || p_new == nullptr || p_old == p_new || !has(p_old)) {
+		return false;
+	}
+	role = get_role(p_old);
+	m_roles_hash.remove(reinterpret_cast<Osm_Relation*>(p_old)->get_inner_id());
+	unsubscribe(*p_old);
+	if (has(p_new)) {
+		mn_nodes -= m_nodes_list.removeAll(p_old);
+	} else {
+		m_nodes_list[m_nodes_list.indexOf(p_old)] = p_new;
+		mn_nodes -= m_nodes_list.removeAll(p_old);
+		m_roles_hash[reinterpret_cast<Osm_Relation*>(p_new)->get_inner_id()] = role;
+		subscribe(*p_new);
+	}
+	/* p_new took the place, a member change rather than a move */
+	emit_update(Meta(NODE_ADDED).set_subject(*p_new));
+	return true;
+}
+
 bool Osm_Relation::has(Osm_Node* p_node) const {
 	if (p_node == nullptr) {
 		return false;
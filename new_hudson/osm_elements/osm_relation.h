@@ -9,6 +9,7 @@
 namespace ns_osm {
 
 class Osm_Relation : public Osm_Object, public Osm_Subscriber, public Osm_Info {
+	friend class Osm_Map;
 private:
 	unsigned short				mn_nodes;
 	unsigned short				mn_ways;
@@ -33,6 +34,7 @@ public:
 	void						remove				(Osm_Node*);
 	void						remove				(Osm_Way*);
 	void						remove				(Osm_Relation*);
+	bool						replace				(Osm_Node* p_old, Osm_Node* p_new); /* Keeps position and role */
 	bool						has					(Osm_Node*) const;
 	bool						has					(Osm_Way*) const;
 	bool						has					(Osm_Relation*) const;
@@ -47,6 +49,7 @@ public:
 	unsigned short				count_relations		() const;
 	                            Osm_Relation		(const QString& id);
 								Osm_Relation		();
+								Osm_Relation		(Id_Allocator&);
 	virtual						~Osm_Relation		();
 };
 }
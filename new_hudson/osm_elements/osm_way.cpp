@@ -17,6 +17,13 @@ Osm_Way::Osm_Way(const QString &id)
 	m_size = 0;
 }
 
+Osm_Way::Osm_Way(Id_Allocator& allocator)
+    : Osm_Object(Osm_Object::Type::WAY),
+      Osm_Info(allocator)
+{
+	m_size = 0;
+}
+
 Osm_Way::~Osm_Way() {
 	emit_delete();
 }
@@ -181,6 +188,41 @@ bool Osm_Way::insert_node_between(Osm_Node* p_node,
 	return (!is_locked(THIS_ID));
 }
 
+bool Osm_Way::replace_nodes(const QHash<Osm_Node*, Osm_Node*>& replacements) {
+	const long long		THIS_ID = get_inner_id();
+	QList<Osm_Node*>	nodes;
+	QSet<Osm_Node*>		set;
+	bool				f_changed = false;
+
+	nodes.reserve(m_nodes.size());
+	for (auto it = m_nodes.cbegin(); it != m_nodes.cend(); ++it) {
+		Osm_Node* p_node = replacements.value(*it, *it);
+		f_changed = f_changed || p_node != *it;
+		if (nodes.isEmpty() || nodes.back() != p_node) {
+			nodes.push_back(p_node);
+			set.insert(p_node);
+		}
+	}
+	if (!f_changed) {
+		return false;
+	}
+	for (auto it = m_set.cbegin(); it != m_set.cend(); ++it) {
+		if (!set.contains(*it)) {
+			unsubscribe(**it);
+		}
+	}
+	for (auto it = set.cbegin(); it != set.cend(); ++it) {
+		if (!m_set.contains(*it)) {
+			subscribe(**it);
+		}
+	}
+	m_nodes = nodes;
+	m_set = set;
+	m_size = m_nodes.size();
+	emit_update(NODE_ADDED);
+	return (!is_locked(THIS_ID));
+}
+
 bool Osm_Way::has(Osm_Node* ptr_node) const {
 	if (ptr_node == nullptr) {
 		return false;
@@ -9,6 +9,7 @@
 namespace ns_osm {
 
 class Osm_Way : public Osm_Object, public Osm_Subscriber, public Osm_Info {
+	friend class Osm_Map;
 private:
 	static const unsigned short				CAPACITY = 2000;
 	unsigned								m_size;
@@ -26,12 +27,15 @@ public:
 	bool									insert_node_between	(Osm_Node* ptr_node,
 																 Osm_Node* ptr_target_1,
 																 Osm_Node* ptr_target_2);
+	/* Rewrites the list at once, dropping repeats the rewrite makes adjacent; one generic NODE_ADDED */
+	bool									replace_nodes		(const QHash<Osm_Node*, Osm_Node*>& replacements);
 	bool									has					(Osm_Node*) const;
 	bool									is_closed			() const;
 	bool									is_empty			() const;
 	const QList<Osm_Node*>&					get_nodes_list		() const;
 											Osm_Way				(const QString& id);
 											Osm_Way				();
+											Osm_Way				(Id_Allocator&);
 											Osm_Way				(const Osm_Way&) = delete;
 	Osm_Way&								operator=			(const Osm_Way&) = delete;
 	virtual									~Osm_Way			();
@@ -0,0 +1,912 @@
+#include "routing_graph.h"
+
+using namespace ns_osm;
+
+/*================================================================*/
+/*                 Routing_Graph::Contraction                     */
+/*================================================================*/
+
+/* Working state of contract(), dropped once the hierarchy is built */
+struct Routing_Graph::Contraction {
+	QVector<QVector<int>>	out_arcs;
+	QVector<QVector<int>>	in_arcs;
+	QVector<bool>			contracted;
+	QVector<int>			n_contracted_neighbors;
+	QVector<double>			dist; /* Witness search distances, reset through touched */
+	QVector<int>			touched;
+};
+
+/*================================================================*/
+/*                        Static members                          */
+/*================================================================*/
+
+const double Routing_Graph::DEFAULT_SPEED = 30.0;
+const int Routing_Graph::WITNESS_SETTLE_LIMIT = 500;
+const int Routing_Graph::MIN_COMPACTION = 1024;
+
+/*================================================================*/
+/*                  Constructors, destructors                     */
+/*================================================================*/
+
+Routing_Graph::Routing_Graph() {
+	mp_map = nullptr;
+	clear();
+}
+
+Routing_Graph::Routing_Graph(const Osm_Map& map) {
+	mp_map = nullptr;
+	build(map);
+}
+
+Routing_Graph::~Routing_Graph() {}
+
+/*================================================================*/
+/*                       Private methods                          */
+/*================================================================*/
+
+bool Routing_Graph::is_routable(const Osm_Way& way) {
+	static const QSet<QString> NOT_ROUTABLE = {"proposed", "construction", "abandoned", "razed",
+	                                           "platform", "raceway", "bus_stop", "elevator"};
+	auto it_highway = way.get_tag_map().constFind("highway");
+
+	if (it_highway == way.get_tag_map().cend() || NOT_ROUTABLE.contains(it_highway.value())) {
+		return false;
+	}
+	return way.get_tag_map().value("area") != "yes";
+}
+
+double Routing_Graph::get_speed(const Osm_Way& way) {
+	static const QHash<QString, double> SPEEDS = {
+		{"motorway", 110.0}, {"motorway_link", 60.0}, {"trunk", 90.0}, {"trunk_link", 50.0},
+		{"primary", 70.0}, {"primary_link", 50.0}, {"secondary", 60.0}, {"secondary_link", 40.0},
+		{"tertiary", 50.0}, {"tertiary_link", 40.0}, {"unclassified", 40.0}, {"residential", 30.0},
+		{"living_street", 10.0}, {"service", 20.0}, {"track", 15.0}, {"cycleway", 15.0},
+		{"pedestrian", 5.0}, {"footway", 5.0}, {"path", 5.0}, {"steps", 3.0}};
+	QString	maxspeed = way.get_tag_map().value("maxspeed");
+	double	speed;
+	bool	f_ok;
+
+	speed = maxspeed.section(' ', 0, 0).toDouble(&f_ok);
+	if (f_ok && speed > 0.0) {
+		return (maxspeed.contains("mph") ? speed * 1.609344 : speed);
+	}
+	return SPEEDS.value(way.get_tag_map().value("highway"), DEFAULT_SPEED);
+}
+
+int Routing_Graph::get_direction(const Osm_Way& way) {
+	QString oneway = way.get_tag_map().value("oneway");
+
+	if (oneway == "yes" || oneway == "true" || oneway == "1") {
+		return 1;
+	}
+	if (oneway == "-1" || oneway == "reverse") {
+		return -1;
+	}
+	if (!oneway.isEmpty()) {
+		return 0;
+	}
+	/* Implied oneways */
+	if (way.get_tag_map().value("highway") == "motorway" || way.get_tag_map().value("junction") == "roundabout") {
+		return 1;
+	}
+	return 0;
+}
+
+quint64 Routing_Graph::arc_key(int from, int to) {
+	return (static_cast<quint64>(static_cast<quint32>(from)) << 32) | static_cast<quint32>(to);
+}
+
+/* Refreshes the position, the node may have moved since the vertex was made */
+int Routing_Graph::get_vertex(const Osm_Node& node) {
+	auto it = m_node_to_vertex.constFind(node.get_id());
+
+	if (it != m_node_to_vertex.cend()) {
+		m_vertex_lats[it.value()] = node.get_lat();
+		m_vertex_lons[it.value()] = node.get_lon();
+		return it.value();
+	}
+	m_node_to_vertex.insert(node.get_id(), m_vertex_nodes.size());
+	m_vertex_nodes.push_back(node.get_id());
+	m_vertex_lats.push_back(node.get_lat());
+	m_vertex_lons.push_back(node.get_lon());
+	return m_vertex_nodes.size() - 1;
+}
+
+int Routing_Graph::find_vertex(long long id_node) const {
+	if (m_node_uses.value(id_node) < 2) {
+		return -1;
+	}
+	return m_node_to_vertex.value(id_node, -1);
+}
+
+void Routing_Graph::count_uses(const QVector<long long>& nodes, int delta) {
+	auto count = [this, delta](long long id_node) {
+		int		uses = m_node_uses.value(id_node) + delta;
+		bool	f_was_junction = (uses - delta >= 2);
+
+		if (uses > 0) {
+			m_node_uses.insert(id_node, uses);
+		} else {
+			m_node_uses.remove(id_node);
+		}
+		if (f_was_junction != (uses >= 2)) {
+			mn_junctions += (f_was_junction ? -1 : 1);
+		}
+	};
+
+	if (nodes.isEmpty()) {
+		return;
+	}
+	for (auto it = nodes.cbegin(); it != nodes.cend(); ++it) {
+		count(*it);
+	}
+	count(nodes.front());
+	count(nodes.back());
+}
+
+void Routing_Graph::derive_edges(const Osm_Way& way, QVector<Raw_Edge>& raw_edges) {
+	const QList<Osm_Node*>&	nodes = way.get_nodes_list();
+	double					speed = get_speed(way) / 3.6;
+	int						direction = get_direction(way);
+	int						from;
+	int						shape_first = m_shape_nodes.size();
+	double					length = 0.0;
+
+	if (nodes.size() < 2) {
+		return;
+	}
+	from = get_vertex(*nodes.front());
+	m_max_speed = qMax(m_max_speed, speed);
+	for (int i = 1; i < nodes.size(); ++i) {
+		length += Geo::haversine(nodes[i - 1]->get_lat(), nodes[i - 1]->get_lon(), nodes[i]->get_lat(), nodes[i]->get_lon());
+		if (i + 1 < nodes.size() && m_node_uses.value(nodes[i]->get_id()) < 2) {
+			m_shape_nodes.push_back(nodes[i]->get_id());
+			continue;
+		}
+		int			to = get_vertex(*nodes[i]);
+		Edge_Info	info{way.get_id(), shape_first, m_shape_nodes.size() - shape_first, false};
+		if (direction >= 0) {
+			raw_edges.push_back(Raw_Edge{from, to, length / speed, info});
+		}
+		if (direction <= 0) {
+			info.f_reversed = true;
+			raw_edges.push_back(Raw_Edge{to, from, length / speed, info});
+		}
+		from = to;
+		shape_first = m_shape_nodes.size();
+		length = 0.0;
+	}
+}
+
+void Routing_Graph::add_edge(const Raw_Edge& raw_edge) {
+	int edge = m_targets.size();
+
+	m_targets.push_back(raw_edge.target);
+	m_weights.push_back(raw_edge.weight);
+	m_edge_infos.push_back(raw_edge.info);
+	m_retired.push_back(false);
+	if (m_overlay.size() <= raw_edge.source) {
+		m_overlay.resize(m_vertex_nodes.size());
+	}
+	m_overlay[raw_edge.source].push_back(edge);
+	m_way_edges[raw_edge.info.way_id].push_back(edge);
+	mn_overlay++;
+}
+
+void Routing_Graph::retire_edges(long long id_way) {
+	const QVector<int> edges = m_way_edges.take(id_way);
+
+	for (auto it = edges.cbegin(); it != edges.cend(); ++it) {
+		if (!m_retired[*it]) {
+			m_retired[*it] = true;
+			mn_retired++;
+		}
+	}
+}
+
+/* Rederives the edges of a way, and of the ways sharing a node whose
+ * junction status it changed: an inserted node splits their edge there,
+ * a removed one merges the two edges around it */
+void Routing_Graph::sync_way(Osm_Way& way, bool f_routable) {
+	long long				id_way = way.get_id();
+	QVector<long long>		old_nodes = m_way_nodes.take(id_way);
+	QVector<long long>		new_nodes;
+	QHash<long long, bool>	was_junction;
+	QSet<long long>			ways;
+	QVector<Raw_Edge>		raw_edges;
+
+	if (f_routable) {
+		m_ways.insert(id_way, &way);
+		if (way.get_size() >= 2) {
+			for (auto it = way.get_nodes_list().cbegin(); it != way.get_nodes_list().cend(); ++it) {
+				new_nodes.push_back((*it)->get_id());
+			}
+			m_way_nodes.insert(id_way, new_nodes);
+		}
+		ways.insert(id_way);
+	} else {
+		m_ways.remove(id_way);
+	}
+
+	for (auto it = old_nodes.cbegin(); it != old_nodes.cend(); ++it) {
+		was_junction.insert(*it, m_node_uses.value(*it) >= 2);
+		m_node_to_ways.remove(*it, id_way);
+	}
+	for (auto it = new_nodes.cbegin(); it != new_nodes.cend(); ++it) {
+		was_junction.insert(*it, m_node_uses.value(*it) >= 2);
+	}
+	count_uses(old_nodes, -1);
+	count_uses(new_nodes, 1);
+	for (auto it = was_junction.cbegin(); it != was_junction.cend(); ++it) {
+		if (it.value() == (m_node_uses.value(it.key()) >= 2)) {
+			continue;
+		}
+		for (auto it_way = m_node_to_ways.constFind(it.key()); it_way != m_node_to_ways.cend() && it_way.key() == it.key(); ++it_way) {
+			ways.insert(it_way.value());
+		}
+	}
+	for (auto it = new_nodes.cbegin(); it != new_nodes.cend(); ++it) {
+		if (!m_node_to_ways.contains(*it, id_way)) {
+			m_node_to_ways.insert(*it, id_way);
+		}
+	}
+
+	drop_hierarchy();
+	retire_edges(id_way);
+	for (auto it = ways.cbegin(); it != ways.cend(); ++it) {
+		auto it_way = m_ways.constFind(*it);
+		retire_edges(*it);
+		if (it_way != m_ways.cend()) {
+			derive_edges(**it_way, raw_edges);
+		}
+	}
+	for (auto it = raw_edges.cbegin(); it != raw_edges.cend(); ++it) {
+		add_edge(*it);
+	}
+}
+
+void Routing_Graph::drop_hierarchy() {
+	m_ranks.clear();
+	m_ch_arcs.clear();
+	m_ch_arc_index.clear();
+	m_up_offsets.clear();
+	m_up_arcs.clear();
+	m_down_offsets.clear();
+	m_down_arcs.clear();
+}
+
+void Routing_Graph::compact() {
+	if (mp_map != nullptr && mn_retired + mn_overlay > qMax(MIN_COMPACTION, count_edges())) {
+		build(*mp_map);
+	}
+}
+
+/* Calls f for every live edge leaving the vertex, overlay included.
+ * Vertices made since the last build have no CSR range. */
+template <typename F>
+void Routing_Graph::for_each_edge(int vertex, F f) const {
+	if (vertex + 1 < m_offsets.size()) {
+		for (int edge = m_offsets[vertex]; edge < m_offsets[vertex + 1]; ++edge) {
+			if (!m_retired[edge]) {
+				f(edge);
+			}
+		}
+	}
+	if (vertex < m_overlay.size()) {
+		for (auto it = m_overlay[vertex].cbegin(); it != m_overlay[vertex].cend(); ++it) {
+			if (!m_retired[*it]) {
+				f(*it);
+			}
+		}
+	}
+}
+
+Routing_Graph::Path Routing_Graph::make_path(int source, const QVector<int>& edges) const {
+	Path path;
+
+	path.nodes.push_back(m_vertex_nodes[source]);
+	for (auto it = edges.cbegin(); it != edges.cend(); ++it) {
+		const Edge_Info& info = m_edge_infos[*it];
+		if (info.f_reversed) {
+			for (int i = info.shape_first + info.shape_size - 1; i >= info.shape_first; --i) {
+				path.nodes.push_back(m_shape_nodes[i]);
+			}
+		} else {
+			for (int i = info.shape_first; i < info.shape_first + info.shape_size; ++i) {
+				path.nodes.push_back(m_shape_nodes[i]);
+			}
+		}
+		path.nodes.push_back(m_vertex_nodes[m_targets[*it]]);
+		path.cost += m_weights[*it];
+	}
+	return path;
+}
+
+/* Dijkstra, or A* with the straight line at top speed as the estimate */
+Routing_Graph::Path Routing_Graph::search(int source, int target, bool f_a_star) const {
+	const double	INF = std::numeric_limits<double>::infinity();
+	int				n_vertices = m_vertex_nodes.size();
+	QVector<double>	dist(n_vertices, INF);
+	QVector<int>	parent_edges(n_vertices, -1);
+	QVector<int>	parent_vertices(n_vertices, -1);
+	QVector<bool>	settled(n_vertices, false);
+	QVector<int>	edges;
+	Queue			queue;
+	auto			estimate = [&](int vertex) {
+		if (!f_a_star || m_max_speed <= 0.0) {
+			return 0.0;
+		}
+		return Geo::haversine(m_vertex_lats[vertex], m_vertex_lons[vertex],
+		                 m_vertex_lats[target], m_vertex_lons[target]) / m_max_speed;
+	};
+
+	dist[source] = 0.0;
+	queue.push(Queue_Entry(estimate(source), source));
+	while (!queue.empty()) {
+		int vertex = queue.top().second;
+		queue.pop();
+		if (vertex == target) {
+			break;
+		}
+		if (settled[vertex]) {
+			continue;
+		}
+		settled[vertex] = true;
+		for_each_edge(vertex, [&](int edge) {
+			int		next = m_targets[edge];
+			double	next_dist = dist[vertex] + m_weights[edge];
+			if (next_dist < dist[next]) {
+				dist[next] = next_dist;
+				parent_edges[next] = edge;
+				parent_vertices[next] = vertex;
+				queue.push(Queue_Entry(next_dist + estimate(next), next));
+			}
+		});
+	}
+	if (dist[target] == INF) {
+		return Path();
+	}
+	for (int vertex = target; vertex != source; vertex = parent_vertices[vertex]) {
+		edges.push_front(parent_edges[vertex]);
+	}
+	return make_path(source, edges);
+}
+
+/* Bidirectional upward search: forward over arcs to higher ranks from the
+ * source, backward over arcs from higher ranks into the target */
+Routing_Graph::Path Routing_Graph::search_ch(int source, int target) const {
+	const double	INF = std::numeric_limits<double>::infinity();
+	int				n_vertices = m_vertex_nodes.size();
+	QVector<double>	dist[2] = {QVector<double>(n_vertices, INF), QVector<double>(n_vertices, INF)};
+	QVector<int>	parent_arcs[2] = {QVector<int>(n_vertices, -1), QVector<int>(n_vertices, -1)};
+	Queue			queues[2];
+	double			best = INF;
+	int				meeting = -1;
+	QVector<int>	arcs;
+	QVector<int>	edges;
+
+	dist[0][source] = 0.0;
+	dist[1][target] = 0.0;
+	queues[0].push(Queue_Entry(0.0, source));
+	queues[1].push(Queue_Entry(0.0, target));
+	for (;;) {
+		double	tops[2] = {queues[0].empty() ? INF : queues[0].top().first,
+		                   queues[1].empty() ? INF : queues[1].top().first};
+		int		side = (tops[0] <= tops[1] ? 0 : 1);
+		if (qMin(tops[0], tops[1]) >= best) {
+			break;
+		}
+		Queue_Entry entry = queues[side].top();
+		queues[side].pop();
+		int vertex = entry.second;
+		if (entry.first > dist[side][vertex]) {
+			continue;
+		}
+		if (dist[side][vertex] + dist[1 - side][vertex] < best) {
+			best = dist[side][vertex] + dist[1 - side][vertex];
+			meeting = vertex;
+		}
+		const QVector<int>& offsets = (side == 0 ? m_up_offsets : m_down_offsets);
+		const QVector<int>& side_arcs = (side == 0 ? m_up_arcs : m_down_arcs);
+		for (int i = offsets[vertex]; i < offsets[vertex + 1]; ++i) {
+			const Ch_Arc&	arc = m_ch_arcs[side_arcs[i]];
+			int				next = (side == 0 ? arc.to : arc.from);
+			double			next_dist = entry.first + arc.weight;
+			if (next_dist < dist[side][next]) {
+				dist[side][next] = next_dist;
+				parent_arcs[side][next] = side_arcs[i];
+				queues[side].push(Queue_Entry(next_dist, next));
+			}
+		}
+	}
+	if (meeting < 0) {
+		return Path();
+	}
+	for (int vertex = meeting; vertex != source; vertex = m_ch_arcs[parent_arcs[0][vertex]].from) {
+		arcs.push_front(parent_arcs[0][vertex]);
+	}
+	for (int vertex = meeting; vertex != target; vertex = m_ch_arcs[parent_arcs[1][vertex]].to) {
+		arcs.push_back(parent_arcs[1][vertex]);
+	}
+	for (auto it = arcs.cbegin(); it != arcs.cend(); ++it) {
+		unpack(*it, edges);
+	}
+	return make_path(source, edges);
+}
+
+/* Replaces shortcuts by the two arcs around their contracted vertex */
+void Routing_Graph::unpack(int arc, QVector<int>& edges) const {
+	QVector<int> stack;
+
+	stack.push_back(arc);
+	while (!stack.isEmpty()) {
+		const Ch_Arc& top = m_ch_arcs[stack.takeLast()];
+		if (top.mid < 0) {
+			edges.push_back(top.edge);
+			continue;
+		}
+		stack.push_back(m_ch_arc_index.value(arc_key(top.mid, top.to)));
+		stack.push_back(m_ch_arc_index.value(arc_key(top.from, top.mid)));
+	}
+}
+
+/* Keeps one arc per vertex pair, the cheapest. Arcs are only changed while
+ * both ends are uncontracted, so shortcuts never lose their halves. */
+void Routing_Graph::add_arc(Contraction& contraction, int from, int to, double weight, int mid, int edge) {
+	auto it = m_ch_arc_index.constFind(arc_key(from, to));
+
+	if (it != m_ch_arc_index.cend()) {
+		Ch_Arc& arc = m_ch_arcs[it.value()];
+		if (weight < arc.weight) {
+			arc.weight = weight;
+			arc.mid = mid;
+			arc.edge = edge;
+		}
+		return;
+	}
+	m_ch_arc_index.insert(arc_key(from, to), m_ch_arcs.size());
+	contraction.out_arcs[from].push_back(m_ch_arcs.size());
+	contraction.in_arcs[to].push_back(m_ch_arcs.size());
+	m_ch_arcs.push_back(Ch_Arc{from, to, weight, mid, edge});
+}
+
+void Routing_Graph::witness_search(Contraction& contraction, int source, int excluded, double max_cost) {
+	Queue	queue;
+	int		n_settled = 0;
+
+	for (auto it = contraction.touched.cbegin(); it != contraction.touched.cend(); ++it) {
+		contraction.dist[*it] = std::numeric_limits<double>::infinity();
+	}
+	contraction.touched.clear();
+	contraction.dist[source] = 0.0;
+	contraction.touched.push_back(source);
+	queue.push(Queue_Entry(0.0, source));
+	while (!queue.empty() && n_settled < WITNESS_SETTLE_LIMIT) {
+		Queue_Entry entry = queue.top();
+		queue.pop();
+		if (entry.first > contraction.dist[entry.second]) {
+			continue;
+		}
+		if (entry.first > max_cost) {
+			break;
+		}
+		n_settled++;
+		const QVector<int>& arcs = contraction.out_arcs[entry.second];
+		for (auto it = arcs.cbegin(); it != arcs.cend(); ++it) {
+			const Ch_Arc& arc = m_ch_arcs[*it];
+			if (arc.to == excluded || contraction.contracted[arc.to]) {
+				continue;
+			}
+			if (entry.first + arc.weight < contraction.dist[arc.to]) {
+				if (std::isinf(contraction.dist[arc.to])) {
+					contraction.touched.push_back(arc.to);
+				}
+				contraction.dist[arc.to] = entry.first + arc.weight;
+				queue.push(Queue_Entry(contraction.dist[arc.to], arc.to));
+			}
+		}
+	}
+}
+
+/* Number of shortcuts contracting the vertex takes; adds them unless simulating */
+int Routing_Graph::contract_vertex(Contraction& contraction, int vertex, bool f_simulate) {
+	const QVector<int>	in_arcs = contraction.in_arcs[vertex];
+	const QVector<int>	out_arcs = contraction.out_arcs[vertex];
+	int					n_shortcuts = 0;
+
+	for (auto it_in = in_arcs.cbegin(); it_in != in_arcs.cend(); ++it_in) {
+		/* Copies: add_arc may grow m_ch_arcs */
+		Ch_Arc	in_arc = m_ch_arcs[*it_in];
+		double	max_cost = -1.0;
+		if (contraction.contracted[in_arc.from]) {
+			continue;
+		}
+		for (auto it_out = out_arcs.cbegin(); it_out != out_arcs.cend(); ++it_out) {
+			const Ch_Arc& out_arc = m_ch_arcs[*it_out];
+			if (!contraction.contracted[out_arc.to] && out_arc.to != in_arc.from) {
+				max_cost = qMax(max_cost, in_arc.weight + out_arc.weight);
+			}
+		}
+		if (max_cost < 0.0) {
+			continue;
+		}
+		witness_search(contraction, in_arc.from, vertex, max_cost);
+		for (auto it_out = out_arcs.cbegin(); it_out != out_arcs.cend(); ++it_out) {
+			Ch_Arc out_arc = m_ch_arcs[*it_out];
+			double via = in_arc.weight + out_arc.weight;
+			if (contraction.contracted[out_arc.to] || out_arc.to == in_arc.from || contraction.dist[out_arc.to] <= via) {
+				continue;
+			}
+			n_shortcuts++;
+			if (!f_simulate) {
+				add_arc(contraction, in_arc.from, out_arc.to, via, vertex, -1);
+			}
+		}
+	}
+	return n_shortcuts;
+}
+
+/*================================================================*/
+/*                      Protected methods                         */
+/*================================================================*/
+
+void Routing_Graph::handle_event_update(Osm_Way& way) {
+	switch (get_meta()) {
+	case NODE_ADDED:
+	case NODE_DELETED:
+	case NODE_UPDATED:
+		sync_way(way, is_routable(way));
+		compact();
+		break;
+	}
+}
+
+/* No compaction here, the dying way may still be listed in the map */
+void Routing_Graph::handle_event_delete(Osm_Way& way) {
+	if (m_ways.contains(way.get_id())) {
+		sync_way(way, false);
+	}
+}
+
+void Routing_Graph::handle_event_update(Osm_Object&) {
+	QHash<long long, Osm_Way*>	old_ways;
+	Meta::Ids					ids;
+	Osm_Way*					p_way;
+	bool						f_routable;
+
+	switch (get_meta().get_event()) {
+	case MAP_WAY_ADDED:
+		p_way = static_cast<Osm_Way*>(get_meta().get_subject());
+		if (is_routable(*p_way)) {
+			subscribe(*p_way);
+			sync_way(*p_way, true);
+			compact();
+		}
+		break;
+	case MAP_TAGS_UPDATED:
+		ids = get_meta().get_ids();
+		for (auto it = ids.ways.cbegin(); it != ids.ways.cend(); ++it) {
+			if ((p_way = mp_map->get_way(*it)) == nullptr) {
+				continue;
+			}
+			f_routable = is_routable(*p_way);
+			if (f_routable) {
+				subscribe(*p_way);
+			} else if (m_ways.contains(p_way->get_id())) {
+				unsubscribe(*p_way);
+			}
+			sync_way(*p_way, f_routable);
+		}
+		if (!ids.ways.isEmpty()) {
+			compact();
+		}
+		break;
+	case MAP_RELOADED:
+		old_ways = m_ways;
+		build(*mp_map);
+		for (auto it = old_ways.cbegin(); it != old_ways.cend(); ++it) {
+			if (!m_ways.contains(it.key())) {
+				unsubscribe(**it);
+			}
+		}
+		for (auto it = m_ways.cbegin(); it != m_ways.cend(); ++it) {
+			subscribe(**it);
+		}
+		break;
+	case MAP_CLEARED:
+		clear();
+		break;
+	}
+}
+
+void Routing_Graph::handle_event_delete(Osm_Object&) {
+	if (get_meta().get_event() == MAP_DELETED) {
+		mp_map = nullptr;
+	}
+}
+
+/*================================================================*/
+/*                        Public methods                          */
+/*================================================================*/
+
+void Routing_Graph::build(const Osm_Map& map) {
+	QVector<Osm_Way*>	ways;
+	QVector<Raw_Edge>	raw_edges;
+	QVector<int>		cursors;
+
+	clear();
+	for (auto it = map.cwbegin(); it != map.cwend(); ++it) {
+		QVector<long long> nodes;
+		if (!is_routable(**it)) {
+			continue;
+		}
+		ways.push_back(*it);
+		m_ways.insert((*it)->get_id(), *it);
+		if ((*it)->get_size() < 2) {
+			continue;
+		}
+		for (auto it_node = (*it)->get_nodes_list().cbegin(); it_node != (*it)->get_nodes_list().cend(); ++it_node) {
+			nodes.push_back((*it_node)->get_id());
+			if (!m_node_to_ways.contains(nodes.back(), (*it)->get_id())) {
+				m_node_to_ways.insert(nodes.back(), (*it)->get_id());
+			}
+		}
+		count_uses(nodes, 1);
+		m_way_nodes.insert((*it)->get_id(), nodes);
+	}
+	for (auto it = ways.cbegin(); it != ways.cend(); ++it) {
+		derive_edges(**it, raw_edges);
+	}
+
+	/* Counting sort by source */
+	m_offsets.fill(0, m_vertex_nodes.size() + 1);
+	for (auto it = raw_edges.cbegin(); it != raw_edges.cend(); ++it) {
+		m_offsets[it->source + 1]++;
+	}
+	for (int i = 1; i < m_offsets.size(); ++i) {
+		m_offsets[i] += m_offsets[i - 1];
+	}
+	cursors = m_offsets;
+	m_targets.resize(raw_edges.size());
+	m_weights.resize(raw_edges.size());
+	m_edge_infos.resize(raw_edges.size());
+	m_retired.fill(false, raw_edges.size());
+	for (auto it = raw_edges.cbegin(); it != raw_edges.cend(); ++it) {
+		int edge = cursors[it->source]++;
+		m_targets[edge] = it->target;
+		m_weights[edge] = it->weight;
+		m_edge_infos[edge] = it->info;
+		m_way_edges[it->info.way_id].push_back(edge);
+	}
+}
+
+void Routing_Graph::follow(Osm_Map& map) {
+	unfollow();
+	mp_map = &map;
+	subscribe(map);
+	build(map);
+	for (auto it = m_ways.cbegin(); it != m_ways.cend(); ++it) {
+		subscribe(**it);
+	}
+}
+
+/* Keeps the graph as it is */
+void Routing_Graph::unfollow() {
+	unsubscribe();
+	mp_map = nullptr;
+}
+
+bool Routing_Graph::is_following() const {
+	return mp_map != nullptr;
+}
+
+void Routing_Graph::clear() {
+	m_vertex_nodes.clear();
+	m_vertex_lats.clear();
+	m_vertex_lons.clear();
+	m_node_to_vertex.clear();
+	m_offsets.fill(0, 1);
+	m_targets.clear();
+	m_weights.clear();
+	m_edge_infos.clear();
+	m_retired.clear();
+	m_overlay.clear();
+	m_shape_nodes.clear();
+	mn_retired = 0;
+	mn_overlay = 0;
+	mn_junctions = 0;
+	m_max_speed = 0.0;
+	m_ways.clear();
+	m_way_nodes.clear();
+	m_way_edges.clear();
+	m_node_to_ways.clear();
+	m_node_uses.clear();
+	drop_hierarchy();
+}
+
+/* Vertices go in lazily updated edge difference order: shortcuts added,
+ * minus arcs removed, plus already contracted neighbours to spread the
+ * contraction evenly over the map */
+void Routing_Graph::contract() {
+	Contraction		contraction;
+	Queue			queue;
+	int				n_vertices = m_vertex_nodes.size();
+	int				rank = 0;
+	QVector<int>	up_cursors;
+	QVector<int>	down_cursors;
+	auto			priority = [&](int vertex) {
+		int n_arcs = 0;
+		for (auto it = contraction.in_arcs[vertex].cbegin(); it != contraction.in_arcs[vertex].cend(); ++it) {
+			n_arcs += (contraction.contracted[m_ch_arcs[*it].from] ? 0 : 1);
+		}
+		for (auto it = contraction.out_arcs[vertex].cbegin(); it != contraction.out_arcs[vertex].cend(); ++it) {
+			n_arcs += (contraction.contracted[m_ch_arcs[*it].to] ? 0 : 1);
+		}
+		return static_cast<double>(contract_vertex(contraction, vertex, true) - n_arcs +
+		                           contraction.n_contracted_neighbors[vertex]);
+	};
+
+	m_ranks.fill(-1, n_vertices);
+	m_ch_arcs.clear();
+	m_ch_arc_index.clear();
+	contraction.out_arcs.resize(n_vertices);
+	contraction.in_arcs.resize(n_vertices);
+	contraction.contracted.fill(false, n_vertices);
+	contraction.n_contracted_neighbors.fill(0, n_vertices);
+	contraction.dist.fill(std::numeric_limits<double>::infinity(), n_vertices);
+	for (int vertex = 0; vertex < n_vertices; ++vertex) {
+		for_each_edge(vertex, [&](int edge) {
+			if (m_targets[edge] != vertex) {
+				add_arc(contraction, vertex, m_targets[edge], m_weights[edge], -1, edge);
+			}
+		});
+	}
+
+	for (int vertex = 0; vertex < n_vertices; ++vertex) {
+		queue.push(Queue_Entry(priority(vertex), vertex));
+	}
+	while (!queue.empty()) {
+		int vertex = queue.top().second;
+		queue.pop();
+		if (contraction.contracted[vertex]) {
+			continue;
+		}
+		double current = priority(vertex);
+		if (!queue.empty() && current > queue.top().first) {
+			queue.push(Queue_Entry(current, vertex));
+			continue;
+		}
+		contract_vertex(contraction, vertex, false);
+		contraction.contracted[vertex] = true;
+		m_ranks[vertex] = rank++;
+		for (auto it = contraction.in_arcs[vertex].cbegin(); it != contraction.in_arcs[vertex].cend(); ++it) {
+			contraction.n_contracted_neighbors[m_ch_arcs[*it].from]++;
+		}
+		for (auto it = contraction.out_arcs[vertex].cbegin(); it != contraction.out_arcs[vertex].cend(); ++it) {
+			contraction.n_contracted_neighbors[m_ch_arcs[*it].to]++;
+		}
+	}
+
+	/* Split arcs into the upward and downward CSR */
+	m_up_offsets.fill(0, n_vertices + 1);
+	m_down_offsets.fill(0, n_vertices + 1);
+	for (auto it = m_ch_arcs.cbegin(); it != m_ch_arcs.cend(); ++it) {
+		if (m_ranks[it->to] > m_ranks[it->from]) {
+			m_up_offsets[it->from + 1]++;
+		} else {
+			m_down_offsets[it->to + 1]++;
+		}
+	}
+	for (int i = 1; i <= n_vertices; ++i) {
+		m_up_offsets[i] += m_up_offsets[i - 1];
+		m_down_offsets[i] += m_down_offsets[i - 1];
+	}
+	up_cursors = m_up_offsets;
+	down_cursors = m_down_offsets;
+	m_up_arcs.resize(m_up_offsets.back());
+	m_down_arcs.resize(m_down_offsets.back());
+	for (int arc = 0; arc < m_ch_arcs.size(); ++arc) {
+		if (m_ranks[m_ch_arcs[arc].to] > m_ranks[m_ch_arcs[arc].from]) {
+			m_up_arcs[up_cursors[m_ch_arcs[arc].from]++] = arc;
+		} else {
+			m_down_arcs[down_cursors[m_ch_arcs[arc].to]++] = arc;
+		}
+	}
+}
+
+bool Routing_Graph::is_contracted() const {
+	return !m_ranks.isEmpty();
+}
+
+int Routing_Graph::count_vertices() const {
+	return mn_junctions;
+}
+
+int Routing_Graph::count_edges() const {
+	return m_targets.size() - mn_retired;
+}
+
+int Routing_Graph::count_components() const {
+	QVector<int>	parents(m_vertex_nodes.size());
+	QVector<bool>	linked(m_vertex_nodes.size(), false);
+	int				n_components = 0;
+	auto			find_root = [&parents](int vertex) {
+		while (parents[vertex] != vertex) {
+			parents[vertex] = parents[parents[vertex]];
+			vertex = parents[vertex];
+		}
+		return vertex;
+	};
+
+	for (int vertex = 0; vertex < parents.size(); ++vertex) {
+		parents[vertex] = vertex;
+	}
+	for (int vertex = 0; vertex < parents.size(); ++vertex) {
+		for_each_edge(vertex, [&](int edge) {
+			linked[vertex] = true;
+			linked[m_targets[edge]] = true;
+			parents[find_root(vertex)] = find_root(m_targets[edge]);
+		});
+	}
+	for (int vertex = 0; vertex < parents.size(); ++vertex) {
+		if (linked[vertex] && find_root(vertex) == vertex) {
+			n_components++;
+		}
+	}
+	return n_components;
+}
+
+bool Routing_Graph::has_vertex(long long id_node) const {
+	return find_vertex(id_node) >= 0;
+}
+
+long long Routing_Graph::nearest_vertex(double lat, double lon) const {
+	double	best = std::numeric_limits<double>::infinity();
+	int		nearest = -1;
+
+	for (int vertex = 0; vertex < m_vertex_nodes.size(); ++vertex) {
+		double distance = Geo::haversine(lat, lon, m_vertex_lats[vertex], m_vertex_lons[vertex]);
+		if (distance < best && m_node_uses.value(m_vertex_nodes[vertex]) >= 2) {
+			best = distance;
+			nearest = vertex;
+		}
+	}
+	return (nearest < 0 ? 0 : m_vertex_nodes[nearest]);
+}
+
+Routing_Graph::Path Routing_Graph::find_path(long long id_from, long long id_to, Algorithm algorithm) const {
+	int source = find_vertex(id_from);
+	int target = find_vertex(id_to);
+
+	if (source < 0 || target < 0) {
+		return Path();
+	}
+	if (source == target) {
+		return make_path(source, QVector<int>());
+	}
+	switch (algorithm) {
+	case DIJKSTRA:
+		return search(source, target, false);
+	case CONTRACTION_HIERARCHY:
+		if (is_contracted()) {
+			return search_ch(source, target);
+		}
+		/* A* until contract() has run */
+		Q_FALLTHROUGH();
+	case A_STAR:
+	default:
+		return search(source, target, true);
+	}
+}
+
+/*================================================================*/
+/*                     Routing_Graph::Path                        */
+/*================================================================*/
+
+Routing_Graph::Path::Path() {
+	cost = 0.0;
+}
+
+bool Routing_Graph::Path::is_empty() const {
+	return nodes.isEmpty();
+}
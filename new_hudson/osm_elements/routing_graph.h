@@ -0,0 +1,179 @@
+#ifndef ROUTING_GRAPH_H
+#define ROUTING_GRAPH_H
+
+#ifndef QT_CORE_H
+#define QT_CORE_H
+#include <QtCore>
+#endif /* Include guard QT_CORE_H */
+
+#ifndef ALGORITHM_H
+#define ALGORITHM_H
+#include <algorithm>
+#endif /* Include guard ALGORITHM_H */
+
+#ifndef CMATH_H
+#define CMATH_H
+#include <cmath>
+#endif /* Include guard CMATH_H */
+
+#ifndef LIMITS_H
+#define LIMITS_H
+#include <limits>
+#endif /* Include guard LIMITS_H */
+
+#ifndef QUEUE_H
+#define QUEUE_H
+#include <queue>
+#endif /* Include guard QUEUE_H */
+
+#ifndef VECTOR_H
+#define VECTOR_H
+#include <vector>
+#endif /* Include guard VECTOR_H */
+
+#ifndef FUNCTIONAL_H
+#define FUNCTIONAL_H
+#include <functional>
+#endif /* Include guard FUNCTIONAL_H */
+
+#include "osm_map.h"
+#include "geo.h"
+
+namespace ns_osm {
+
+/* Directed routing graph over the highway ways of a map, in CSR form.
+ * Vertices are way ends and nodes shared between ways; the nodes between
+ * two vertices only survive as the edge's shape. Edge weights are travel
+ * times in seconds: haversine length over a speed taken from maxspeed or
+ * the highway class. contract() adds a contraction hierarchy for fast
+ * repeated queries; it is dropped by the next build() or edit.
+ *
+ * After follow(), edits to the map are patched in: the edges of a changed
+ * way, and of ways whose junctions it changed, are retired and rederived
+ * into an overlay next to the CSR arrays. The CSR is rebuilt once retired
+ * and overlay edges outnumber the live ones. */
+class Routing_Graph : public Osm_Subscriber {
+public:
+	enum Algorithm {DIJKSTRA, A_STAR, CONTRACTION_HIERARCHY};
+	struct Path;
+private:
+	struct Edge_Info {
+		long long	way_id;
+		int			shape_first; /* Into m_shape_nodes, way order */
+		int			shape_size;
+		bool		f_reversed;
+	};
+	struct Raw_Edge {
+		int			source;
+		int			target;
+		double		weight;
+		Edge_Info	info;
+	};
+	struct Ch_Arc {
+		int			from;
+		int			to;
+		double		weight;
+		int			mid;  /* Contracted vertex of a shortcut, -1 for an edge */
+		int			edge; /* Graph edge of a plain arc */
+	};
+	struct Contraction;
+	typedef std::pair<double, int>											Queue_Entry;
+	typedef std::priority_queue<Queue_Entry, std::vector<Queue_Entry>, std::greater<Queue_Entry>> Queue;
+
+	static const double						DEFAULT_SPEED; /* km/h */
+	static const int						WITNESS_SETTLE_LIMIT;
+	static const int						MIN_COMPACTION; /* Stale edges tolerated on any graph */
+	Osm_Map*								mp_map; /* Followed map, nullptr for a snapshot */
+	QVector<long long>						m_vertex_nodes;
+	QVector<double>							m_vertex_lats;
+	QVector<double>							m_vertex_lons;
+	QHash<long long, int>					m_node_to_vertex;
+	QVector<int>							m_offsets; /* CSR edges of v are [m_offsets[v], m_offsets[v + 1]) */
+	QVector<int>							m_targets;
+	QVector<double>							m_weights;
+	QVector<Edge_Info>						m_edge_infos;
+	QVector<bool>							m_retired;
+	QVector<QVector<int>>					m_overlay; /* Per vertex, edges added since the last build */
+	QVector<long long>						m_shape_nodes;
+	int										mn_retired;
+	int										mn_overlay;
+	int										mn_junctions; /* Nodes used twice, the live vertices */
+	double									m_max_speed; /* m/s, keeps the A* estimate admissible */
+	QHash<long long, Osm_Way*>				m_ways; /* Routable ways */
+	QHash<long long, QVector<long long>>	m_way_nodes; /* Node ids as of the last sync */
+	QHash<long long, QVector<int>>			m_way_edges;
+	QMultiHash<long long, long long>		m_node_to_ways;
+	QHash<long long, int>					m_node_uses; /* Way ends count twice, so they become vertices */
+	QVector<int>							m_ranks; /* Empty unless contracted */
+	QVector<Ch_Arc>							m_ch_arcs;
+	QHash<quint64, int>						m_ch_arc_index; /* from, to -> arc */
+	QVector<int>							m_up_offsets;
+	QVector<int>							m_up_arcs;	 /* Arcs to higher ranks, by from */
+	QVector<int>							m_down_offsets;
+	QVector<int>							m_down_arcs; /* Arcs from higher ranks, by to */
+
+	static bool								is_routable		(const Osm_Way&);
+	static double							get_speed		(const Osm_Way&); /* km/h */
+	static int								get_direction	(const Osm_Way&); /* 1 forward, -1 backward, 0 both */
+	static quint64							arc_key			(int from, int to);
+	int										get_vertex		(const Osm_Node&);
+	void									count_uses		(const QVector<long long>& nodes, int delta);
+	void									derive_edges	(const Osm_Way&, QVector<Raw_Edge>&);
+	void									add_edge		(const Raw_Edge&); /* Into the overlay */
+	void									retire_edges	(long long id_way);
+	void									sync_way		(Osm_Way&, bool f_routable);
+	void									drop_hierarchy	();
+	void									compact			(); /* Rebuilds once stale edges dominate */
+	int										find_vertex		(long long id_node) const; /* -1 unless live */
+	template <typename F>
+	void									for_each_edge	(int vertex, F f) const;
+	Path									make_path		(int source, const QVector<int>& edges) const;
+	Path									search			(int source, int target, bool f_a_star) const;
+	Path									search_ch		(int source, int target) const;
+	void									unpack			(int arc, QVector<int>& edges) const;
+	void									add_arc			(Contraction&, int from, int to, double weight, int mid, int edge);
+	void									witness_search	(Contraction&, int source, int excluded, double max_cost);
+	int										contract_vertex	(Contraction&, int vertex, bool f_simulate);
+protected:
+	void									handle_event_update	(Osm_Way&) override;
+	void									handle_event_delete	(Osm_Way&) override;
+	void									handle_event_update	(Osm_Object&) override;
+	void									handle_event_delete	(Osm_Object&) override;
+public:
+	void									build			(const Osm_Map&);
+	void									follow			(Osm_Map&); /* Builds, then tracks edits */
+	void									unfollow		();
+	bool									is_following	() const;
+	void									clear			();
+	void									contract		();
+	bool									is_contracted	() const;
+	int										count_vertices	() const;
+	int										count_edges		() const; /* Live edges */
+	int										count_components() const; /* Weakly connected, vertices with edges only */
+	bool									has_vertex		(long long id_node) const;
+	long long								nearest_vertex	(double lat, double lon) const; /* Node id, 0 if empty */
+	Path									find_path		(long long id_from,
+	                                                         long long id_to,
+	                                                         Algorithm = DIJKSTRA) const; /* Between vertices */
+	                                        Routing_Graph	();
+											Routing_Graph	(const Osm_Map&);
+											Routing_Graph	(const Routing_Graph&) = delete;
+	Routing_Graph&							operator=		(const Routing_Graph&) = delete;
+	virtual									~Routing_Graph	();
+};
+
+/*================================================================*/
+/*                     Routing_Graph::Path                        */
+/*================================================================*/
+
+struct Routing_Graph::Path {
+	QVector<long long>	nodes; /* Every node passed, shape nodes included */
+	double				cost;  /* Seconds */
+
+	bool				is_empty	() const;
+	                    Path		();
+};
+
+}
+
+#endif // ROUTING_GRAPH_H
@@ -0,0 +1,150 @@
+#ifndef SHARED_TABLE_H
+#define SHARED_TABLE_H
+
+#ifndef QT_CORE_H
+#define QT_CORE_H
+#include <QtCore>
+#endif /* Include guard QT_CORE_H */
+
+namespace ns_osm {
+
+/* Id-keyed table whose copies share structure. Items sit in small hashes
+ * reached through two levels of FAN_OUT-wide vectors, all of them Qt
+ * implicitly shared containers. Copying a table costs a reference; the
+ * first change to a copy then detaches only the path down to the changed
+ * item: two vectors of FAN_OUT handles and one hash of count() / FAN_OUT²
+ * items on average. Copies can be read on other threads while the
+ * original keeps changing. */
+template <typename T>
+class Shared_Table {
+private:
+	static const int						FAN_OUT = 256;
+	typedef QHash<long long, T>				Shard;
+	typedef QVector<Shard>					Page;
+	QVector<Page>							m_pages; /* Empty until the first insert; so is each page */
+	int										mn_items;
+
+	static quint64							get_hash		(long long id);
+	const Shard*							find_shard		(long long id) const;
+	Shard&									get_shard		(long long id); /* Detaches the path */
+public:
+	int										count			() const;
+	bool									contains		(long long id) const;
+	T										value			(long long id) const; /* T() when absent */
+	void									insert			(long long id, const T&);
+	bool									remove			(long long id);
+	void									clear			();
+	template <typename F> void				for_each		(F f) const; /* f(const T&), in no set order */
+	                                        Shared_Table	();
+};
+
+/*================================================================*/
+/*                  Constructors, destructors                     */
+/*================================================================*/
+
+template <typename T>
+Shared_Table<T>::Shared_Table() {
+	mn_items = 0;
+}
+
+/*================================================================*/
+/*                       Private methods                          */
+/*================================================================*/
+
+/* Fibonacci hashing spreads the runs of consecutive ids */
+template <typename T>
+quint64 Shared_Table<T>::get_hash(long long id) {
+	return static_cast<quint64>(id) * Q_UINT64_C(0x9E3779B97F4A7C15);
+}
+
+template <typename T>
+const typename Shared_Table<T>::Shard* Shared_Table<T>::find_shard(long long id) const {
+	quint64 hash = get_hash(id);
+
+	if (m_pages.isEmpty()) {
+		return nullptr;
+	}
+	const Page& page = m_pages.at(static_cast<int>(hash >> 56));
+	if (page.isEmpty()) {
+		return nullptr;
+	}
+	return &page.at(static_cast<int>((hash >> 48) & 0xFF));
+}
+
+template <typename T>
+typename Shared_Table<T>::Shard& Shared_Table<T>::get_shard(long long id) {
+	quint64 hash = get_hash(id);
+
+	if (m_pages.isEmpty()) {
+		m_pages.resize(FAN_OUT);
+	}
+	Page& page = m_pages[static_cast<int>(hash >> 56)];
+	if (page.isEmpty()) {
+		page.resize(FAN_OUT);
+	}
+	return page[static_cast<int>((hash >> 48) & 0xFF)];
+}
+
+/*================================================================*/
+/*                        Public methods                          */
+/*================================================================*/
+
+template <typename T>
+int Shared_Table<T>::count() const {
+	return mn_items;
+}
+
+template <typename T>
+bool Shared_Table<T>::contains(long long id) const {
+	const Shard* p_shard = find_shard(id);
+
+	return p_shard != nullptr && p_shard->contains(id);
+}
+
+template <typename T>
+T Shared_Table<T>::value(long long id) const {
+	const Shard* p_shard = find_shard(id);
+
+	return p_shard != nullptr ? p_shard->value(id) : T();
+}
+
+template <typename T>
+void Shared_Table<T>::insert(long long id, const T& item) {
+	Shard&	shard = get_shard(id);
+	int		n_before = shard.size();
+
+	shard.insert(id, item);
+	mn_items += shard.size() - n_before;
+}
+
+template <typename T>
+bool Shared_Table<T>::remove(long long id) {
+	if (!contains(id)) {
+		return false;
+	}
+	get_shard(id).remove(id);
+	--mn_items;
+	return true;
+}
+
+template <typename T>
+void Shared_Table<T>::clear() {
+	m_pages.clear();
+	mn_items = 0;
+}
+
+template <typename T>
+template <typename F>
+void Shared_Table<T>::for_each(F f) const {
+	for (const Page& page : m_pages) {
+		for (const Shard& shard : page) {
+			for (auto it = shard.cbegin(); it != shard.cend(); ++it) {
+				f(it.value());
+			}
+		}
+	}
+}
+
+}
+
+#endif // SHARED_TABLE_H
@@ -0,0 +1,27 @@
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#ifndef QT_CORE_H
+#define QT_CORE_H
+#include <QtCore>
+#endif /* Include guard QT_CORE_H */
+
+namespace ns_osm {
+
+class Osm_Node;
+class Osm_Way;
+
+/* Spatial lookup a map view can lend to map-level algorithms. Results may
+ * be a superset of the exact answer; callers recheck the geometry. */
+class Spatial_Index {
+public:
+	/* geo_rect: x is longitude, y is latitude. Ways are those with a node inside. */
+	virtual void			find			(const QRectF& geo_rect,
+	                                         QVector<Osm_Node*>& nodes,
+	                                         QVector<Osm_Way*>& ways) = 0;
+	virtual					~Spatial_Index	() = default;
+};
+
+}
+
+#endif // SPATIAL_INDEX_H
@@ -0,0 +1,234 @@
+#include "tag_index.h"
+
+using namespace ns_osm;
+
+/*================================================================*/
+/*                          Class Id_Set                          */
+/*================================================================*/
+
+void Id_Set::insert(long long id) {
+	auto it = std::lower_bound(m_ids.begin(), m_ids.end(), id);
+
+	if (it == m_ids.end() || *it != id) {
+		m_ids.insert(it, id);
+	}
+}
+
+void Id_Set::remove(long long id) {
+	auto it = std::lower_bound(m_ids.begin(), m_ids.end(), id);
+
+	if (it != m_ids.end() && *it == id) {
+		m_ids.erase(it);
+	}
+}
+
+void Id_Set::stage(long long id, bool f_present) {
+	m_pending.insert(id, f_present);
+}
+
+void Id_Set::merge() {
+	QVector<long long> added;
+	QVector<long long> removed;
+	QVector<long long> merged;
+
+	if (m_pending.isEmpty()) {
+		return;
+	}
+	for (auto it = m_pending.cbegin(); it != m_pending.cend(); ++it) {
+		(it.value() ? added : removed).push_back(it.key());
+	}
+	m_pending.clear();
+	std::sort(added.begin(), added.end());
+	std::sort(removed.begin(), removed.end());
+
+	merged.reserve(m_ids.size() + added.size());
+	std::set_union(m_ids.cbegin(), m_ids.cend(), added.cbegin(), added.cend(), std::back_inserter(merged));
+	m_ids.clear();
+	std::set_difference(merged.cbegin(), merged.cend(), removed.cbegin(), removed.cend(), std::back_inserter(m_ids));
+}
+
+const QVector<long long>& Id_Set::get_ids() const {
+	return m_ids;
+}
+
+bool Id_Set::is_empty() const {
+	return m_ids.isEmpty();
+}
+
+/*================================================================*/
+/*                     Tag_Index::Postings                        */
+/*================================================================*/
+
+bool Tag_Index::Postings::is_empty() const {
+	for (int kind = 0; kind < KIND_COUNT; ++kind) {
+		if (!ids[kind].is_empty()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*================================================================*/
+/*                  Constructors, destructors                     */
+/*================================================================*/
+
+Tag_Index::Tag_Index() {
+	mn_batches = 0;
+}
+
+Tag_Index::~Tag_Index() {}
+
+/*================================================================*/
+/*                       Private methods                          */
+/*================================================================*/
+
+void Tag_Index::edit(Id_Set& ids, long long id, bool f_present) {
+	if (mn_batches > 0) {
+		ids.stage(id, f_present);
+		m_staged.insert(&ids);
+	} else if (f_present) {
+		ids.insert(id);
+	} else {
+		ids.remove(id);
+	}
+}
+
+/* Never while a batch is open: staged sets are pointed to */
+void Tag_Index::prune(const QString& key, const QString& value) {
+	auto it_values = m_by_tag.find(key);
+
+	if (it_values != m_by_tag.end()) {
+		auto it_value = it_values.value().find(value);
+		if (it_value != it_values.value().end() && it_value.value().is_empty()) {
+			it_values.value().erase(it_value);
+		}
+		if (it_values.value().isEmpty()) {
+			m_by_tag.erase(it_values);
+		}
+	}
+	auto it_key = m_by_key.find(key);
+	if (it_key != m_by_key.end() && it_key.value().is_empty()) {
+		m_by_key.erase(it_key);
+	}
+}
+
+const QVector<long long>& Tag_Index::get_empty() {
+	static const QVector<long long> empty;
+	return empty;
+}
+
+/*================================================================*/
+/*                        Public methods                          */
+/*================================================================*/
+
+void Tag_Index::begin_batch() {
+	mn_batches++;
+}
+
+void Tag_Index::end_batch() {
+	if (mn_batches == 0 || --mn_batches > 0) {
+		return;
+	}
+	for (auto it = m_staged.cbegin(); it != m_staged.cend(); ++it) {
+		(*it)->merge();
+	}
+	m_staged.clear();
+	for (auto it = m_emptied.cbegin(); it != m_emptied.cend(); ++it) {
+		prune(it->first, it->second);
+	}
+	m_emptied.clear();
+}
+
+void Tag_Index::insert(Kind kind, long long id, const QString& key, const QString& value) {
+	edit(m_by_key[key].ids[kind], id, true);
+	edit(m_by_tag[key][value].ids[kind], id, true);
+}
+
+void Tag_Index::remove(Kind kind, long long id, const QString& key, const QString& value) {
+	auto it_key = m_by_key.find(key);
+	if (it_key != m_by_key.end()) {
+		edit(it_key.value().ids[kind], id, false);
+	}
+	auto it_values = m_by_tag.find(key);
+	if (it_values == m_by_tag.end()) {
+		return;
+	}
+	auto it_value = it_values.value().find(value);
+	if (it_value != it_values.value().end()) {
+		edit(it_value.value().ids[kind], id, false);
+	}
+	if (mn_batches > 0) {
+		m_emptied.insert(qMakePair(key, value));
+	} else {
+		prune(key, value);
+	}
+}
+
+const QVector<long long>& Tag_Index::find(Kind kind, const QString& key) const {
+	auto it_key = m_by_key.constFind(key);
+
+	if (it_key == m_by_key.cend()) {
+		return get_empty();
+	}
+	return it_key.value().ids[kind].get_ids();
+}
+
+const QVector<long long>& Tag_Index::find(Kind kind, const QString& key, const QString& value) const {
+	auto it_values = m_by_tag.constFind(key);
+
+	if (it_values == m_by_tag.cend()) {
+		return get_empty();
+	}
+	auto it_value = it_values.value().constFind(value);
+	if (it_value == it_values.value().cend()) {
+		return get_empty();
+	}
+	return it_value.value().ids[kind].get_ids();
+}
+
+QStringList Tag_Index::get_keys() const {
+	QStringList keys;
+
+	for (auto it = m_by_key.cbegin(); it != m_by_key.cend(); ++it) {
+		for (int kind = 0; kind < KIND_COUNT; ++kind) {
+			if (!it.value().ids[kind].is_empty()) {
+				keys.push_back(it.key());
+				break;
+			}
+		}
+	}
+	return keys;
+}
+
+QStringList Tag_Index::get_values(const QString& key) const {
+	QStringList values;
+	auto it_values = m_by_tag.constFind(key);
+
+	if (it_values == m_by_tag.cend()) {
+		return values;
+	}
+	for (auto it = it_values.value().cbegin(); it != it_values.value().cend(); ++it) {
+		for (int kind = 0; kind < KIND_COUNT; ++kind) {
+			if (!it.value().ids[kind].is_empty()) {
+				values.push_back(it.key());
+				break;
+			}
+		}
+	}
+	return values;
+}
+
+void Tag_Index::clear() {
+	m_by_key.clear();
+	m_by_tag.clear();
+	m_staged.clear();
+	m_emptied.clear();
+}
+
+void Tag_Index::swap(Tag_Index& other) {
+	m_by_key.swap(other.m_by_key);
+	m_by_tag.swap(other.m_by_tag);
+	m_staged.swap(other.m_staged);
+	m_emptied.swap(other.m_emptied);
+	qSwap(mn_batches, other.mn_batches);
+}
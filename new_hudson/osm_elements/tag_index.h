@@ -0,0 +1,84 @@
+#ifndef TAG_INDEX_H
+#define TAG_INDEX_H
+
+#ifndef QT_CORE_H
+#define QT_CORE_H
+#include <QtCore>
+#endif /* Include guard QT_CORE_H */
+
+#ifndef ALGORITHM_H
+#define ALGORITHM_H
+#include <algorithm>
+#endif /* Include guard ALGORITHM_H */
+
+namespace ns_osm {
+
+/*================================================================*/
+/*                          Class Id_Set                          */
+/*================================================================*/
+
+/* Sorted id vector. insert and remove apply at once; staged edits wait for
+ * merge, so retagging many elements costs O(k log k) instead of O(n) per id.
+ * Reads never modify the set. */
+class Id_Set {
+	friend class Osm_Map;
+private:
+	QVector<long long>								m_ids;
+	QHash<long long, bool>							m_pending; /* id -> present after the edit */
+public:
+	void											insert			(long long id);
+	void											remove			(long long id);
+	void											stage			(long long id, bool f_present);
+	void											merge			();
+	const QVector<long long>&						get_ids			() const; /* Staged edits not included */
+	bool											is_empty		() const;
+};
+
+/*================================================================*/
+/*                        Class Tag_Index                         */
+/*================================================================*/
+
+/* Inverted index from tag key and from key=value to the ids of the
+ * elements carrying them. Ids are kept per element kind, since OSM ids
+ * are only unique within a kind. A key or value no element carries any
+ * more is dropped. */
+class Tag_Index {
+	friend class Osm_Map;
+public:
+	enum Kind {NODE, WAY, RELATION, KIND_COUNT};
+private:
+	struct Postings {
+		Id_Set	ids[KIND_COUNT];
+		bool	is_empty() const;
+	};
+	QHash<QString, Postings>						m_by_key;
+	QHash<QString, QHash<QString, Postings>>		m_by_tag; /* key -> value -> ids */
+	int												mn_batches;
+	QSet<Id_Set*>									m_staged; /* QHash nodes stay put on rehash */
+	QSet<QPair<QString, QString>>					m_emptied; /* Key and value of staged removals, pruned after the merge */
+
+	void											edit			(Id_Set&, long long id, bool f_present);
+	void											prune			(const QString& key, const QString& value);
+	static const QVector<long long>&				get_empty		();
+public:
+	/* Between these, edits are staged and each touched set merged once at the
+	 * end. Lookups are plain reads, safe from many threads while nobody writes */
+	void											begin_batch		();
+	void											end_batch		();
+	void											insert			(Kind, long long id, const QString& key, const QString& value);
+	void											remove			(Kind, long long id, const QString& key, const QString& value);
+	const QVector<long long>&						find			(Kind, const QString& key) const; /* Sorted */
+	const QVector<long long>&						find			(Kind, const QString& key, const QString& value) const;
+	QStringList										get_keys		() const;
+	QStringList										get_values		(const QString& key) const;
+	void											clear			();
+	void											swap			(Tag_Index&);
+	                                                Tag_Index		();
+													Tag_Index		(const Tag_Index&) = delete;
+	Tag_Index&										operator=		(const Tag_Index&) = delete;
+	virtual											~Tag_Index		();
+};
+
+}
+
+#endif // TAG_INDEX_H
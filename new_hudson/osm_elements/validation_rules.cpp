@@ -0,0 +1,244 @@
+#include "validation_rules.h"
+
+using namespace ns_osm;
+
+/*================================================================*/
+/*                     Duplicate_Node_Rule                        */
+/*================================================================*/
+
+QString Duplicate_Node_Rule::get_name() const {
+	return "duplicate_node";
+}
+
+void Duplicate_Node_Rule::check(const Validator::Partition& partition, QVector<Validator::Issue>& issues) const {
+	QHash<QPair<qint64, qint64>, QVector<long long>> positions;
+
+	for (auto it = partition.nodes.cbegin(); it != partition.nodes.cend(); ++it) {
+		positions[qMakePair(qRound64((*it)->get_lat() * 1e7), qRound64((*it)->get_lon() * 1e7))].push_back((*it)->get_id());
+	}
+	for (auto it = positions.cbegin(); it != positions.cend(); ++it) {
+		if (it.value().size() < 2) {
+			continue;
+		}
+		Validator::Issue issue;
+		issue.rule = get_name();
+		issue.message = QString("%1 nodes at the same position").arg(it.value().size());
+		issue.nodes = it.value();
+		std::sort(issue.nodes.begin(), issue.nodes.end());
+		issue.lat = it.key().first / 1e7;
+		issue.lon = it.key().second / 1e7;
+		issues.push_back(issue);
+	}
+}
+
+/*================================================================*/
+/*                   Self_Intersection_Rule                       */
+/*================================================================*/
+
+QString Self_Intersection_Rule::get_name() const {
+	return "self_intersection";
+}
+
+/* Sweep over the segments sorted by their west end */
+void Self_Intersection_Rule::check(const Validator::Partition& partition, QVector<Validator::Issue>& issues) const {
+	for (auto it = partition.ways.cbegin(); it != partition.ways.cend(); ++it) {
+		const QList<Osm_Node*>&	nodes = (*it)->get_nodes_list();
+		QVector<int>			order;
+		int						n_crossings = 0;
+		QPointF					first_at;
+		QPointF					at;
+		auto					west = [&nodes](int segment) {
+			return qMin(nodes[segment]->get_lon(), nodes[segment + 1]->get_lon());
+		};
+		auto					east = [&nodes](int segment) {
+			return qMax(nodes[segment]->get_lon(), nodes[segment + 1]->get_lon());
+		};
+
+		if (nodes.size() < 4) {
+			continue;
+		}
+		for (int i = 0; i + 1 < nodes.size(); ++i) {
+			order.push_back(i);
+		}
+		std::sort(order.begin(), order.end(), [&west](int first, int second) {
+			return west(first) < west(second);
+		});
+		for (int i = 0; i < order.size(); ++i) {
+			for (int j = i + 1; j < order.size() && west(order[j]) <= east(order[i]); ++j) {
+				if (is_crossing(get_pos(*nodes[order[i]]), get_pos(*nodes[order[i] + 1]),
+				                get_pos(*nodes[order[j]]), get_pos(*nodes[order[j] + 1]), at)) {
+					first_at = (n_crossings == 0 ? at : first_at);
+					n_crossings++;
+				}
+			}
+		}
+		if (n_crossings == 0) {
+			continue;
+		}
+		Validator::Issue issue;
+		issue.rule = get_name();
+		issue.message = QString("Way crosses itself %1 time(s)").arg(n_crossings);
+		issue.ways.push_back((*it)->get_id());
+		issue.lat = first_at.y();
+		issue.lon = first_at.x();
+		issues.push_back(issue);
+	}
+}
+
+/*================================================================*/
+/*                   Crossing_Highways_Rule                       */
+/*================================================================*/
+
+bool Crossing_Highways_Rule::is_highway(const Osm_Way& way) {
+	return way.get_tag_map().contains("highway") && way.get_tag_map().value("area") != "yes";
+}
+
+QString Crossing_Highways_Rule::get_level(const Osm_Way& way) {
+	QString level = way.get_tag_map().value("layer", "0");
+
+	if (way.get_tag_map().value("bridge", "no") != "no") {
+		level += "b";
+	}
+	if (way.get_tag_map().value("tunnel", "no") != "no") {
+		level += "t";
+	}
+	return level;
+}
+
+QString Crossing_Highways_Rule::get_name() const {
+	return "crossing_highways";
+}
+
+void Crossing_Highways_Rule::check(const Validator::Partition& partition, QVector<Validator::Issue>& issues) const {
+	QVector<Validator::Segment>			segments;
+	QHash<const Osm_Way*, QString>		levels;
+	QPointF								at;
+	auto								get_node = [](const Validator::Segment& segment, int offset) {
+		return segment.p_way->get_nodes_list()[segment.index + offset];
+	};
+	auto								west = [&get_node](const Validator::Segment& segment) {
+		return qMin(get_node(segment, 0)->get_lon(), get_node(segment, 1)->get_lon());
+	};
+	auto								east = [&get_node](const Validator::Segment& segment) {
+		return qMax(get_node(segment, 0)->get_lon(), get_node(segment, 1)->get_lon());
+	};
+
+	for (auto it = partition.segments.cbegin(); it != partition.segments.cend(); ++it) {
+		if (levels.contains(it->p_way)) {
+			segments.push_back(*it);
+		} else if (is_highway(*it->p_way)) {
+			levels.insert(it->p_way, get_level(*it->p_way));
+			segments.push_back(*it);
+		}
+	}
+	std::sort(segments.begin(), segments.end(), [&west](const Validator::Segment& first, const Validator::Segment& second) {
+		return west(first) < west(second);
+	});
+	for (int i = 0; i < segments.size(); ++i) {
+		const Validator::Segment& first = segments[i];
+		for (int j = i + 1; j < segments.size() && west(segments[j]) <= east(first); ++j) {
+			const Validator::Segment& second = segments[j];
+			if (first.p_way == second.p_way || levels.value(first.p_way) != levels.value(second.p_way)) {
+				continue;
+			}
+			if (!is_crossing(get_pos(*get_node(first, 0)), get_pos(*get_node(first, 1)),
+			                 get_pos(*get_node(second, 0)), get_pos(*get_node(second, 1)), at)
+			        || !partition.owns(at.y(), at.x())) {
+				continue;
+			}
+			Validator::Issue issue;
+			issue.rule = get_name();
+			issue.message = "Highways cross without a junction";
+			issue.ways.push_back(qMin(first.p_way->get_id(), second.p_way->get_id()));
+			issue.ways.push_back(qMax(first.p_way->get_id(), second.p_way->get_id()));
+			issue.lat = at.y();
+			issue.lon = at.x();
+			issues.push_back(issue);
+		}
+	}
+}
+
+/*================================================================*/
+/*                       Way_Limits_Rule                          */
+/*================================================================*/
+
+QString Way_Limits_Rule::get_name() const {
+	return "way_limits";
+}
+
+void Way_Limits_Rule::check(const Validator::Partition& partition, QVector<Validator::Issue>& issues) const {
+	for (auto it = partition.ways.cbegin(); it != partition.ways.cend(); ++it) {
+		Validator::Issue issue;
+		issue.severity = Validator::ERROR;
+		issue.rule = get_name();
+		issue.ways.push_back((*it)->get_id());
+		if (!(*it)->get_nodes_list().isEmpty()) {
+			issue.lat = (*it)->get_nodes_list().front()->get_lat();
+			issue.lon = (*it)->get_nodes_list().front()->get_lon();
+		}
+		if ((*it)->get_size() >= (*it)->get_capacity()) {
+			issue.message = QString("Way is at its capacity of %1 nodes").arg((*it)->get_capacity());
+		} else if ((*it)->get_size() < 2) {
+			issue.message = "Way has fewer than two nodes";
+		} else if (!(*it)->is_valid()) {
+			issue.message = "Way refused a node";
+		} else {
+			continue;
+		}
+		issues.push_back(issue);
+	}
+}
+
+/*================================================================*/
+/*                    Relation_Members_Rule                       */
+/*================================================================*/
+
+QString Relation_Members_Rule::get_name() const {
+	return "relation_members";
+}
+
+void Relation_Members_Rule::check(const Validator::Partition& partition, QVector<Validator::Issue>& issues) const {
+	for (auto it = partition.relations.cbegin(); it != partition.relations.cend(); ++it) {
+		const Osm_Relation&	relation = **it;
+		Validator::Issue	issue;
+		QStringList			missing;
+
+		issue.severity = Validator::ERROR;
+		issue.rule = get_name();
+		issue.relations.push_back(relation.get_id());
+		if (!relation.get_nodes().isEmpty()) {
+			issue.lat = relation.get_nodes().front()->get_lat();
+			issue.lon = relation.get_nodes().front()->get_lon();
+		}
+		for (auto it_node = relation.get_nodes().cbegin(); it_node != relation.get_nodes().cend(); ++it_node) {
+			if (!partition.p_map->has(*it_node)) {
+				issue.nodes.push_back((*it_node)->get_id());
+			}
+		}
+		for (auto it_way = relation.get_ways().cbegin(); it_way != relation.get_ways().cend(); ++it_way) {
+			if (!partition.p_map->has(*it_way)) {
+				issue.ways.push_back((*it_way)->get_id());
+			}
+		}
+		for (auto it_rel = relation.get_relations().cbegin(); it_rel != relation.get_relations().cend(); ++it_rel) {
+			if (!partition.p_map->has(*it_rel)) {
+				issue.relations.push_back((*it_rel)->get_id());
+			}
+		}
+		if (issue.nodes.size() + issue.ways.size() + issue.relations.size() > 1) {
+			issue.message = QString("%1 member(s) not in the map")
+			                .arg(issue.nodes.size() + issue.ways.size() + issue.relations.size() - 1);
+			std::sort(issue.nodes.begin(), issue.nodes.end());
+			std::sort(issue.ways.begin(), issue.ways.end());
+			std::sort(issue.relations.begin(), issue.relations.end());
+		} else if (relation.get_size() == 0) {
+			issue.severity = Validator::WARNING;
+			issue.message = "Relation has no members";
+		} else if (!relation.is_valid()) {
+			issue.message = "Relation is marked invalid";
+		} else {
+			continue;
+		}
+		issues.push_back(issue);
+	}
+}
@@ -0,0 +1,48 @@
+#ifndef VALIDATION_RULES_H
+#define VALIDATION_RULES_H
+
+#include "validator.h"
+
+namespace ns_osm {
+
+/* Distinct nodes at the same position, to 1e-7 degrees */
+class Duplicate_Node_Rule : public Validator::Rule {
+public:
+	QString		get_name	() const override;
+	void		check		(const Validator::Partition&, QVector<Validator::Issue>&) const override;
+};
+
+/* Ways crossing themselves, one issue per way */
+class Self_Intersection_Rule : public Validator::Rule {
+public:
+	QString		get_name	() const override;
+	void		check		(const Validator::Partition&, QVector<Validator::Issue>&) const override;
+};
+
+/* Highways crossing on the same layer without a shared node */
+class Crossing_Highways_Rule : public Validator::Rule {
+private:
+	static bool		is_highway	(const Osm_Way&);
+	static QString	get_level	(const Osm_Way&); /* Layer, bridge and tunnel */
+public:
+	QString		get_name	() const override;
+	void		check		(const Validator::Partition&, QVector<Validator::Issue>&) const override;
+};
+
+/* Ways at Osm_Way's capacity, with fewer than two nodes, or that refused a node */
+class Way_Limits_Rule : public Validator::Rule {
+public:
+	QString		get_name	() const override;
+	void		check		(const Validator::Partition&, QVector<Validator::Issue>&) const override;
+};
+
+/* Empty or invalid relations and members missing from the map */
+class Relation_Members_Rule : public Validator::Rule {
+public:
+	QString		get_name	() const override;
+	void		check		(const Validator::Partition&, QVector<Validator::Issue>&) const override;
+};
+
+}
+
+#endif // VALIDATION_RULES_H
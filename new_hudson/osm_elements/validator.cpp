@@ -0,0 +1,319 @@
+#include "validator.h"
+#include "validation_rules.h"
+
+using namespace ns_osm;
+
+/*================================================================*/
+/*                    Validator::Check_Task                       */
+/*================================================================*/
+
+class Validator::Check_Task : public QRunnable {
+	const Validator*	mp_validator;
+	const Partition*	mp_partition;
+	QVector<Issue>*		mp_issues;
+public:
+	void				run			() override;
+	                    Check_Task	(const Validator&, const Partition&, QVector<Issue>& issues);
+};
+
+Validator::Check_Task::Check_Task(const Validator& validator, const Partition& partition, QVector<Issue>& issues) {
+	mp_validator = &validator;
+	mp_partition = &partition;
+	mp_issues = &issues;
+}
+
+/* Runs on a pool thread: writes only its own issue vector */
+void Validator::Check_Task::run() {
+	for (auto it = mp_validator->m_rules.cbegin(); it != mp_validator->m_rules.cend(); ++it) {
+		(*it)->check(*mp_partition, *mp_issues);
+	}
+}
+
+/*================================================================*/
+/*                        Static members                          */
+/*================================================================*/
+
+const int Validator::DEFAULT_PARTITION_SIZE = 8192;
+const int Validator::MAX_GRID_SIDE = 64;
+
+/*================================================================*/
+/*                  Constructors, destructors                     */
+/*================================================================*/
+
+Validator::Validator() {
+	m_partition_size = DEFAULT_PARTITION_SIZE;
+}
+
+Validator::~Validator() {
+	m_pool.waitForDone();
+	clear_rules();
+}
+
+/*================================================================*/
+/*                       Private methods                          */
+/*================================================================*/
+
+QVector<Validator::Partition> Validator::partition(const Osm_Map& map) const {
+	QVector<Partition>	partitions;
+	int					n_elements = map.count_nodes() + map.count_ways() + map.count_relations();
+	int					side;
+	double				south = 0.0;
+	double				west = 0.0;
+	double				north = 0.0;
+	double				east = 0.0;
+	Grid				grid;
+	auto				get_node_cell = [&grid](const Osm_Node& node) {
+		/* At the duplicate rule's precision, so equal positions share a cell */
+		return grid.get_cell(qRound64(node.get_lat() * 1e7) / 1e7, qRound64(node.get_lon() * 1e7) / 1e7);
+	};
+
+	for (auto it = map.cnbegin(); it != map.cnend(); ++it) {
+		if (it == map.cnbegin()) {
+			south = north = (*it)->get_lat();
+			west = east = (*it)->get_lon();
+			continue;
+		}
+		south = qMin(south, (*it)->get_lat());
+		north = qMax(north, (*it)->get_lat());
+		west = qMin(west, (*it)->get_lon());
+		east = qMax(east, (*it)->get_lon());
+	}
+	side = qBound(1, qCeil(std::sqrt(static_cast<double>(n_elements) / m_partition_size)), MAX_GRID_SIDE);
+	grid = Grid(QRectF(west, south, east - west, north - south), side, side);
+	partitions.resize(grid.count_cells());
+	for (int i = 0; i < partitions.size(); ++i) {
+		partitions[i].p_map = &map;
+		partitions[i].grid = grid;
+		partitions[i].cell = i;
+	}
+
+	for (auto it = map.cnbegin(); it != map.cnend(); ++it) {
+		partitions[get_node_cell(**it)].nodes.push_back(*it);
+	}
+	for (auto it = map.cwbegin(); it != map.cwend(); ++it) {
+		const QList<Osm_Node*>& nodes = (*it)->get_nodes_list();
+		if (nodes.isEmpty()) {
+			partitions[0].ways.push_back(*it);
+			continue;
+		}
+		partitions[get_node_cell(*nodes.front())].ways.push_back(*it);
+		for (int i = 0; i + 1 < nodes.size(); ++i) {
+			QVector<int> cells = grid.get_cells(nodes[i]->get_lat(), nodes[i]->get_lon(),
+			                                    nodes[i + 1]->get_lat(), nodes[i + 1]->get_lon());
+			for (auto it_cell = cells.cbegin(); it_cell != cells.cend(); ++it_cell) {
+				partitions[*it_cell].segments.push_back(Segment{*it, i});
+			}
+		}
+	}
+	for (auto it = map.crbegin(); it != map.crend(); ++it) {
+		const Osm_Node* p_anchor = nullptr;
+		if (!(*it)->get_nodes().isEmpty()) {
+			p_anchor = (*it)->get_nodes().front();
+		}
+		for (auto it_way = (*it)->get_ways().cbegin(); p_anchor == nullptr && it_way != (*it)->get_ways().cend(); ++it_way) {
+			if (!(*it_way)->get_nodes_list().isEmpty()) {
+				p_anchor = (*it_way)->get_nodes_list().front();
+			}
+		}
+		partitions[p_anchor == nullptr ? 0 : get_node_cell(*p_anchor)].relations.push_back(*it);
+	}
+	return partitions;
+}
+
+/*================================================================*/
+/*                        Public methods                          */
+/*================================================================*/
+
+bool Validator::is_before(const Issue& first, const Issue& second) {
+	if (first.severity != second.severity) {
+		return first.severity > second.severity;
+	}
+	if (first.rule != second.rule) {
+		return first.rule < second.rule;
+	}
+	if (first.lat != second.lat) {
+		return first.lat < second.lat;
+	}
+	if (first.lon != second.lon) {
+		return first.lon < second.lon;
+	}
+	if (first.ways != second.ways) {
+		return first.ways < second.ways;
+	}
+	if (first.nodes != second.nodes) {
+		return first.nodes < second.nodes;
+	}
+	return first.relations < second.relations;
+}
+
+void Validator::add_rule(Rule* p_rule) {
+	if (p_rule != nullptr && !m_rules.contains(p_rule)) {
+		m_rules.push_back(p_rule);
+	}
+}
+
+void Validator::add_default_rules() {
+	add_rule(new Duplicate_Node_Rule);
+	add_rule(new Self_Intersection_Rule);
+	add_rule(new Crossing_Highways_Rule);
+	add_rule(new Way_Limits_Rule);
+	add_rule(new Relation_Members_Rule);
+}
+
+void Validator::clear_rules() {
+	qDeleteAll(m_rules);
+	m_rules.clear();
+}
+
+int Validator::count_rules() const {
+	return m_rules.size();
+}
+
+void Validator::set_partition_size(int n_elements) {
+	m_partition_size = qMax(1, n_elements);
+}
+
+int Validator::count_partitions(const Osm_Map& map) const {
+	return partition(map).size();
+}
+
+QVector<Validator::Issue> Validator::run(const Osm_Map& map) const {
+	QVector<Partition>		partitions;
+	QVector<QVector<Issue>>	partition_issues;
+	QVector<Issue>			issues;
+
+	if (m_rules.isEmpty()) {
+		return issues;
+	}
+	map.freeze();
+	partitions = partition(map);
+	if (partitions.size() == 1) {
+		issues = check(partitions.front());
+	} else {
+		partition_issues.resize(partitions.size());
+		for (int i = 0; i < partitions.size(); ++i) {
+			m_pool.start(new Check_Task(*this, partitions[i], partition_issues[i]));
+		}
+		m_pool.waitForDone();
+		for (auto it = partition_issues.cbegin(); it != partition_issues.cend(); ++it) {
+			issues += *it;
+		}
+	}
+	map.thaw();
+	std::sort(issues.begin(), issues.end(), is_before);
+	return issues;
+}
+
+QVector<Validator::Issue> Validator::check(const Partition& partition) const {
+	QVector<Issue> issues;
+
+	for (auto it = m_rules.cbegin(); it != m_rules.cend(); ++it) {
+		(*it)->check(partition, issues);
+	}
+	return issues;
+}
+
+/*================================================================*/
+/*                       Validator::Issue                         */
+/*================================================================*/
+
+Validator::Issue::Issue() {
+	severity = WARNING;
+	lat = 0.0;
+	lon = 0.0;
+}
+
+/*================================================================*/
+/*                       Validator::Grid                          */
+/*================================================================*/
+
+Validator::Grid::Grid() {
+	m_cols = 1;
+	m_rows = 1;
+}
+
+Validator::Grid::Grid(const QRectF& bound, int cols, int rows) {
+	m_bound = bound;
+	m_cols = qMax(1, cols);
+	m_rows = qMax(1, rows);
+}
+
+int Validator::Grid::get_col(double lon) const {
+	if (m_bound.width() <= 0.0) {
+		return 0;
+	}
+	return qBound(0, static_cast<int>((lon - m_bound.left()) / m_bound.width() * m_cols), m_cols - 1);
+}
+
+int Validator::Grid::get_row(double lat) const {
+	if (m_bound.height() <= 0.0) {
+		return 0;
+	}
+	return qBound(0, static_cast<int>((lat - m_bound.top()) / m_bound.height() * m_rows), m_rows - 1);
+}
+
+int Validator::Grid::count_cells() const {
+	return m_cols * m_rows;
+}
+
+int Validator::Grid::get_cell(double lat, double lon) const {
+	return get_row(lat) * m_cols + get_col(lon);
+}
+
+QVector<int> Validator::Grid::get_cells(double lat1, double lon1, double lat2, double lon2) const {
+	QVector<int>	cells;
+	int				col_first = get_col(qMin(lon1, lon2));
+	int				col_last = get_col(qMax(lon1, lon2));
+	int				row_first = get_row(qMin(lat1, lat2));
+	int				row_last = get_row(qMax(lat1, lat2));
+
+	for (int row = row_first; row <= row_last; ++row) {
+		for (int col = col_first; col <= col_last; ++col) {
+			cells.push_back(row * m_cols + col);
+		}
+	}
+	return cells;
+}
+
+/*================================================================*/
+/*                     Validator::Partition                       */
+/*================================================================*/
+
+Validator::Partition::Partition() {
+	p_map = nullptr;
+	cell = -1;
+}
+
+bool Validator::Partition::owns(double lat, double lon) const {
+	return cell < 0 || grid.get_cell(lat, lon) == cell;
+}
+
+/*================================================================*/
+/*                       Validator::Rule                          */
+/*================================================================*/
+
+Validator::Rule::~Rule() {}
+
+bool Validator::Rule::is_crossing(const QPointF& a, const QPointF& b, const QPointF& c, const QPointF& d, QPointF& at) {
+	auto	cross = [](const QPointF& p, const QPointF& q, const QPointF& r) {
+		return (q.x() - p.x()) * (r.y() - p.y()) - (q.y() - p.y()) * (r.x() - p.x());
+	};
+	double	d1 = cross(c, d, a);
+	double	d2 = cross(c, d, b);
+	double	d3 = cross(a, b, c);
+	double	d4 = cross(a, b, d);
+
+	if (!((d1 > 0.0 && d2 < 0.0) || (d1 < 0.0 && d2 > 0.0))
+	        || !((d3 > 0.0 && d4 < 0.0) || (d3 < 0.0 && d4 > 0.0))) {
+		return false;
+	}
+	at = a + (b - a) * (d1 / (d1 - d2));
+	/* Rounding must not move the point out of either segment's cells */
+	at.setX(qBound(qMax(qMin(a.x(), b.x()), qMin(c.x(), d.x())), at.x(), qMin(qMax(a.x(), b.x()), qMax(c.x(), d.x()))));
+	at.setY(qBound(qMax(qMin(a.y(), b.y()), qMin(c.y(), d.y())), at.y(), qMin(qMax(a.y(), b.y()), qMax(c.y(), d.y()))));
+	return true;
+}
+
+QPointF Validator::Rule::get_pos(const Osm_Node& node) {
+	return QPointF(node.get_lon(), node.get_lat());
+}
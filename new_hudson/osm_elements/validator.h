@@ -0,0 +1,148 @@
+#ifndef VALIDATOR_H
+#define VALIDATOR_H
+
+#ifndef QT_CORE_H
+#define QT_CORE_H
+#include <QtCore>
+#endif /* Include guard QT_CORE_H */
+
+#ifndef ALGORITHM_H
+#define ALGORITHM_H
+#include <algorithm>
+#endif /* Include guard ALGORITHM_H */
+
+#include "osm_map.h"
+
+namespace ns_osm {
+
+/* Runs pluggable rules over a map. The map is split into a grid of
+ * partitions by node position, and each partition is checked on a pool
+ * thread. Rules only get const access, tag index lookups included.
+ * run() freezes the map and blocks its caller until every partition is
+ * checked, so the map's own edits are refused meanwhile; call it on the
+ * thread that edits the elements, so nothing else can touch them either.
+ *
+ * A way or relation belongs to the partition of its first located node.
+ * Way segments are also listed in every partition their box meets, so
+ * pairwise rules see all candidates; they report a finding only in the
+ * partition owning its location, to report it once. */
+class Validator {
+public:
+	enum Severity {WARNING, ERROR};
+	struct Issue;
+	struct Segment;
+	class Grid;
+	struct Partition;
+	class Rule;
+private:
+	class Check_Task;
+
+	static const int						DEFAULT_PARTITION_SIZE;
+	static const int						MAX_GRID_SIDE;
+	QVector<Rule*>							m_rules; /* Owned */
+	int										m_partition_size;
+	mutable QThreadPool						m_pool;
+
+	QVector<Partition>						partition		(const Osm_Map&) const;
+public:
+	static bool								is_before		(const Issue&, const Issue&); /* Report order */
+	void									add_rule		(Rule*); /* Takes ownership */
+	void									add_default_rules();
+	void									clear_rules		();
+	int										count_rules		() const;
+	void									set_partition_size(int n_elements); /* Elements per partition, about */
+	int										count_partitions(const Osm_Map&) const;
+	QVector<Issue>							run				(const Osm_Map&) const; /* Sorted by is_before */
+	QVector<Issue>							check			(const Partition&) const; /* On the calling thread */
+	                                        Validator		();
+											Validator		(const Validator&) = delete;
+	Validator&								operator=		(const Validator&) = delete;
+	virtual									~Validator		();
+};
+
+/*================================================================*/
+/*                       Validator::Issue                         */
+/*================================================================*/
+
+struct Validator::Issue {
+	Severity			severity;
+	QString				rule;
+	QString				message;
+	QVector<long long>	nodes; /* Elements involved, ascending */
+	QVector<long long>	ways;
+	QVector<long long>	relations;
+	double				lat;
+	double				lon;
+
+	                    Issue		();
+};
+
+/*================================================================*/
+/*                      Validator::Segment                        */
+/*================================================================*/
+
+/* From get_nodes_list()[index] to get_nodes_list()[index + 1] */
+struct Validator::Segment {
+	const Osm_Way*		p_way;
+	int					index;
+};
+
+/*================================================================*/
+/*                       Validator::Grid                          */
+/*================================================================*/
+
+/* Uniform grid over a box, x is longitude */
+class Validator::Grid {
+private:
+	QRectF				m_bound;
+	int					m_cols;
+	int					m_rows;
+
+	int					get_col			(double lon) const;
+	int					get_row			(double lat) const;
+public:
+	int					count_cells		() const;
+	int					get_cell		(double lat, double lon) const; /* Clamped into the grid */
+	QVector<int>		get_cells		(double lat1, double lon1, double lat2, double lon2) const; /* Met by the box */
+	                    Grid			();
+						Grid			(const QRectF& bound, int cols, int rows);
+};
+
+/*================================================================*/
+/*                     Validator::Partition                       */
+/*================================================================*/
+
+struct Validator::Partition {
+	const Osm_Map*					p_map;
+	Grid							grid;
+	int								cell; /* -1 owns every location */
+	QVector<const Osm_Node*>		nodes;
+	QVector<const Osm_Way*>			ways;
+	QVector<const Osm_Relation*>	relations;
+	QVector<Segment>				segments;
+
+	bool							owns		(double lat, double lon) const;
+	                                Partition	();
+};
+
+/*================================================================*/
+/*                       Validator::Rule                          */
+/*================================================================*/
+
+/* Called from several threads at once: check() must be reentrant */
+class Validator::Rule {
+protected:
+	/* Proper crossing of ab and cd, sharing an end does not count */
+	static bool							is_crossing		(const QPointF& a, const QPointF& b,
+	                                                     const QPointF& c, const QPointF& d,
+	                                                     QPointF& at);
+	static QPointF						get_pos			(const Osm_Node&); /* x is longitude */
+public:
+	virtual QString						get_name		() const = 0;
+	virtual void						check			(const Partition&, QVector<Issue>&) const = 0;
+	virtual								~Rule			();
+};
+
+}
+
+#endif // VALIDATOR_H
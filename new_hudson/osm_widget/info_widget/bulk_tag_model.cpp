@@ -0,0 +1,173 @@
+#include "bulk_tag_model.h"
+
+using namespace ns_osm;
+
+/*================================================================*/
+/*                        Static members                          */
+/*================================================================*/
+
+const char* Bulk_Tag_Model::MIXED_TEXT = "<mixed>";
+const int Bulk_Tag_Model::KEY_COL = 0;
+const int Bulk_Tag_Model::VALUE_COL = 1;
+
+/*================================================================*/
+/*                  Constructors, destructors                     */
+/*================================================================*/
+
+Bulk_Tag_Model::Bulk_Tag_Model(QObject* p_parent) : QAbstractTableModel(p_parent) {
+	mp_map = nullptr;
+	f_has_new_row = false;
+}
+
+Bulk_Tag_Model::~Bulk_Tag_Model() {}
+
+/*================================================================*/
+/*                       Private methods                          */
+/*================================================================*/
+
+void Bulk_Tag_Model::rebuild() {
+	QMap<QString, Row> rows;
+
+	for (auto it = m_elements.cbegin(); it != m_elements.cend(); ++it) {
+		const QMap<QString, QString>& tags = (*it)->get_tag_map();
+		for (auto it_tag = tags.cbegin(); it_tag != tags.cend(); ++it_tag) {
+			auto it_row = rows.find(it_tag.key());
+			if (it_row == rows.end()) {
+				it_row = rows.insert(it_tag.key(), Row{it_tag.key(), it_tag.value(), 0, false});
+			} else if (it_row.value().value != it_tag.value()) {
+				it_row.value().f_mixed = true;
+			}
+			it_row.value().n_owners++;
+		}
+	}
+
+	beginResetModel();
+	m_rows.clear();
+	m_rows.reserve(rows.size());
+	for (auto it = rows.begin(); it != rows.end(); ++it) {
+		it.value().f_mixed |= (it.value().n_owners < m_elements.size());
+		m_rows.push_back(it.value());
+	}
+	f_has_new_row = false;
+	endResetModel();
+}
+
+/*================================================================*/
+/*                        Public methods                          */
+/*================================================================*/
+
+int Bulk_Tag_Model::rowCount(const QModelIndex& parent) const {
+	return (parent.isValid() ? 0 : m_rows.size() + (f_has_new_row ? 1 : 0));
+}
+
+int Bulk_Tag_Model::columnCount(const QModelIndex& parent) const {
+	return (parent.isValid() ? 0 : 2);
+}
+
+QVariant Bulk_Tag_Model::data(const QModelIndex& index, int role) const {
+	if (!index.isValid() || index.row() >= rowCount()) {
+		return QVariant();
+	}
+	const Row& row = (index.row() < m_rows.size() ? m_rows[index.row()] : m_new_row);
+	bool f_mixed_value = (row.f_mixed && index.column() == VALUE_COL);
+
+	switch (role) {
+	case Qt::DisplayRole:
+		if (f_mixed_value) {
+			return QString(MIXED_TEXT);
+		}
+		return (index.column() == KEY_COL ? row.key : row.value);
+	case Qt::EditRole:
+		/* A mixed value is replaced, not edited */
+		if (f_mixed_value) {
+			return QString();
+		}
+		return (index.column() == KEY_COL ? row.key : row.value);
+	case Qt::ForegroundRole:
+		if (f_mixed_value) {
+			return QBrush(Qt::gray);
+		}
+		break;
+	case Qt::ToolTipRole:
+		if (index.row() < m_rows.size()) {
+			return QString("%1 of %2 elements").arg(row.n_owners).arg(m_elements.size());
+		}
+		break;
+	default:
+		break;
+	}
+	return QVariant();
+}
+
+bool Bulk_Tag_Model::setData(const QModelIndex& index, const QVariant& value, int role) {
+	QString text = value.toString();
+
+	if (!index.isValid() || role != Qt::EditRole || mp_map == nullptr || index.row() >= rowCount()) {
+		return false;
+	}
+	if (index.row() == m_rows.size()) {
+		(index.column() == KEY_COL ? m_new_row.key : m_new_row.value) = text;
+		if (m_new_row.key.isEmpty() || index.column() != VALUE_COL) {
+			emit dataChanged(index, index);
+			return true;
+		}
+		mp_map->set_tag(m_elements, m_new_row.key, m_new_row.value);
+	} else if (index.column() == KEY_COL) {
+		/* Elements already holding the new key keep the old one, which stays listed */
+		mp_map->rename_tag(m_elements, m_rows[index.row()].key, text);
+	} else {
+		mp_map->set_tag(m_elements, m_rows[index.row()].key, text);
+	}
+	rebuild();
+	return true;
+}
+
+Qt::ItemFlags Bulk_Tag_Model::flags(const QModelIndex& index) const {
+	if (!index.isValid()) {
+		return Qt::NoItemFlags;
+	}
+	return QAbstractTableModel::flags(index) | Qt::ItemIsEditable;
+}
+
+QVariant Bulk_Tag_Model::headerData(int section, Qt::Orientation orientation, int role) const {
+	if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+		return QAbstractTableModel::headerData(section, orientation, role);
+	}
+	return (section == KEY_COL ? QString("Tag") : QString("Value (%1 selected)").arg(m_elements.size()));
+}
+
+bool Bulk_Tag_Model::removeRows(int row, int count, const QModelIndex& parent) {
+	if (parent.isValid() || row < 0 || count <= 0 || row + count > rowCount() || mp_map == nullptr) {
+		return false;
+	}
+	for (int i = row; i < row + count && i < m_rows.size(); ++i) {
+		mp_map->remove_tag(m_elements, m_rows[i].key);
+	}
+	rebuild();
+	return true;
+}
+
+void Bulk_Tag_Model::push_row() {
+	if (f_has_new_row) {
+		return;
+	}
+	beginInsertRows(QModelIndex(), m_rows.size(), m_rows.size());
+	m_new_row = Row{QString(), QString(), 0, false};
+	f_has_new_row = true;
+	endInsertRows();
+}
+
+void Bulk_Tag_Model::clear_rows() {
+	removeRows(0, rowCount());
+}
+
+void Bulk_Tag_Model::set_selection(Osm_Map* p_map, const QList<Osm_Info*>& elements) {
+	mp_map = p_map;
+	m_elements = elements;
+	rebuild();
+	emit headerDataChanged(Qt::Horizontal, VALUE_COL, VALUE_COL);
+}
+
+int Bulk_Tag_Model::count_elements() const {
+	return m_elements.size();
+}
@@ -0,0 +1,60 @@
+#ifndef BULK_TAG_MODEL_H
+#define BULK_TAG_MODEL_H
+
+#ifndef QT_WIDGETS_H
+#define QT_WIDGETS_H
+#include <QtWidgets>
+#endif /* Include guard QT_WIDGETS_H */
+
+#include "osm_elements.h"
+
+namespace ns_osm {
+
+/* Table model over the union of tags of many elements. A key whose value
+ * differs between the elements, or that some of them lack, is shown as
+ * mixed. Every edit goes to all elements as one batched Osm_Map call. */
+class Bulk_Tag_Model : public QAbstractTableModel {
+	Q_OBJECT
+private:
+	struct Row {
+		QString		key;
+		QString		value;	/* Value of the first element having the key */
+		int			n_owners;
+		bool		f_mixed;
+	};
+	static const char*				MIXED_TEXT;
+	Osm_Map*						mp_map;
+	QList<Osm_Info*>				m_elements;
+	QVector<Row>					m_rows;
+	Row								m_new_row; /* Typed in, not applied until it has a key and a value */
+	bool							f_has_new_row;
+
+	void							rebuild			();
+public:
+	static const int				KEY_COL;
+	static const int				VALUE_COL;
+
+	int								rowCount		(const QModelIndex& parent = QModelIndex()) const override;
+	int								columnCount		(const QModelIndex& parent = QModelIndex()) const override;
+	QVariant						data			(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+	bool							setData			(const QModelIndex& index,
+	                                                 const QVariant& value,
+	                                                 int role = Qt::EditRole) override;
+	Qt::ItemFlags					flags			(const QModelIndex& index) const override;
+	QVariant						headerData		(int section,
+	                                                 Qt::Orientation,
+	                                                 int role = Qt::DisplayRole) const override;
+	bool							removeRows		(int row, int count, const QModelIndex& parent = QModelIndex()) override;
+	void							push_row		();
+	void							clear_rows		();
+	void							set_selection	(Osm_Map*, const QList<Osm_Info*>&);
+	int								count_elements	() const;
+	                                Bulk_Tag_Model	(QObject* p_parent = nullptr);
+									Bulk_Tag_Model	(const Bulk_Tag_Model&) = delete;
+	Bulk_Tag_Model&					operator=		(const Bulk_Tag_Model&) = delete;
+	virtual							~Bulk_Tag_Model	();
+};
+
+}
+
+#endif // BULK_TAG_MODEL_H
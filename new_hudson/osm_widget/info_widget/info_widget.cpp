@@ -6,9 +6,12 @@ using namespace ns_osm;
 /*                  Constructors, destructors                     */
 /*================================================================*/
 
-Info_Widget::Info_Widget(QWidget* p_parent) : QWidget(p_parent) {
+Info_Widget::Info_Widget(Osm_Map& map, QWidget* p_parent) : QWidget(p_parent), m_map(map) {
 	QToolBar* p_toolbar = new QToolBar(this);
-	mp_tag_table = new Tag_Table;
+	mp_tag_table = new Tag_Table(m_map);
+	mp_issue_list = new QListWidget(this);
+	mp_object = nullptr;
+	mp_live_validator = nullptr;
 
 //	p_toolbar->addAction("Update", mp_tag_table, SLOT(slot_update()));
 	p_toolbar->addAction("Push row", mp_tag_table, SLOT(slot_push_row()));
@@ -21,32 +24,140 @@ Info_Widget::Info_Widget(QWidget* p_parent) : QWidget(p_parent) {
 	setLayout(new QVBoxLayout(this));
 	layout()->addWidget(p_toolbar);
 	layout()->addWidget(mp_tag_table);
+	layout()->addWidget(mp_issue_list);
+	mp_issue_list->setMaximumHeight(120);
+	mp_issue_list->hide();
+}
+
+/*================================================================*/
+/*                       Private methods                          */
+/*================================================================*/
+
+void Info_Widget::follow(Osm_Object* p_object) {
+	unsubscribe();
+	mp_object = p_object;
+	if (p_object != nullptr) {
+		subscribe(*p_object);
+		subscribe(m_map);
+	}
+	refresh_issues();
+}
+
+/* Subscribed after the validator, so it has caught up by the time the map's events get here */
+void Info_Widget::refresh_issues() {
+	QVector<Validator::Issue>	issues;
+	Osm_Node*					p_node;
+	Osm_Way*					p_way;
+
+	mp_issue_list->clear();
+	if (mp_live_validator == nullptr) {
+		return;
+	}
+	if ((p_node = dynamic_cast<Osm_Node*>(mp_object)) != nullptr) {
+		issues = mp_live_validator->find_node_issues(p_node->get_id());
+	} else if ((p_way = dynamic_cast<Osm_Way*>(mp_object)) != nullptr) {
+		issues = mp_live_validator->find_way_issues(p_way->get_id());
+	}
+	for (auto it = issues.cbegin(); it != issues.cend(); ++it) {
+		mp_issue_list->addItem(QString("%1 (%2): %3")
+		                       .arg(it->severity == Validator::ERROR ? "Error" : "Warning", it->rule, it->message));
+	}
 }
 
 /*================================================================*/
 /*                      Protected methods                         */
 /*================================================================*/
 
+/* Tag edits through the map leave the element silent, the map tells which ones changed */
+void Info_Widget::handle_event_update(Osm_Object&) {
+	Meta::Ids	ids;
+	Osm_Node*	p_node;
+	Osm_Way*	p_way;
+
+	if (mp_object == nullptr) {
+		return;
+	}
+	/* An edit next to the element may raise or settle an issue of it */
+	refresh_issues();
+	if (get_meta().get_event() != MAP_TAGS_UPDATED) {
+		return;
+	}
+	if (get_meta().get_subject() == mp_object) {
+		mp_tag_table->refresh();
+		return;
+	}
+	ids = get_meta().get_ids();
+	if ((p_node = dynamic_cast<Osm_Node*>(mp_object)) != nullptr) {
+		if (ids.nodes.contains(p_node->get_id()) && m_map.get_node(p_node->get_id()) == p_node) {
+			mp_tag_table->refresh();
+		}
+	} else if ((p_way = dynamic_cast<Osm_Way*>(mp_object)) != nullptr) {
+		if (ids.ways.contains(p_way->get_id()) && m_map.get_way(p_way->get_id()) == p_way) {
+			mp_tag_table->refresh();
+		}
+	}
+}
+
+void Info_Widget::handle_event_update(Osm_Node&) {
+	mp_tag_table->refresh();
+}
+
+void Info_Widget::handle_event_update(Osm_Way&) {
+	mp_tag_table->refresh();
+}
+
 void Info_Widget::handle_event_delete(Osm_Node&) {
-	mp_tag_table->unset_info();
+	mp_object = nullptr;
+	mp_tag_table->discard_info();
+	refresh_issues();
 }
 
 void Info_Widget::handle_event_delete(Osm_Way&) {
-	mp_tag_table->unset_info();
+	mp_object = nullptr;
+	mp_tag_table->discard_info();
+	refresh_issues();
 }
 
 /*================================================================*/
 /*                        Public methods                          */
 /*================================================================*/
 
+void Info_Widget::set_live_validator(const Live_Validator* p_live_validator) {
+	mp_live_validator = p_live_validator;
+	mp_issue_list->setVisible(p_live_validator != nullptr);
+	refresh_issues();
+}
+
 void Info_Widget::slot_object_selected(Osm_Node& node) {
-	unsubscribe();
-	subscribe(node);
+	follow(&node);
 	mp_tag_table->set_info(node);
 }
 
 void Info_Widget::slot_object_selected(Osm_Way& way) {
-	unsubscribe();
-	subscribe(way);
+	follow(&way);
 	mp_tag_table->set_info(way);
 }
+
+void Info_Widget::slot_selection_changed(QList<Osm_Info*> selection) {
+	Osm_Node*	p_node;
+	Osm_Way*	p_way;
+
+	switch (selection.size()) {
+	case 0:
+		follow(nullptr);
+		mp_tag_table->unset_info();
+		break;
+	case 1:
+		if ((p_node = dynamic_cast<Osm_Node*>(selection.front())) != nullptr) {
+			slot_object_selected(*p_node);
+		} else if ((p_way = dynamic_cast<Osm_Way*>(selection.front())) != nullptr) {
+			slot_object_selected(*p_way);
+		}
+		break;
+	default:
+		/* View_Handler drops the selection before any selected element dies */
+		follow(nullptr);
+		mp_tag_table->set_selection(selection);
+		break;
+	}
+}
@@ -13,15 +13,28 @@ namespace ns_osm {
 class Info_Widget : public QWidget, public Osm_Subscriber {
 	Q_OBJECT
 private:
-	Tag_Table*	mp_tag_table;
+	Osm_Map&				m_map;
+	Tag_Table*				mp_tag_table;
+	QListWidget*			mp_issue_list; /* Of the element shown */
+	Osm_Object*				mp_object; /* The element shown, nullptr while none or several are */
+	const Live_Validator*	mp_live_validator;
+
+	void		follow				(Osm_Object*); /* The element and the map's edits near it */
+	void		refresh_issues		();
 protected:
+	void		handle_event_update	(Osm_Object&) override; /* Map events */
+	void		handle_event_update	(Osm_Node&) override;
+	void		handle_event_update	(Osm_Way&) override;
 	void		handle_event_delete	(Osm_Node&) override;
 	void		handle_event_delete	(Osm_Way&) override;
 public slots:
 	void		slot_object_selected(Osm_Node&);
 	void		slot_object_selected(Osm_Way&);
+	void		slot_selection_changed(QList<Osm_Info*>);
 public:
-	            Info_Widget			(QWidget* p_parent = nullptr);
+	/* Lists its issues for the element shown; it must follow the same map */
+	void		set_live_validator	(const Live_Validator*);
+	            Info_Widget			(Osm_Map&, QWidget* p_parent = nullptr);
 };
 }
 
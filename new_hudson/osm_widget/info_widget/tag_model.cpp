@@ -0,0 +1,231 @@
+#include "tag_model.h"
+
+using namespace ns_osm;
+
+/*================================================================*/
+/*                        Static members                          */
+/*================================================================*/
+
+const int Tag_Model::KEY_COL = 0;
+const int Tag_Model::VALUE_COL = 1;
+
+/*================================================================*/
+/*                  Constructors, destructors                     */
+/*================================================================*/
+
+Tag_Model::Tag_Model(Osm_Map& map, QObject* p_parent) : QAbstractTableModel(p_parent), m_map(map) {
+	mp_info = nullptr;
+	mp_node = nullptr;
+	mp_way = nullptr;
+	mp_relation = nullptr;
+}
+
+Tag_Model::~Tag_Model() {}
+
+/*================================================================*/
+/*                       Private methods                          */
+/*================================================================*/
+
+bool Tag_Model::is_in_sync() const {
+	int row = 0;
+
+	if (mp_info == nullptr) {
+		return m_rows.isEmpty();
+	}
+	if (m_rows.size() != mp_info->get_tag_map().size()) {
+		return false;
+	}
+	for (auto it = mp_info->get_tag_map().cbegin(); it != mp_info->get_tag_map().cend(); ++it, ++row) {
+		if (m_rows[row].key != it.key() || m_rows[row].value != it.value()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void Tag_Model::set_element(Osm_Info* p_info, Osm_Node* p_node, Osm_Way* p_way, Osm_Relation* p_relation) {
+	mp_info = p_info;
+	mp_node = p_node;
+	mp_way = p_way;
+	mp_relation = p_relation;
+	reload();
+}
+
+/*================================================================*/
+/*                        Public methods                          */
+/*================================================================*/
+
+int Tag_Model::rowCount(const QModelIndex& parent) const {
+	return (parent.isValid() ? 0 : m_rows.size());
+}
+
+int Tag_Model::columnCount(const QModelIndex& parent) const {
+	return (parent.isValid() ? 0 : 2);
+}
+
+QVariant Tag_Model::data(const QModelIndex& index, int role) const {
+	if (!index.isValid() || index.row() >= m_rows.size()) {
+		return QVariant();
+	}
+	switch (role) {
+	case Qt::DisplayRole:
+	case Qt::EditRole:
+		return (index.column() == KEY_COL ? m_rows[index.row()].key : m_rows[index.row()].value);
+	case Qt::FontRole:
+		if (m_rows[index.row()].f_edited) {
+			QFont font;
+			font.setItalic(true);
+			return font;
+		}
+		break;
+	default:
+		break;
+	}
+	return QVariant();
+}
+
+bool Tag_Model::setData(const QModelIndex& index, const QVariant& value, int role) {
+	QString text = value.toString();
+
+	if (!index.isValid() || role != Qt::EditRole || index.row() >= m_rows.size()) {
+		return false;
+	}
+	Row& row = m_rows[index.row()];
+	QString& field = (index.column() == KEY_COL ? row.key : row.value);
+	if (field == text) {
+		return true;
+	}
+	field = text;
+	row.f_edited = true;
+	emit dataChanged(this->index(index.row(), KEY_COL), this->index(index.row(), VALUE_COL));
+	return true;
+}
+
+Qt::ItemFlags Tag_Model::flags(const QModelIndex& index) const {
+	if (!index.isValid()) {
+		return Qt::NoItemFlags;
+	}
+	return QAbstractTableModel::flags(index) | Qt::ItemIsEditable;
+}
+
+QVariant Tag_Model::headerData(int section, Qt::Orientation orientation, int role) const {
+	if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+		return QAbstractTableModel::headerData(section, orientation, role);
+	}
+	return (section == KEY_COL ? QString("Tag") : QString("Value"));
+}
+
+bool Tag_Model::removeRows(int row, int count, const QModelIndex& parent) {
+	if (parent.isValid() || row < 0 || count <= 0 || row + count > m_rows.size()) {
+		return false;
+	}
+	beginRemoveRows(parent, row, row + count - 1);
+	for (int i = row; i < row + count; ++i) {
+		if (!m_rows[i].base_key.isEmpty()) {
+			m_removed_keys.insert(m_rows[i].base_key);
+		}
+	}
+	m_rows.remove(row, count);
+	endRemoveRows();
+	return true;
+}
+
+void Tag_Model::push_row() {
+	beginInsertRows(QModelIndex(), m_rows.size(), m_rows.size());
+	m_rows.push_back(Row{QString(), QString(), QString(), true});
+	endInsertRows();
+}
+
+void Tag_Model::clear_rows() {
+	removeRows(0, m_rows.size());
+}
+
+void Tag_Model::set_info(Osm_Node* p_node) {
+	set_element(p_node, p_node, nullptr, nullptr);
+}
+
+void Tag_Model::set_info(Osm_Way* p_way) {
+	set_element(p_way, nullptr, p_way, nullptr);
+}
+
+void Tag_Model::set_info(Osm_Relation* p_relation) {
+	set_element(p_relation, nullptr, nullptr, p_relation);
+}
+
+void Tag_Model::unset_info() {
+	set_element(nullptr, nullptr, nullptr, nullptr);
+}
+
+Osm_Info* Tag_Model::get_info() const {
+	return mp_info;
+}
+
+bool Tag_Model::has_changes() const {
+	if (!m_removed_keys.isEmpty()) {
+		return true;
+	}
+	for (auto it = m_rows.cbegin(); it != m_rows.cend(); ++it) {
+		if (it->f_edited) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool Tag_Model::commit() {
+	QSet<QString>			touched(m_removed_keys);
+	QMap<QString, QString>	wanted;
+	QStringList				removed;
+	bool					f_changed;
+
+	if (mp_info == nullptr || !has_changes()) {
+		return false;
+	}
+	for (auto it = m_rows.cbegin(); it != m_rows.cend(); ++it) {
+		if (it->f_edited) {
+			touched.insert(it->base_key);
+			touched.insert(it->key);
+		}
+	}
+	touched.remove(QString());
+	/* Later rows win if a key was typed twice */
+	for (auto it = m_rows.cbegin(); it != m_rows.cend(); ++it) {
+		if (touched.contains(it->key)) {
+			wanted[it->key] = it->value;
+		}
+	}
+	for (auto it = touched.cbegin(); it != touched.cend(); ++it) {
+		if (!wanted.contains(*it)) {
+			removed.push_back(*it);
+		}
+	}
+	if (mp_node != nullptr) {
+		f_changed = m_map.set_tags(*mp_node, wanted, removed);
+	} else if (mp_way != nullptr) {
+		f_changed = m_map.set_tags(*mp_way, wanted, removed);
+	} else {
+		f_changed = m_map.set_tags(*mp_relation, wanted, removed);
+	}
+	reload();
+	return f_changed;
+}
+
+void Tag_Model::reload() {
+	beginResetModel();
+	m_rows.clear();
+	m_removed_keys.clear();
+	if (mp_info != nullptr) {
+		m_rows.reserve(mp_info->get_tag_map().size());
+		for (auto it = mp_info->get_tag_map().cbegin(); it != mp_info->get_tag_map().cend(); ++it) {
+			m_rows.push_back(Row{it.key(), it.value(), it.key(), false});
+		}
+	}
+	endResetModel();
+}
+
+void Tag_Model::refresh() {
+	if (has_changes() || is_in_sync()) {
+		return;
+	}
+	reload();
+}
@@ -0,0 +1,70 @@
+#ifndef TAG_MODEL_H
+#define TAG_MODEL_H
+
+#ifndef QT_WIDGETS_H
+#define QT_WIDGETS_H
+#include <QtWidgets>
+#endif /* Include guard QT_WIDGETS_H */
+
+#include "osm_elements.h"
+
+namespace ns_osm {
+
+/* Table model over the tags of one element. Rows start as shared copies
+ * of the element's tags (no string data is duplicated); edits stay in the
+ * model until commit(), which hands only the changed keys to the map in
+ * a single batched call. */
+class Tag_Model : public QAbstractTableModel {
+	Q_OBJECT
+private:
+	struct Row {
+		QString		key;
+		QString		value;
+		QString		base_key; /* Key the row was loaded with, empty for new rows */
+		bool		f_edited;
+	};
+	Osm_Map&						m_map;
+	Osm_Info*						mp_info;
+	Osm_Node*						mp_node; /* The same element, typed for Osm_Map::set_tags */
+	Osm_Way*						mp_way;
+	Osm_Relation*					mp_relation;
+	QVector<Row>					m_rows;
+	QSet<QString>					m_removed_keys; /* Loaded keys whose rows were removed */
+
+	bool							is_in_sync		() const; /* Rows still mirror the element */
+	void							set_element		(Osm_Info*, Osm_Node*, Osm_Way*, Osm_Relation*);
+public:
+	static const int				KEY_COL;
+	static const int				VALUE_COL;
+
+	int								rowCount		(const QModelIndex& parent = QModelIndex()) const override;
+	int								columnCount		(const QModelIndex& parent = QModelIndex()) const override;
+	QVariant						data			(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+	bool							setData			(const QModelIndex& index,
+	                                                 const QVariant& value,
+	                                                 int role = Qt::EditRole) override;
+	Qt::ItemFlags					flags			(const QModelIndex& index) const override;
+	QVariant						headerData		(int section,
+	                                                 Qt::Orientation,
+	                                                 int role = Qt::DisplayRole) const override;
+	bool							removeRows		(int row, int count, const QModelIndex& parent = QModelIndex()) override;
+	void							push_row		();
+	void							clear_rows		();
+	void							set_info		(Osm_Node*);
+	void							set_info		(Osm_Way*);
+	void							set_info		(Osm_Relation*);
+	void							unset_info		(); /* Drops the element and the edits */
+	Osm_Info*						get_info		() const;
+	bool							has_changes		() const;
+	bool							commit			(); /* True if the element was changed */
+	void							reload			(); /* Drops edits, rereads the element */
+	void							refresh			(); /* Rereads the element unless edited or in sync */
+	                                Tag_Model		(Osm_Map&, QObject* p_parent = nullptr);
+									Tag_Model		(const Tag_Model&) = delete;
+	Tag_Model&						operator=		(const Tag_Model&) = delete;
+	virtual							~Tag_Model		();
+};
+
+}
+
+#endif // TAG_MODEL_H
@@ -3,96 +3,113 @@
 using namespace ns_osm;
 
 /*================================================================*/
-/*                        Static members                          */
+/*                  Constructors, destructors                     */
 /*================================================================*/
-const char* Tag_Table::KEY_HEADER = "Tag";
-const char* Tag_Table::VALUE_HEADER = "Value";
-const int Tag_Table::KEY_COL = 0;
-const int Tag_Table::VALUE_COL = 1;
+
+Tag_Table::Tag_Table(Osm_Map& map) : m_map(map) {
+	mp_model = new Tag_Model(m_map, this);
+	mp_bulk_model = new Bulk_Tag_Model(this);
+	setModel(mp_model);
+	horizontalHeader()->setStretchLastSection(true);
+	setSelectionBehavior(QAbstractItemView::SelectRows);
+}
 
 /*================================================================*/
-/*                  Constructors, destructors                     */
+/*                       Private methods                          */
 /*================================================================*/
 
-Tag_Table::Tag_Table() {
-	QStringList headers;
-	insertColumn(0);
-	insertColumn(1);
-	headers << KEY_HEADER << VALUE_HEADER;
-	setHorizontalHeaderLabels(headers);
-	mp_info = nullptr;
-	clear();
-//	QObject::connect(this, SIGNAL(cellChanged(int,int)), this, SLOT(slot_cell_changed(int,int)));
+template <typename T>
+void Tag_Table::set_element(T& element) {
+	if (static_cast<Osm_Info*>(&element) == mp_model->get_info()) {
+		return;
+	}
+	unset_info();
+	mp_model->set_info(&element);
 }
+
 /*================================================================*/
-/*                        Public methods                          */
+/*                        Public slots                            */
 /*================================================================*/
 
 void Tag_Table::slot_push_row() {
-	int row = rowCount();
-	insertRow(row);
-	setItem(row, KEY_COL, new QTableWidgetItem(""));
-	setItem(row, VALUE_COL, new QTableWidgetItem(""));
+	if (is_bulk_editing()) {
+		mp_bulk_model->push_row();
+	} else {
+		mp_model->push_row();
+	}
+	edit(model()->index(model()->rowCount() - 1, Tag_Model::KEY_COL));
 }
 
 void Tag_Table::slot_pop_row() {
-	removeRow(rowCount() - 1);
+	model()->removeRows(model()->rowCount() - 1, 1);
 }
 
 void Tag_Table::slot_delete_selected() {
-	QList<QTableWidgetSelectionRange> selected(selectedRanges());
-	int row_min = rowCount() + 1;
+	QModelIndexList selected(selectionModel()->selectedIndexes());
+	int row_min = model()->rowCount() + 1;
 	int row_max = -1;
 
 	if (selected.empty()) {
 		return;
 	}
-	for (auto it = selected.begin(); it != selected.end(); ++it) {
-		row_max = std::max(row_max, std::max(it->bottomRow(), it->topRow()));
-		row_min = std::min(row_min, std::min(it->bottomRow(), it->topRow()));
-	}
-
-	for (int i = 0; i < row_max - row_min + 1; ++i) {
-		removeRow(row_min);
+	for (auto it = selected.cbegin(); it != selected.cend(); ++it) {
+		row_max = std::max(row_max, it->row());
+		row_min = std::min(row_min, it->row());
 	}
+	model()->removeRows(row_min, row_max - row_min + 1);
 }
 
 void Tag_Table::slot_delete_all() {
-	setRowCount(0);
+	model()->removeRows(0, model()->rowCount());
 }
 
 /*================================================================*/
 /*                        Public methods                          */
 /*================================================================*/
 
-void Tag_Table::set_info(Osm_Info& info) {
-	int row = 0;
+void Tag_Table::set_info(Osm_Node& node) {
+	set_element(node);
+}
 
-	if (&info == mp_info) {
-		return;
-	}
-	unset_info();
-	mp_info = &info;
+void Tag_Table::set_info(Osm_Way& way) {
+	set_element(way);
+}
 
-	setRowCount(mp_info->get_tag_map().size());
-	for (auto it = mp_info->get_tag_map().cbegin(); it != mp_info->get_tag_map().cend(); ++it) {
-		setItem(row, KEY_COL, new QTableWidgetItem(it.key()));
-		setItem(row, VALUE_COL, new QTableWidgetItem(it.value()));
-		row++;
-	}
+void Tag_Table::set_info(Osm_Relation& relation) {
+	set_element(relation);
 }
 
 void Tag_Table::unset_info() {
-	if (mp_info != nullptr) {
-		mp_info->clear_tags();
+	/* An editor still open holds the last typed text */
+	if (state() == QAbstractItemView::EditingState && focusWidget() != nullptr) {
+		commitData(focusWidget());
 	}
-	for (int row = 0; row < rowCount(); ++row) {
-		QString key = (item(row, KEY_COL) ? item(row, KEY_COL)->data(Qt::DisplayRole).toString() : "");
-		QString value = (item(row, VALUE_COL) ? item(row, VALUE_COL)->data(Qt::DisplayRole).toString() : "");
-		if (key != "") {
-			mp_info->set_tag(key, value);
-		}
+	mp_model->commit();
+	mp_model->unset_info();
+	if (model() != mp_model) {
+		mp_bulk_model->set_selection(nullptr, QList<Osm_Info*>());
+		setModel(mp_model);
+	}
+}
+
+void Tag_Table::discard_info() {
+	mp_model->unset_info();
+	if (model() != mp_model) {
+		mp_bulk_model->set_selection(nullptr, QList<Osm_Info*>());
+		setModel(mp_model);
 	}
-	mp_info = nullptr;
-	slot_delete_all();
+}
+
+void Tag_Table::refresh() {
+	mp_model->refresh();
+}
+
+void Tag_Table::set_selection(const QList<Osm_Info*>& elements) {
+	unset_info();
+	mp_bulk_model->set_selection(&m_map, elements);
+	setModel(mp_bulk_model);
+}
+
+bool Tag_Table::is_bulk_editing() const {
+	return model() == mp_bulk_model;
 }
@@ -7,16 +7,20 @@
 #endif /* Include guard QT_WIDGETS_H */
 
 #include "osm_elements.h"
+#include "tag_model.h"
+#include "bulk_tag_model.h"
 
 namespace ns_osm {
-class Tag_Table : public QTableWidget {
+class Tag_Table : public QTableView {
 	Q_OBJECT
 private:
-	static const char*	KEY_HEADER;
-	static const char*	VALUE_HEADER;
-	static const int	KEY_COL;
-	static const int	VALUE_COL;
-	Osm_Info*			mp_info;
+	Osm_Map&			m_map;
+	Tag_Model*			mp_model;
+	Bulk_Tag_Model*		mp_bulk_model; /* Shown while several elements are selected */
+
+	template <typename T>
+	void				set_element			(T&);
+
 protected:
 	//QString				get_at				(int row, int col);
 	//void				remove_at			(int row);
@@ -28,9 +32,15 @@ public slots:
 	void				slot_delete_all		();
 //	void				slot_update			();
 public:
-	void				set_info			(Osm_Info&);
-	void				unset_info			();
-	Tag_Table();
+	void				set_info			(Osm_Node&);
+	void				set_info			(Osm_Way&);
+	void				set_info			(Osm_Relation&);
+	void				unset_info			(); /* Commits the edits */
+	void				discard_info		(); /* Drops the edits, the element is going away */
+	void				refresh				(); /* The element was changed elsewhere */
+	void				set_selection		(const QList<Osm_Info*>&); /* Edits all of them at once */
+	bool				is_bulk_editing		() const;
+	Tag_Table(Osm_Map&);
 };
 }
 
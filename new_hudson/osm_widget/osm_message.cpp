@@ -14,6 +14,8 @@ const char* Osm_Message::operator()(const int code) {
 		return "No such xml file. ";
 	case OSM_ERROR_CANNOT_WRITE_FILE:
 		return "Cannot write file. ";
+	case OSM_ERROR_CANCELLED:
+		return "Cancelled. ";
 	}
 	return "Unknown result code. ";
 }
@@ -6,6 +6,7 @@ const int OSM_ERROR						= 1; /* Unspecified error */
 const int OSM_ERROR_WRONG_XML_FORMAT	= 2; /* Unable to parse xml file */
 const int OSM_ERROR_XML_FILE_NOT_EXISTS	= 3; /* No such xml file */
 const int OSM_ERROR_CANNOT_WRITE_FILE	= 4; /* Cannot write file */
+const int OSM_ERROR_CANCELLED			= 5; /* Stopped on request */
 
 class Osm_Message {
 public:
@@ -13,9 +13,14 @@ Osm_Widget::Osm_Widget(QWidget* p_parent) :
 //	setMinimumWidth(600);
 	mp_map = new Osm_Map;
 	mp_map->adopt();
+	m_map_versioner.follow(*mp_map);
+	m_live_validator.follow(*mp_map);
 	mp_xml_handler = new Xml_Handler(*mp_map);
+	mp_xml_loader = new Xml_Loader(this);
+	mp_xml_saver = new Xml_Saver(this);
 	mp_view_handler = new View_Handler(*mp_map);
-	mp_info_widget = new Info_Widget(this);
+	mp_info_widget = new Info_Widget(*mp_map, this);
+	mp_info_widget->set_live_validator(&m_live_validator);
 //	mp_info_widget->setMinimumWidth(200);
 	setLayout(new QHBoxLayout(this));
 	p_splitter->addWidget(mp_info_widget);
@@ -30,9 +35,22 @@ Osm_Widget::Osm_Widget(QWidget* p_parent) :
 	                 mp_info_widget, SLOT(slot_object_selected(Osm_Node&)));
 	QObject::connect(mp_view_handler, SIGNAL(signal_object_selected(Osm_Way&)),
 	                 mp_info_widget, SLOT(slot_object_selected(Osm_Way&)));
+	QObject::connect(mp_view_handler, SIGNAL(signal_selection_changed(QList<Osm_Info*>)),
+	                 mp_info_widget, SLOT(slot_selection_changed(QList<Osm_Info*>)));
+	QObject::connect(mp_xml_loader, SIGNAL(signal_progress(qint64,qint64,int)),
+	                 this, SIGNAL(signal_load_progress(qint64,qint64,int)));
+	QObject::connect(mp_xml_loader, SIGNAL(signal_finished(int)),
+	                 this, SLOT(slot_load_finished(int)));
+	QObject::connect(mp_xml_saver, SIGNAL(signal_finished(int,QString)),
+	                 this, SIGNAL(signal_save_finished(int,QString)));
 }
 
 Osm_Widget::~Osm_Widget() {
+	delete mp_xml_loader;
+	delete mp_xml_saver;
+	m_map_versioner.unfollow();
+	mp_info_widget->set_live_validator(nullptr);
+	m_live_validator.unfollow();
 	mp_map->orphan();
 	delete mp_view_handler;
 	delete mp_xml_handler;
@@ -42,6 +60,21 @@ Osm_Widget::~Osm_Widget() {
 	}
 }
 
+/*================================================================*/
+/*                       Private methods                          */
+/*================================================================*/
+
+/* The loaded map replaces the current one in a single call, views included */
+void Osm_Widget::slot_load_finished(int result_code) {
+	Osm_Map* p_loaded = (result_code == OSM_OK ? mp_xml_loader->take_map() : nullptr);
+
+	if (p_loaded != nullptr) {
+		mp_map->take(*p_loaded);
+		delete p_loaded;
+	}
+	emit signal_load_finished(result_code);
+}
+
 /*================================================================*/
 /*                        Public methods                          */
 /*================================================================*/
@@ -54,10 +87,40 @@ int Osm_Widget::save_to_xml(const QString& xml_path) {
 	return mp_xml_handler->save_to_xml(xml_path);
 }
 
+/* Validated once when complete rather than element by element as it comes in */
 int Osm_Widget::load_from_xml(const QString &xml_path) {
+	int result_code;
+
 //	return m_xml_handler.load_from_xml(xml_path);
+	m_live_validator.unfollow();
 	mp_map->clear();
-	return mp_xml_handler->load_from_xml(xml_path);
+	result_code = mp_xml_handler->load_from_xml(xml_path);
+	m_live_validator.follow(*mp_map);
+	return result_code;
+}
+
+bool Osm_Widget::load_from_xml_async(const QString& xml_path) {
+	return mp_xml_loader->start(xml_path);
+}
+
+bool Osm_Widget::is_loading() const {
+	return mp_xml_loader->is_busy();
+}
+
+bool Osm_Widget::save_to_xml_async(const QString& xml_path) {
+	return mp_xml_saver->start(m_map_versioner.get_snapshot(), xml_path);
+}
+
+bool Osm_Widget::is_saving() const {
+	return mp_xml_saver->is_busy();
+}
+
+Map_Snapshot Osm_Widget::get_snapshot() {
+	return m_map_versioner.get_snapshot();
+}
+
+const Live_Validator& Osm_Widget::get_live_validator() const {
+	return m_live_validator;
 }
 
 void Osm_Widget::slot_select_tool_cursor() {
@@ -71,3 +134,11 @@ void Osm_Widget::slot_select_tool_node() {
 void Osm_Widget::slot_select_tool_way() {
 	mp_view_handler->set_tool(Osm_Tool::WAY);
 }
+
+void Osm_Widget::slot_set_tiled_rendering(bool f) {
+	mp_view_handler->set_tiled_rendering(f);
+}
+
+void Osm_Widget::slot_cancel_loading() {
+	mp_xml_loader->cancel();
+}
@@ -2,6 +2,8 @@
 #define OSM_WIDGET_H
 
 #include "xml_handler/xml_handler.h"
+#include "xml_handler/xml_loader.h"
+#include "xml_handler/xml_saver.h"
 #include "view_handler/view_handler.h"
 #include "info_widget/info_widget.h"
 #include "osm_elements.h"
@@ -9,15 +11,33 @@
 
 class Osm_Widget : public QWidget {
 	Q_OBJECT
+signals:
+	void					signal_load_progress	(qint64 bytes_read, qint64 bytes_total, int n_elements);
+	void					signal_load_finished	(int result_code);
+	void					signal_save_finished	(int result_code, const QString& xml_path);
+private slots:
+	void					slot_load_finished		(int result_code);
 private:
 	ns_osm::Info_Widget*	mp_info_widget;
 	ns_osm::Osm_Map*		mp_map;
 	ns_osm::Xml_Handler*	mp_xml_handler;
+	ns_osm::Xml_Loader*		mp_xml_loader;
+	ns_osm::Xml_Saver*		mp_xml_saver;
+	ns_osm::Map_Versioner	m_map_versioner; /* Snapshots for background readers */
+	ns_osm::Live_Validator	m_live_validator; /* Issues kept current while editing */
 	ns_osm::View_Handler*	mp_view_handler;
 public:
 	void					select_tool				(Osm_Tool);
 	int						save_to_xml				(const QString& xml_path);
 	int						load_from_xml			(const QString& xml_path);
+	/* Parses on a worker thread; the current map stays until the new one is complete */
+	bool					load_from_xml_async		(const QString& xml_path); /* False while a load runs */
+	bool					is_loading				() const;
+	/* Writes a snapshot on a worker thread; editing goes on meanwhile */
+	bool					save_to_xml_async		(const QString& xml_path); /* False while a save runs */
+	bool					is_saving				() const;
+	ns_osm::Map_Snapshot	get_snapshot			(); /* Costs what changed since the last one */
+	const ns_osm::Live_Validator&	get_live_validator	() const;
 	                        Osm_Widget				(QWidget* p_parent = nullptr);
 	Osm_Widget&				operator=				(const Osm_Widget&) = delete;
 	                        Osm_Widget				(const Osm_Widget&) = delete;
@@ -26,6 +46,8 @@ public slots:
 	void					slot_select_tool_cursor	();
 	void					slot_select_tool_node	();
 	void					slot_select_tool_way	();
+	void					slot_set_tiled_rendering(bool);
+	void					slot_cancel_loading		();
 };
 
 #endif // OSM_WIDGET_H
@@ -34,9 +34,15 @@ view_handler/osm_view.cpp       \
 view_handler/view_handler.cpp   \
 xml_handler/osm_xml.cpp         \
 xml_handler/xml_handler.cpp     \
+xml_handler/xml_loader.cpp      \
+xml_handler/xml_saver.cpp       \
 info_widget/tag_table.cpp       \
+info_widget/tag_model.cpp       \
+info_widget/bulk_tag_model.cpp  \
 info_widget/info_widget.cpp     \
-    view_handler/coord_handler.cpp
+    view_handler/coord_handler.cpp \
+    view_handler/tile_cache.cpp \
+    view_handler/pick_handler.cpp
 
 HEADERS += \
 osm_message.h                   \
@@ -49,7 +55,13 @@ view_handler/osm_view.h         \
 view_handler/view_handler.h     \
 xml_handler/osm_xml.h           \
 xml_handler/xml_handler.h       \
+xml_handler/xml_loader.h        \
+xml_handler/xml_saver.h         \
 info_widget/info_widget.h       \
 info_widget/tag_table.h         \
+info_widget/tag_model.h         \
+info_widget/bulk_tag_model.h    \
     view_handler/coord_handler.h \
-    view_handler/osm_tool.h
+    view_handler/osm_tool.h \
+    view_handler/tile_cache.h \
+    view_handler/pick_handler.h
@@ -158,6 +158,8 @@ void Coord_Handler::handle_event_update(Osm_Object&) {
 
 	if (event == MAP_CLEARED) {
 		reset_autorects();
+	} else if (event == MAP_RELOADED) {
+		recalculate_autorects();
 	} else if (event == MAP_NODE_UPDATED || event == MAP_NODE_ADDED) {
 		if (get_meta().get_subject() == nullptr) {
 			return;
@@ -179,7 +181,11 @@ void Coord_Handler::set_map(Osm_Map& map) {
 }
 
 QPointF Coord_Handler::get_pos_on_scene(Osm_Node& node) const {
-	QPointF point(node.get_lon(), node.get_lat());
+	return get_pos_on_scene(node.get_lat(), node.get_lon());
+}
+
+QPointF Coord_Handler::get_pos_on_scene(double lat, double lon) const {
+	QPointF point(lon, lat);
 
 	if (get_normalized_rect().right() > 180 && point.x() <= 0) {
 		point.setX(point.x() + 360.0);
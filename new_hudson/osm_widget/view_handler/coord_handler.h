@@ -33,6 +33,7 @@ protected:
 public:
 	void				set_map					(Osm_Map&);
 	QPointF				get_pos_on_scene		(Osm_Node&) const;
+	QPointF				get_pos_on_scene		(double lat, double lon) const;
 	QPointF				get_geo_coords			(QPointF scene_pos) const;
 	                    Coord_Handler			();
 						Coord_Handler			(const Coord_Handler&);
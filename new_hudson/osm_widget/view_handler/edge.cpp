@@ -48,17 +48,17 @@ QList<Edge> Edge::to_edge_list(const Osm_Way& way) {
 }
 
 QList<Edge> Edge::to_edge_list(const QList<Osm_Node*>& nodelist) {
-	QList<Edge>					edges;
-	QList<Osm_Node*>			nodes(nodelist);
-	QList<Osm_Node*>::iterator	it_current = nodes.begin();
-	QList<Osm_Node*>::iterator	it_next = nodes.begin();
+	QList<Edge>							edges;
+	QList<Osm_Node*>::const_iterator	it_current = nodelist.cbegin();
+	QList<Osm_Node*>::const_iterator	it_next = nodelist.cbegin();
 
 	if (nodelist.size() <= 1) {
 		return edges;
 	}
 
+	edges.reserve(nodelist.size() - 1);
 	it_next++;
-	while (it_next != nodes.end()) {
+	while (it_next != nodelist.cend()) {
 		edges.push_back(Edge(**it_current, **it_next));
 		it_current++;
 		it_next++;
@@ -15,7 +15,7 @@ Item_Edge::Item_Edge(const Coord_Handler& handler,
                        QGraphicsObject(p_parent),
                        Edge(node1, node2),
                        m_coord_handler(handler),
-                       m_way(way)
+                       mp_way(&way)
 {
 	subscribe(*first());
 	subscribe(*second());
@@ -23,6 +23,9 @@ Item_Edge::Item_Edge(const Coord_Handler& handler,
 	setFlag(ItemSendsGeometryChanges);
 	setActive(true);
 	setAcceptedMouseButtons(Qt::LeftButton | Qt::RightButton | Qt::MidButton);
+	m_pos_first = m_coord_handler.get_pos_on_scene(*first());
+	m_pos_second = m_coord_handler.get_pos_on_scene(*second());
+	f_highlighted = false;
 }
 
 Item_Edge::Item_Edge(const Coord_Handler& handler,
@@ -33,7 +36,7 @@ Item_Edge::Item_Edge(const Coord_Handler& handler,
                        QGraphicsObject(p_parent),
                        Edge(edge),
                        m_coord_handler(handler),
-                       m_way(way)
+                       mp_way(&way)
 {
 	subscribe(*first());
 	subscribe(*second());
@@ -41,6 +44,9 @@ Item_Edge::Item_Edge(const Coord_Handler& handler,
 	setFlag(ItemSendsGeometryChanges);
 	setActive(true);
 	setAcceptedMouseButtons(Qt::LeftButton | Qt::RightButton | Qt::MidButton);
+	m_pos_first = m_coord_handler.get_pos_on_scene(*first());
+	m_pos_second = m_coord_handler.get_pos_on_scene(*second());
+	f_highlighted = false;
 }
 
 Item_Edge::~Item_Edge() {}
@@ -48,14 +54,30 @@ Item_Edge::~Item_Edge() {}
 /*                      Protected methods                         */
 /*================================================================*/
 
+void Item_Edge::refresh_geometry() {
+	QPointF pos_first = m_coord_handler.get_pos_on_scene(*first());
+	QPointF pos_second = m_coord_handler.get_pos_on_scene(*second());
+
+	if (pos_first == m_pos_first && pos_second == m_pos_second) {
+		return;
+	}
+	/* The old bounds are reported here, the new ones after the positions are swapped */
+	prepareGeometryChange();
+	m_pos_first = pos_first;
+	m_pos_second = pos_second;
+}
+
 void Item_Edge::mouseReleaseEvent(QGraphicsSceneMouseEvent *event) {
-	emit signal_edge_clicked(event->scenePos(), &m_way, first(), second(), event->button());
+	emit signal_edge_clicked(event->scenePos(), mp_way, first(), second(), event->button());
 	QGraphicsItem::mouseReleaseEvent(event);
 }
 
 void Item_Edge::handle_event_update(Osm_Node& node) {
-	prepareGeometryChange();
-	update(boundingRect());
+	/* The edge is edited live, so it is drawn over the (outdated) tiles */
+	if (flags() & ItemHasNoContents) {
+		setFlag(ItemHasNoContents, false);
+	}
+	refresh_geometry();
 }
 
 /*================================================================*/
@@ -66,19 +88,60 @@ int Item_Edge::type() const {
 	return Type;
 }
 
+void Item_Edge::reset(Osm_Node& node1, Osm_Node& node2, Osm_Way& way) {
+	unsubscribe();
+	Edge::operator=(Edge(node1, node2));
+	mp_way = &way;
+	subscribe(node1);
+	subscribe(node2);
+	refresh_geometry();
+	f_highlighted = false;
+	setFlag(ItemHasNoContents, false);
+	setEnabled(true);
+	show();
+}
+
+void Item_Edge::detach() {
+	unsubscribe();
+}
+
+void Item_Edge::set_highlighted(bool f) {
+	if (f == f_highlighted) {
+		return;
+	}
+	f_highlighted = f;
+	if (f) {
+		setFlag(ItemHasNoContents, false);
+	}
+	update();
+}
+
+bool Item_Edge::is_highlighted() const {
+	return f_highlighted;
+}
+
 QRectF Item_Edge::boundingRect() const {
-	double left = std::min(m_coord_handler.get_pos_on_scene(*first()).x(), m_coord_handler.get_pos_on_scene(*second()).x());
-	double top = std::max(m_coord_handler.get_pos_on_scene(*first()).y(), m_coord_handler.get_pos_on_scene(*second()).y());
-	double right = std::max(m_coord_handler.get_pos_on_scene(*first()).x(), m_coord_handler.get_pos_on_scene(*second()).x());
-	double bottom = std::min(m_coord_handler.get_pos_on_scene(*first()).y(), m_coord_handler.get_pos_on_scene(*second()).y());
+	const double MARGIN = 1.0; /* Half of the pen width */
+
+	return QRectF(m_pos_first, m_pos_second).normalized().adjusted(-MARGIN, -MARGIN, MARGIN, MARGIN);
+}
+
+QPainterPath Item_Edge::shape() const {
+	QPainterPath		path(m_pos_first);
+	QPainterPathStroker	stroker;
 
-	return QRectF(QPointF(left, top), QPointF(right, bottom));
+	path.lineTo(m_pos_second);
+	stroker.setWidth(2.0);
+	return stroker.createStroke(path);
 }
 
 void Item_Edge::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
 	QPen pen;
 
 	pen.setWidth(1);
+	if (f_highlighted) {
+		pen.setColor(Qt::GlobalColor::darkCyan);
+	}
 	painter->setPen(pen);
-	painter->drawLine(m_coord_handler.get_pos_on_scene(*first()), m_coord_handler.get_pos_on_scene(*second()));
+	painter->drawLine(m_pos_first, m_pos_second);
 }
@@ -28,15 +28,24 @@ signals:
 protected:
 //	const Osm_Map&	m_map;
 	const Coord_Handler&	m_coord_handler;
-	Osm_Way&				m_way;
+	Osm_Way*				mp_way;
+	QPointF					m_pos_first;  /* Projected positions of the nodes, */
+	QPointF					m_pos_second; /* as they were painted last time */
+	bool					f_highlighted;
 
+	void					refresh_geometry	();
 	void					mouseReleaseEvent	(QGraphicsSceneMouseEvent *event) override;
 	void					handle_event_update	(Osm_Node&) override;
 public:
 	enum {Type = UserType + 2};
 
 	int						type				() const override;
+	void					reset				(Osm_Node& node1, Osm_Node& node2, Osm_Way&); /* Rebinds a recycled item */
+	void					detach				(); /* Stops listening to the nodes */
+	void					set_highlighted		(bool f); /* Selected, drawn over the tiles */
+	bool					is_highlighted		() const;
 	QRectF					boundingRect		() const override;
+	QPainterPath			shape				() const override; /* The line itself, not its bounding box */
 	void					paint				(QPainter *painter,
 	                                             const QStyleOptionGraphicsItem *option,
 	                                             QWidget *widget) override;
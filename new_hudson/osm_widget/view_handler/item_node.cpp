@@ -2,6 +2,12 @@
 
 using namespace ns_osm;
 
+/*================================================================*/
+/*                        Static members                          */
+/*================================================================*/
+
+const int Item_Node::COMMIT_INTERVAL = 16;
+
 /*================================================================*/
 /*                  Constructors, destructors                     */
 /*================================================================*/
@@ -12,8 +18,11 @@ Item_Node::Item_Node(const Coord_Handler& handler,
                      :
                        QGraphicsObject(p_parent),
                        m_coord_handler(handler),
-                       m_node(node)
+                       mp_node(&node)
 {
+	f_dragging = false;
+	f_position_dirty = false;
+	f_highlighted = false;
 	setPos(m_coord_handler.get_pos_on_scene(node));
 	setZValue(10);
 	setFlag(ItemIsMovable);
@@ -28,16 +37,29 @@ Item_Node::~Item_Node() {}
 /*                      Protected methods                         */
 /*================================================================*/
 
+void Item_Node::commit_position() {
+	QPointF pos;
+
+	m_commit_timer.stop();
+	if (!f_position_dirty) {
+		return;
+	}
+	f_position_dirty = false;
+	pos = m_coord_handler.get_geo_coords(this->pos());
+	mp_node->set_lat_lon(pos.y(), pos.x());
+}
+
 QVariant Item_Node::itemChange(GraphicsItemChange change, const QVariant &value) {
-	QPointF pos = value.toPointF();
-	pos = m_coord_handler.get_geo_coords(pos);
-	prepareGeometryChange();
+	/* The bounding rect is local and constant, so moving the item already repaints the old and new spot */
 	switch (change) {
 	case ItemPositionHasChanged:
-		m_node.set_lat_lon(pos.y(), pos.x());
-		break;
-	case ItemPositionChange:
-		m_node.set_lat_lon(pos.y(), pos.x());
+		f_position_dirty = true;
+		/* While dragging, the node hears about the item at most once a frame */
+		if (!f_dragging) {
+			commit_position();
+		} else if (!m_commit_timer.isActive()) {
+			m_commit_timer.start(COMMIT_INTERVAL, this);
+		}
 		break;
 	default:
 		break;
@@ -45,8 +67,26 @@ QVariant Item_Node::itemChange(GraphicsItemChange change, const QVariant &value)
 	return QGraphicsItem::itemChange(change, value);
 }
 
+void Item_Node::timerEvent(QTimerEvent *event) {
+	if (event->timerId() != m_commit_timer.timerId()) {
+		QGraphicsObject::timerEvent(event);
+		return;
+	}
+	commit_position();
+}
+
+void Item_Node::mousePressEvent(QGraphicsSceneMouseEvent *event) {
+	f_dragging = (event->button() == Qt::LeftButton);
+	QGraphicsObject::mousePressEvent(event);
+}
+
 void Item_Node::mouseReleaseEvent(QGraphicsSceneMouseEvent *event) {
-	emit signal_node_clicked(&m_node, event->button());
+	/* The final position goes to the node as a single update */
+	if (f_dragging) {
+		f_dragging = false;
+		commit_position();
+	}
+	emit signal_node_clicked(mp_node, event->button());
 	QGraphicsItem::mouseReleaseEvent(event);
 }
 
@@ -55,7 +95,41 @@ void Item_Node::mouseReleaseEvent(QGraphicsSceneMouseEvent *event) {
 /*================================================================*/
 
 Osm_Node* Item_Node::get_node() const {
-	return &m_node;
+	return mp_node;
+}
+
+void Item_Node::reset(Osm_Node& node) {
+	detach();
+	mp_node = &node;
+	f_highlighted = false;
+	/* Placing the item must not write the position back into the node */
+	setFlag(ItemSendsGeometryChanges, false);
+	setPos(m_coord_handler.get_pos_on_scene(node));
+	setFlag(ItemSendsGeometryChanges);
+	setFlag(ItemHasNoContents, false);
+	setEnabled(true);
+	show();
+}
+
+void Item_Node::detach() {
+	m_commit_timer.stop();
+	f_dragging = false;
+	f_position_dirty = false;
+}
+
+void Item_Node::set_highlighted(bool f) {
+	if (f == f_highlighted) {
+		return;
+	}
+	f_highlighted = f;
+	if (f) {
+		setFlag(ItemHasNoContents, false);
+	}
+	update();
+}
+
+bool Item_Node::is_highlighted() const {
+	return f_highlighted;
 }
 
 int Item_Node::type() const {
@@ -66,7 +140,7 @@ void Item_Node::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
 	QPen pen;
 	QBrush brush;
 
-	brush.setColor(Qt::GlobalColor::darkBlue);
+	brush.setColor(f_highlighted ? Qt::GlobalColor::cyan : Qt::GlobalColor::darkBlue);
 	brush.setStyle(Qt::BrushStyle::SolidPattern);
 	pen.setColor(Qt::red);
 	pen.setWidth(1);
@@ -16,16 +16,28 @@ class Item_Node : public QGraphicsObject {
 signals:
 	void			signal_node_clicked	(Osm_Node*, Qt::MouseButton);
 protected:
+	static const int		COMMIT_INTERVAL; /* Milliseconds, about one frame */
 	const Coord_Handler&	m_coord_handler;
-	Osm_Node&				m_node;
+	Osm_Node*				mp_node;
+	QBasicTimer				m_commit_timer;
+	bool					f_dragging;
+	bool					f_position_dirty; /* The item moved, the node does not know yet */
+	bool					f_highlighted;
 
+	void			commit_position		();
 //	int				get_pen_size		() const;
 	QVariant		itemChange			(GraphicsItemChange change, const QVariant &value) override;
+	void			timerEvent			(QTimerEvent *event) override;
+	void			mousePressEvent		(QGraphicsSceneMouseEvent *event) override;
 	void			mouseReleaseEvent	(QGraphicsSceneMouseEvent *event) override;
 public:
 	enum {Type = UserType + 1};
 
 	Osm_Node*		get_node			() const;
+	void			reset				(Osm_Node&); /* Rebinds a recycled item to another node */
+	void			detach				(); /* Drops a pending position, the node may be gone */
+	void			set_highlighted		(bool f); /* Selected, drawn over the tiles */
+	bool			is_highlighted		() const;
 	int				type				() const override;
 	virtual void	paint				(QPainter *painter,
 	                                     const QStyleOptionGraphicsItem *option,
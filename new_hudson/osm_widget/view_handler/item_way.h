@@ -17,19 +17,21 @@ class View_Handler;
 class Item_Way : public QGraphicsItem, public Osm_Subscriber {
 	//Q_OBJECT
 private:
-	struct Diff;
-	mutable QList<Item_Edge*>	m_edges;
+	mutable QList<Item_Edge*>	m_edges; /* m_edges[i] joins nodes i and i + 1 of m_way */
 //	const Osm_Map&				m_map;
-	const Coord_Handler			m_coord_handler;
+	const Coord_Handler&		m_coord_handler;
 	View_Handler&				m_view_handler;
 	Osm_Way&					m_way;
+	QRectF						m_bounding_rect;
+	bool						f_highlighted;
 
+	QRectF						get_node_rect		(Osm_Node&) const;
+	void						fit_bounding_rect	(const QRectF&); /* Grows only */
+	void						recalculate_bounding_rect();
+	bool						is_edge_at			(int item_edge_pos, Osm_Node* p_first, Osm_Node* p_second) const;
 	bool						split_edge			(int item_edge_pos, Osm_Node* p_node_to_split_with);
 	bool						merge_edges			(int item_edge_pos_prev, int item_edge_pos_next);
-	int							seek_pos_node_first	(Osm_Node* p_first, Osm_Node* p_next = nullptr) const;
-	int							seek_pos_item_edge	(Osm_Node* p_first, Osm_Node* p_second) const;
-	Diff						get_diff			() const;
-	void						handle_diffs		();
+	void						resync				(); /* O(n) fallback for events without positions */
 	void						handle_added_front	();
 	void						handle_added_back	();
 	void						handle_added_mid	(const Meta&);
@@ -46,6 +48,8 @@ public:
 
 	QRectF						boundingRect		() const override;
 	Osm_Way*					get_way				() const;
+	void						set_edges_hollow	(bool f); /* Edges do not paint, tiles do */
+	void						set_highlighted		(bool f);
 	void						paint				(QPainter *painter,
 	                                                 const QStyleOptionGraphicsItem *option,
 	                                                 QWidget *widget) override;
@@ -60,17 +64,6 @@ public:
 	Item_Way&					operator=			(const Item_Way&)	= delete;
 };
 
-/*================================================================*/
-/*                        Item_Way::Diff                          */
-/*================================================================*/
-
-struct Item_Way::Diff {
-	enum Diff_Type {ADD_BEFORE, REMOVE, NONE}	type;
-	QList<Item_Edge*>::iterator					it_diff;
-	Osm_Node*									p_node_first;
-	Osm_Node*									p_node_second;
-};
-
 }
 
 #endif // ITEM_WAY_H
@@ -7,21 +7,58 @@ using namespace ns_osm;
 /*================================================================*/
 
 Osm_View::Osm_View(QWidget* p_parent) : QGraphicsView(p_parent) {
+	mp_tile_cache = nullptr;
+	mp_rubber_band = new QRubberBand(QRubberBand::Rectangle, viewport());
+	mp_rubber_band->hide();
 //	setDragMode(ScrollHandDrag);
 	setRenderHint(QPainter::Antialiasing, true);
 	setRenderHint(QPainter::SmoothPixmapTransform, true);
 	setTransformationAnchor(AnchorUnderMouse);
-	setViewportUpdateMode(FullViewportUpdate);
 //	setMinimumSize(600,400);
 //	setViewportUpdateMode(BoundingRectViewportUpdate);
+	/* Items report exact old and new bounds, so only the dirty region is repainted */
+	setViewportUpdateMode(MinimalViewportUpdate);
 }
 
 Osm_View::~Osm_View() {}
 
+/*================================================================*/
+/*                       Private methods                          */
+/*================================================================*/
+
+void Osm_View::slot_tile_ready(QRectF scene_rect) {
+	invalidateScene(scene_rect, QGraphicsScene::BackgroundLayer);
+}
+
 /*================================================================*/
 /*                      Protected methods                         */
 /*================================================================*/
 
+void Osm_View::drawBackground(QPainter* p_painter, const QRectF& rect) {
+	int				zoom;
+	double			extent;
+	const QImage*	p_tile;
+
+	QGraphicsView::drawBackground(p_painter, rect);
+	if (mp_tile_cache == nullptr) {
+		return;
+	}
+	zoom = Tile_Cache::zoom_for_scale(transform().m11());
+	extent = Tile_Cache::tile_extent(zoom);
+	for (int x = static_cast<int>(std::floor(rect.left() / extent)); x * extent < rect.right(); ++x) {
+		for (int y = static_cast<int>(std::floor(rect.top() / extent)); y * extent < rect.bottom(); ++y) {
+			if ((p_tile = mp_tile_cache->get_tile(zoom, x, y)) != nullptr) {
+				p_painter->drawImage(Tile_Cache::tile_rect(zoom, x, y), *p_tile);
+			/* Until the tile is ready, stretch the coarser one if it is still cached */
+			} else if ((p_tile = mp_tile_cache->peek_tile(zoom - 1, x >> 1, y >> 1)) != nullptr) {
+				QRectF source(QPointF((x & 1) * Tile_Cache::TILE_SIZE / 2.0, (y & 1) * Tile_Cache::TILE_SIZE / 2.0),
+				              QSizeF(Tile_Cache::TILE_SIZE / 2.0, Tile_Cache::TILE_SIZE / 2.0));
+				p_painter->drawImage(Tile_Cache::tile_rect(zoom, x, y), *p_tile, source);
+			}
+		}
+	}
+}
+
 void Osm_View::wheelEvent(QWheelEvent* p_event) {
 	double factor;
 	switch (p_event->modifiers()) {
@@ -41,19 +78,54 @@ void Osm_View::wheelEvent(QWheelEvent* p_event) {
 	default:
 		break;
 	}
+	emit signal_visible_rect_changed();
+}
+
+void Osm_View::scrollContentsBy(int dx, int dy) {
+	QGraphicsView::scrollContentsBy(dx, dy);
+	emit signal_visible_rect_changed();
+}
+
+void Osm_View::resizeEvent(QResizeEvent* p_event) {
+	QGraphicsView::resizeEvent(p_event);
+	emit signal_visible_rect_changed();
+}
+
+void Osm_View::mousePressEvent(QMouseEvent* p_event) {
+	if (p_event->button() == Qt::LeftButton && (p_event->modifiers() & Qt::ShiftModifier)) {
+		m_rubber_origin = p_event->pos();
+		mp_rubber_band->setGeometry(QRect(m_rubber_origin, QSize()));
+		mp_rubber_band->show();
+		return;
+	}
+	QGraphicsView::mousePressEvent(p_event);
+}
+
+void Osm_View::mouseMoveEvent(QMouseEvent* p_event) {
+	if (mp_rubber_band->isVisible()) {
+		mp_rubber_band->setGeometry(QRect(m_rubber_origin, p_event->pos()).normalized());
+		return;
+	}
+	QGraphicsView::mouseMoveEvent(p_event);
 }
 
 void Osm_View::mouseReleaseEvent(QMouseEvent* p_event) {
+	if (mp_rubber_band->isVisible() && p_event->button() == Qt::LeftButton) {
+		mp_rubber_band->hide();
+		emit signal_area_selected(mapToScene(mp_rubber_band->geometry()).boundingRect(),
+		                          p_event->modifiers() & Qt::ControlModifier);
+		return;
+	}
+	/* An item that took the press handles the click itself, anything else is
+	 * left to View_Handler, which snaps it to the nearest node or segment */
+	bool f_grabbed = (scene() != nullptr && scene()->mouseGrabberItem() != nullptr);
+
 	switch (p_event->button()) {
 	case Qt::MouseButton::MiddleButton:
 		break;
 	case Qt::MouseButton::RightButton:
-		if (items(p_event->pos()).empty()) {
-			emit signal_blank_area_clicked(p_event->pos(), p_event->button());
-		}
-		break;
 	case Qt::MouseButton::LeftButton:
-		if (items(p_event->pos()).empty()) {
+		if (!f_grabbed) {
 			emit signal_blank_area_clicked(mapToScene(p_event->pos()), p_event->button());
 		}
 		break;
@@ -62,3 +134,20 @@ void Osm_View::mouseReleaseEvent(QMouseEvent* p_event) {
 	}
 	QGraphicsView::mouseReleaseEvent(p_event);
 }
+
+/*================================================================*/
+/*                        Public methods                          */
+/*================================================================*/
+
+void Osm_View::set_tile_cache(Tile_Cache* p_tile_cache) {
+	if (mp_tile_cache != nullptr) {
+		QObject::disconnect(mp_tile_cache, SIGNAL(signal_tile_ready(QRectF)),
+		                    this, SLOT(slot_tile_ready(QRectF)));
+	}
+	mp_tile_cache = p_tile_cache;
+	if (mp_tile_cache != nullptr) {
+		QObject::connect(mp_tile_cache, SIGNAL(signal_tile_ready(QRectF)),
+		                 this, SLOT(slot_tile_ready(QRectF)));
+	}
+	viewport()->update();
+}
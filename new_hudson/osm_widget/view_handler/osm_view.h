@@ -6,16 +6,32 @@
 #include <QtWidgets>
 #endif /* Include guard QT_WIDGETS_H */
 
+#include "tile_cache.h"
+
 namespace ns_osm {
 
 class Osm_View : public QGraphicsView {
 	Q_OBJECT
 signals:
 	void	signal_blank_area_clicked	(QPointF, Qt::MouseButton);
+	void	signal_area_selected		(QRectF scene_rect, bool f_extend);
+	void	signal_visible_rect_changed	(); /* Scrolled, zoomed or resized */
+private slots:
+	void	slot_tile_ready				(QRectF scene_rect);
+private:
+	Tile_Cache*	mp_tile_cache;
+	QRubberBand*	mp_rubber_band; /* Shift + drag selects an area */
+	QPoint			m_rubber_origin;
 protected:
+	void	drawBackground				(QPainter *painter, const QRectF &rect) override;
 	void	wheelEvent					(QWheelEvent *event) override;
+	void	scrollContentsBy			(int dx, int dy) override;
+	void	resizeEvent					(QResizeEvent *event) override;
+	void	mousePressEvent				(QMouseEvent *event) override;
+	void	mouseMoveEvent				(QMouseEvent *event) override;
 	void	mouseReleaseEvent			(QMouseEvent *event) override;
 public:
+	void	set_tile_cache				(Tile_Cache*); /* nullptr switches tiled rendering off */
 	        Osm_View					(QWidget* p_parent = nullptr);
 	virtual	~Osm_View					();
 };
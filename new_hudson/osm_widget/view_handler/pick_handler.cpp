@@ -0,0 +1,405 @@
+#include "pick_handler.h"
+
+using namespace ns_osm;
+
+/*================================================================*/
+/*                        Static members                          */
+/*================================================================*/
+
+const double Pick_Handler::CELL_SIZE = 64.0;
+const int Pick_Handler::MAX_SEGMENT_CELLS = 4096;
+const quint64 Pick_Handler::LONG_SEGMENTS_KEY = Pick_Handler::cell_key(INT_MIN, INT_MIN); /* Far off any projected point */
+
+/*================================================================*/
+/*                  Constructors, destructors                     */
+/*================================================================*/
+
+Pick_Handler::Pick_Handler(const Coord_Handler& handler) : m_coord_handler(handler) {}
+
+Pick_Handler::~Pick_Handler() {}
+
+/*================================================================*/
+/*                       Private methods                          */
+/*================================================================*/
+
+quint64 Pick_Handler::cell_key(int cell_x, int cell_y) {
+	return (static_cast<quint64>(static_cast<quint32>(cell_x)) << 32) | static_cast<quint32>(cell_y);
+}
+
+int Pick_Handler::cell_coord(double scene_coord) {
+	return static_cast<int>(std::floor(scene_coord / CELL_SIZE));
+}
+
+double Pick_Handler::distance_to_segment(const QPointF& point,
+                                         const QPointF& first,
+                                         const QPointF& second,
+                                         QPointF* p_nearest)
+{
+	QPointF	direction = second - first;
+	double	length_sq = QPointF::dotProduct(direction, direction);
+	double	t = 0.0;
+	QPointF	nearest;
+
+	if (length_sq > 0.0) {
+		t = qBound(0.0, QPointF::dotProduct(point - first, direction) / length_sq, 1.0);
+	}
+	nearest = first + direction * t;
+	if (p_nearest != nullptr) {
+		*p_nearest = nearest;
+	}
+	return std::hypot(point.x() - nearest.x(), point.y() - nearest.y());
+}
+
+/* Walks the grid cells the segment actually crosses (Amanatides-Woo) */
+void Pick_Handler::cells_on_segment(const QPointF& first,
+                                    const QPointF& second,
+                                    QVector<quint64>& cells) const
+{
+	const double	INF = std::numeric_limits<double>::infinity();
+	int				x = cell_coord(first.x());
+	int				y = cell_coord(first.y());
+	int				x_end = cell_coord(second.x());
+	int				y_end = cell_coord(second.y());
+	int				n_steps = std::abs(x_end - x) + std::abs(y_end - y);
+	double			dx = second.x() - first.x();
+	double			dy = second.y() - first.y();
+	int				step_x = (dx > 0) ? 1 : -1;
+	int				step_y = (dy > 0) ? 1 : -1;
+	double			t_max_x = (dx != 0) ? ((x + (step_x > 0 ? 1 : 0)) * CELL_SIZE - first.x()) / dx : INF;
+	double			t_max_y = (dy != 0) ? ((y + (step_y > 0 ? 1 : 0)) * CELL_SIZE - first.y()) / dy : INF;
+	double			t_delta_x = (dx != 0) ? CELL_SIZE / std::fabs(dx) : INF;
+	double			t_delta_y = (dy != 0) ? CELL_SIZE / std::fabs(dy) : INF;
+
+	/* Huge segments would flood the grid, they are checked on every pick instead */
+	if (n_steps >= MAX_SEGMENT_CELLS) {
+		cells.push_back(LONG_SEGMENTS_KEY);
+		return;
+	}
+	cells.push_back(cell_key(x, y));
+	for (int i = 0; i < n_steps; ++i) {
+		/* Rounding must not lead the walk past the last cell */
+		if (y == y_end || (x != x_end && t_max_x < t_max_y)) {
+			x += step_x;
+			t_max_x += t_delta_x;
+		} else {
+			y += step_y;
+			t_max_y += t_delta_y;
+		}
+		cells.push_back(cell_key(x, y));
+	}
+}
+
+void Pick_Handler::index_node(Osm_Node* p_node) {
+	QPointF	pos = m_coord_handler.get_pos_on_scene(*p_node);
+	quint64	key = cell_key(cell_coord(pos.x()), cell_coord(pos.y()));
+
+	m_node_cells[key].push_back(p_node);
+	m_node_to_cell.insert(p_node, key);
+}
+
+void Pick_Handler::unindex_node(Osm_Node* p_node) {
+	auto it_cell = m_node_to_cell.find(p_node);
+
+	if (it_cell == m_node_to_cell.end()) {
+		return;
+	}
+	auto it_nodes = m_node_cells.find(it_cell.value());
+	if (it_nodes != m_node_cells.end()) {
+		it_nodes.value().removeOne(p_node);
+		if (it_nodes.value().isEmpty()) {
+			m_node_cells.erase(it_nodes);
+		}
+	}
+	m_node_to_cell.erase(it_cell);
+}
+
+void Pick_Handler::index_way(Osm_Way* p_way) {
+	const QList<Osm_Node*>&	nodes = p_way->get_nodes_list();
+	QVector<quint64>&		way_cells = m_way_to_cells[p_way];
+	QPointF					pos_first;
+	QPointF					pos_second;
+	int						n_cells;
+
+	if (nodes.isEmpty()) {
+		return;
+	}
+	pos_second = m_coord_handler.get_pos_on_scene(*nodes.front());
+	for (int i = 1; i < nodes.size(); ++i) {
+		pos_first = pos_second;
+		pos_second = m_coord_handler.get_pos_on_scene(*nodes[i]);
+		n_cells = way_cells.size();
+		cells_on_segment(pos_first, pos_second, way_cells);
+		for (int j = n_cells; j < way_cells.size(); ++j) {
+			m_segment_cells[way_cells[j]].push_back(Segment{p_way, nodes[i - 1], nodes[i]});
+		}
+	}
+	for (auto it = nodes.cbegin(); it != nodes.cend(); ++it) {
+		if (!m_node_to_ways.contains(*it, p_way)) {
+			m_node_to_ways.insert(*it, p_way);
+		}
+	}
+	m_way_to_nodes.insert(p_way, nodes.toVector());
+}
+
+void Pick_Handler::unindex_way(Osm_Way* p_way) {
+	auto				it_way = m_way_to_cells.find(p_way);
+	QVector<quint64>	way_cells;
+
+	if (it_way == m_way_to_cells.end()) {
+		return;
+	}
+	way_cells = it_way.value();
+	m_way_to_cells.erase(it_way);
+	/* A one-node way has no segments, so the nodes are taken from the list kept at indexing.
+	 * They may be gone already, only the pointers are used */
+	QVector<Osm_Node*> way_nodes = m_way_to_nodes.take(p_way);
+	for (auto it = way_nodes.cbegin(); it != way_nodes.cend(); ++it) {
+		m_node_to_ways.remove(*it, p_way);
+	}
+	std::sort(way_cells.begin(), way_cells.end());
+	way_cells.erase(std::unique(way_cells.begin(), way_cells.end()), way_cells.end());
+
+	for (auto it_key = way_cells.cbegin(); it_key != way_cells.cend(); ++it_key) {
+		auto it_cell = m_segment_cells.find(*it_key);
+		if (it_cell == m_segment_cells.end()) {
+			continue;
+		}
+		QVector<Segment>& segments = it_cell.value();
+		for (int i = segments.size() - 1; i >= 0; --i) {
+			if (segments[i].p_way != p_way) {
+				continue;
+			}
+			segments[i] = segments.back();
+			segments.pop_back();
+		}
+		if (segments.isEmpty()) {
+			m_segment_cells.erase(it_cell);
+		}
+	}
+}
+
+void Pick_Handler::flush() {
+	for (auto it = m_dirty_nodes.cbegin(); it != m_dirty_nodes.cend(); ++it) {
+		unindex_node(*it);
+		index_node(*it);
+		for (auto it_way = m_node_to_ways.find(*it); it_way != m_node_to_ways.end() && it_way.key() == *it; ++it_way) {
+			m_dirty_ways.insert(it_way.value());
+		}
+	}
+	m_dirty_nodes.clear();
+	for (auto it = m_dirty_ways.cbegin(); it != m_dirty_ways.cend(); ++it) {
+		unindex_way(*it);
+		index_way(*it);
+	}
+	m_dirty_ways.clear();
+}
+
+void Pick_Handler::add_memory_usage(Memory_Usage& usage) const {
+	qint64 n_bytes = Memory_Usage::bytes_of(m_node_cells) + Memory_Usage::bytes_of(m_segment_cells)
+	                 + Memory_Usage::bytes_of(m_node_to_cell) + Memory_Usage::bytes_of(m_way_to_cells)
+	                 + Memory_Usage::bytes_of(m_way_to_nodes)
+	                 + Memory_Usage::bytes_of(m_node_to_ways)
+	                 + Memory_Usage::bytes_of(m_dirty_nodes) + Memory_Usage::bytes_of(m_dirty_ways);
+
+	for (auto it = m_node_cells.cbegin(); it != m_node_cells.cend(); ++it) {
+		n_bytes += Memory_Usage::bytes_of(*it);
+	}
+	for (auto it = m_segment_cells.cbegin(); it != m_segment_cells.cend(); ++it) {
+		n_bytes += Memory_Usage::bytes_of(*it);
+	}
+	for (auto it = m_way_to_cells.cbegin(); it != m_way_to_cells.cend(); ++it) {
+		n_bytes += Memory_Usage::bytes_of(*it);
+	}
+	for (auto it = m_way_to_nodes.cbegin(); it != m_way_to_nodes.cend(); ++it) {
+		n_bytes += Memory_Usage::bytes_of(*it);
+	}
+	usage.add(Memory_Usage::VIEW, Memory_Usage::INDEXES, n_bytes);
+}
+
+/*================================================================*/
+/*                        Public methods                          */
+/*================================================================*/
+
+void Pick_Handler::add(Osm_Node& node) {
+	if (!m_node_to_cell.contains(&node)) {
+		index_node(&node);
+	}
+}
+
+void Pick_Handler::add(Osm_Way& way) {
+	m_dirty_ways.insert(&way);
+}
+
+void Pick_Handler::remove(Osm_Node& node) {
+	unindex_node(&node);
+	m_dirty_nodes.remove(&node);
+	/* Segments still point at the node until their ways are reindexed */
+	for (auto it = m_node_to_ways.find(&node); it != m_node_to_ways.end() && it.key() == &node; ++it) {
+		m_dirty_ways.insert(it.value());
+	}
+}
+
+void Pick_Handler::remove(Osm_Way& way) {
+	unindex_way(&way);
+	m_dirty_ways.remove(&way);
+}
+
+void Pick_Handler::update(Osm_Node& node) {
+	if (m_node_to_cell.contains(&node)) {
+		m_dirty_nodes.insert(&node);
+	}
+}
+
+void Pick_Handler::update(Osm_Way& way) {
+	m_dirty_ways.insert(&way);
+}
+
+void Pick_Handler::clear() {
+	m_node_cells.clear();
+	m_segment_cells.clear();
+	m_node_to_cell.clear();
+	m_way_to_cells.clear();
+	m_way_to_nodes.clear();
+	m_node_to_ways.clear();
+	m_dirty_nodes.clear();
+	m_dirty_ways.clear();
+}
+
+Pick_Handler::Hit Pick_Handler::pick(const QPointF& scene_pos, double tolerance) {
+	Hit		hit;
+	QPointF	nearest;
+	double	distance;
+	int		x_min = cell_coord(scene_pos.x() - tolerance);
+	int		x_max = cell_coord(scene_pos.x() + tolerance);
+	int		y_min = cell_coord(scene_pos.y() - tolerance);
+	int		y_max = cell_coord(scene_pos.y() + tolerance);
+	QVector<quint64> keys;
+
+	flush();
+	keys.push_back(LONG_SEGMENTS_KEY);
+	for (int x = x_min; x <= x_max; ++x) {
+		for (int y = y_min; y <= y_max; ++y) {
+			keys.push_back(cell_key(x, y));
+		}
+	}
+
+	hit.distance = tolerance;
+	for (auto it_key = keys.cbegin(); it_key != keys.cend(); ++it_key) {
+		auto it_cell = m_node_cells.constFind(*it_key);
+		if (it_cell == m_node_cells.cend()) {
+			continue;
+		}
+		for (auto it = it_cell.value().cbegin(); it != it_cell.value().cend(); ++it) {
+			nearest = m_coord_handler.get_pos_on_scene(**it);
+			distance = std::hypot(scene_pos.x() - nearest.x(), scene_pos.y() - nearest.y());
+			if (distance <= hit.distance) {
+				hit.p_node = *it;
+				hit.point = nearest;
+				hit.distance = distance;
+			}
+		}
+	}
+	if (hit.is_node()) {
+		return hit;
+	}
+
+	for (auto it_key = keys.cbegin(); it_key != keys.cend(); ++it_key) {
+		auto it_cell = m_segment_cells.constFind(*it_key);
+		if (it_cell == m_segment_cells.cend()) {
+			continue;
+		}
+		for (auto it = it_cell.value().cbegin(); it != it_cell.value().cend(); ++it) {
+			distance = distance_to_segment(scene_pos,
+			                               m_coord_handler.get_pos_on_scene(*(it->p_first)),
+			                               m_coord_handler.get_pos_on_scene(*(it->p_second)),
+			                               &nearest);
+			if (distance <= hit.distance) {
+				hit.p_way = it->p_way;
+				hit.p_first = it->p_first;
+				hit.p_second = it->p_second;
+				hit.point = nearest;
+				hit.distance = distance;
+			}
+		}
+	}
+	return hit;
+}
+
+void Pick_Handler::query(const QRectF& scene_rect, QSet<Osm_Node*>& nodes, QSet<Osm_Way*>& ways) {
+	QRectF	rect = scene_rect.normalized();
+	int		x_min = cell_coord(rect.left());
+	int		x_max = cell_coord(rect.right());
+	int		y_min = cell_coord(rect.top());
+	int		y_max = cell_coord(rect.bottom());
+	auto	collect = [&](const QVector<Osm_Node*>& cell) {
+		for (auto it = cell.cbegin(); it != cell.cend(); ++it) {
+			if (!rect.contains(m_coord_handler.get_pos_on_scene(**it))) {
+				continue;
+			}
+			nodes.insert(*it);
+			for (auto it_way = m_node_to_ways.constFind(*it); it_way != m_node_to_ways.cend() && it_way.key() == *it; ++it_way) {
+				ways.insert(it_way.value());
+			}
+		}
+	};
+
+	flush();
+	/* A rectangle over the whole map has more empty cells than filled ones */
+	if (static_cast<double>(x_max - x_min + 1) * (y_max - y_min + 1) > m_node_cells.size()) {
+		for (auto it = m_node_cells.cbegin(); it != m_node_cells.cend(); ++it) {
+			collect(it.value());
+		}
+		return;
+	}
+	for (int x = x_min; x <= x_max; ++x) {
+		for (int y = y_min; y <= y_max; ++y) {
+			auto it_cell = m_node_cells.constFind(cell_key(x, y));
+			if (it_cell != m_node_cells.cend()) {
+				collect(it_cell.value());
+			}
+		}
+	}
+}
+
+/* Geographic lookups go through the grid; one scene unit of slack keeps
+ * elements on the border that rounding would push out */
+void Pick_Handler::find(const QRectF& geo_rect, QVector<Osm_Node*>& nodes, QVector<Osm_Way*>& ways) {
+	QSet<Osm_Node*>	node_set;
+	QSet<Osm_Way*>	way_set;
+	QRectF			scene_rect(m_coord_handler.get_pos_on_scene(geo_rect.top(), geo_rect.left()),
+	                           m_coord_handler.get_pos_on_scene(geo_rect.bottom(), geo_rect.right()));
+
+	query(scene_rect.normalized().adjusted(-1.0, -1.0, 1.0, 1.0), node_set, way_set);
+	nodes.reserve(nodes.size() + node_set.size());
+	for (auto it = node_set.cbegin(); it != node_set.cend(); ++it) {
+		nodes.push_back(*it);
+	}
+	ways.reserve(ways.size() + way_set.size());
+	for (auto it = way_set.cbegin(); it != way_set.cend(); ++it) {
+		ways.push_back(*it);
+	}
+}
+
+/*================================================================*/
+/*                       Pick_Handler::Hit                        */
+/*================================================================*/
+
+Pick_Handler::Hit::Hit() {
+	p_node = nullptr;
+	p_way = nullptr;
+	p_first = nullptr;
+	p_second = nullptr;
+	distance = 0.0;
+}
+
+bool Pick_Handler::Hit::is_empty() const {
+	return (p_node == nullptr && p_way == nullptr);
+}
+
+bool Pick_Handler::Hit::is_node() const {
+	return (p_node != nullptr);
+}
+
+bool Pick_Handler::Hit::is_segment() const {
+	return (p_node == nullptr && p_way != nullptr);
+}
@@ -0,0 +1,118 @@
+#ifndef PICK_HANDLER_H
+#define PICK_HANDLER_H
+
+#ifndef QT_WIDGETS_H
+#define QT_WIDGETS_H
+#include <QtWidgets>
+#endif /* Include guard QT_WIDGETS_H */
+
+#ifndef ALGORITHM_H
+#define ALGORITHM_H
+#include <algorithm>
+#endif /* Include guard ALGORITHM_H */
+
+#ifndef CMATH_H
+#define CMATH_H
+#include <cmath>
+#endif /* Include guard CMATH_H */
+
+#ifndef LIMITS_H
+#define LIMITS_H
+#include <limits>
+#endif /* Include guard LIMITS_H */
+
+#ifndef CLIMITS_H
+#define CLIMITS_H
+#include <climits>
+#endif /* Include guard CLIMITS_H */
+
+#include "osm_elements.h"
+#include "coord_handler.h"
+
+namespace ns_osm {
+
+/* Finds the node or way segment nearest to a scene point. Nodes and
+ * segments are kept in a uniform grid of scene cells; edits only mark
+ * elements dirty and the grid catches up right before the next pick. */
+class Pick_Handler : public Spatial_Index {
+public:
+	struct Hit;
+private:
+	struct Segment {
+		Osm_Way*	p_way;
+		Osm_Node*	p_first;
+		Osm_Node*	p_second;
+	};
+	static const double								CELL_SIZE; /* Scene units */
+	static const int								MAX_SEGMENT_CELLS;
+	static const quint64							LONG_SEGMENTS_KEY;
+	const Coord_Handler&							m_coord_handler;
+	QHash<quint64, QVector<Osm_Node*>>				m_node_cells;
+	QHash<quint64, QVector<Segment>>				m_segment_cells;
+	QHash<Osm_Node*, quint64>						m_node_to_cell;
+	QHash<Osm_Way*, QVector<quint64>>				m_way_to_cells;
+	QHash<Osm_Way*, QVector<Osm_Node*>>				m_way_to_nodes; /* As indexed, segments or not */
+	QMultiHash<Osm_Node*, Osm_Way*>					m_node_to_ways;
+	QSet<Osm_Node*>									m_dirty_nodes;
+	QSet<Osm_Way*>									m_dirty_ways;
+
+	static quint64									cell_key			(int cell_x, int cell_y);
+	static int										cell_coord			(double scene_coord);
+	static double									distance_to_segment	(const QPointF& point,
+	                                                                     const QPointF& first,
+	                                                                     const QPointF& second,
+	                                                                     QPointF* p_nearest);
+	void											cells_on_segment	(const QPointF& first,
+	                                                                     const QPointF& second,
+	                                                                     QVector<quint64>& cells) const;
+	void											index_node			(Osm_Node*);
+	void											unindex_node		(Osm_Node*);
+	void											index_way			(Osm_Way*);
+	void											unindex_way			(Osm_Way*);
+	void											flush				();
+public:
+	void											add					(Osm_Node&);
+	void											add					(Osm_Way&);
+	void											remove				(Osm_Node&);
+	void											remove				(Osm_Way&);
+	void											update				(Osm_Node&); /* Node moved */
+	void											update				(Osm_Way&);  /* Node list changed */
+	void											clear				();
+	void											add_memory_usage	(Memory_Usage&) const; /* As VIEW indexes */
+	Hit												pick				(const QPointF& scene_pos,
+	                                                                     double tolerance); /* Scene units */
+	void											query				(const QRectF& scene_rect,
+	                                                                     QSet<Osm_Node*>& nodes,
+	                                                                     QSet<Osm_Way*>& ways); /* Ways with a node inside */
+	void											find				(const QRectF& geo_rect,
+	                                                                     QVector<Osm_Node*>& nodes,
+	                                                                     QVector<Osm_Way*>& ways) override;
+	                                                Pick_Handler		(const Coord_Handler&);
+													Pick_Handler		(const Pick_Handler&) = delete;
+	Pick_Handler&									operator=			(const Pick_Handler&) = delete;
+	virtual											~Pick_Handler		();
+};
+
+/*================================================================*/
+/*                       Pick_Handler::Hit                        */
+/*================================================================*/
+
+/* A node within tolerance always wins over a segment. For a segment
+ * hit p_node is nullptr and point is the nearest point on the segment. */
+struct Pick_Handler::Hit {
+	Osm_Node*	p_node;
+	Osm_Way*	p_way;
+	Osm_Node*	p_first;
+	Osm_Node*	p_second;
+	QPointF		point;
+	double		distance;
+
+	bool		is_empty		() const;
+	bool		is_node			() const;
+	bool		is_segment		() const;
+	            Hit				();
+};
+
+}
+
+#endif // PICK_HANDLER_H
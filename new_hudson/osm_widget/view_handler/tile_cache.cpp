@@ -0,0 +1,473 @@
+#include "tile_cache.h"
+
+using namespace ns_osm;
+
+/*================================================================*/
+/*                   Tile_Cache::Rasterizer                       */
+/*================================================================*/
+
+namespace ns_osm {
+
+class Tile_Cache::Rasterizer : public QRunnable {
+	Tile_Cache*			mp_cache;
+	Snapshot_Ptr		mp_snapshot;
+	Tile_Key			m_key;
+	quint64				m_epoch;
+public:
+	void				run			() override;
+	                    Rasterizer	(Tile_Cache&, Snapshot_Ptr, const Tile_Key&, quint64 epoch);
+};
+
+}
+
+Tile_Cache::Rasterizer::Rasterizer(Tile_Cache& cache,
+                                   Snapshot_Ptr p_snapshot,
+                                   const Tile_Key& key,
+                                   quint64 epoch)
+                                   :
+                                     mp_cache(&cache),
+                                     mp_snapshot(p_snapshot),
+                                     m_key(key),
+                                     m_epoch(epoch)
+{
+	setAutoDelete(true);
+}
+
+void Tile_Cache::Rasterizer::run() {
+	const QRectF	rect	= tile_rect(m_key.zoom, m_key.x, m_key.y);
+	const double	scale	= TILE_SIZE / rect.width();
+	const double	margin	= 3.0 / scale;
+	const QRectF	probe	= rect.adjusted(-margin, -margin, margin, margin);
+	QImage			image(TILE_SIZE, TILE_SIZE, QImage::Format_ARGB32_Premultiplied);
+	QSet<long long>	drawn;
+	QPen			pen;
+	QBrush			brush(Qt::GlobalColor::darkBlue, Qt::SolidPattern);
+	int				cell_left	= static_cast<int>(std::floor(probe.left() / Snapshot::CELL_SIZE));
+	int				cell_right	= static_cast<int>(std::floor(probe.right() / Snapshot::CELL_SIZE));
+	int				cell_top	= static_cast<int>(std::floor(probe.top() / Snapshot::CELL_SIZE));
+	int				cell_bottom	= static_cast<int>(std::floor(probe.bottom() / Snapshot::CELL_SIZE));
+	QList<Snapshot::Cell> cells;
+
+	image.fill(Qt::transparent);
+
+	/* Collect the grid cells under the tile; on coarse zooms it is cheaper to scan the occupied ones */
+	if (static_cast<double>(cell_right - cell_left + 1) * (cell_bottom - cell_top + 1) > mp_snapshot->cells.count()) {
+		mp_snapshot->cells.for_each([&](const Snapshot::Cell& cell) {
+			int cell_x = static_cast<int>(cell.key >> 32);
+			int cell_y = static_cast<int>(cell.key & 0xFFFFFFFF);
+			if (cell_x >= cell_left && cell_x <= cell_right && cell_y >= cell_top && cell_y <= cell_bottom) {
+				cells.push_back(cell);
+			}
+		});
+	} else {
+		for (int cell_x = cell_left; cell_x <= cell_right; ++cell_x) {
+			for (int cell_y = cell_top; cell_y <= cell_bottom; ++cell_y) {
+				long long key = static_cast<long long>(Snapshot::cell_key(cell_x, cell_y));
+				if (mp_snapshot->cells.contains(key)) {
+					cells.push_back(mp_snapshot->cells.value(key));
+				}
+			}
+		}
+	}
+
+	QPainter painter(&image);
+	painter.setRenderHint(QPainter::Antialiasing, true);
+	painter.scale(scale, scale);
+	painter.translate(-rect.topLeft());
+	pen.setWidth(1);
+	pen.setCosmetic(true);
+	painter.setPen(pen);
+
+	for (auto it_cell = cells.cbegin(); it_cell != cells.cend(); ++it_cell) {
+		for (auto it = it_cell->lines.cbegin(); it != it_cell->lines.cend(); ++it) {
+			if (drawn.contains(*it)) {
+				continue;
+			}
+			drawn.insert(*it);
+			const QVector<long long> line_points = mp_snapshot->lines.value(*it).points;
+			for (int i = 1; i < line_points.size(); ++i) {
+				if (!mp_snapshot->points.contains(line_points[i - 1]) || !mp_snapshot->points.contains(line_points[i])) {
+					continue;
+				}
+				const QPointF first = mp_snapshot->points.value(line_points[i - 1]).pos;
+				const QPointF second = mp_snapshot->points.value(line_points[i]).pos;
+				if (QRectF(first, second).normalized().adjusted(-margin, -margin, margin, margin).intersects(probe)) {
+					painter.drawLine(first, second);
+				}
+			}
+		}
+	}
+
+	/* Nodes are only distinguishable once a scene unit takes about a pixel, as with Item_Node */
+	if (scale >= 1.0) {
+		pen.setColor(Qt::red);
+		painter.setPen(pen);
+		painter.setBrush(brush);
+		for (auto it_cell = cells.cbegin(); it_cell != cells.cend(); ++it_cell) {
+			for (auto it = it_cell->points.cbegin(); it != it_cell->points.cend(); ++it) {
+				const QPointF point = mp_snapshot->points.value(*it).pos;
+				if (probe.contains(point)) {
+					painter.drawEllipse(point, 2, 2);
+				}
+			}
+		}
+	}
+	painter.end();
+
+	QMetaObject::invokeMethod(mp_cache,
+	                          "slot_tile_rasterized",
+	                          Qt::QueuedConnection,
+	                          Q_ARG(int, m_key.zoom),
+	                          Q_ARG(int, m_key.x),
+	                          Q_ARG(int, m_key.y),
+	                          Q_ARG(quint64, m_epoch),
+	                          Q_ARG(QImage, image));
+}
+
+/*================================================================*/
+/*                     Tile_Cache::Tile_Key                       */
+/*================================================================*/
+
+Tile_Cache::Tile_Key::Tile_Key(int z, int tile_x, int tile_y) {
+	zoom = z;
+	x = tile_x;
+	y = tile_y;
+}
+
+bool ns_osm::operator==(const Tile_Cache::Tile_Key& lhs, const Tile_Cache::Tile_Key& rhs) {
+	return (lhs.zoom == rhs.zoom && lhs.x == rhs.x && lhs.y == rhs.y);
+}
+
+uint ns_osm::qHash(const Tile_Cache::Tile_Key& key, uint seed) {
+	return ::qHash((static_cast<quint64>(static_cast<quint32>(key.x)) << 32) | static_cast<quint32>(key.y),
+	               seed ^ static_cast<uint>(key.zoom));
+}
+
+/*================================================================*/
+/*                     Tile_Cache::Snapshot                       */
+/*================================================================*/
+
+const double Tile_Cache::Snapshot::CELL_SIZE = 1000.0;
+
+quint64 Tile_Cache::Snapshot::cell_key(int cell_x, int cell_y) {
+	return (static_cast<quint64>(static_cast<quint32>(cell_x)) << 32) | static_cast<quint32>(cell_y);
+}
+
+quint64 Tile_Cache::Snapshot::cell_key(const QPointF& scene_pos) {
+	return cell_key(static_cast<int>(std::floor(scene_pos.x() / CELL_SIZE)),
+	                static_cast<int>(std::floor(scene_pos.y() / CELL_SIZE)));
+}
+
+void Tile_Cache::Snapshot::add_to_cell(quint64 key, long long id_node) {
+	Cell cell = cells.value(static_cast<long long>(key));
+
+	cell.key = key;
+	cell.points.push_back(id_node);
+	cells.insert(static_cast<long long>(key), cell);
+}
+
+void Tile_Cache::Snapshot::remove_from_cell(quint64 key, long long id_node) {
+	Cell cell = cells.value(static_cast<long long>(key));
+
+	cell.points.removeOne(id_node);
+	if (cell.points.isEmpty() && cell.lines.isEmpty()) {
+		cells.remove(static_cast<long long>(key));
+	} else {
+		cells.insert(static_cast<long long>(key), cell);
+	}
+}
+
+/* A line sits in every cell the bounding box of one of its segments meets */
+void Tile_Cache::Snapshot::place_line(long long id_line, Line& line) {
+	QSet<quint64> keys;
+
+	for (int i = 1; i < line.points.size(); ++i) {
+		if (!points.contains(line.points[i - 1]) || !points.contains(line.points[i])) {
+			continue;
+		}
+		QRectF bound = QRectF(points.value(line.points[i - 1]).pos, points.value(line.points[i]).pos).normalized();
+		for (int x = static_cast<int>(std::floor(bound.left() / CELL_SIZE)); x <= std::floor(bound.right() / CELL_SIZE); ++x) {
+			for (int y = static_cast<int>(std::floor(bound.top() / CELL_SIZE)); y <= std::floor(bound.bottom() / CELL_SIZE); ++y) {
+				keys.insert(cell_key(x, y));
+			}
+		}
+	}
+	line.cells.clear();
+	for (auto it = keys.cbegin(); it != keys.cend(); ++it) {
+		Cell cell = cells.value(static_cast<long long>(*it));
+		cell.key = *it;
+		cell.lines.push_back(id_line);
+		cells.insert(static_cast<long long>(*it), cell);
+		line.cells.push_back(*it);
+	}
+}
+
+void Tile_Cache::Snapshot::unplace_line(long long id_line, const Line& line) {
+	for (auto it = line.cells.cbegin(); it != line.cells.cend(); ++it) {
+		Cell cell = cells.value(static_cast<long long>(*it));
+		cell.lines.removeOne(id_line);
+		if (cell.points.isEmpty() && cell.lines.isEmpty()) {
+			cells.remove(static_cast<long long>(*it));
+		} else {
+			cells.insert(static_cast<long long>(*it), cell);
+		}
+	}
+}
+
+void Tile_Cache::Snapshot::set_point(long long id_node, const QPointF& scene_pos) {
+	bool	f_known = points.contains(id_node);
+	Point	point = points.value(id_node);
+
+	if (f_known && point.pos == scene_pos) {
+		return;
+	}
+	if (!f_known) {
+		add_to_cell(cell_key(scene_pos), id_node);
+	} else if (cell_key(point.pos) != cell_key(scene_pos)) {
+		remove_from_cell(cell_key(point.pos), id_node);
+		add_to_cell(cell_key(scene_pos), id_node);
+	}
+	point.pos = scene_pos;
+	points.insert(id_node, point);
+	/* Only the lines through the point change cells */
+	for (auto it = point.lines.cbegin(); it != point.lines.cend(); ++it) {
+		Line line = lines.value(*it);
+		unplace_line(*it, line);
+		place_line(*it, line);
+		lines.insert(*it, line);
+	}
+}
+
+void Tile_Cache::Snapshot::remove_point(long long id_node) {
+	if (!points.contains(id_node)) {
+		return;
+	}
+	remove_from_cell(cell_key(points.value(id_node).pos), id_node);
+	points.remove(id_node);
+}
+
+void Tile_Cache::Snapshot::set_line(long long id_way, const QVector<long long>& id_nodes) {
+	Line line;
+
+	remove_line(id_way);
+	line.points = id_nodes;
+	for (auto it = id_nodes.cbegin(); it != id_nodes.cend(); ++it) {
+		if (!points.contains(*it)) {
+			continue;
+		}
+		Point point = points.value(*it);
+		if (!point.lines.contains(id_way)) {
+			point.lines.push_back(id_way);
+			points.insert(*it, point);
+		}
+	}
+	place_line(id_way, line);
+	lines.insert(id_way, line);
+}
+
+void Tile_Cache::Snapshot::remove_line(long long id_way) {
+	if (!lines.contains(id_way)) {
+		return;
+	}
+	const Line line = lines.value(id_way);
+	unplace_line(id_way, line);
+	for (auto it = line.points.cbegin(); it != line.points.cend(); ++it) {
+		if (!points.contains(*it)) {
+			continue;
+		}
+		Point point = points.value(*it);
+		point.lines.removeAll(id_way);
+		points.insert(*it, point);
+	}
+	lines.remove(id_way);
+}
+
+QRectF Tile_Cache::Snapshot::get_footprint(long long id_node) const {
+	QRectF	rect;
+	auto	include = [this, &rect](long long id) {
+		if (!points.contains(id)) {
+			return;
+		}
+		const QPointF point = points.value(id).pos;
+		rect.setLeft(std::min(rect.left(), point.x()));
+		rect.setRight(std::max(rect.right(), point.x()));
+		rect.setTop(std::min(rect.top(), point.y()));
+		rect.setBottom(std::max(rect.bottom(), point.y()));
+	};
+
+	if (!points.contains(id_node)) {
+		return rect;
+	}
+	const Point point = points.value(id_node);
+	rect = QRectF(point.pos, QSizeF(0, 0));
+	for (auto it = point.lines.cbegin(); it != point.lines.cend(); ++it) {
+		const QVector<long long> line_points = lines.value(*it).points;
+		for (int i = 0; i < line_points.size(); ++i) {
+			if (line_points[i] != id_node) {
+				continue;
+			}
+			if (i > 0) {
+				include(line_points[i - 1]);
+			}
+			if (i + 1 < line_points.size()) {
+				include(line_points[i + 1]);
+			}
+		}
+	}
+	return rect.adjusted(-3, -3, 3, 3);
+}
+
+/*================================================================*/
+/*                        Static members                          */
+/*================================================================*/
+
+const int Tile_Cache::TILE_SIZE = 256;
+const int Tile_Cache::MAX_TILES = 512;
+
+/*================================================================*/
+/*                  Constructors, destructors                     */
+/*================================================================*/
+
+Tile_Cache::Tile_Cache(QObject* p_parent) : QObject(p_parent) {
+	m_tiles.setMaxCost(MAX_TILES);
+	m_epoch = 0;
+	f_snapshot_dirty = true;
+}
+
+Tile_Cache::~Tile_Cache() {
+	m_pool.clear();
+	m_pool.waitForDone();
+}
+
+/*================================================================*/
+/*                       Private methods                          */
+/*================================================================*/
+
+void Tile_Cache::slot_tile_rasterized(int zoom, int x, int y, quint64 epoch, QImage image) {
+	Tile_Key key(zoom, x, y);
+	auto it = m_pending.find(key);
+
+	/* The tile was invalidated while it was being painted */
+	if (it == m_pending.end() || it.value() != epoch) {
+		return;
+	}
+	m_pending.erase(it);
+	m_tiles.insert(key, new QImage(image));
+	emit signal_tile_ready(tile_rect(zoom, x, y));
+}
+
+void Tile_Cache::request(const Tile_Key& key) {
+	if (m_pending.contains(key)) {
+		return;
+	}
+	if (f_snapshot_dirty) {
+		emit signal_snapshot_required();
+	}
+	if (mp_snapshot.isNull()) {
+		return;
+	}
+	m_pending[key] = ++m_epoch;
+	m_pool.start(new Rasterizer(*this, mp_snapshot, key, m_epoch));
+}
+
+/*================================================================*/
+/*                        Public methods                          */
+/*================================================================*/
+
+int Tile_Cache::zoom_for_scale(double view_scale) {
+	return static_cast<int>(std::floor(std::log2(std::max(view_scale, 1e-9))));
+}
+
+double Tile_Cache::tile_extent(int zoom) {
+	return TILE_SIZE / std::pow(2.0, zoom);
+}
+
+QRectF Tile_Cache::tile_rect(int zoom, int x, int y) {
+	double extent = tile_extent(zoom);
+	return QRectF(x * extent, y * extent, extent, extent);
+}
+
+const QImage* Tile_Cache::get_tile(int zoom, int x, int y) {
+	Tile_Key key(zoom, x, y);
+	const QImage* p_image = m_tiles.object(key);
+
+	if (p_image == nullptr) {
+		request(key);
+	}
+	return p_image;
+}
+
+const QImage* Tile_Cache::peek_tile(int zoom, int x, int y) const {
+	return m_tiles.object(Tile_Key(zoom, x, y));
+}
+
+Tile_Cache::Snapshot_Ptr Tile_Cache::get_snapshot() const {
+	return mp_snapshot;
+}
+
+void Tile_Cache::set_snapshot(Snapshot_Ptr p_snapshot) {
+	mp_snapshot = p_snapshot;
+	f_snapshot_dirty = false;
+}
+
+void Tile_Cache::set_snapshot_dirty() {
+	f_snapshot_dirty = true;
+}
+
+bool Tile_Cache::is_idle() const {
+	return (m_pending.isEmpty() && !f_snapshot_dirty);
+}
+
+void Tile_Cache::invalidate(const QRectF& scene_rect) {
+	if (m_tiles.isEmpty() && m_pending.isEmpty()) {
+		return;
+	}
+	QList<Tile_Key> keys = m_tiles.keys();
+
+	for (auto it = keys.cbegin(); it != keys.cend(); ++it) {
+		double margin = 3.0 * tile_extent(it->zoom) / TILE_SIZE;
+		if (tile_rect(it->zoom, it->x, it->y).intersects(scene_rect.adjusted(-margin, -margin, margin, margin))) {
+			m_tiles.remove(*it);
+		}
+	}
+	for (auto it = m_pending.begin(); it != m_pending.end();) {
+		double margin = 3.0 * tile_extent(it.key().zoom) / TILE_SIZE;
+		if (tile_rect(it.key().zoom, it.key().x, it.key().y).intersects(scene_rect.adjusted(-margin, -margin, margin, margin))) {
+			it = m_pending.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+void Tile_Cache::clear() {
+	m_pool.clear();
+	m_tiles.clear();
+	m_pending.clear();
+	f_snapshot_dirty = true;
+}
+
+void Tile_Cache::add_memory_usage(Memory_Usage& usage) const {
+	QList<Tile_Key>	keys = m_tiles.keys();
+	qint64			n_bytes = Memory_Usage::bytes_of(m_pending);
+
+	for (auto it = keys.cbegin(); it != keys.cend(); ++it) {
+		const QImage* p_tile = m_tiles.object(*it);
+		n_bytes += sizeof(QImage) + p_tile->bytesPerLine() * p_tile->height();
+	}
+	if (mp_snapshot) {
+		n_bytes += sizeof(Snapshot);
+		mp_snapshot->points.for_each([&n_bytes](const Snapshot::Point& point) {
+			n_bytes += sizeof(long long) + sizeof(Snapshot::Point) + Memory_Usage::bytes_of(point.lines);
+		});
+		mp_snapshot->lines.for_each([&n_bytes](const Snapshot::Line& line) {
+			n_bytes += sizeof(long long) + sizeof(Snapshot::Line)
+			           + Memory_Usage::bytes_of(line.points) + Memory_Usage::bytes_of(line.cells);
+		});
+		mp_snapshot->cells.for_each([&n_bytes](const Snapshot::Cell& cell) {
+			n_bytes += sizeof(long long) + sizeof(Snapshot::Cell)
+			           + Memory_Usage::bytes_of(cell.points) + Memory_Usage::bytes_of(cell.lines);
+		});
+	}
+	usage.add(Memory_Usage::VIEW, Memory_Usage::TILES, n_bytes);
+}
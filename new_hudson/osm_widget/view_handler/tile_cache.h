@@ -0,0 +1,119 @@
+#ifndef TILE_CACHE_H
+#define TILE_CACHE_H
+
+#ifndef QT_WIDGETS_H
+#define QT_WIDGETS_H
+#include <QtWidgets>
+#endif /* Include guard QT_WIDGETS_H */
+
+#include "memory_usage.h"
+#include "shared_table.h"
+
+namespace ns_osm {
+
+/* Rasterizes the map into TILE_SIZE x TILE_SIZE images per zoom level.
+ * Tiles are painted on a worker pool from an immutable Snapshot, so the
+ * GUI thread only blits ready tiles and never walks the map while painting. */
+class Tile_Cache : public QObject {
+	Q_OBJECT
+public:
+	struct Tile_Key;
+	struct Snapshot;
+	typedef QSharedPointer<const Snapshot>	Snapshot_Ptr;
+signals:
+	void						signal_tile_ready			(QRectF scene_rect);
+	void						signal_snapshot_required	();
+private slots:
+	void						slot_tile_rasterized		(int zoom, int x, int y, quint64 epoch, QImage image);
+private:
+	class Rasterizer;
+
+	static const int			MAX_TILES;
+	QThreadPool					m_pool;
+	QCache<Tile_Key, QImage>	m_tiles;
+	QHash<Tile_Key, quint64>	m_pending; /* Tile -> epoch of the request */
+	Snapshot_Ptr				mp_snapshot;
+	quint64						m_epoch;
+	bool						f_snapshot_dirty;
+
+	void						request						(const Tile_Key&);
+public:
+	static const int			TILE_SIZE;
+
+	static int					zoom_for_scale				(double view_scale);
+	static double				tile_extent					(int zoom); /* Tile side in scene units */
+	static QRectF				tile_rect					(int zoom, int x, int y);
+	const QImage*				get_tile					(int zoom, int x, int y); /* Schedules missing tiles */
+	const QImage*				peek_tile					(int zoom, int x, int y) const;
+	Snapshot_Ptr				get_snapshot				() const;
+	void						set_snapshot				(Snapshot_Ptr);
+	void						set_snapshot_dirty			();
+	bool						is_idle						() const; /* Every requested tile matches the latest snapshot */
+	void						invalidate					(const QRectF& scene_rect);
+	void						clear						();
+	void						add_memory_usage			(Memory_Usage&) const; /* Tiles and snapshot, as VIEW tiles */
+	                            Tile_Cache					(QObject* p_parent = nullptr);
+								Tile_Cache					(const Tile_Cache&) = delete;
+	Tile_Cache&					operator=					(const Tile_Cache&) = delete;
+	virtual						~Tile_Cache					();
+};
+
+/*================================================================*/
+/*                     Tile_Cache::Tile_Key                       */
+/*================================================================*/
+
+struct Tile_Cache::Tile_Key {
+	int		zoom;
+	int		x;
+	int		y;
+	        Tile_Key(int zoom, int x, int y);
+};
+
+bool operator==(const Tile_Cache::Tile_Key&, const Tile_Cache::Tile_Key&);
+uint qHash(const Tile_Cache::Tile_Key&, uint seed = 0);
+
+/*================================================================*/
+/*                     Tile_Cache::Snapshot                       */
+/*================================================================*/
+
+/* Scene-space copy of everything the rasterizer draws, patched element by
+ * element on the GUI thread as the map changes. Its tables are Shared_Tables,
+ * so a copy costs a few references and the next patch detaches only the
+ * paths it touches. Copies handed to Tile_Cache::set_snapshot are never
+ * modified. Lines must be set after their points. */
+struct Tile_Cache::Snapshot {
+	struct Point {
+		QPointF					pos;
+		QVector<long long>		lines; /* Ids of the lines through the point */
+	};
+	struct Line {
+		QVector<long long>		points; /* Node ids, in way order */
+		QVector<quint64>		cells; /* Cells its segments cross */
+	};
+	struct Cell {
+		quint64					key;
+		QVector<long long>		points;
+		QVector<long long>		lines;
+	};
+	static const double			CELL_SIZE; /* Scene units */
+
+	Shared_Table<Point>			points; /* By node id */
+	Shared_Table<Line>			lines; /* By way id */
+	Shared_Table<Cell>			cells; /* By cell_key */
+
+	static quint64				cell_key		(int cell_x, int cell_y);
+	static quint64				cell_key		(const QPointF& scene_pos);
+	void						add_to_cell		(quint64 key, long long id_node);
+	void						remove_from_cell(quint64 key, long long id_node);
+	void						place_line		(long long id_line, Line&); /* Refreshes its cells */
+	void						unplace_line	(long long id_line, const Line&);
+	void						set_point		(long long id_node, const QPointF& scene_pos); /* Adds or moves */
+	void						remove_point	(long long id_node);
+	void						set_line		(long long id_way, const QVector<long long>& id_nodes);
+	void						remove_line		(long long id_way);
+	QRectF						get_footprint	(long long id_node) const; /* Node with its adjacent segments */
+};
+
+}
+
+#endif // TILE_CACHE_H
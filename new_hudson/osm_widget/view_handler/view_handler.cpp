@@ -7,13 +7,21 @@ using namespace ns_osm;
 /*================================================================*/
 
 const char* View_Handler::MENU_DELETE = "delete";
+const int View_Handler::MAX_POOLED_ITEMS = 4096;
+const int View_Handler::MAX_LIVE_ITEMS = 20000;
+const double View_Handler::PICK_TOLERANCE = 6.0;
+const int View_Handler::ITEM_OVERHEAD = 200;
+const int View_Handler::OBJECT_OVERHEAD = 120;
 
 /*================================================================*/
 /*                  Constructors, destructors                     */
 /*================================================================*/
 
-View_Handler::View_Handler(Osm_Map& map) : m_map(map) {
+View_Handler::View_Handler(Osm_Map& map) : m_map(map), m_pick_handler(m_coord_handler) {
 	m_drawing.current_tool = Osm_Tool::CURSOR;
+	mp_tile_cache = nullptr;
+	f_live_sync_scheduled = false;
+	f_recycle_scheduled = false;
 	m_coord_handler.set_map(m_map);
 	m_drawing.p_menu = new QMenu;
 	m_drawing.p_menu->addAction(MENU_DELETE);
@@ -23,9 +31,15 @@ View_Handler::View_Handler(Osm_Map& map) : m_map(map) {
 
 /*----------------------------------------------------------------*/
 
-View_Handler::View_Handler(const View_Handler& vhandler) : m_map(vhandler.m_map) {
+View_Handler::View_Handler(const View_Handler& vhandler)
+                           : m_map(vhandler.m_map),
+                             m_pick_handler(m_coord_handler)
+{
 	delete m_drawing.p_menu;
 	f_editable = vhandler.f_editable;
+	mp_tile_cache = nullptr;
+	f_live_sync_scheduled = false;
+	f_recycle_scheduled = false;
 	m_drawing.p_menu = new QMenu(this);
 	m_drawing.p_menu->addAction(MENU_DELETE);
 	load_from_map();
@@ -41,6 +55,12 @@ View_Handler::~View_Handler() {
 	while (!m_wayid_to_item.isEmpty()) {
 		remove(m_wayid_to_item.begin().value()->get_way());
 	}
+	/* Items call back into the pools while dying, so they go before the members do */
+	slot_recycle();
+	qDeleteAll(m_free_item_nodes);
+	qDeleteAll(m_free_item_edges);
+	m_free_item_nodes.clear();
+	m_free_item_edges.clear();
 }
 
 /*================================================================*/
@@ -48,21 +68,37 @@ View_Handler::~View_Handler() {
 /*================================================================*/
 
 void View_Handler::slot_blank_area_clicked(QPointF point, Qt::MouseButton button) {
-	Osm_Node* p_node;
+	Osm_Node*			p_node;
+	Pick_Handler::Hit	hit = pick(point);
+
+	/* Clicks that missed the items still snap to whatever is within a few pixels */
+	if (hit.is_node()) {
+		slot_node_clicked(hit.p_node, button);
+		return;
+	} else if (hit.is_segment()) {
+		slot_edge_clicked(hit.point, hit.p_way, hit.p_first, hit.p_second, button);
+		return;
+	}
 	switch (button) {
 	case Qt::LeftButton:
 		switch (m_drawing.current_tool) {
+		case Osm_Tool::CURSOR:
+			if (!(QApplication::keyboardModifiers() & Qt::ControlModifier)) {
+				clear_selection();
+				emit_selection_changed();
+			}
+			break;
 		case Osm_Tool::NODE:
 			point = m_coord_handler.get_geo_coords(point);
-			m_map.add(new Osm_Node(point.y(), point.x()));
+			m_map.add(new Osm_Node(point.y(), point.x(), m_map.get_id_allocator()));
 			break;
 		case Osm_Tool::WAY:
 			point = m_coord_handler.get_geo_coords(point);
 			if (m_drawing.p_last_way == nullptr) {
-				m_drawing.p_last_way = new Osm_Way;
+				m_drawing.p_last_way = new Osm_Way(m_map.get_id_allocator());
 				m_map.add(m_drawing.p_last_way);
 			}
-			p_node = new Osm_Node(point.y(), point.x());
+			p_node = new Osm_Node(point.y(), point.x(), m_map.get_id_allocator());
 			m_drawing.p_last_way->push_node(p_node);
 			break;
 		}
@@ -79,7 +115,7 @@ void View_Handler::slot_node_clicked(Osm_Node* p_node, Qt::MouseButton button) {
 	switch (button) {
 	case Qt::RightButton:
 		m_drawing.p_menu->hide();
-		if (!(p_action = m_drawing.p_menu->exec(mapToGlobal(mp_view->mapFromScene(m_nodeid_to_item[p_node->get_id()]->pos()))))) {
+		if (!(p_action = m_drawing.p_menu->exec(mapToGlobal(mp_view->mapFromScene(m_coord_handler.get_pos_on_scene(*p_node)))))) {
 			break;
 		}
 		if (p_action->text() == MENU_DELETE) {
@@ -88,9 +124,12 @@ void View_Handler::slot_node_clicked(Osm_Node* p_node, Qt::MouseButton button) {
 		break;
 	case Qt::LeftButton:
 		switch (m_drawing.current_tool) {
+		case Osm_Tool::CURSOR:
+			select(p_node, QApplication::keyboardModifiers() & Qt::ControlModifier);
+			break;
 		case Osm_Tool::WAY:
 			if (m_drawing.p_last_way == nullptr) {
-				m_drawing.p_last_way = new Osm_Way;
+				m_drawing.p_last_way = new Osm_Way(m_map.get_id_allocator());
 				m_map.add(m_drawing.p_last_way);
 			}
 			if (!(m_drawing.p_last_way->push_node(p_node))) {
@@ -98,7 +137,7 @@ void View_Handler::slot_node_clicked(Osm_Node* p_node, Qt::MouseButton button) {
 					m_map.remove(m_drawing.p_last_way);
 					return;
 				}
-				m_drawing.p_last_way = new Osm_Way;
+				m_drawing.p_last_way = new Osm_Way(m_map.get_id_allocator());
 				m_map.add(m_drawing.p_last_way);
 			}
 			m_drawing.p_last_way->push_node(p_node);
@@ -133,14 +172,17 @@ void View_Handler::slot_edge_clicked(QPointF point,
 	case Qt::LeftButton:
 		point = m_coord_handler.get_geo_coords(point);
 		switch (m_drawing.current_tool) {
+		case Osm_Tool::CURSOR:
+			select(p_way, QApplication::keyboardModifiers() & Qt::ControlModifier);
+			break;
 		case Osm_Tool::NODE:
-			p_node = new Osm_Node(point.y(), point.x());
+			p_node = new Osm_Node(point.y(), point.x(), m_map.get_id_allocator());
 			p_way->insert_node_between(p_node, p_node1, p_node2);
 			break;
 		case Osm_Tool::WAY:
-			p_node = new Osm_Node(point.y(), point.x());
+			p_node = new Osm_Node(point.y(), point.x(), m_map.get_id_allocator());
 			if (m_drawing.p_last_way == nullptr) {
-				m_drawing.p_last_way = new Osm_Way;
+				m_drawing.p_last_way = new Osm_Way(m_map.get_id_allocator());
 				m_map.add(m_drawing.p_last_way);
 			}
 			p_way->insert_node_between(p_node, p_node1, p_node2);
@@ -153,79 +195,330 @@ void View_Handler::slot_edge_clicked(QPointF point,
 
 /*----------------------------------------------------------------*/
 
-void View_Handler::add(Osm_Node* p_node) {
+/* The grid decides first, so a click on an edge next to a node snaps to the node
+ * as it would beside the edge; the item hit is only the fallback */
+void View_Handler::slot_item_edge_clicked(QPointF point,
+                                          Osm_Way* p_way,
+                                          Osm_Node* p_node1,
+                                          Osm_Node* p_node2,
+                                          Qt::MouseButton button)
+{
+	Pick_Handler::Hit hit = pick(point);
+
+	if (hit.is_node()) {
+		slot_node_clicked(hit.p_node, button);
+	} else if (hit.is_segment()) {
+		slot_edge_clicked(hit.point, hit.p_way, hit.p_first, hit.p_second, button);
+	} else {
+		slot_edge_clicked(point, p_way, p_node1, p_node2, button);
+	}
+}
+
+/*----------------------------------------------------------------*/
+
+/* The events kept m_tile_snapshot current, so handing it out is a copy of its table roots */
+void View_Handler::slot_snapshot_required() {
+	mp_tile_cache->set_snapshot(Tile_Cache::Snapshot_Ptr(new Tile_Cache::Snapshot(m_tile_snapshot)));
+}
+
+/*----------------------------------------------------------------*/
+
+void View_Handler::slot_tile_ready(QRectF) {
+	Item_Node*	p_nodeitem;
+	Item_Way*	p_item_way;
+
+	/* Touched items go back under the tiles once the tiles have caught up with the edits */
+	if ((m_touched_nodes.isEmpty() && m_touched_ways.isEmpty())
+	    || !mp_tile_cache->is_idle() || QApplication::mouseButtons() != Qt::NoButton) {
+		return;
+	}
+	for (auto it = m_touched_nodes.cbegin(); it != m_touched_nodes.cend(); ++it) {
+		if ((p_nodeitem = m_nodeid_to_item.value(*it, nullptr)) != nullptr) {
+			p_nodeitem->setFlag(QGraphicsItem::ItemHasNoContents, !p_nodeitem->is_highlighted());
+		}
+	}
+	for (auto it = m_touched_ways.cbegin(); it != m_touched_ways.cend(); ++it) {
+		if ((p_item_way = m_wayid_to_item.value(*it, nullptr)) != nullptr) {
+			p_item_way->set_edges_hollow(true);
+		}
+	}
+	m_touched_nodes.clear();
+	m_touched_ways.clear();
+}
+
+/*----------------------------------------------------------------*/
+
+void View_Handler::slot_area_selected(QRectF scene_rect, bool f_extend) {
+	QSet<Osm_Node*>	nodes;
+	QSet<Osm_Way*>	ways;
+
+	if (!f_extend) {
+		clear_selection();
+	}
+	m_pick_handler.query(scene_rect, nodes, ways);
+	for (auto it = nodes.cbegin(); it != nodes.cend(); ++it) {
+		if (!m_selected_nodes.contains(*it)) {
+			add_item(**it, true);
+			m_selected_nodes.insert(*it);
+			m_nodeid_to_item[(*it)->get_id()]->set_highlighted(true);
+		}
+	}
+	for (auto it = ways.cbegin(); it != ways.cend(); ++it) {
+		if (!m_selected_ways.contains(*it)) {
+			add_item(**it, true);
+			m_selected_ways.insert(*it);
+			m_wayid_to_item[(*it)->get_id()]->set_highlighted(true);
+		}
+	}
+	emit_selection_changed();
+}
+
+/*----------------------------------------------------------------*/
+
+void View_Handler::slot_visible_rect_changed() {
+	/* Scrolling reports every step, the items follow once per turn of the event loop */
+	if (mp_tile_cache == nullptr || f_live_sync_scheduled) {
+		return;
+	}
+	f_live_sync_scheduled = true;
+	QMetaObject::invokeMethod(this, "slot_sync_live_items", Qt::QueuedConnection);
+}
+
+/*----------------------------------------------------------------*/
+
+void View_Handler::slot_sync_live_items() {
+	f_live_sync_scheduled = false;
+	if (mp_tile_cache != nullptr) {
+		sync_live_items(true);
+	}
+}
+
+/*----------------------------------------------------------------*/
+
+void View_Handler::slot_recycle() {
+	Item_Node* p_item_node;
+	Item_Edge* p_item_edge;
+
+	/* Dying ways hand their edges over to m_released_item_edges */
+	while (!m_released_item_ways.isEmpty()) {
+		delete m_released_item_ways.takeFirst();
+	}
+	while (!m_released_item_nodes.isEmpty()) {
+		p_item_node = m_released_item_nodes.takeFirst();
+		if (m_free_item_nodes.size() >= MAX_POOLED_ITEMS) {
+			delete p_item_node;
+			continue;
+		}
+		if (p_item_node->scene() != nullptr) {
+			p_item_node->scene()->removeItem(p_item_node);
+		}
+		m_free_item_nodes.push_back(p_item_node);
+	}
+	while (!m_released_item_edges.isEmpty()) {
+		p_item_edge = m_released_item_edges.takeFirst();
+		if (m_free_item_edges.size() >= MAX_POOLED_ITEMS) {
+			delete p_item_edge;
+			continue;
+		}
+		if (p_item_edge->scene() != nullptr) {
+			p_item_edge->scene()->removeItem(p_item_edge);
+		}
+		m_free_item_edges.push_back(p_item_edge);
+	}
+	f_recycle_scheduled = false;
+}
+
+/*----------------------------------------------------------------*/
+
+Item_Node* View_Handler::acquire_item_node(Osm_Node& node) {
 	Item_Node* p_nodeitem;
 
-	if (p_node == nullptr) {
+	if (!m_free_item_nodes.isEmpty()) {
+		p_nodeitem = m_free_item_nodes.takeLast();
+		p_nodeitem->reset(node);
+	} else {
+		p_nodeitem = new Item_Node(m_coord_handler, node);
+		p_nodeitem->setFlag(QGraphicsItem::ItemIsMovable);
+		QObject::connect(p_nodeitem,
+		                 SIGNAL(signal_node_clicked(Osm_Node*,Qt::MouseButton)),
+		                 this,
+		                 SLOT(slot_node_clicked(Osm_Node*,Qt::MouseButton)));
+	}
+	mp_scene->addItem(p_nodeitem);
+	return p_nodeitem;
+}
+
+/*----------------------------------------------------------------*/
+
+void View_Handler::release(Item_Node* p_item) {
+	/* The item may be the one handling the current mouse event, so it leaves the scene later */
+	p_item->detach();
+	p_item->setEnabled(false);
+	p_item->hide();
+	m_released_item_nodes.push_back(p_item);
+	schedule_recycle();
+}
+
+/*----------------------------------------------------------------*/
+
+void View_Handler::release(Item_Way* p_item) {
+	p_item->setEnabled(false);
+	p_item->hide();
+	m_released_item_ways.push_back(p_item);
+	schedule_recycle();
+}
+
+/*----------------------------------------------------------------*/
+
+void View_Handler::schedule_recycle() {
+	if (f_recycle_scheduled) {
 		return;
-	} else if (m_nodeid_to_item.contains(p_node->get_id())) {
+	}
+	f_recycle_scheduled = true;
+	QMetaObject::invokeMethod(this, "slot_recycle", Qt::QueuedConnection);
+}
+
+/*----------------------------------------------------------------*/
+
+void View_Handler::add(Osm_Node* p_node, bool f_invalidate) {
+	QPointF pos;
+
+	if (p_node == nullptr) {
 		return;
 	}
 	subscribe(*p_node);
-	p_nodeitem = new Item_Node(m_coord_handler, *p_node);
-	mp_scene->addItem(p_nodeitem);
-	m_nodeid_to_item.insert(p_node->get_id(), p_nodeitem);
-	p_nodeitem->setFlag(QGraphicsItem::ItemIsMovable);
-	QObject::connect(p_nodeitem,
-	                 SIGNAL(signal_node_clicked(Osm_Node*,Qt::MouseButton)),
-	                 this,
-	                 SLOT(slot_node_clicked(Osm_Node*,Qt::MouseButton)));
-//	mp_view->centerOn(p_nodeitem);
+	m_pick_handler.add(*p_node);
+	if (mp_tile_cache == nullptr) {
+		add_item(*p_node, false);
+		return;
+	}
+	pos = m_coord_handler.get_pos_on_scene(*p_node);
+	m_tile_snapshot.set_point(p_node->get_id(), pos);
+	/* While tiled only edits in sight get an item, painting until the tiles have them */
+	if (f_invalidate) {
+		grow_scene_rect(QRectF(pos - QPointF(3, 3), QSizeF(6, 6)));
+		if (get_live_area().contains(pos) && add_item(*p_node, false)) {
+			touch(*p_node);
+		}
+		invalidate_tiles(get_tile_footprint(*p_node));
+	}
 }
 
 /*----------------------------------------------------------------*/
 
-void View_Handler::add(Osm_Way* p_way) {
-	Item_Way*	p_item_way;
+void View_Handler::add(Osm_Way* p_way, bool f_invalidate) {
+	QRectF rect;
 
 	if (p_way == nullptr) {
 		return;
-	} else if (m_wayid_to_item.contains(p_way->get_id())) {
+	}
+	subscribe(*p_way);
+	m_pick_handler.add(*p_way);
+	if (mp_tile_cache == nullptr) {
+		add_item(*p_way, false);
 		return;
 	}
+	sync_tile_snapshot(*p_way);
+	if (f_invalidate) {
+		rect = get_tile_footprint(*p_way);
+		if (get_live_area().intersects(rect) && add_item(*p_way, false)) {
+			touch(*p_way);
+		}
+		invalidate_tiles(rect);
+	}
+}
 
-	subscribe(*p_way);
-	p_item_way = new Item_Way(m_coord_handler, *this, *p_way);
+/*----------------------------------------------------------------*/
+
+bool View_Handler::add_item(Osm_Node& node, bool f_hollow) {
+	Item_Node* p_nodeitem;
+
+	if (m_nodeid_to_item.contains(node.get_id())) {
+		return false;
+	}
+	p_nodeitem = acquire_item_node(node);
+	p_nodeitem->setFlag(QGraphicsItem::ItemHasNoContents, f_hollow);
+	m_nodeid_to_item.insert(node.get_id(), p_nodeitem);
+	return true;
+}
+
+/*----------------------------------------------------------------*/
+
+bool View_Handler::add_item(Osm_Way& way, bool f_hollow) {
+	Item_Way* p_item_way;
+
+	if (m_wayid_to_item.contains(way.get_id())) {
+		return false;
+	}
+	p_item_way = new Item_Way(m_coord_handler, *this, way);
 	mp_scene->addItem(p_item_way);
-	m_wayid_to_item.insert(p_way->get_id(), p_item_way);
+	p_item_way->set_edges_hollow(f_hollow);
+	m_wayid_to_item.insert(way.get_id(), p_item_way);
+	return true;
+}
+
+/*----------------------------------------------------------------*/
+
+void View_Handler::add_all_items() {
+	for (Osm_Map::node_iterator it = m_map.nbegin(); it != m_map.nend(); ++it) {
+		add_item(**it, false);
+	}
+	for (Osm_Map::way_iterator it = m_map.wbegin(); it != m_map.wend(); ++it) {
+		add_item(**it, false);
+	}
 }
 
 /*----------------------------------------------------------------*/
 
 void View_Handler::remove(Osm_Node* p_node) {
-	Item_Node* p_nodeitem;
 	if (p_node == nullptr) {
 		return;
 	}
-	if (!m_nodeid_to_item.contains(p_node->get_id())) {
-		return;
+	/* Editors hold the selected elements, so they must hear about it before the node dies */
+	if (m_selected_nodes.contains(p_node)) {
+		clear_selection();
+		emit_selection_changed();
 	}
-	p_nodeitem = m_nodeid_to_item[p_node->get_id()];
-//	mp_scene->removeItem(p_nodeitem);
-	m_nodeid_to_item.remove(p_node->get_id());
-	p_nodeitem->setEnabled(false);
-	p_nodeitem->hide();
-	//delete p_nodeitem;
+	m_pick_handler.remove(*p_node);
+	remove_item(*p_node);
 }
 
 /*----------------------------------------------------------------*/
 
 void View_Handler::remove(Osm_Way* p_way) {
-	Item_Way*	p_item_way;
-
 	if (p_way == nullptr) {
 		return;
 	}
-	if (!m_wayid_to_item.contains(p_way->get_id())) {
+	if (m_selected_ways.contains(p_way)) {
+		clear_selection();
+		emit_selection_changed();
+	}
+	m_pick_handler.remove(*p_way);
+	remove_item(*p_way);
+}
+
+/*----------------------------------------------------------------*/
+
+void View_Handler::remove_item(Osm_Node& node) {
+	Item_Node* p_nodeitem = m_nodeid_to_item.take(node.get_id());
+
+	if (p_nodeitem == nullptr) {
 		return;
 	}
+	m_touched_nodes.remove(node.get_id());
+	release(p_nodeitem);
+}
+
+/*----------------------------------------------------------------*/
 
-	p_item_way = m_wayid_to_item[p_way->get_id()];
-	//mp_scene->removeItem(p_item_way);
-	m_wayid_to_item.remove(p_way->get_id());
-	p_item_way->setEnabled(false);
-	p_item_way->hide();
-	//delete p_item_way;
+void View_Handler::remove_item(Osm_Way& way) {
+	Item_Way* p_item_way = m_wayid_to_item.take(way.get_id());
+
+	if (p_item_way == nullptr) {
+		return;
+	}
+	m_touched_ways.remove(way.get_id());
+	release(p_item_way);
 }
 
 /*----------------------------------------------------------------*/
@@ -240,12 +533,271 @@ void View_Handler::load_from_map() {
 	                 SIGNAL(signal_blank_area_clicked(QPointF,Qt::MouseButton)),
 	                 this,
 	                 SLOT(slot_blank_area_clicked(QPointF,Qt::MouseButton)));
+	QObject::connect(mp_view,
+	                 SIGNAL(signal_area_selected(QRectF,bool)),
+	                 this,
+	                 SLOT(slot_area_selected(QRectF,bool)));
+	QObject::connect(mp_view,
+	                 SIGNAL(signal_visible_rect_changed()),
+	                 this,
+	                 SLOT(slot_visible_rect_changed()));
+	add_all();
+}
+
+/*----------------------------------------------------------------*/
+
+void View_Handler::add_all() {
+	QRectF extent;
+
 	for (Osm_Map::node_iterator it = m_map.nbegin(); it != m_map.nend(); ++it) {
-		add(*it);
+		add(*it, false);
+		if (mp_tile_cache != nullptr) {
+			extent |= QRectF(m_coord_handler.get_pos_on_scene(**it) - QPointF(3, 3), QSizeF(6, 6));
+		}
 	}
 	for (Osm_Map::way_iterator it = m_map.wbegin(); it != m_map.wend(); ++it) {
-		add(*it);
+		add(*it, false);
+	}
+	if (mp_tile_cache != nullptr) {
+		grow_scene_rect(extent);
+		mp_tile_cache->clear();
+		mp_view->viewport()->update();
+		/* Nothing is tiled yet, so what is in sight paints until it is */
+		sync_live_items(false);
+	}
+}
+
+/*----------------------------------------------------------------*/
+
+void View_Handler::sync_tile_snapshot(Osm_Way& way) {
+	QVector<long long> id_nodes;
+
+	id_nodes.reserve(way.get_nodes_list().size());
+	for (auto it = way.get_nodes_list().cbegin(); it != way.get_nodes_list().cend(); ++it) {
+		id_nodes.push_back((*it)->get_id());
+	}
+	m_tile_snapshot.set_line(way.get_id(), id_nodes);
+}
+
+/*----------------------------------------------------------------*/
+
+QRectF View_Handler::get_tile_footprint(Osm_Node& node) const {
+	QPointF	pos = m_coord_handler.get_pos_on_scene(node);
+	QRectF	rect(pos - QPointF(3, 3), QSizeF(6, 6));
+
+	/* Called before patching, the snapshot still knows where the node and its edges were drawn */
+	if (mp_tile_cache != nullptr) {
+		rect |= m_tile_snapshot.get_footprint(node.get_id());
+	}
+	return rect;
+}
+
+/*----------------------------------------------------------------*/
+
+QRectF View_Handler::get_tile_footprint(Osm_Way& way) const {
+	QRectF rect;
+
+	for (auto it = way.get_nodes_list().cbegin(); it != way.get_nodes_list().cend(); ++it) {
+		rect |= get_tile_footprint(**it);
 	}
+	return rect;
+}
+
+/*----------------------------------------------------------------*/
+
+void View_Handler::invalidate_tiles(const QRectF& scene_rect) {
+	if (mp_tile_cache == nullptr || scene_rect.isNull()) {
+		return;
+	}
+	mp_tile_cache->invalidate(scene_rect);
+	mp_tile_cache->set_snapshot_dirty();
+	mp_view->viewport()->update(mp_view->mapFromScene(scene_rect).boundingRect());
+}
+
+/*----------------------------------------------------------------*/
+
+void View_Handler::set_items_hollow(bool f) {
+	for (auto it = m_nodeid_to_item.begin(); it != m_nodeid_to_item.end(); ++it) {
+		it.value()->setFlag(QGraphicsItem::ItemHasNoContents, f && !it.value()->is_highlighted());
+	}
+	for (auto it = m_wayid_to_item.begin(); it != m_wayid_to_item.end(); ++it) {
+		it.value()->set_edges_hollow(f);
+	}
+}
+
+/*----------------------------------------------------------------*/
+
+void View_Handler::touch(Osm_Node& node) {
+	if (m_nodeid_to_item.contains(node.get_id())) {
+		m_touched_nodes.insert(node.get_id());
+	}
+}
+
+/*----------------------------------------------------------------*/
+
+void View_Handler::touch(Osm_Way& way) {
+	if (m_wayid_to_item.contains(way.get_id())) {
+		m_touched_ways.insert(way.get_id());
+	}
+}
+
+/*----------------------------------------------------------------*/
+
+QRectF View_Handler::get_live_area() const {
+	QRectF rect = mp_view->mapToScene(mp_view->viewport()->rect()).boundingRect();
+
+	/* Half a view on every side, so short scrolls find their items already there */
+	return rect.adjusted(-rect.width() / 2, -rect.height() / 2, rect.width() / 2, rect.height() / 2);
+}
+
+/*----------------------------------------------------------------*/
+
+/* While tiled, what comes into the live area gets an item and what leaves it
+ * gives its item back; selected elements and the item under the mouse stay */
+void View_Handler::sync_live_items(bool f_hollow) {
+	QSet<Osm_Node*>	nodes;
+	QSet<Osm_Way*>	ways;
+	QList<Osm_Node*>	gone_nodes;
+	QList<Osm_Way*>		gone_ways;
+	QGraphicsItem*	p_grabber = mp_scene->mouseGrabberItem();
+
+	m_pick_handler.query(get_live_area(), nodes, ways);
+	if (nodes.size() + ways.size() > MAX_LIVE_ITEMS) {
+		/* Zoomed out this far, the tiles are all there is to see */
+		nodes.clear();
+		ways.clear();
+	}
+	for (auto it = m_nodeid_to_item.cbegin(); it != m_nodeid_to_item.cend(); ++it) {
+		Osm_Node* p_node = it.value()->get_node();
+		if (!nodes.contains(p_node) && !m_selected_nodes.contains(p_node) && it.value() != p_grabber) {
+			gone_nodes.push_back(p_node);
+		}
+	}
+	for (auto it = m_wayid_to_item.cbegin(); it != m_wayid_to_item.cend(); ++it) {
+		Osm_Way* p_way = it.value()->get_way();
+		if (!ways.contains(p_way) && !m_selected_ways.contains(p_way)
+		    && (p_grabber == nullptr || p_grabber->parentItem() != it.value())) {
+			gone_ways.push_back(p_way);
+		}
+	}
+	for (auto it = gone_nodes.cbegin(); it != gone_nodes.cend(); ++it) {
+		remove_item(**it);
+	}
+	for (auto it = gone_ways.cbegin(); it != gone_ways.cend(); ++it) {
+		remove_item(**it);
+	}
+	for (auto it = nodes.cbegin(); it != nodes.cend(); ++it) {
+		if (add_item(**it, f_hollow) && !f_hollow) {
+			touch(**it);
+		}
+	}
+	for (auto it = ways.cbegin(); it != ways.cend(); ++it) {
+		if (add_item(**it, f_hollow) && !f_hollow) {
+			touch(**it);
+		}
+	}
+}
+
+/*----------------------------------------------------------------*/
+
+void View_Handler::grow_scene_rect(const QRectF& rect) {
+	/* On its own the scene only grows around its items, and tiled mode has few */
+	if (!rect.isNull() && !mp_scene->sceneRect().contains(rect)) {
+		mp_scene->setSceneRect(mp_scene->sceneRect() | rect);
+	}
+}
+
+/*----------------------------------------------------------------*/
+
+void View_Handler::select(Osm_Node* p_node, bool f_extend) {
+	bool f_selected;
+
+	if (!f_extend) {
+		clear_selection();
+	}
+	/* Ctrl + click toggles */
+	f_selected = !m_selected_nodes.remove(p_node);
+	if (f_selected) {
+		m_selected_nodes.insert(p_node);
+		add_item(*p_node, true);
+	}
+	if (m_nodeid_to_item.contains(p_node->get_id())) {
+		m_nodeid_to_item[p_node->get_id()]->set_highlighted(f_selected);
+	}
+	emit_selection_changed();
+}
+
+/*----------------------------------------------------------------*/
+
+void View_Handler::select(Osm_Way* p_way, bool f_extend) {
+	bool f_selected;
+
+	if (!f_extend) {
+		clear_selection();
+	}
+	f_selected = !m_selected_ways.remove(p_way);
+	if (f_selected) {
+		m_selected_ways.insert(p_way);
+		add_item(*p_way, true);
+	}
+	if (m_wayid_to_item.contains(p_way->get_id())) {
+		m_wayid_to_item[p_way->get_id()]->set_highlighted(f_selected);
+	}
+	emit_selection_changed();
+}
+
+/*----------------------------------------------------------------*/
+
+void View_Handler::clear_selection() {
+	Item_Node*	p_nodeitem;
+	Item_Way*	p_item_way;
+	QRectF		area;
+
+	/* While tiled, items out of sight were only there for the selection, and
+	 * the ones in sight go back under the tiles unless an edit is pending */
+	if (mp_tile_cache != nullptr) {
+		area = get_live_area();
+	}
+	for (auto it = m_selected_nodes.cbegin(); it != m_selected_nodes.cend(); ++it) {
+		if ((p_nodeitem = m_nodeid_to_item.value((*it)->get_id(), nullptr)) == nullptr) {
+			continue;
+		}
+		p_nodeitem->set_highlighted(false);
+		if (mp_tile_cache == nullptr) {
+			continue;
+		} else if (!area.intersects(get_tile_footprint(**it))) {
+			remove_item(**it);
+		} else if (!m_touched_nodes.contains((*it)->get_id())) {
+			p_nodeitem->setFlag(QGraphicsItem::ItemHasNoContents, true);
+		}
+	}
+	for (auto it = m_selected_ways.cbegin(); it != m_selected_ways.cend(); ++it) {
+		if ((p_item_way = m_wayid_to_item.value((*it)->get_id(), nullptr)) == nullptr) {
+			continue;
+		}
+		p_item_way->set_highlighted(false);
+		if (mp_tile_cache == nullptr) {
+			continue;
+		} else if (!area.intersects(get_tile_footprint(**it))) {
+			remove_item(**it);
+		} else if (!m_touched_ways.contains((*it)->get_id())) {
+			p_item_way->set_edges_hollow(true);
+		}
+	}
+	m_selected_nodes.clear();
+	m_selected_ways.clear();
+}
+
+/*----------------------------------------------------------------*/
+
+void View_Handler::emit_selection_changed() {
+	emit signal_selection_changed(get_selection());
+}
+
+/*----------------------------------------------------------------*/
+
+Pick_Handler::Hit View_Handler::pick(const QPointF& scene_pos) {
+	return m_pick_handler.pick(scene_pos, PICK_TOLERANCE / mp_view->transform().m11());
 }
 
 /*================================================================*/
@@ -253,21 +805,73 @@ void View_Handler::load_from_map() {
 /*================================================================*/
 
 void View_Handler::handle_event_delete(Osm_Node& node) {
+	if (mp_tile_cache != nullptr) {
+		QRectF rect = get_tile_footprint(node);
+		m_tile_snapshot.remove_point(node.get_id());
+		invalidate_tiles(rect);
+	}
 	remove(&node);
 }
 
 /*----------------------------------------------------------------*/
 
 void View_Handler::handle_event_delete(Osm_Way& way) {
+	if (mp_tile_cache != nullptr) {
+		QRectF rect = get_tile_footprint(way);
+		m_tile_snapshot.remove_line(way.get_id());
+		invalidate_tiles(rect);
+	}
 	remove(&way);
 }
 
 /*----------------------------------------------------------------*/
 
+void View_Handler::handle_event_update(Osm_Way& way) {
+	QRectF rect;
+
+	m_pick_handler.update(way);
+	if (mp_tile_cache == nullptr) {
+		return;
+	}
+	switch (get_meta()) {
+	case NODE_ADDED:
+	case NODE_DELETED:
+		rect = get_tile_footprint(way);
+		if (get_meta().get_subject() != nullptr) {
+			rect |= get_tile_footprint(*static_cast<Osm_Node*>(get_meta().get_subject()));
+		}
+		sync_tile_snapshot(way);
+		invalidate_tiles(rect | get_tile_footprint(way));
+		/* A way drawn into sight gets its item here, new edges paint until tiled */
+		if (!m_wayid_to_item.contains(way.get_id()) && get_live_area().intersects(get_tile_footprint(way))) {
+			add_item(way, false);
+		}
+		touch(way);
+		break;
+	case NODE_UPDATED: /* The moved node's edges show themselves */
+		touch(way);
+		break;
+	default:
+		break;
+	}
+}
+
+/*----------------------------------------------------------------*/
+
 void View_Handler::handle_event_update(Osm_Object&) {
 	Meta meta(get_meta());
 	switch (meta) {
 	case MAP_EVENT:
+		if (meta.get_event() == MAP_CLEARED) {
+			m_pick_handler.clear();
+			if (mp_tile_cache != nullptr) {
+				mp_tile_cache->clear();
+				m_tile_snapshot = Tile_Cache::Snapshot();
+			}
+		} else if (meta.get_event() == MAP_RELOADED) {
+			m_tile_snapshot = Tile_Cache::Snapshot();
+			add_all();
+		}
 		if (meta.get_subject() == nullptr) {
 			return;
 		}
@@ -278,6 +882,21 @@ void View_Handler::handle_event_update(Osm_Object&) {
 		case MAP_WAY_ADDED:
 			add(static_cast<Osm_Way*>(meta.get_subject()));
 			break;
+		case MAP_TAGS_UPDATED: /* Nothing drawn or picked depends on tags, whatever get_ids() lists */
+			break;
+		case MAP_NODE_UPDATED:
+			m_pick_handler.update(*static_cast<Osm_Node*>(meta.get_subject()));
+			if (mp_tile_cache != nullptr) {
+				Osm_Node* p_node = static_cast<Osm_Node*>(meta.get_subject());
+				if (m_nodeid_to_item.contains(p_node->get_id())) {
+					m_nodeid_to_item[p_node->get_id()]->setFlag(QGraphicsItem::ItemHasNoContents, false);
+					touch(*p_node);
+				}
+				QRectF rect = get_tile_footprint(*p_node);
+				m_tile_snapshot.set_point(p_node->get_id(), m_coord_handler.get_pos_on_scene(*p_node));
+				invalidate_tiles(rect | get_tile_footprint(*p_node));
+			}
+			break;
 		default:
 			break;
 		}
@@ -297,6 +916,7 @@ void View_Handler::handle_event_delete(Osm_Object&) {
 		while (!m_wayid_to_item.isEmpty()) {
 			remove(m_wayid_to_item.begin().value()->get_way());
 		}
+		m_pick_handler.clear(); /* Elements without an item are still in it */
 	case MAP_CLEARED:
 		mp_scene->setSceneRect(0,0,0,0);
 		break;
@@ -309,6 +929,52 @@ void View_Handler::handle_event_delete(Osm_Object&) {
 /*                        Public methods                          */
 /*================================================================*/
 
+QList<Osm_Info*> View_Handler::get_selection() const {
+	QList<Osm_Info*> selection;
+
+	selection.reserve(m_selected_nodes.size() + m_selected_ways.size());
+	for (auto it = m_selected_nodes.cbegin(); it != m_selected_nodes.cend(); ++it) {
+		selection.push_back(*it);
+	}
+	for (auto it = m_selected_ways.cbegin(); it != m_selected_ways.cend(); ++it) {
+		selection.push_back(*it);
+	}
+	return selection;
+}
+
+/*----------------------------------------------------------------*/
+
+void View_Handler::select(const Osm_Query::Result& result, bool f_extend) {
+	if (!f_extend) {
+		clear_selection();
+	}
+	for (auto it = result.nodes.cbegin(); it != result.nodes.cend(); ++it) {
+		Osm_Node* p_node = m_map.get_node(*it);
+		if (p_node != nullptr && !m_selected_nodes.contains(p_node)) {
+			m_selected_nodes.insert(p_node);
+			add_item(*p_node, true);
+			m_nodeid_to_item[*it]->set_highlighted(true);
+		}
+	}
+	for (auto it = result.ways.cbegin(); it != result.ways.cend(); ++it) {
+		Osm_Way* p_way = m_map.get_way(*it);
+		if (p_way != nullptr && !m_selected_ways.contains(p_way)) {
+			m_selected_ways.insert(p_way);
+			add_item(*p_way, true);
+			m_wayid_to_item[*it]->set_highlighted(true);
+		}
+	}
+	emit_selection_changed();
+}
+
+/*----------------------------------------------------------------*/
+
+Spatial_Index& View_Handler::get_spatial_index() {
+	return m_pick_handler;
+}
+
+/*----------------------------------------------------------------*/
+
 void View_Handler::set_tool(Osm_Tool tool) {
 	m_drawing.current_tool = tool;
 	if (m_drawing.p_last_way != nullptr) {
@@ -318,3 +984,115 @@ void View_Handler::set_tool(Osm_Tool tool) {
 	}
 	m_drawing.p_last_way = nullptr;
 }
+
+/*----------------------------------------------------------------*/
+
+Item_Edge* View_Handler::acquire_item_edge(Osm_Node& node1, Osm_Node& node2, Osm_Way& way) {
+	Item_Edge* p_item_edge;
+
+	if (!m_free_item_edges.isEmpty()) {
+		p_item_edge = m_free_item_edges.takeLast();
+		p_item_edge->reset(node1, node2, way);
+		return p_item_edge;
+	}
+	p_item_edge = new Item_Edge(m_coord_handler, node1, node2, way);
+	QObject::connect(p_item_edge,
+	                 SIGNAL(signal_edge_clicked(QPointF,Osm_Way*,Osm_Node*,Osm_Node*,Qt::MouseButton)),
+	                 this,
+	                 SLOT(slot_item_edge_clicked(QPointF,Osm_Way*,Osm_Node*,Osm_Node*,Qt::MouseButton)));
+	return p_item_edge;
+}
+
+/*----------------------------------------------------------------*/
+
+void View_Handler::release(Item_Edge* p_item) {
+	/* Unparented right away, so a dying Item_Way does not take the edge with it */
+	p_item->detach();
+	p_item->setParentItem(nullptr);
+	p_item->setEnabled(false);
+	p_item->hide();
+	m_released_item_edges.push_back(p_item);
+	schedule_recycle();
+}
+
+/*----------------------------------------------------------------*/
+
+void View_Handler::set_tiled_rendering(bool f) {
+	if (f == is_tiled_rendering()) {
+		return;
+	}
+	if (f) {
+		mp_tile_cache = new Tile_Cache(this);
+		/* Built once here, patched by the events from then on */
+		for (Osm_Map::node_iterator it = m_map.nbegin(); it != m_map.nend(); ++it) {
+			m_tile_snapshot.set_point((*it)->get_id(), m_coord_handler.get_pos_on_scene(**it));
+		}
+		for (Osm_Map::way_iterator it = m_map.wbegin(); it != m_map.wend(); ++it) {
+			sync_tile_snapshot(**it);
+		}
+		QObject::connect(mp_tile_cache, SIGNAL(signal_snapshot_required()),
+		                 this, SLOT(slot_snapshot_required()), Qt::DirectConnection);
+		QObject::connect(mp_tile_cache, SIGNAL(signal_tile_ready(QRectF)),
+		                 this, SLOT(slot_tile_ready(QRectF)));
+		mp_view->set_tile_cache(mp_tile_cache);
+		/* Walks every item this once; from here on only the live area has any */
+		sync_live_items(true);
+		set_items_hollow(true);
+	} else {
+		mp_view->set_tile_cache(nullptr);
+		delete mp_tile_cache;
+		mp_tile_cache = nullptr;
+		m_tile_snapshot = Tile_Cache::Snapshot();
+		add_all_items();
+		set_items_hollow(false);
+		mp_scene->setSceneRect(QRectF()); /* Back to growing around the items */
+	}
+	m_touched_nodes.clear();
+	m_touched_ways.clear();
+}
+
+/*----------------------------------------------------------------*/
+
+Memory_Usage View_Handler::get_memory_usage() const {
+	Memory_Usage			usage;
+	QList<QGraphicsItem*>	items = mp_scene->items();
+	qint64					n_item_bytes = 0;
+
+	for (auto it = items.cbegin(); it != items.cend(); ++it) {
+		switch ((*it)->type()) {
+		case Item_Node::Type:
+			n_item_bytes += sizeof(Item_Node) + ITEM_OVERHEAD + OBJECT_OVERHEAD;
+			break;
+		case Item_Edge::Type:
+			n_item_bytes += sizeof(Item_Edge) + ITEM_OVERHEAD + OBJECT_OVERHEAD;
+			break;
+		case Item_Way::Type:
+			n_item_bytes += sizeof(Item_Way) + ITEM_OVERHEAD;
+			break;
+		default:
+			n_item_bytes += ITEM_OVERHEAD;
+		}
+	}
+	n_item_bytes += m_free_item_nodes.size() * (sizeof(Item_Node) + ITEM_OVERHEAD + OBJECT_OVERHEAD)
+	                + m_free_item_edges.size() * (sizeof(Item_Edge) + ITEM_OVERHEAD + OBJECT_OVERHEAD)
+	                + Memory_Usage::bytes_of(m_free_item_nodes) + Memory_Usage::bytes_of(m_free_item_edges)
+	                + Memory_Usage::bytes_of(m_released_item_nodes) + Memory_Usage::bytes_of(m_released_item_edges)
+	                + Memory_Usage::bytes_of(m_released_item_ways);
+	usage.add_elements(Memory_Usage::VIEW, items.size() + m_free_item_nodes.size() + m_free_item_edges.size());
+	usage.add(Memory_Usage::VIEW, Memory_Usage::OBJECT, sizeof(View_Handler));
+	usage.add(Memory_Usage::VIEW, Memory_Usage::SCENE_ITEMS, n_item_bytes);
+	usage.add(Memory_Usage::VIEW, Memory_Usage::INDEXES,
+	          Memory_Usage::bytes_of(m_nodeid_to_item) + Memory_Usage::bytes_of(m_wayid_to_item)
+	          + Memory_Usage::bytes_of(m_selected_nodes) + Memory_Usage::bytes_of(m_selected_ways));
+	m_pick_handler.add_memory_usage(usage);
+	if (mp_tile_cache != nullptr) {
+		mp_tile_cache->add_memory_usage(usage);
+	}
+	return usage;
+}
+
+/*----------------------------------------------------------------*/
+
+bool View_Handler::is_tiled_rendering() const {
+	return mp_tile_cache != nullptr;
+}
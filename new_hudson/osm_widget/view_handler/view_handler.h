@@ -13,6 +13,8 @@
 #include "osm_view.h"
 #include "coord_handler.h"
 #include "osm_tool.h"
+#include "tile_cache.h"
+#include "pick_handler.h"
 #include <math.h>
 
 namespace ns_osm {
@@ -22,6 +24,7 @@ class View_Handler : public QWidget, public Osm_Subscriber {
 signals:
 	void								signal_object_selected	(Osm_Node&);
 	void								signal_object_selected	(Osm_Way&);
+	void								signal_selection_changed(QList<Osm_Info*>);
 private slots:
 	void								slot_blank_area_clicked	(QPointF, Qt::MouseButton);
 	void								slot_node_clicked		(Osm_Node*, Qt::MouseButton);
@@ -30,33 +33,97 @@ private slots:
 	                                                             Osm_Node*,
 	                                                             Osm_Node*,
 	                                                             Qt::MouseButton);
+	void								slot_item_edge_clicked	(QPointF,
+	                                                             Osm_Way*,
+	                                                             Osm_Node*,
+	                                                             Osm_Node*,
+	                                                             Qt::MouseButton);
+	void								slot_snapshot_required	();
+	void								slot_tile_ready			(QRectF scene_rect);
+	void								slot_recycle			();
+	void								slot_area_selected		(QRectF scene_rect, bool f_extend);
+	void								slot_visible_rect_changed();
+	void								slot_sync_live_items	();
 private:
 	static const char*					MENU_DELETE;
+	static const int					MAX_POOLED_ITEMS;
+	static const int					MAX_LIVE_ITEMS; /* Zoomed out past this, only the selection has items while tiled */
+	static const double					PICK_TOLERANCE; /* Pixels */
+	static const int					ITEM_OVERHEAD; /* Bytes behind a QGraphicsItem's d-pointer, about */
+	static const int					OBJECT_OVERHEAD; /* And behind a QObject's */
 	struct Drawing {
 		Osm_Way*	p_last_way;
 		Osm_Tool	current_tool;
 		QMenu*		p_menu;}			m_drawing;
 	Osm_Map&							m_map;
 	Coord_Handler						m_coord_handler;
+	Pick_Handler						m_pick_handler;
 	QGraphicsScene*						mp_scene;
 	Osm_View*							mp_view;
 	QHash<long long, Item_Node*>		m_nodeid_to_item;
 	QHash<long long, Item_Way*>			m_wayid_to_item;
+	QList<Item_Node*>					m_free_item_nodes;		/* Out of the scene, ready for reuse */
+	QList<Item_Edge*>					m_free_item_edges;
+	QList<Item_Node*>					m_released_item_nodes;	/* Hidden, leave the scene on recycling */
+	QList<Item_Edge*>					m_released_item_edges;
+	QList<Item_Way*>					m_released_item_ways;
+	bool								f_recycle_scheduled;
+	QSet<Osm_Node*>						m_selected_nodes;
+	QSet<Osm_Way*>						m_selected_ways;
+	Tile_Cache*							mp_tile_cache; /* nullptr unless tiled rendering is on */
+	Tile_Cache::Snapshot				m_tile_snapshot; /* Patched per event while tiled, copied out on demand */
+	QSet<long long>						m_touched_nodes;	/* Items painting until the tiles catch up */
+	QSet<long long>						m_touched_ways;
+	bool								f_live_sync_scheduled;
 	bool								f_editable;
 
-	void								add						(Osm_Node*);
-	void								add						(Osm_Way*);
+	void								add						(Osm_Node*, bool f_invalidate = true);
+	void								add						(Osm_Way*, bool f_invalidate = true);
+	void								add_all					(); /* Drops the tiles once rather than per element */
+	bool								add_item				(Osm_Node&, bool f_hollow); /* false if it had one */
+	bool								add_item				(Osm_Way&, bool f_hollow);
+	void								add_all_items			();
+	void								remove_item				(Osm_Node&);
+	void								remove_item				(Osm_Way&);
 	void								remove					(Osm_Node*);
 	void								remove					(Osm_Way*);
 	void								load_from_map			();
+	Item_Node*							acquire_item_node		(Osm_Node&);
+	void								release					(Item_Node*);
+	void								release					(Item_Way*);
+	void								schedule_recycle		();
+	void								sync_tile_snapshot		(Osm_Way&);
+	QRectF								get_tile_footprint		(Osm_Node&) const;
+	QRectF								get_tile_footprint		(Osm_Way&) const;
+	void								invalidate_tiles		(const QRectF& scene_rect);
+	void								set_items_hollow		(bool f);
+	void								touch					(Osm_Node&);
+	void								touch					(Osm_Way&);
+	QRectF								get_live_area			() const; /* What is visible and a margin around it */
+	void								sync_live_items			(bool f_hollow);
+	void								grow_scene_rect			(const QRectF&);
+	Pick_Handler::Hit					pick					(const QPointF& scene_pos);
+	void								select					(Osm_Node*, bool f_extend);
+	void								select					(Osm_Way*, bool f_extend);
+	void								clear_selection			();
+	void								emit_selection_changed	();
 protected:
 	void								handle_event_delete		(Osm_Node&) override;
 //	void								handle_event_update		(Osm_Node&) override;
 	void								handle_event_delete		(Osm_Way&) override;
+	void								handle_event_update		(Osm_Way&) override;
 	void								handle_event_update		(Osm_Object&) override;
 	void								handle_event_delete		(Osm_Object&) override;
 public:
+	Item_Edge*							acquire_item_edge		(Osm_Node& node1, Osm_Node& node2, Osm_Way&);
+	void								release					(Item_Edge*);
 	void								set_tool				(Osm_Tool);
+	QList<Osm_Info*>					get_selection			() const;
+	void								select					(const Osm_Query::Result&, bool f_extend); /* Relations are skipped */
+	Spatial_Index&						get_spatial_index		();
+	void								set_tiled_rendering		(bool f);
+	bool								is_tiled_rendering		() const;
+	Memory_Usage						get_memory_usage		() const; /* Items, indexes and tiles; not the map */
 	                                    View_Handler			(Osm_Map&);
 										View_Handler			(const View_Handler&);
 										View_Handler			() = delete;
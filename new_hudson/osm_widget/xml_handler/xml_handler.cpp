@@ -1,6 +1,12 @@
 #include "xml_handler.h"
 using namespace ns_osm;
 
+/*================================================================*/
+/*                        Static members                          */
+/*================================================================*/
+
+const int Xml_Handler::PROGRESS_INTERVAL = 4096;
+
 /*================================================================*/
 /*                  Constructors, destructors                     */
 /*================================================================*/
@@ -228,6 +234,15 @@ void Xml_Handler::load_relations_from_xml(const QDomNode &node) {
 	}
 }
 
+void Xml_Handler::read_attrs(const QXmlStreamAttributes& attrs, Osm_Info& info) {
+	info.set_attr(Osm_Xml::VISIBLE, attrs.value(Osm_Xml::VISIBLE).toString());
+	info.set_attr(Osm_Xml::VERSION, attrs.value(Osm_Xml::VERSION).toString());
+	info.set_attr(Osm_Xml::CHANGESET, attrs.value(Osm_Xml::CHANGESET).toString());
+	info.set_attr(Osm_Xml::TIMESTAMP, attrs.value(Osm_Xml::TIMESTAMP).toString());
+	info.set_attr(Osm_Xml::USER, attrs.value(Osm_Xml::USER).toString());
+	info.set_attr(Osm_Xml::UID, attrs.value(Osm_Xml::UID).toString());
+}
+
 void Xml_Handler::compose_attrs_and_tags(QDomDocument& doc,
                                          QDomElement& node,
                                          const Osm_Info& info) {
@@ -310,6 +325,21 @@ void Xml_Handler::compose_relations(QDomDocument &doc, QDomElement &node_osm) {
 	}
 }
 
+void Xml_Handler::write_attrs_and_tags(QXmlStreamWriter& writer, const Map_Snapshot::Element& element) {
+	writer.writeAttribute(Osm_Xml::ID, element.attrs.value(Osm_Xml::ID));
+	writer.writeAttribute(Osm_Xml::VISIBLE, element.attrs.value(Osm_Xml::VISIBLE));
+	writer.writeAttribute(Osm_Xml::VERSION, element.attrs.value(Osm_Xml::VERSION));
+	writer.writeAttribute(Osm_Xml::TIMESTAMP, element.attrs.value(Osm_Xml::TIMESTAMP));
+	writer.writeAttribute(Osm_Xml::USER, element.attrs.value(Osm_Xml::USER));
+	writer.writeAttribute(Osm_Xml::UID, element.attrs.value(Osm_Xml::UID));
+
+	for (auto it = element.tags.cbegin(); it != element.tags.cend(); ++it) {
+		writer.writeEmptyElement(Osm_Xml::TAG);
+		writer.writeAttribute(Osm_Xml::K, it.key());
+		writer.writeAttribute(Osm_Xml::V, it.value());
+	}
+}
+
 /*================================================================*/
 /*                        Public methods                          */
 /*================================================================*/
@@ -324,10 +354,12 @@ int Xml_Handler::load_from_xml(const QString &xml_path) {
 	if (file.open(QIODevice::ReadOnly)) {
 		if (dom_document.setContent(&file)) {
 			dom_element = dom_document.documentElement();
+			m_map.begin_batch();
 			load_bound_from_xml(dom_element);
 			load_nodes_from_xml(dom_element);
 			load_ways_from_xml(dom_element);
 			load_relations_from_xml(dom_element);
+			m_map.end_batch();
 		} else {
 			//f_done = false;
 			code = OSM_ERROR_WRONG_XML_FORMAT;
@@ -344,6 +376,123 @@ int Xml_Handler::load_from_xml(const QString &xml_path) {
 	return code;
 }
 
+/* On failure or cancellation the map is left empty */
+int Xml_Handler::load_from_xml(const QString& xml_path, const Progress_Callback& callback) {
+	struct Pending_Relation {
+		Osm_Relation* p_master;
+		long long	  slave_id;
+		QString		  slave_role;
+	};
+
+	QList<Pending_Relation>	pending_relations;
+	QFile					file(xml_path);
+	QXmlStreamReader		reader;
+	Progress				progress = {0, 0, 0, 0, 0};
+	Osm_Info*				p_info = nullptr; /* Open element, not in the map yet */
+	Osm_Node*				p_node = nullptr;
+	Osm_Way*				p_way = nullptr;
+	Osm_Relation*			p_rel = nullptr;
+	int						n_unreported = 0;
+	int						code = OSM_OK;
+
+	m_map.clear();
+	if (!file.open(QIODevice::ReadOnly)) {
+		return OSM_ERROR_XML_FILE_NOT_EXISTS;
+	}
+	progress.bytes_total = file.size();
+	reader.setDevice(&file);
+	m_map.begin_batch();
+	while (!reader.atEnd() && code == OSM_OK) {
+		QXmlStreamReader::TokenType token = reader.readNext();
+
+		if (token == QXmlStreamReader::EndElement && p_info != nullptr) {
+			if (reader.name() == QLatin1String(Osm_Xml::NODE) && p_node != nullptr) {
+				m_map.add(p_node);
+				++progress.n_nodes;
+			} else if (reader.name() == QLatin1String(Osm_Xml::WAY) && p_way != nullptr) {
+				m_map.add(p_way);
+				++progress.n_ways;
+			} else if (reader.name() == QLatin1String(Osm_Xml::RELATION) && p_rel != nullptr) {
+				m_map.add(p_rel);
+				++progress.n_relations;
+			} else {
+				continue;
+			}
+			p_info = nullptr;
+			p_node = nullptr;
+			p_way = nullptr;
+			p_rel = nullptr;
+			if (++n_unreported == PROGRESS_INTERVAL && callback) {
+				n_unreported = 0;
+				progress.bytes_read = file.pos();
+				code = (callback(progress) ? OSM_OK : OSM_ERROR_CANCELLED);
+			}
+			continue;
+		}
+		if (token != QXmlStreamReader::StartElement) {
+			continue;
+		}
+
+		QXmlStreamAttributes attrs = reader.attributes();
+		if (reader.name() == QLatin1String(Osm_Xml::BOUNDS)) {
+			QRectF bound;
+			bound.setLeft(attrs.value(Osm_Xml::MINLON).toDouble());
+			bound.setBottom(attrs.value(Osm_Xml::MINLAT).toDouble());
+			bound.setRight(attrs.value(Osm_Xml::MAXLON).toDouble());
+			bound.setTop(attrs.value(Osm_Xml::MAXLAT).toDouble());
+			m_map.set_bound(bound);
+		} else if (p_info != nullptr) {
+			if (reader.name() == QLatin1String(Osm_Xml::TAG)) {
+				p_info->set_tag(attrs.value(Osm_Xml::K).toString(), attrs.value(Osm_Xml::V).toString());
+			} else if (reader.name() == QLatin1String(Osm_Xml::ND) && p_way != nullptr) {
+				p_way->push_node(m_map.get_node(attrs.value(Osm_Xml::REF).toLongLong()));
+			} else if (reader.name() == QLatin1String(Osm_Xml::MEMBER) && p_rel != nullptr) {
+				long long	ref = attrs.value(Osm_Xml::REF).toLongLong();
+				QString		role = attrs.value(Osm_Xml::ROLE).toString();
+				if (attrs.value(Osm_Xml::TYPE) == QLatin1String(Osm_Xml::NODE)) {
+					p_rel->add(m_map.get_node(ref), role);
+				} else if (attrs.value(Osm_Xml::TYPE) == QLatin1String(Osm_Xml::WAY)) {
+					p_rel->add(m_map.get_way(ref), role);
+				} else if (attrs.value(Osm_Xml::TYPE) == QLatin1String(Osm_Xml::RELATION)) {
+					pending_relations.push_front(Pending_Relation{p_rel, ref, role});
+				}
+			}
+		} else if (reader.name() == QLatin1String(Osm_Xml::NODE)) {
+			p_info = p_node = new Osm_Node(attrs.value(Osm_Xml::ID).toString(),
+			                               attrs.value(Osm_Xml::LAT).toString(),
+			                               attrs.value(Osm_Xml::LON).toString());
+			read_attrs(attrs, *p_node);
+		} else if (reader.name() == QLatin1String(Osm_Xml::WAY)) {
+			p_info = p_way = new Osm_Way(attrs.value(Osm_Xml::ID).toString());
+			read_attrs(attrs, *p_way);
+		} else if (reader.name() == QLatin1String(Osm_Xml::RELATION)) {
+			p_info = p_rel = new Osm_Relation(attrs.value(Osm_Xml::ID).toString());
+			read_attrs(attrs, *p_rel);
+		}
+	}
+	if (code == OSM_OK && reader.hasError()) {
+		code = OSM_ERROR_WRONG_XML_FORMAT;
+	}
+	m_map.end_batch();
+	if (code != OSM_OK) {
+		delete p_node;
+		delete p_way;
+		delete p_rel;
+		m_map.clear();
+		return code;
+	}
+
+	/* Handle pending relations */
+	for (auto it = pending_relations.begin(); it != pending_relations.end(); ++it) {
+		it->p_master->add(m_map.get_relation(it->slave_id), it->slave_role);
+	}
+	progress.bytes_read = progress.bytes_total;
+	if (callback) {
+		callback(progress);
+	}
+	return OSM_OK;
+}
+
 int Xml_Handler::save_to_xml(const QString& xml_path) {
 	QDomDocument	out_xml;
 	QDomElement		node_osm = out_xml.createElement(Osm_Xml::OSM);
@@ -374,3 +523,61 @@ int Xml_Handler::save_to_xml(const QString& xml_path) {
 	}
 	return OSM_OK;
 }
+
+int Xml_Handler::save_to_xml(const Map_Snapshot& snapshot, const QString& xml_path) {
+	static const char*	MEMBER_TYPES[] = {Osm_Xml::NODE, Osm_Xml::WAY, Osm_Xml::RELATION};
+	QSaveFile			file(xml_path);
+	QXmlStreamWriter	writer;
+	QRectF				bound(snapshot.get_bound());
+
+	if (!file.open(QIODevice::WriteOnly)) {
+		return OSM_ERROR_CANNOT_WRITE_FILE;
+	}
+	writer.setDevice(&file);
+	writer.setAutoFormatting(true);
+	writer.writeStartDocument();
+	writer.writeStartElement(Osm_Xml::OSM);
+	writer.writeAttribute(Osm_Xml::VERSION, "0.6");
+	writer.writeAttribute(Osm_Xml::GENERATOR, "Hudson");
+
+	writer.writeEmptyElement(Osm_Xml::BOUNDS);
+	writer.writeAttribute(Osm_Xml::MINLON, QString::number(bound.left()));
+	writer.writeAttribute(Osm_Xml::MAXLON, QString::number(bound.right()));
+	writer.writeAttribute(Osm_Xml::MINLAT, QString::number(bound.bottom()));
+	writer.writeAttribute(Osm_Xml::MAXLAT, QString::number(bound.top()));
+
+	snapshot.get_nodes().for_each([&writer](const Map_Snapshot::Node& node) {
+		writer.writeStartElement(Osm_Xml::NODE);
+		writer.writeAttribute(Osm_Xml::LAT, node.attrs.value(Osm_Xml::LAT));
+		writer.writeAttribute(Osm_Xml::LON, node.attrs.value(Osm_Xml::LON));
+		write_attrs_and_tags(writer, node);
+		writer.writeEndElement();
+	});
+	snapshot.get_ways().for_each([&writer](const Map_Snapshot::Way& way) {
+		writer.writeStartElement(Osm_Xml::WAY);
+		write_attrs_and_tags(writer, way);
+		for (long long ref : way.nodes) {
+			writer.writeEmptyElement(Osm_Xml::ND);
+			writer.writeAttribute(Osm_Xml::REF, QString::number(ref));
+		}
+		writer.writeEndElement();
+	});
+	snapshot.get_relations().for_each([&writer](const Map_Snapshot::Relation& rel) {
+		writer.writeStartElement(Osm_Xml::RELATION);
+		write_attrs_and_tags(writer, rel);
+		for (const Map_Snapshot::Member& member : rel.members) {
+			writer.writeEmptyElement(Osm_Xml::MEMBER);
+			writer.writeAttribute(Osm_Xml::TYPE, MEMBER_TYPES[member.type]);
+			writer.writeAttribute(Osm_Xml::REF, QString::number(member.id));
+			writer.writeAttribute(Osm_Xml::ROLE, member.role);
+		}
+		writer.writeEndElement();
+	});
+
+	writer.writeEndElement();
+	writer.writeEndDocument();
+	if (writer.hasError() || !file.commit()) {
+		return OSM_ERROR_CANNOT_WRITE_FILE;
+	}
+	return OSM_OK;
+}
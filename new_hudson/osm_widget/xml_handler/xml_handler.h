@@ -4,19 +4,33 @@
 #include "osm_elements.h"
 #include "osm_message.h"
 
-#ifndef QT_WIDGETS_H
-#define QT_WIDGETS_H
-#include <QtWidgets>
-#endif // Include Guard QT_WIDGETS_H
+#ifndef QT_CORE_H
+#define QT_CORE_H
+#include <QtCore>
+#endif // Include Guard QT_CORE_H
 
 #ifndef QT_XML_H
 #define QT_XML_H
 #include <QtXml>
 #endif // Include Guard QT_XML_H
 
+#ifndef FUNCTIONAL_H
+#define FUNCTIONAL_H
+#include <functional>
+#endif /* Include guard FUNCTIONAL_H */
+
 namespace ns_osm  {
 
 class Xml_Handler {
+public:
+	struct Progress {
+		qint64	bytes_read;
+		qint64	bytes_total;
+		int		n_nodes;
+		int		n_ways;
+		int		n_relations;
+	};
+	typedef std::function<bool(const Progress&)>	Progress_Callback; /* Returns false to cancel */
 private:
 	                        Xml_Handler				()						= delete;
 							Xml_Handler				(const Xml_Handler&)	= delete;
@@ -24,12 +38,14 @@ private:
 protected:
 	struct Osm_Xml;
 
+	static const int		PROGRESS_INTERVAL; /* Elements between progress callbacks */
 	ns_osm::Osm_Map&		m_map;
 
 	void					load_bound_from_xml		(const QDomNode& node);
 	void					load_nodes_from_xml		(const QDomNode& node);
 	void					load_ways_from_xml		(const QDomNode& node);
 	void					load_relations_from_xml	(const QDomNode& node);
+	void					read_attrs				(const QXmlStreamAttributes&, Osm_Info&);
 	void					compose_attrs_and_tags	(QDomDocument& doc,
 	                                                 QDomElement& node,
 	                                                 const Osm_Info& info);
@@ -37,9 +53,16 @@ protected:
 	void					compose_ways			(QDomDocument& doc, QDomElement& node_osm);
 	void					compose_relations		(QDomDocument& doc, QDomElement& node_osm);
 	void					compose_bound			(QDomDocument& doc, QDomElement& node_osm);
+	static void				write_attrs_and_tags	(QXmlStreamWriter&, const Map_Snapshot::Element&);
 public:
 	int						load_from_xml			(const QString& xml_path);
+	/* Streams the file instead of building a DOM, so it can report progress and stop
+	 * halfway; elements must come in the usual order, nodes before the ways using them */
+	int						load_from_xml			(const QString& xml_path, const Progress_Callback&);
 	int						save_to_xml				(const QString& xml_path);
+	/* Writes the same document as save_to_xml, streamed rather than built in memory.
+	 * Safe on any thread; the file is replaced only once it is complete */
+	static int				save_to_xml				(const Map_Snapshot&, const QString& xml_path);
 	                        Xml_Handler				(Osm_Map&);
 }; /* class Xml_Handler */
 }/* namespace  */
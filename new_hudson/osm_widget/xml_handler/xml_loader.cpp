@@ -0,0 +1,110 @@
+#include "xml_loader.h"
+
+using namespace ns_osm;
+
+/*================================================================*/
+/*                      Xml_Loader::Task                          */
+/*================================================================*/
+
+namespace ns_osm {
+
+class Xml_Loader::Task : public QRunnable {
+	Xml_Loader*			mp_loader;
+	Osm_Map*			mp_map;
+	QString				m_xml_path;
+public:
+	void				run			() override;
+	                    Task		(Xml_Loader&, Osm_Map&, const QString& xml_path);
+};
+
+}
+
+Xml_Loader::Task::Task(Xml_Loader& loader, Osm_Map& map, const QString& xml_path)
+                       :
+                         mp_loader(&loader),
+                         mp_map(&map),
+                         m_xml_path(xml_path)
+{
+	setAutoDelete(true);
+}
+
+/* Progress is emitted from here; receivers on the GUI thread get it queued */
+void Xml_Loader::Task::run() {
+	Xml_Loader*	p_loader = mp_loader;
+	int			result = Xml_Handler(*mp_map).load_from_xml(m_xml_path, [p_loader](const Xml_Handler::Progress& progress) {
+		emit p_loader->signal_progress(progress.bytes_read,
+		                               progress.bytes_total,
+		                               progress.n_nodes + progress.n_ways + progress.n_relations);
+		return p_loader->m_cancel_requested.load() == 0;
+	});
+
+	QMetaObject::invokeMethod(mp_loader, "slot_task_finished", Qt::QueuedConnection, Q_ARG(int, result));
+}
+
+/*================================================================*/
+/*                  Constructors, destructors                     */
+/*================================================================*/
+
+Xml_Loader::Xml_Loader(QObject* p_parent) : QObject(p_parent) {
+	m_pool.setMaxThreadCount(1);
+	mp_map = nullptr;
+	f_busy = false;
+}
+
+Xml_Loader::~Xml_Loader() {
+	cancel();
+	m_pool.waitForDone();
+	delete mp_map;
+}
+
+/*================================================================*/
+/*                       Private methods                          */
+/*================================================================*/
+
+/* A load that got through before seeing the request still counts as cancelled */
+void Xml_Loader::slot_task_finished(int result_code) {
+	f_busy = false;
+	if (result_code == OSM_OK && m_cancel_requested.load() != 0) {
+		result_code = OSM_ERROR_CANCELLED;
+	}
+	if (result_code != OSM_OK) {
+		delete mp_map;
+		mp_map = nullptr;
+	}
+	emit signal_finished(result_code);
+}
+
+/*================================================================*/
+/*                        Public methods                          */
+/*================================================================*/
+
+bool Xml_Loader::start(const QString& xml_path) {
+	if (f_busy) {
+		return false;
+	}
+	delete mp_map;
+	mp_map = new Osm_Map;
+	m_cancel_requested.store(0);
+	f_busy = true;
+	m_pool.start(new Task(*this, *mp_map, xml_path));
+	return true;
+}
+
+void Xml_Loader::cancel() {
+	if (f_busy) {
+		m_cancel_requested.store(1);
+	}
+}
+
+bool Xml_Loader::is_busy() const {
+	return f_busy;
+}
+
+Osm_Map* Xml_Loader::take_map() {
+	Osm_Map* p_map = (f_busy ? nullptr : mp_map);
+
+	if (p_map != nullptr) {
+		mp_map = nullptr;
+	}
+	return p_map;
+}
@@ -0,0 +1,45 @@
+#ifndef XML_LOADER_H
+#define XML_LOADER_H
+
+#ifndef QT_CORE_H
+#define QT_CORE_H
+#include <QtCore>
+#endif /* Include guard QT_CORE_H */
+
+#include "xml_handler.h"
+
+namespace ns_osm {
+
+/* Loads an .osm file on a worker thread into a map of its own, so the GUI
+ * keeps running during the parse. Progress comes as signals every few
+ * thousand elements and cancel() stops the parse at the next one. The
+ * finished map is handed over with take_map, usually into Osm_Map::take,
+ * so views never see a half-loaded map. */
+class Xml_Loader : public QObject {
+	Q_OBJECT
+signals:
+	void					signal_progress		(qint64 bytes_read, qint64 bytes_total, int n_elements);
+	void					signal_finished		(int result_code); /* OSM_ERROR_CANCELLED after cancel() */
+private slots:
+	void					slot_task_finished	(int result_code);
+private:
+	class Task;
+
+	QThreadPool				m_pool;
+	QAtomicInt				m_cancel_requested;
+	Osm_Map*				mp_map; /* Being loaded or loaded, owned until taken */
+	bool					f_busy;
+public:
+	bool					start				(const QString& xml_path); /* False while a load runs */
+	void					cancel				();
+	bool					is_busy				() const;
+	Osm_Map*				take_map			(); /* After OSM_OK, once; the caller owns the map */
+	                        Xml_Loader			(QObject* p_parent = nullptr);
+							Xml_Loader			(const Xml_Loader&) = delete;
+	Xml_Loader&				operator=			(const Xml_Loader&) = delete;
+	virtual					~Xml_Loader			();
+};
+
+}
+
+#endif // XML_LOADER_H
@@ -0,0 +1,80 @@
+#include "xml_saver.h"
+
+using namespace ns_osm;
+
+/*================================================================*/
+/*                       Xml_Saver::Task                          */
+/*================================================================*/
+
+namespace ns_osm {
+
+class Xml_Saver::Task : public QRunnable {
+	Xml_Saver*			mp_saver;
+	Map_Snapshot		m_snapshot;
+	QString				m_xml_path;
+public:
+	void				run			() override;
+	                    Task		(Xml_Saver&, const Map_Snapshot&, const QString& xml_path);
+};
+
+}
+
+Xml_Saver::Task::Task(Xml_Saver& saver, const Map_Snapshot& snapshot, const QString& xml_path)
+                      :
+                        mp_saver(&saver),
+                        m_snapshot(snapshot),
+                        m_xml_path(xml_path)
+{
+	setAutoDelete(true);
+}
+
+void Xml_Saver::Task::run() {
+	int result = Xml_Handler::save_to_xml(m_snapshot, m_xml_path);
+
+	QMetaObject::invokeMethod(mp_saver, "slot_task_finished", Qt::QueuedConnection,
+	                          Q_ARG(int, result), Q_ARG(QString, m_xml_path));
+}
+
+/*================================================================*/
+/*                  Constructors, destructors                     */
+/*================================================================*/
+
+Xml_Saver::Xml_Saver(QObject* p_parent) : QObject(p_parent) {
+	m_pool.setMaxThreadCount(1);
+	f_busy = false;
+}
+
+/* A save in progress is finished rather than left half written */
+Xml_Saver::~Xml_Saver() {
+	m_pool.waitForDone();
+}
+
+/*================================================================*/
+/*                       Private methods                          */
+/*================================================================*/
+
+void Xml_Saver::slot_task_finished(int result_code, const QString& xml_path) {
+	f_busy = false;
+	emit signal_finished(result_code, xml_path);
+}
+
+/*================================================================*/
+/*                        Public methods                          */
+/*================================================================*/
+
+bool Xml_Saver::start(const Map_Snapshot& snapshot, const QString& xml_path) {
+	if (f_busy) {
+		return false;
+	}
+	f_busy = true;
+	m_pool.start(new Task(*this, snapshot, xml_path));
+	return true;
+}
+
+bool Xml_Saver::is_busy() const {
+	return f_busy;
+}
+
+void Xml_Saver::wait() {
+	m_pool.waitForDone();
+}
@@ -0,0 +1,39 @@
+#ifndef XML_SAVER_H
+#define XML_SAVER_H
+
+#ifndef QT_CORE_H
+#define QT_CORE_H
+#include <QtCore>
+#endif /* Include guard QT_CORE_H */
+
+#include "xml_handler.h"
+
+namespace ns_osm {
+
+/* Saves a map snapshot on a worker thread, while the map itself stays
+ * free for editing. Whatever is edited after start() goes into the next
+ * save. */
+class Xml_Saver : public QObject {
+	Q_OBJECT
+signals:
+	void					signal_finished		(int result_code, const QString& xml_path);
+private slots:
+	void					slot_task_finished	(int result_code, const QString& xml_path);
+private:
+	class Task;
+
+	QThreadPool				m_pool;
+	bool					f_busy;
+public:
+	bool					start				(const Map_Snapshot&, const QString& xml_path); /* False while a save runs */
+	bool					is_busy				() const;
+	void					wait				(); /* Until the running save, if any, is on disk */
+	                        Xml_Saver			(QObject* p_parent = nullptr);
+							Xml_Saver			(const Xml_Saver&) = delete;
+	Xml_Saver&				operator=			(const Xml_Saver&) = delete;
+	virtual					~Xml_Saver			();
+};
+
+}
+
+#endif // XML_SAVER_H
@@ -0,0 +1,53 @@
+#include <QtTest>
+#include "benchmark.h"
+#include "osm_widget.h"
+
+using namespace ns_osm;
+
+class Bench_Coord_Handler : public QObject {
+	Q_OBJECT
+private:
+	Osm_Map			m_map;
+	Coord_Handler	m_coord_handler;
+private slots:
+	void initTestCase() {
+		ns_bench::fill_grid(m_map, 300);
+		m_coord_handler.set_map(m_map);
+	}
+
+	void to_scene() {
+		QPointF sum;
+
+		QBENCHMARK {
+			for (auto it = m_map.nbegin(); it != m_map.nend(); ++it) {
+				sum += m_coord_handler.get_pos_on_scene(**it);
+			}
+		}
+		QVERIFY(!sum.isNull());
+	}
+
+	void to_geo() {
+		QVector<QPointF>	positions;
+		QPointF				sum;
+
+		for (auto it = m_map.nbegin(); it != m_map.nend(); ++it) {
+			positions.push_back(m_coord_handler.get_pos_on_scene(**it));
+		}
+		QBENCHMARK {
+			for (auto it = positions.cbegin(); it != positions.cend(); ++it) {
+				sum += m_coord_handler.get_geo_coords(*it);
+			}
+		}
+		QVERIFY(!sum.isNull());
+	}
+
+	/* Every node added widens the automatic bounds */
+	void set_map() {
+		QBENCHMARK {
+			m_coord_handler.set_map(m_map);
+		}
+	}
+};
+
+BENCH_MAIN(Bench_Coord_Handler)
+#include "bench_coord_handler.moc"
@@ -0,0 +1,23 @@
+TEMPLATE = app
+
+QT += gui core widgets xml testlib
+
+INCLUDEPATH += \
+$$PWD/.. \
+$$PWD/../../../osm_widget \
+$$PWD/../../../osm_elements
+
+DEFINES += \
+    private=public                                              \
+    protected=public
+
+LIBS += -L$$PWD/../../../intermediate_libs/ -losm_widget
+LIBS += -L$$PWD/../../../intermediate_libs/ -losm_elements
+
+CONFIG += c++11
+
+HEADERS += \
+    ../benchmark.h
+
+SOURCES += \
+    bench_coord_handler.cpp
@@ -0,0 +1,77 @@
+#include <QtTest>
+#include "benchmark.h"
+
+using namespace ns_osm;
+
+class Bench_Events : public QObject {
+	Q_OBJECT
+private:
+	class Counter : public Osm_Subscriber {
+	public:
+		int n_updates;
+
+		void handle_event_update(Osm_Object&) override {
+			n_updates++;
+		}
+		Counter() {
+			n_updates = 0;
+		}
+	};
+private slots:
+	void emit_update_data() {
+		QTest::addColumn<int>("n_subscribers");
+		QTest::newRow("1") << 1;
+		QTest::newRow("10") << 10;
+		QTest::newRow("100") << 100;
+		QTest::newRow("1000") << 1000;
+	}
+
+	/* Straight fan-out: every subscriber sees the event */
+	void emit_update() {
+		QFETCH(int, n_subscribers);
+		Osm_Node			node(50.0, 7.0);
+		QVector<Counter*>	counters;
+
+		for (int i = 0; i < n_subscribers; ++i) {
+			counters.push_back(new Counter);
+			counters.back()->subscribe(node);
+		}
+		QBENCHMARK {
+			node.emit_update(NODE_UPDATED);
+		}
+		QVERIFY(counters.front()->n_updates > 0);
+		qDeleteAll(counters);
+	}
+
+	void node_moved_data() {
+		QTest::addColumn<int>("n_ways");
+		QTest::newRow("1") << 1;
+		QTest::newRow("10") << 10;
+		QTest::newRow("100") << 100;
+	}
+
+	/* Through the ways into the map: node -> ways -> map and its subscribers */
+	void node_moved() {
+		QFETCH(int, n_ways);
+		Osm_Map		map;
+		Osm_Node*	p_node = new Osm_Node(50.0, 7.0);
+		Counter		counter;
+		double		lat = 50.0;
+
+		for (int i = 0; i < n_ways; ++i) {
+			Osm_Way* p_way = new Osm_Way;
+			p_way->push_node(p_node);
+			p_way->push_node(new Osm_Node(50.0 + i * 0.001, 7.001));
+			map.add(p_way);
+		}
+		counter.subscribe(map);
+		QBENCHMARK {
+			lat += 0.0000001;
+			p_node->set_lat(lat);
+		}
+		QVERIFY(counter.n_updates > 0);
+	}
+};
+
+BENCH_MAIN(Bench_Events)
+#include "bench_events.moc"
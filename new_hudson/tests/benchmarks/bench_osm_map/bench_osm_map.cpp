@@ -0,0 +1,81 @@
+#include <QtTest>
+#include "benchmark.h"
+
+using namespace ns_osm;
+
+/* Each phase runs once on a fresh map: repeating it would measure a different map */
+class Bench_Osm_Map : public QObject {
+	Q_OBJECT
+private:
+	void add_sizes() {
+		QTest::addColumn<int>("side");
+		QTest::newRow("10k") << 100;
+		QTest::newRow("90k") << 300;
+		QTest::newRow("250k") << 500;
+	}
+private slots:
+	void add_data() {
+		add_sizes();
+	}
+
+	void add() {
+		QFETCH(int, side);
+		Osm_Map map;
+
+		QBENCHMARK_ONCE {
+			ns_bench::fill_grid(map, side);
+		}
+		QCOMPARE(side * side, map.count_nodes());
+	}
+
+	void remove_data() {
+		add_sizes();
+	}
+
+	/* Every other way, then every third node */
+	void remove() {
+		QFETCH(int, side);
+		Osm_Map				map;
+		QList<Osm_Way*>		ways;
+		QList<long long>	nodes; /* Ids: a way left with one node takes it along */
+
+		ns_bench::fill_grid(map, side);
+		for (auto it = map.wbegin(); it != map.wend(); ++it) {
+			if ((*it)->get_id() % 2 == 0) {
+				ways.push_back(*it);
+			}
+		}
+		for (auto it = map.nbegin(); it != map.nend(); ++it) {
+			if ((*it)->get_id() % 3 == 0) {
+				nodes.push_back((*it)->get_id());
+			}
+		}
+		QBENCHMARK_ONCE {
+			for (auto it = ways.cbegin(); it != ways.cend(); ++it) {
+				map.remove(*it);
+			}
+			for (auto it = nodes.cbegin(); it != nodes.cend(); ++it) {
+				map.remove(map.get_node(*it));
+			}
+		}
+		QVERIFY(map.count_ways() < 2 * side);
+	}
+
+	void clear_data() {
+		add_sizes();
+	}
+
+	void clear() {
+		QFETCH(int, side);
+		Osm_Map map;
+
+		ns_bench::fill_grid(map, side);
+		QBENCHMARK_ONCE {
+			map.clear();
+		}
+		QCOMPARE(0, map.count_nodes());
+	}
+};
+
+BENCH_MAIN(Bench_Osm_Map)
+#include "bench_osm_map.moc"
@@ -0,0 +1,17 @@
+TEMPLATE = app
+
+QT += testlib core
+
+CONFIG += c++11
+
+INCLUDEPATH += $$PWD/.. \
+    $$PWD/../../../osm_elements
+
+LIBS += -L$$PWD/../../../intermediate_libs -losm_elements
+
+HEADERS += ../benchmark.h
+
+SOURCES += bench_osm_map.cpp
+
+DEFINES += private=public \
+    protected=public
@@ -0,0 +1,51 @@
+#include <QtTest>
+#include "benchmark.h"
+#include "osm_widget.h"
+
+using namespace ns_osm;
+
+class Bench_View_Handler : public QObject {
+	Q_OBJECT
+private:
+	void add_sizes() {
+		QTest::addColumn<int>("side");
+		QTest::newRow("2500") << 50;
+		QTest::newRow("10k") << 100;
+	}
+private slots:
+	void construct_data() {
+		add_sizes();
+	}
+
+	void construct() {
+		QFETCH(int, side);
+		Osm_Map map;
+
+		ns_bench::fill_grid(map, side);
+		QBENCHMARK {
+			View_Handler handler(map);
+		}
+	}
+
+	void paint_data() {
+		add_sizes();
+	}
+
+	/* The whole scene into a 1024 px square, as a cold view would */
+	void paint() {
+		QFETCH(int, side);
+		Osm_Map	map;
+		QImage	image(1024, 1024, QImage::Format_ARGB32_Premultiplied);
+
+		ns_bench::fill_grid(map, side);
+		View_Handler handler(map);
+		QBENCHMARK {
+			QPainter painter(&image);
+			image.fill(Qt::white);
+			handler.mp_scene->render(&painter);
+		}
+	}
+};
+
+BENCH_MAIN(Bench_View_Handler)
+#include "bench_view_handler.moc"
@@ -0,0 +1,66 @@
+#include <QtTest>
+#include "benchmark.h"
+#include "osm_widget.h"
+
+using namespace ns_osm;
+
+class Bench_Xml_Handler : public QObject {
+	Q_OBJECT
+private:
+	QTemporaryDir	m_dir;
+
+	QString get_grid_path(int side) const {
+		return m_dir.filePath(QString("grid_%1.osm").arg(side));
+	}
+private slots:
+	void initTestCase() {
+		const int SIDES[] = {100, 300};
+
+		QVERIFY(m_dir.isValid());
+		for (int side : SIDES) {
+			Osm_Map map;
+			ns_bench::fill_grid(map, side);
+			QCOMPARE(OSM_OK, Xml_Handler(map).save_to_xml(get_grid_path(side)));
+		}
+	}
+
+	void load_data() {
+		QTest::addColumn<QString>("path");
+		QTest::newRow("genuine") << QString(PATH_GENUINE_MAP);
+		QTest::newRow("grid_10k") << get_grid_path(100);
+		QTest::newRow("grid_90k") << get_grid_path(300);
+	}
+
+	void load() {
+		QFETCH(QString, path);
+		Osm_Map		map;
+		Xml_Handler	handler(map);
+
+		QBENCHMARK {
+			QCOMPARE(OSM_OK, handler.load_from_xml(path));
+		}
+		QVERIFY(map.count_nodes() > 0);
+	}
+
+	void save_data() {
+		QTest::addColumn<QString>("path");
+		QTest::newRow("genuine") << QString(PATH_GENUINE_MAP);
+		QTest::newRow("grid_10k") << get_grid_path(100);
+		QTest::newRow("grid_90k") << get_grid_path(300);
+	}
+
+	void save() {
+		QFETCH(QString, path);
+		Osm_Map		map;
+		Xml_Handler	handler(map);
+		QString		out_path = m_dir.filePath("out.osm");
+
+		QCOMPARE(OSM_OK, handler.load_from_xml(path));
+		QBENCHMARK {
+			QCOMPARE(OSM_OK, handler.save_to_xml(out_path));
+		}
+	}
+};
+
+BENCH_MAIN(Bench_Xml_Handler)
+#include "bench_xml_handler.moc"
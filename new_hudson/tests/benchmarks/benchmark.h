@@ -0,0 +1,137 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#ifndef QT_CORE_H
+#define QT_CORE_H
+#include <QtCore>
+#endif /* Include guard QT_CORE_H */
+
+#include <QtTest>
+#include "osm_elements.h"
+
+/* Shared by the benchmarks: deterministic fixtures and a main() that also
+ * writes the results as JSON. Every benchmark accepts the usual QtTest
+ * arguments plus
+ *
+ *   -json <path>    results as {"benchmark", "qt", "results": [{"function",
+ *                   "tag", "metric", "value", "iterations"}]}
+ *
+ * Widget benchmarks default to the offscreen platform, so they run without
+ * a display. */
+namespace ns_bench {
+
+/* side * side nodes 0.0005 degrees apart, a residential way along every row
+ * and a tertiary one along every column */
+inline void fill_grid(ns_osm::Osm_Map& map, int side) {
+	QVector<ns_osm::Osm_Node*> nodes;
+
+	nodes.reserve(side * side);
+	for (int row = 0; row < side; ++row) {
+		for (int col = 0; col < side; ++col) {
+			nodes.push_back(new ns_osm::Osm_Node(50.0 + row * 0.0005, 7.0 + col * 0.0005));
+		}
+	}
+	for (int row = 0; row < side; ++row) {
+		ns_osm::Osm_Way* p_way = new ns_osm::Osm_Way;
+		for (int col = 0; col < side; ++col) {
+			p_way->push_node(nodes[row * side + col]);
+		}
+		p_way->set_tag("highway", "residential");
+		map.add(p_way);
+	}
+	for (int col = 0; col < side; ++col) {
+		ns_osm::Osm_Way* p_way = new ns_osm::Osm_Way;
+		for (int row = 0; row < side; ++row) {
+			p_way->push_node(nodes[row * side + col]);
+		}
+		p_way->set_tag("highway", "tertiary");
+		map.add(p_way);
+	}
+}
+
+/* QtTest's xml log, reduced to the benchmark results */
+inline bool write_json(const QString& xml_path, const QString& json_path, const QString& name) {
+	QFile				xml_file(xml_path);
+	QFile				json_file(json_path);
+	QXmlStreamReader	reader;
+	QJsonArray			results;
+	QJsonObject			root;
+	QString				function;
+
+	if (!xml_file.open(QIODevice::ReadOnly)) {
+		return false;
+	}
+	reader.setDevice(&xml_file);
+	while (!reader.atEnd()) {
+		if (reader.readNext() != QXmlStreamReader::StartElement) {
+			continue;
+		}
+		if (reader.name() == QLatin1String("TestFunction")) {
+			function = reader.attributes().value("name").toString();
+		} else if (reader.name() == QLatin1String("BenchmarkResult")) {
+			QJsonObject result;
+			result["function"] = function;
+			result["tag"] = reader.attributes().value("tag").toString();
+			result["metric"] = reader.attributes().value("metric").toString();
+			result["value"] = reader.attributes().value("value").toDouble();
+			result["iterations"] = reader.attributes().value("iterations").toInt();
+			results.append(result);
+		}
+	}
+	root["benchmark"] = name;
+	root["qt"] = QString(qVersion());
+	root["results"] = results;
+	if (reader.hasError() || !json_file.open(QIODevice::WriteOnly)) {
+		return false;
+	}
+	json_file.write(QJsonDocument(root).toJson());
+	return true;
+}
+
+inline int exec(QObject* p_bench, int argc, char* argv[]) {
+	QStringList		args;
+	QString			json_path;
+	QTemporaryDir	dir;
+	int				result;
+
+	for (int i = 0; i < argc; ++i) {
+		if (QString(argv[i]) == "-json" && i + 1 < argc) {
+			json_path = argv[++i];
+		} else {
+			args.push_back(argv[i]);
+		}
+	}
+	if (json_path.isEmpty()) {
+		return QTest::qExec(p_bench, args);
+	}
+	args << "-o" << dir.filePath("results.xml") + ",xml" << "-o" << "-,txt";
+	result = QTest::qExec(p_bench, args);
+	if (!write_json(dir.filePath("results.xml"), json_path, p_bench->metaObject()->className())) {
+		qWarning("Cannot write %s", qPrintable(json_path));
+		return result == 0 ? 1 : result;
+	}
+	return result;
+}
+
+}
+
+#ifdef QT_WIDGETS_LIB
+#define BENCH_MAIN(Bench_Class) \
+int main(int argc, char* argv[]) { \
+	if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) { \
+		qputenv("QT_QPA_PLATFORM", "offscreen"); \
+	} \
+	QApplication app(argc, argv); \
+	Bench_Class bench; \
+	return ns_bench::exec(&bench, argc, argv); \
+}
+#else
+#define BENCH_MAIN(Bench_Class) \
+int main(int argc, char* argv[]) { \
+	QCoreApplication app(argc, argv); \
+	Bench_Class bench; \
+	return ns_bench::exec(&bench, argc, argv); \
+}
+#endif
+
+#endif // BENCHMARK_H
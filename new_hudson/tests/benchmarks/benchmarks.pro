@@ -0,0 +1,8 @@
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    bench_xml_handler \
+    bench_events \
+    bench_osm_map \
+    bench_coord_handler \
+    bench_view_handler \
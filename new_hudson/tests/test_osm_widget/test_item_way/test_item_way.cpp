@@ -137,6 +137,53 @@ private slots:
 		QCOMPARE(nodes2.front(), ap2_nodes[0]);
 		QCOMPARE(nodes2.back(), ap2_nodes[2]);
 	}
+
+	void mid_inserts_and_deletes___lockstep() {
+		const int N_NODES = 50;
+		Osm_Widget widget;
+		Osm_Map& map = *(widget.mp_map);
+		Osm_Way* p_way = new Osm_Way;
+		QList<Osm_Node*> inserted;
+		map.add(p_way);
+		QList<Item_Edge*>& itemedges = widget.mp_view_handler->m_wayid_to_item.begin().value()->m_edges;
+		const QList<Osm_Node*>& waynodes = p_way->get_nodes_list();
+
+		for (int i = 0; i < N_NODES; ++i) {
+			p_way->push_node(new Osm_Node(i, i));
+		}
+		for (int i = 0; i < N_NODES - 1; i += 2) {
+			Osm_Node* p_node = new Osm_Node(i + 0.5, i + 0.5);
+			p_way->insert_node_between(p_node, waynodes[i], waynodes[i + 1]);
+			inserted.push_back(p_node);
+		}
+		for (int i = 0; i < inserted.size(); i += 3) {
+			delete inserted[i];
+		}
+
+		QCOMPARE(waynodes.size() - 1, itemedges.size());
+		for (int i = 0; i < itemedges.size(); ++i) {
+			QCOMPARE(waynodes[i], itemedges[i]->first());
+			QCOMPARE(waynodes[i + 1], itemedges[i]->second());
+		}
+	}
+
+	void node_delete___rect_shrinks() {
+		Osm_Widget widget;
+		Osm_Map& map = *(widget.mp_map);
+		Osm_Way* p_way = new Osm_Way;
+		Osm_Node* p_first = new Osm_Node(1, 1);
+		Osm_Node* p_second = new Osm_Node(2, 2);
+		Osm_Node* p_far = new Osm_Node(20, 20);
+
+		p_way->push_node(p_first);
+		p_way->push_node(p_second);
+		p_way->push_node(p_far);
+		map.add(p_way);
+		Item_Way* p_item = widget.mp_view_handler->m_wayid_to_item.begin().value();
+
+		delete p_far;
+		QCOMPARE(p_item->get_node_rect(*p_first) | p_item->get_node_rect(*p_second), p_item->boundingRect());
+	}
 };
 
 QTEST_MAIN(Test_Item_Way)
@@ -3,6 +3,9 @@ TEMPLATE = subdirs
 SUBDIRS += \
     test_osm_xml \
     manual_test \
-    test_item_way
+    test_item_way \
+    test_pick_handler \
+    test_tag_model \
+    test_tile_cache
 
 test_osm_xml.subdirs = test_osm_xml
@@ -1,5 +1,6 @@
 #include <QtTest>
 #include "osm_widget.h"
+#include "map_generator.h"
 using namespace ns_osm;
 #define COMPARE_ATTR(osm_object, attr_name, exp_value) \
 	QCOMPARE(osm_object->get_attr_value(attr_name), QString(#exp_value))
@@ -38,7 +39,7 @@ private slots:
 	void load_from_xml___nodes() {
 		Osm_Widget					 osmw;
 		Osm_Node*					 p_node;
-		QHash<long long, Osm_Node*>& nodes = osmw.mp_map->m_nodes_hash;
+		Id_Hash<Osm_Node*>&			 nodes = osmw.mp_map->m_nodes_hash;
 
 		QCOMPARE(OSM_OK, osmw.load_from_xml(PATH_TEST_MAP));
 		//QCOMPARE(5, nodes.count());
@@ -130,8 +131,8 @@ private slots:
 	void load_from_xml___ways() {
 		Osm_Way*					 p_way;
 		Osm_Widget					 osmw;
-		QHash<long long, Osm_Node*>& nodes = osmw.mp_map->m_nodes_hash;
-		QHash<long long, Osm_Way*>&  ways = osmw.mp_map->m_ways_hash;
+		Id_Hash<Osm_Node*>&			 nodes = osmw.mp_map->m_nodes_hash;
+		Id_Hash<Osm_Way*>&			 ways = osmw.mp_map->m_ways_hash;
 
 		QCOMPARE(OSM_OK, osmw.load_from_xml(PATH_TEST_MAP));
 
@@ -175,9 +176,9 @@ private slots:
 
 	void load_from_xml___relations() {
 		Osm_Widget						 osmw;
-		QHash<long long, Osm_Node*>&	 nodes = osmw.mp_map->m_nodes_hash;
-		QHash<long long, Osm_Way*>&		 ways = osmw.mp_map->m_ways_hash;
-		QHash<long long, Osm_Relation*>& relations = osmw.mp_map->m_relations_hash;
+		Id_Hash<Osm_Node*>&				 nodes = osmw.mp_map->m_nodes_hash;
+		Id_Hash<Osm_Way*>&				 ways = osmw.mp_map->m_ways_hash;
+		Id_Hash<Osm_Relation*>&			 relations = osmw.mp_map->m_relations_hash;
 		Osm_Relation*					 p_rel;
 
 		QCOMPARE(OSM_OK, osmw.load_from_xml(PATH_TEST_MAP));
@@ -215,6 +216,107 @@ private slots:
 		COMPARE_ATTR(p_rel, USER,		Dinamik);
 		COMPARE_ATTR(p_rel, UID,		39040);
 	}
+	/* The streaming parser has to agree with the DOM one on a real map */
+	void load_from_xml___streaming() {
+		Osm_Map		dom_map;
+		Osm_Map		stream_map;
+		int			n_calls = 0;
+
+		QCOMPARE(OSM_OK, Xml_Handler(dom_map).load_from_xml(PATH_GENUINE_MAP));
+		QCOMPARE(OSM_OK, Xml_Handler(stream_map).load_from_xml(PATH_GENUINE_MAP,
+		                                                       [&n_calls](const Xml_Handler::Progress& progress) {
+			++n_calls;
+			return progress.bytes_read <= progress.bytes_total;
+		}));
+		QVERIFY(n_calls > 0);
+		QCOMPARE(stream_map.m_nodes_hash.count(),		dom_map.m_nodes_hash.count());
+		QCOMPARE(stream_map.m_ways_hash.count(),		dom_map.m_ways_hash.count());
+		QCOMPARE(stream_map.m_relations_hash.count(),	dom_map.m_relations_hash.count());
+		QCOMPARE(stream_map.m_bounding_rect,			dom_map.m_bounding_rect);
+		for (Osm_Way* p_way : dom_map.m_ways_hash) {
+			Osm_Way* p_other = stream_map.m_ways_hash.value(p_way->get_id());
+
+			QVERIFY(p_other != nullptr);
+			QCOMPARE(p_other->get_size(),				p_way->get_size());
+			QCOMPARE(p_other->get_tag_map(),			p_way->get_tag_map());
+			QCOMPARE(p_other->get_attr_value(VERSION),	p_way->get_attr_value(VERSION));
+			QCOMPARE(p_other->get_attr_value(USER),		p_way->get_attr_value(USER));
+		}
+	}
+
+	void load_from_xml___cancelled() {
+		QTemporaryDir	dir;
+		QString			path = dir.filePath("generated.osm");
+		Map_Generator	generator;
+		Osm_Map			map;
+
+		generator.set_target_size(10000);
+		QVERIFY(generator.write_osm(path));
+		QCOMPARE(OSM_ERROR_CANCELLED, Xml_Handler(map).load_from_xml(path, [](const Xml_Handler::Progress&) {
+			return false;
+		}));
+		QCOMPARE(0, map.m_nodes_hash.count());
+		QCOMPARE(0, map.m_ways_hash.count());
+		QCOMPARE(0, map.m_relations_hash.count());
+	}
+
+	void load_from_xml___async() {
+		Osm_Widget	osmw;
+		QSignalSpy	spy(&osmw, SIGNAL(signal_load_finished(int)));
+		Osm_Map		dom_map;
+
+		QCOMPARE(OSM_OK, Xml_Handler(dom_map).load_from_xml(PATH_GENUINE_MAP));
+		QVERIFY(osmw.load_from_xml_async(PATH_GENUINE_MAP));
+		QVERIFY(osmw.is_loading());
+		QVERIFY(!osmw.load_from_xml_async(PATH_GENUINE_MAP));
+		QVERIFY(spy.wait(30000));
+		QCOMPARE(OSM_OK, spy.at(0).at(0).toInt());
+		QVERIFY(!osmw.is_loading());
+		QCOMPARE(osmw.mp_map->m_nodes_hash.count(), dom_map.m_nodes_hash.count());
+	}
+	/* A snapshot saved by the streaming writer loads back to the same map */
+	void save_to_xml___snapshot() {
+		QTemporaryDir	dir;
+		QString			path = dir.filePath("saved.osm");
+		Osm_Map			map;
+		Osm_Map			reloaded;
+
+		QCOMPARE(OSM_OK, Xml_Handler(map).load_from_xml(PATH_TEST_MAP));
+		QCOMPARE(OSM_OK, Xml_Handler::save_to_xml(Map_Snapshot(map), path));
+		QCOMPARE(OSM_OK, Xml_Handler(reloaded).load_from_xml(path));
+		QCOMPARE(reloaded.m_nodes_hash.count(),		map.m_nodes_hash.count());
+		QCOMPARE(reloaded.m_ways_hash.count(),		map.m_ways_hash.count());
+		QCOMPARE(reloaded.m_relations_hash.count(),	map.m_relations_hash.count());
+		QCOMPARE(reloaded.m_bounding_rect,			map.m_bounding_rect);
+		QCOMPARE(reloaded.get_way(11)->get_size(),	3);
+		QCOMPARE(reloaded.get_way(11)->get_tag_value("name"), map.get_way(11)->get_tag_value("name"));
+		QCOMPARE(reloaded.get_relation(101)->get_role(reloaded.get_node(1)), QString("haha"));
+		QCOMPARE(reloaded.get_relation(101)->get_role(reloaded.get_relation(102)), QString("first"));
+	}
+
+	/* Edits made while the save runs stay out of the file */
+	void save_to_xml___async() {
+		QTemporaryDir	dir;
+		QString			path = dir.filePath("saved.osm");
+		Osm_Widget		osmw;
+		Osm_Map			reloaded;
+		QSignalSpy		spy(&osmw, SIGNAL(signal_save_finished(int,QString)));
+
+		QCOMPARE(OSM_OK, osmw.load_from_xml(PATH_TEST_MAP));
+		QVERIFY(osmw.save_to_xml_async(path));
+		QVERIFY(osmw.is_saving());
+		QVERIFY(!osmw.save_to_xml_async(path));
+		osmw.mp_map->get_node(4)->set_tag("addr:housenumber", "18");
+		osmw.mp_map->add(new Osm_Node(16.0, 33.0, osmw.mp_map->get_id_allocator()));
+
+		QVERIFY(spy.wait(30000));
+		QCOMPARE(OSM_OK, spy.at(0).at(0).toInt());
+		QCOMPARE(path, spy.at(0).at(1).toString());
+		QVERIFY(!osmw.is_saving());
+		QCOMPARE(OSM_OK, Xml_Handler(reloaded).load_from_xml(path));
+		QCOMPARE(reloaded.m_nodes_hash.count(), osmw.mp_map->m_nodes_hash.count() - 1);
+		QCOMPARE(reloaded.get_node(4)->get_tag_value("addr:housenumber"), QString("17"));
+	}
 };
 
 QTEST_MAIN(Test_Osm_Xml)
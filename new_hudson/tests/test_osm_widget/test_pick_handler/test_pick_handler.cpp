@@ -0,0 +1,174 @@
+#include <QtTest>
+#include "osm_widget.h"
+
+using namespace ns_osm;
+
+class Test_Pick_Handler : public QObject {
+	Q_OBJECT
+private slots:
+	void node_within_tolerance_wins_over_segment() {
+		Osm_Map map;
+		Coord_Handler coord_handler;
+		Pick_Handler picker(coord_handler);
+		Osm_Node* p_first = new Osm_Node(0.0, 0.0);
+		Osm_Node* p_second = new Osm_Node(0.0, 0.01);
+		Osm_Way* p_way = new Osm_Way;
+
+		coord_handler.set_map(map);
+		p_way->push_node(p_first);
+		p_way->push_node(p_second);
+		map.add(p_way);
+		picker.add(*p_first);
+		picker.add(*p_second);
+		picker.add(*p_way);
+
+		QPointF pos = coord_handler.get_pos_on_scene(*p_first);
+		Pick_Handler::Hit hit = picker.pick(pos + QPointF(2, 2), 6);
+		QCOMPARE(true, hit.is_node());
+		QCOMPARE(p_first, hit.p_node);
+
+		hit = picker.pick(pos + QPointF(0, 50), 6);
+		QCOMPARE(true, hit.is_empty());
+	}
+
+	void edge_click_near_node___snaps_to_node() {
+		Osm_Widget widget;
+		Osm_Map& map = *(widget.mp_map);
+		View_Handler& view_handler = *(widget.mp_view_handler);
+		Osm_Node* p_first = new Osm_Node(0.0, 0.0);
+		Osm_Node* p_second = new Osm_Node(0.0, 0.01);
+		Osm_Way* p_way = new Osm_Way;
+
+		p_way->push_node(p_first);
+		p_way->push_node(p_second);
+		map.add(p_way);
+
+		/* Over the edge item, but within reach of its first node */
+		QPointF pos = view_handler.m_coord_handler.get_pos_on_scene(*p_first);
+		view_handler.slot_item_edge_clicked(pos + QPointF(3, 0), p_way, p_first, p_second, Qt::LeftButton);
+		QCOMPARE(1, view_handler.get_selection().size());
+		QCOMPARE(static_cast<Osm_Info*>(p_first), view_handler.get_selection().front());
+	}
+
+	void diagonal_segment___exact_distance() {
+		Osm_Map map;
+		Coord_Handler coord_handler;
+		Pick_Handler picker(coord_handler);
+		Osm_Node* p_first = new Osm_Node(0.0, 0.0);
+		Osm_Node* p_second = new Osm_Node(0.01, 0.01);
+		Osm_Way* p_way = new Osm_Way;
+
+		coord_handler.set_map(map);
+		p_way->push_node(p_first);
+		p_way->push_node(p_second);
+		map.add(p_way);
+		picker.add(*p_first);
+		picker.add(*p_second);
+		picker.add(*p_way);
+
+		QPointF first = coord_handler.get_pos_on_scene(*p_first);
+		QPointF second = coord_handler.get_pos_on_scene(*p_second);
+		QPointF middle = (first + second) / 2;
+
+		/* Inside the bounding box of the segment, but far from the line */
+		QCOMPARE(true, picker.pick(QPointF(second.x() - 10, first.y() - 10), 6).is_empty());
+
+		Pick_Handler::Hit hit = picker.pick(middle + QPointF(3, 3), 6);
+		QCOMPARE(true, hit.is_segment());
+		QCOMPARE(p_way, hit.p_way);
+		QCOMPARE(p_first, hit.p_first);
+		QCOMPARE(p_second, hit.p_second);
+		QVERIFY(hit.distance < 6);
+		QVERIFY(std::hypot(hit.point.x() - middle.x(), hit.point.y() - middle.y()) < 1);
+	}
+
+	void moved_and_removed_elements() {
+		Osm_Map map;
+		Coord_Handler coord_handler;
+		Pick_Handler picker(coord_handler);
+		Osm_Node* p_first = new Osm_Node(0.0, 0.0);
+		Osm_Node* p_second = new Osm_Node(0.0, 0.01);
+		Osm_Way* p_way = new Osm_Way;
+
+		coord_handler.set_map(map);
+		p_way->push_node(p_first);
+		p_way->push_node(p_second);
+		map.add(p_way);
+		picker.add(*p_first);
+		picker.add(*p_second);
+		picker.add(*p_way);
+
+		QPointF old_pos = coord_handler.get_pos_on_scene(*p_second);
+		p_second->set_lat_lon(0.01, 0.01);
+		picker.update(*p_second);
+		QPointF new_pos = coord_handler.get_pos_on_scene(*p_second);
+
+		QCOMPARE(p_second, picker.pick(new_pos, 6).p_node);
+		QCOMPARE(true, picker.pick(old_pos, 6).is_empty());
+
+		picker.remove(*p_way);
+		QCOMPARE(true, picker.pick((coord_handler.get_pos_on_scene(*p_first) + new_pos) / 2, 6).is_empty());
+		picker.remove(*p_second);
+		QCOMPARE(true, picker.pick(new_pos, 6).is_empty());
+	}
+
+	/* A one-node way has no segments; its node must still forget it */
+	void one_node_way___removed_then_node_moved() {
+		Osm_Map map;
+		Coord_Handler coord_handler;
+		Pick_Handler picker(coord_handler);
+		Osm_Node* p_node = new Osm_Node(0.0, 0.0);
+		Osm_Way* p_way = new Osm_Way;
+
+		coord_handler.set_map(map);
+		map.set_remove_orphaned_nodes(false);
+		p_way->push_node(p_node);
+		map.add(p_way);
+		picker.add(*p_node);
+		picker.add(*p_way);
+		picker.pick(QPointF(0, 0), 6);
+		QCOMPARE(true, picker.m_node_to_ways.contains(p_node, p_way));
+
+		picker.remove(*p_way);
+		map.remove(p_way);
+		QCOMPARE(false, picker.m_node_to_ways.contains(p_node));
+		QCOMPARE(false, picker.m_way_to_nodes.contains(p_way));
+
+		p_node->set_lat_lon(0.01, 0.01);
+		picker.update(*p_node);
+		QPointF pos = coord_handler.get_pos_on_scene(*p_node);
+		QCOMPARE(p_node, picker.pick(pos, 6).p_node);
+		QCOMPARE(true, picker.m_way_to_cells.isEmpty());
+	}
+
+	void dense_grid___pick_is_fast() {
+		const int N_SIDE = 200;
+		Osm_Map map;
+		Coord_Handler coord_handler;
+		Pick_Handler picker(coord_handler);
+		QVector<Osm_Node*> nodes;
+		QElapsedTimer timer;
+
+		coord_handler.set_map(map);
+		for (int row = 0; row < N_SIDE; ++row) {
+			Osm_Way* p_way = new Osm_Way;
+			for (int col = 0; col < N_SIDE; ++col) {
+				nodes.push_back(new Osm_Node(row * 0.0002, col * 0.0002));
+				p_way->push_node(nodes.back());
+				picker.add(*nodes.back());
+			}
+			map.add(p_way);
+			picker.add(*p_way);
+		}
+		picker.pick(QPointF(0, 0), 6);
+
+		timer.start();
+		for (int i = 0; i < 1000; ++i) {
+			picker.pick(coord_handler.get_pos_on_scene(*nodes[(i * 7919) % nodes.size()]) + QPointF(7, 7), 12);
+		}
+		QVERIFY(timer.elapsed() < 1000);
+	}
+};
+
+QTEST_MAIN(Test_Pick_Handler)
+#include "test_pick_handler.moc"
@@ -0,0 +1,87 @@
+#include <QtTest>
+#include "osm_widget.h"
+
+using namespace ns_osm;
+
+class Update_Counter : public Osm_Subscriber {
+public:
+	int			n_updates = 0;
+	Osm_Object*	p_subject = nullptr;
+
+	void	handle_event_update	(Osm_Object&) override {
+		if (get_meta().get_event() == MAP_TAGS_UPDATED) {
+			n_updates++;
+			p_subject = get_meta().get_subject();
+		}
+	}
+	        Update_Counter		(Osm_Object& object) {
+		subscribe(object);
+	}
+};
+
+class Test_Tag_Model : public QObject {
+	Q_OBJECT
+private slots:
+	void unchanged_tags___no_commit() {
+		Osm_Map map;
+		Osm_Node node(1.0, 1.0);
+		Update_Counter counter(map);
+		Tag_Model model(map);
+
+		node.set_tag("highway", "crossing");
+		node.set_tag("name", "Main");
+		model.set_info(&node);
+		QCOMPARE(2, model.rowCount());
+		QCOMPARE(QVariant("highway"), model.data(model.index(0, Tag_Model::KEY_COL)));
+
+		model.setData(model.index(1, Tag_Model::VALUE_COL), "Main");
+		QCOMPARE(false, model.has_changes());
+		QCOMPARE(false, model.commit());
+		QCOMPARE(0, counter.n_updates);
+	}
+
+	void edits___single_update_with_delta() {
+		Osm_Map map;
+		Osm_Node node(1.0, 1.0);
+		Update_Counter counter(map);
+		Tag_Model model(map);
+
+		node.set_tag("highway", "crossing");
+		node.set_tag("name", "Main");
+		node.set_tag("ref", "7");
+		model.set_info(&node);
+
+		model.setData(model.index(1, Tag_Model::VALUE_COL), "High");
+		model.removeRows(2, 1);
+		model.push_row();
+		model.setData(model.index(2, Tag_Model::KEY_COL), "lanes");
+		model.setData(model.index(2, Tag_Model::VALUE_COL), "2");
+		QCOMPARE(true, model.commit());
+
+		QCOMPARE(1, counter.n_updates);
+		QCOMPARE(static_cast<Osm_Object*>(&node), counter.p_subject);
+		QCOMPARE(3, node.get_tag_map().size());
+		QCOMPARE(QString("crossing"), node.get_tag_value("highway"));
+		QCOMPARE(QString("High"), node.get_tag_value("name"));
+		QCOMPARE(QString("2"), node.get_tag_value("lanes"));
+		QCOMPARE(false, node.get_tag_map().contains("ref"));
+		QCOMPARE(false, model.has_changes());
+	}
+
+	void renamed_key___old_key_removed() {
+		Osm_Map map;
+		Osm_Node node(1.0, 1.0);
+		Tag_Model model(map);
+
+		node.set_tag("nmae", "Main");
+		model.set_info(&node);
+		model.setData(model.index(0, Tag_Model::KEY_COL), "name");
+		model.commit();
+
+		QCOMPARE(1, node.get_tag_map().size());
+		QCOMPARE(QString("Main"), node.get_tag_value("name"));
+	}
+};
+
+QTEST_MAIN(Test_Tag_Model)
+#include "test_tag_model.moc"
@@ -0,0 +1,65 @@
+#include <QtTest>
+#include "osm_widget.h"
+
+using namespace ns_osm;
+
+class Test_Tile_Cache : public QObject {
+	Q_OBJECT
+private slots:
+	void snapshot___patched_per_element() {
+		Tile_Cache::Snapshot snapshot;
+
+		snapshot.set_point(1, QPointF(10, 10));
+		snapshot.set_point(2, QPointF(20, 10));
+		snapshot.set_point(3, QPointF(2500, 10));
+		snapshot.set_line(7, QVector<long long>() << 1 << 2 << 3);
+		QCOMPARE(3, snapshot.cells.count());
+		Tile_Cache::Snapshot copy(snapshot);
+
+		/* Moving the far node pulls the line out of two cells; the copy keeps the old shape */
+		snapshot.set_point(3, QPointF(30, 10));
+		QCOMPARE(1, snapshot.cells.count());
+		QCOMPARE(3, copy.cells.count());
+		QCOMPARE(QPointF(2500, 10), copy.points.value(3).pos);
+		QCOMPARE(QRectF(7, 7, 26, 6), snapshot.get_footprint(2));
+
+		snapshot.remove_line(7);
+		QCOMPARE(QRectF(17, 7, 6, 6), snapshot.get_footprint(2));
+		QCOMPARE(0, snapshot.lines.count());
+		snapshot.remove_point(1);
+		snapshot.remove_point(2);
+		QCOMPARE(1, snapshot.cells.count());
+		snapshot.remove_point(3);
+		QCOMPARE(0, snapshot.cells.count());
+		QCOMPARE(3, copy.points.count());
+	}
+
+	void tiled___items_only_in_sight_or_selected() {
+		Osm_Widget widget;
+		Osm_Map& map = *(widget.mp_map);
+		View_Handler& handler = *(widget.mp_view_handler);
+		Osm_Node* p_near = new Osm_Node(0, 0);
+		Osm_Node* p_far = new Osm_Node(60, 100);
+
+		map.add(p_near);
+		map.add(p_far);
+		QCOMPARE(2, handler.m_nodeid_to_item.count());
+
+		handler.mp_view->centerOn(handler.m_coord_handler.get_pos_on_scene(*p_near));
+		handler.set_tiled_rendering(true);
+		QCOMPARE(false, handler.m_nodeid_to_item.contains(p_far->get_id()));
+		QVERIFY(handler.mp_scene->sceneRect().contains(handler.m_coord_handler.get_pos_on_scene(*p_far)));
+
+		/* The selection brings its own items, and takes them back */
+		handler.select(p_far, false);
+		QCOMPARE(true, handler.m_nodeid_to_item.contains(p_far->get_id()));
+		handler.clear_selection();
+		QCOMPARE(false, handler.m_nodeid_to_item.contains(p_far->get_id()));
+
+		handler.set_tiled_rendering(false);
+		QCOMPARE(2, handler.m_nodeid_to_item.count());
+	}
+};
+
+QTEST_MAIN(Test_Tile_Cache)
+#include "test_tile_cache.moc"
@@ -7,3 +7,4 @@ QT += testlib core
 SUBDIRS += \
     test_osm_widget \
     tests_osm_elements \
+    benchmarks \
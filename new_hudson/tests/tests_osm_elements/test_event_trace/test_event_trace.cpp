@@ -0,0 +1,81 @@
+#include <QString>
+#include <QtTest>
+#include "osm_elements.h"
+using namespace ns_osm;
+
+class Test_Event_Trace : public QObject
+{
+	Q_OBJECT
+private slots:
+	void init() {
+		Event_Trace::stop();
+		Event_Trace::reset();
+	}
+
+	void is_available() {
+		QCOMPARE(true, Event_Trace::is_available());
+	}
+
+	void start___cascade() {
+		Osm_Node	node(50.0, 7.0);
+		Osm_Node	other(50.001, 7.0);
+		Osm_Way		first;
+		Osm_Way		second;
+
+		first.push_node(&node);
+		first.push_node(&other);
+		second.push_node(&other);
+		second.push_node(&node);
+		Event_Trace::start();
+		node.set_lat_lon(50.0002, 7.0002);
+		Event_Trace::stop();
+		node.set_lat_lon(50.0003, 7.0003);
+
+		QMap<Event, Event_Trace::Counter> counters = Event_Trace::get_counters();
+		QCOMPARE(1, counters.size());
+		Event_Trace::Counter counter = counters.value(NODE_UPDATED);
+		QCOMPARE(3LL, counter.n_emits); /* The node's, then one per way */
+		QCOMPARE(2LL, counter.n_deliveries);
+		QCOMPARE(2, counter.max_fan_out);
+		QCOMPARE(2, counter.max_depth);
+		QVERIFY(counter.self_ns <= counter.total_ns);
+		QCOMPARE(0LL, Event_Trace::count_dropped());
+	}
+
+	void get_counters___map_reloaded() {
+		Osm_Map		map;
+		Osm_Map		loaded;
+
+		loaded.add(new Osm_Node(50.0, 7.0));
+		Event_Trace::start();
+		map.take(loaded);
+		Event_Trace::stop();
+
+		QMap<Event, Event_Trace::Counter> counters = Event_Trace::get_counters();
+		QCOMPARE(1LL, counters.value(MAP_RELOADED).n_emits);
+		QCOMPARE(false, counters.contains(NONE));
+	}
+
+	void to_chrome_json___spans() {
+		Osm_Node	node(50.0, 7.0);
+		Osm_Way		way;
+
+		way.push_node(&node);
+		Event_Trace::start(1);
+		node.set_lat_lon(50.0002, 7.0002);
+		Event_Trace::stop();
+
+		QJsonDocument json = QJsonDocument::fromJson(Event_Trace::to_chrome_json());
+		QVERIFY(json.isObject());
+		QJsonArray events = json.object().value("traceEvents").toArray();
+		QCOMPARE(1, events.size()); /* The way's emit closes first and fills the buffer */
+		QCOMPARE(QString("NODE_UPDATED"), events[0].toObject().value("name").toString());
+		QCOMPARE(QString("X"), events[0].toObject().value("ph").toString());
+		QCOMPARE(2, events[0].toObject().value("args").toObject().value("depth").toInt());
+		QCOMPARE(1.0, json.object().value("otherData").toObject().value("dropped").toDouble());
+	}
+};
+
+QTEST_MAIN(Test_Event_Trace)
+
+#include "test_event_trace.moc"
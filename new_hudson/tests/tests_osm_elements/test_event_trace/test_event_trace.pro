@@ -0,0 +1,20 @@
+TEMPLATE = app
+
+QT += testlib core
+
+CONFIG += c++11
+
+INCLUDEPATH += $$PWD/../../../osm_elements
+
+LIBS += -L$$PWD/../../../intermediate_libs -losm_elements
+
+# The hooks live in these two; built here with the define, they take the
+# place of the library's copies whether or not it has CONFIG+=event_trace
+DEFINES += OSM_EVENT_TRACE
+
+SOURCES += test_event_trace.cpp \
+    $$PWD/../../../osm_elements/osm_object.cpp \
+    $$PWD/../../../osm_elements/event_trace.cpp
+
+DEFINES += private=public \
+    protected=public
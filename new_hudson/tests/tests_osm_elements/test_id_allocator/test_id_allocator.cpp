@@ -0,0 +1,143 @@
+#include <QString>
+#include <QtTest>
+#include "osm_elements.h"
+using namespace ns_osm;
+
+class Test_Id_Allocator : public QObject
+{
+	Q_OBJECT
+private:
+	/* Makes nodes from its own block and records their ids */
+	struct Maker : QRunnable {
+		Id_Allocator*		p_allocator;
+		QVector<long long>	ids;
+		QVector<long long>	inner_ids;
+		void run() override {
+			Id_Allocator::Block block(*p_allocator, 100);
+			for (int i = 0; i < 5000; ++i) {
+				Osm_Node node(50.0, 7.0);
+				ids.push_back(block.acquire());
+				inner_ids.push_back(node.get_inner_id());
+			}
+		}
+	};
+private slots:
+	void acquire___descending() {
+		Id_Allocator allocator;
+
+		QCOMPARE(-1LL, allocator.acquire());
+		QCOMPARE(-2LL, allocator.acquire());
+		QCOMPARE(-3LL, allocator.acquire_block(10));
+		QCOMPARE(-13LL, allocator.acquire());
+	}
+
+	void reserve___keeps_clear() {
+		Id_Allocator allocator;
+
+		allocator.reserve(42);
+		QCOMPARE(-1LL, allocator.get_next());
+		allocator.reserve(-20);
+		QCOMPARE(-21LL, allocator.acquire());
+		allocator.reserve(-5);
+		QCOMPARE(-22LL, allocator.acquire());
+	}
+
+	/* Each map keeps its own count, clear of the ids it holds */
+	void get_id_allocator___per_map() {
+		Osm_Map		first;
+		Osm_Map		second;
+
+		first.add(new Osm_Node("-7", "50", "7"));
+		QCOMPARE(-8LL, first.get_id_allocator().get_next());
+		QCOMPARE(-1LL, second.get_id_allocator().get_next());
+
+		Osm_Node* p_node = new Osm_Node(50.0, 7.0, first.get_id_allocator());
+		Osm_Way* p_way = new Osm_Way(second.get_id_allocator());
+		Osm_Relation* p_rel = new Osm_Relation(second.get_id_allocator());
+		QCOMPARE(-8LL, p_node->get_id());
+		QCOMPARE(-1LL, p_way->get_id());
+		QCOMPARE(-2LL, p_rel->get_id());
+		first.add(p_node);
+		second.add(p_rel);
+		delete p_way;
+	}
+
+	/* A default-made element meeting a map-made one with its id takes a new id on add() */
+	void add___default_and_map_ids_mixed() {
+		Osm_Map		map;
+		Osm_Node*	p_loose = new Osm_Node(50.0, 7.0);
+		Osm_Way*	p_way = new Osm_Way;
+
+		map.get_id_allocator().reserve(p_loose->get_id() + 1);
+		Osm_Node* p_drawn = new Osm_Node(50.1, 7.1, map.get_id_allocator());
+		QCOMPARE(p_loose->get_id(), p_drawn->get_id());
+		map.add(p_drawn);
+
+		p_loose->set_tag("amenity", "cafe");
+		p_way->push_node(p_drawn);
+		p_way->push_node(p_loose);
+		map.add(p_way);
+		QCOMPARE(2, map.count_nodes());
+		QCOMPARE(true, map.has(p_drawn));
+		QCOMPARE(true, map.has(p_loose));
+		QVERIFY(p_loose->get_id() < p_drawn->get_id());
+		QCOMPARE(p_drawn, map.get_node(p_drawn->get_id()));
+		QCOMPARE(p_loose, map.get_node(p_loose->get_id()));
+		QCOMPARE(QString::number(p_loose->get_id()), p_loose->get_attr_value("id"));
+		QCOMPARE(p_loose, map.find_nodes("amenity", "cafe").front());
+
+		/* Server ids are not reassigned; the twin stays out */
+		Osm_Node* p_server = new Osm_Node("42", "50", "7");
+		Osm_Node* p_twin = new Osm_Node("42", "50", "7");
+		map.add(p_server);
+		map.add(p_twin);
+		QCOMPARE(true, map.has(p_server));
+		QCOMPARE(false, map.has(p_twin));
+		QCOMPARE(p_server, map.get_node(42));
+		delete p_twin;
+	}
+
+	void copy___keeps_id() {
+		Osm_Info	info;
+		long long	next = Id_Allocator::get_default().get_next();
+
+		info.set_tag("name", "Copy");
+		Osm_Info copy(info);
+		QCOMPARE(info.get_id(), copy.get_id());
+		QCOMPARE(QString("Copy"), copy.get_tag_value("name"));
+		QCOMPARE(next, Id_Allocator::get_default().get_next());
+	}
+
+	/* Ids from blocks and inner ids stay unique with threads making elements at once */
+	void block___threads() {
+		const int		N_THREADS = 4;
+		Id_Allocator	allocator;
+		QThreadPool		pool;
+		Maker			makers[N_THREADS];
+		QSet<long long>	ids;
+		QSet<long long>	inner_ids;
+
+		pool.setMaxThreadCount(N_THREADS);
+		for (Maker& maker : makers) {
+			maker.setAutoDelete(false);
+			maker.p_allocator = &allocator;
+			pool.start(&maker);
+		}
+		pool.waitForDone();
+		for (const Maker& maker : makers) {
+			for (long long id : maker.ids) {
+				QVERIFY(id < 0);
+				ids.insert(id);
+			}
+			for (long long id : maker.inner_ids) {
+				inner_ids.insert(id);
+				QVERIFY(Osm_Object::is_locked(id)); /* The node is gone */
+			}
+		}
+		QCOMPARE(N_THREADS * 5000, ids.size());
+		QCOMPARE(N_THREADS * 5000, inner_ids.size());
+	}
+};
+
+QTEST_MAIN(Test_Id_Allocator)
+#include "test_id_allocator.moc"
@@ -0,0 +1,127 @@
+#include <QString>
+#include <QtTest>
+#include "osm_elements.h"
+using namespace ns_osm;
+
+class Test_Id_Hash : public QObject
+{
+	Q_OBJECT
+private slots:
+	/* Ids in file order stay in the sorted array */
+	void insert___ascending_stays_sorted() {
+		Id_Hash<int> hash;
+
+		for (int i = 0; i < 10000; ++i) {
+			hash.insert(static_cast<long long>(i) * i, i);
+		}
+		QCOMPARE(true, hash.is_sorted());
+		QCOMPARE(10000, hash.size());
+		for (int i = 0; i < 10000; ++i) {
+			QCOMPARE(i, hash.value(static_cast<long long>(i) * i, -1));
+		}
+		QCOMPARE(false, hash.contains(2));
+		QCOMPARE(-1, hash.value(-5, -1));
+		hash.insert(25, 50);
+		QCOMPARE(true, hash.is_sorted());
+		QCOMPARE(50, hash.value(25));
+	}
+
+	void insert___out_of_order_hashes() {
+		Id_Hash<int> hash;
+
+		hash.insert(10, 1);
+		hash.insert(20, 2);
+		hash.insert(-3, 3);
+		QCOMPARE(false, hash.is_sorted());
+		QCOMPARE(3, hash.size());
+		QCOMPARE(1, hash.value(10));
+		QCOMPARE(2, hash.value(20));
+		QCOMPARE(3, hash.value(-3));
+		QCOMPARE(0, hash.value(30));
+	}
+
+	/* Against QHash, across growth, tombstones and shrinking */
+	void remove___matches_qhash() {
+		Id_Hash<int>			hash;
+		QHash<long long, int>	reference;
+		quint32					seed = 7;
+
+		for (int i = 0; i < 50000; ++i) {
+			seed = seed * 1103515245u + 12345u;
+			long long id = static_cast<long long>((seed >> 8) % 4000) - 2000;
+			if (i % 3 == 2) {
+				QCOMPARE(hash.remove(id), reference.remove(id));
+			} else {
+				hash[id] = i;
+				reference[id] = i;
+			}
+		}
+		QCOMPARE(hash.size(), reference.size());
+		for (auto it = reference.cbegin(); it != reference.cend(); ++it) {
+			QCOMPARE(hash.value(it.key(), -1), it.value());
+		}
+		int n_items = 0;
+		for (auto it = hash.cbegin(); it != hash.cend(); ++it) {
+			QCOMPARE(reference.value(it.key(), -1), *it);
+			++n_items;
+		}
+		QCOMPARE(n_items, reference.size());
+		QList<long long> ids = hash.keys();
+		for (auto it = ids.cbegin(); it != ids.cend(); ++it) {
+			QCOMPARE(1, hash.remove(*it));
+		}
+		QCOMPARE(true, hash.isEmpty());
+		QVERIFY(hash.cbegin() == hash.cend());
+	}
+
+	void remove___last_keeps_sorted() {
+		Id_Hash<int> hash;
+
+		hash.insert(1, 1);
+		hash.insert(2, 2);
+		hash.insert(3, 3);
+		QCOMPARE(1, hash.remove(3));
+		QCOMPARE(0, hash.remove(3));
+		QCOMPARE(true, hash.is_sorted());
+		QCOMPARE(1, hash.remove(1));
+		QCOMPARE(false, hash.is_sorted());
+		QCOMPARE(2, hash.value(2));
+		hash.clear();
+		QCOMPARE(true, hash.is_sorted());
+		QCOMPARE(0, hash.size());
+	}
+
+	void find___iterator() {
+		Id_Hash<int> hash;
+
+		hash.insert(5, 50);
+		hash.insert(1, 10);
+		Id_Hash<int>::iterator it = hash.find(5);
+		QVERIFY(it != hash.end());
+		QCOMPARE(5LL, it.key());
+		*it = 55;
+		QCOMPARE(55, hash.value(5));
+		QVERIFY(hash.find(2) == hash.end());
+	}
+
+	/* Osm_Map keeps file order in its tables */
+	void get_node___map() {
+		Osm_Map map;
+
+		for (int i = 1; i <= 100; ++i) {
+			map.add(new Osm_Node(QString::number(i), "50", "7"));
+		}
+		QCOMPARE(true, map.m_nodes_hash.is_sorted());
+		QCOMPARE(42LL, map.get_node(42)->get_id());
+		QVERIFY(map.get_node(101) == nullptr);
+		map.remove(map.get_node(42));
+		QVERIFY(map.get_node(42) == nullptr);
+		QCOMPARE(43LL, map.get_node(43)->get_id());
+		map.clear();
+		QCOMPARE(0, map.count_nodes());
+	}
+};
+
+QTEST_MAIN(Test_Id_Hash)
+
+#include "test_id_hash.moc"
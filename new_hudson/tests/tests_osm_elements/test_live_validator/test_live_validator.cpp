@@ -0,0 +1,120 @@
+#include <QString>
+#include <QtTest>
+#include "osm_elements.h"
+using namespace ns_osm;
+
+class Test_Live_Validator : public QObject
+{
+	Q_OBJECT
+private:
+	Osm_Way* make_way(Osm_Map& map, const QVector<QPointF>& points, const QString& highway) {
+		Osm_Way* p_way = new Osm_Way;
+		for (auto it = points.cbegin(); it != points.cend(); ++it) {
+			p_way->push_node(new Osm_Node(it->y(), it->x()));
+		}
+		if (!highway.isEmpty()) {
+			p_way->set_tag("highway", highway);
+		}
+		map.add(p_way);
+		return p_way;
+	}
+
+	/* Same issues as a full run, compared in report order */
+	bool is_current(const Live_Validator& live, const Osm_Map& map) {
+		Validator					validator;
+		QVector<Validator::Issue>	expected;
+		QVector<Validator::Issue>	actual = live.get_issues();
+
+		validator.add_default_rules();
+		expected = validator.run(map);
+		if (expected.size() != actual.size()) {
+			return false;
+		}
+		for (int i = 0; i < expected.size(); ++i) {
+			if (expected[i].rule != actual[i].rule || expected[i].nodes != actual[i].nodes
+			        || expected[i].ways != actual[i].ways || expected[i].relations != actual[i].relations) {
+				return false;
+			}
+		}
+		return true;
+	}
+private slots:
+	void follow___duplicates() {
+		Osm_Map			map;
+		Live_Validator	live;
+		Osm_Node*		p_first = new Osm_Node(51.0, 8.0);
+		Osm_Node*		p_second = new Osm_Node(51.1, 8.0);
+
+		map.add(p_first);
+		map.add(p_second);
+		live.follow(map);
+		QCOMPARE(true, live.is_following());
+		QCOMPARE(0, live.count_issues());
+
+		p_second->set_lat_lon(51.0, 8.0);
+		QCOMPARE(1, live.count_issues());
+		QCOMPARE(1, live.find_node_issues(p_first->get_id()).size());
+		QCOMPARE(QString("duplicate_node"), live.find_node_issues(p_second->get_id()).front().rule);
+		QVERIFY(is_current(live, map));
+
+		p_second->set_lat(51.2);
+		QCOMPARE(0, live.count_issues());
+
+		p_second->set_lat(51.0);
+		QCOMPARE(1, live.count_issues());
+		map.remove(p_first);
+		QCOMPARE(0, live.count_issues());
+		QVERIFY(is_current(live, map));
+	}
+
+	void follow___crossings() {
+		Osm_Map			map;
+		Live_Validator	live;
+		Osm_Way*		p_across;
+		Osm_Way*		p_along;
+
+		p_across = make_way(map, {QPointF(7.0, 50.0), QPointF(7.02, 50.0)}, "residential");
+		p_along = make_way(map, {QPointF(7.01, 49.98), QPointF(7.01, 49.99)}, "residential");
+		/* Far away, never rechecked by the edits below */
+		make_way(map, {QPointF(9.0, 52.0), QPointF(9.001, 52.001), QPointF(9.001, 52.0), QPointF(9.0, 52.001)}, "");
+		live.follow(map);
+		QCOMPARE(1, live.count_issues());
+
+		p_along->push_node(new Osm_Node(50.01, 7.01));
+		QCOMPARE(2, live.count_issues());
+		QCOMPARE(1, live.find_way_issues(p_across->get_id()).size());
+		QCOMPARE(1, live.find_way_issues(p_along->get_id()).size());
+		QVERIFY(is_current(live, map));
+
+		p_along->get_nodes_list().back()->set_lat(49.995);
+		QCOMPARE(1, live.count_issues());
+		QVERIFY(is_current(live, map));
+
+		p_along->get_nodes_list().back()->set_lat(50.01);
+		QCOMPARE(2, live.count_issues());
+		map.remove(p_across);
+		QCOMPARE(0, live.find_way_issues(p_along->get_id()).size());
+		QVERIFY(is_current(live, map));
+
+		map.clear();
+		QCOMPARE(0, live.count_issues());
+		live.unfollow();
+		QCOMPARE(false, live.is_following());
+	}
+
+	void follow___map_deleted() {
+		Osm_Map*		p_map = new Osm_Map;
+		Live_Validator	live;
+
+		p_map->add(new Osm_Node(51.0, 8.0));
+		p_map->add(new Osm_Node(51.0, 8.0));
+		live.follow(*p_map);
+		QCOMPARE(1, live.count_issues());
+		delete p_map;
+		QCOMPARE(false, live.is_following());
+		QCOMPARE(0, live.count_issues());
+	}
+};
+
+QTEST_MAIN(Test_Live_Validator)
+#include "test_live_validator.moc"
@@ -0,0 +1,79 @@
+#include <QString>
+#include <QtTest>
+#include "osm_elements.h"
+using namespace ns_osm;
+
+class Test_Map_Generator : public QObject
+{
+	Q_OBJECT
+private:
+	QByteArray write(const Map_Generator& generator) {
+		QBuffer buffer;
+		buffer.open(QIODevice::WriteOnly);
+		Map_Generator::Xml_Sink sink(&buffer);
+		generator.generate(sink);
+		return buffer.data();
+	}
+private slots:
+	void generate___deterministic() {
+		Map_Generator generator;
+
+		generator.set_target_size(5000);
+		generator.set_seed(42);
+		QByteArray first = write(generator);
+		QVERIFY(first.contains("<bounds"));
+		QCOMPARE(first, write(generator));
+		generator.set_seed(43);
+		QVERIFY(first != write(generator));
+	}
+
+	void generate___map() {
+		Osm_Map			map;
+		Map_Generator	generator;
+		int				n_multipolygons = 0;
+
+		generator.set_target_size(5000);
+		QVERIFY(generator.generate(map) >= 5000);
+		QVERIFY(map.count_nodes() + map.count_ways() + map.count_relations() >= 5000);
+		for (auto it = map.crbegin(); it != map.crend(); ++it) {
+			n_multipolygons += ((*it)->get_tag_value("type") == "multipolygon" ? 1 : 0);
+		}
+		QVERIFY(n_multipolygons > 0);
+		for (auto it = map.cwbegin(); it != map.cwend(); ++it) {
+			QVERIFY((*it)->get_nodes_list().size() >= 2);
+		}
+	}
+
+	void generate___antimeridian() {
+		Osm_Map			map;
+		Map_Generator	generator;
+		bool			f_east = false;
+		bool			f_west = false;
+
+		generator.set_target_size(100);
+		generator.set_antimeridian(true);
+		generator.generate(map);
+		for (auto it = map.cnbegin(); it != map.cnend(); ++it) {
+			QVERIFY((*it)->get_lon() >= -180.0 && (*it)->get_lon() < 180.0);
+			f_east |= (*it)->get_lon() > 179.0;
+			f_west |= (*it)->get_lon() < -179.0;
+		}
+		QVERIFY(f_east);
+		QVERIFY(f_west);
+
+		/* A bound crossing longitude 180 has west > east */
+		QVERIFY(map.get_bound().left() > 179.0);
+		QVERIFY(map.get_bound().right() < -179.0);
+
+		/* With the towns further east it spans them and the antimeridian town only */
+		Osm_Map wide;
+		generator.set_target_size(5000);
+		generator.generate(wide);
+		QVERIFY(wide.get_bound().left() > 4.0 && wide.get_bound().left() < 6.0);
+		QVERIFY(wide.get_bound().right() < -179.0);
+	}
+};
+
+QTEST_MAIN(Test_Map_Generator)
+
+#include "test_map_generator.moc"
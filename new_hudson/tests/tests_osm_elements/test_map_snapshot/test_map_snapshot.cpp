@@ -0,0 +1,117 @@
+#include <QString>
+#include <QtTest>
+#include "osm_elements.h"
+using namespace ns_osm;
+
+class Test_Map_Snapshot : public QObject
+{
+	Q_OBJECT
+private slots:
+	void constructor___contents() {
+		Osm_Map			map;
+		Osm_Node*		p_first = new Osm_Node(50.0, 7.0);
+		Osm_Node*		p_second = new Osm_Node(50.001, 7.0);
+		Osm_Way*		p_way = new Osm_Way;
+		Osm_Relation*	p_rel = new Osm_Relation;
+
+		p_first->set_tag("name", "First");
+		p_way->push_node(p_first);
+		p_way->push_node(p_second);
+		p_rel->add(p_way, "outer");
+		p_rel->add(p_first, "label");
+		map.add(p_way);
+		map.add(p_rel);
+		map.set_bound(QRectF(7.0, 50.0, 0.1, 0.1));
+
+		Map_Snapshot snapshot(map);
+		QCOMPARE(map.get_bound(), snapshot.get_bound());
+		QCOMPARE(2, snapshot.get_nodes().count());
+		QCOMPARE(1, snapshot.get_ways().count());
+		QCOMPARE(1, snapshot.get_relations().count());
+
+		const Map_Snapshot::Way way = snapshot.get_ways().value(p_way->get_id());
+		QCOMPARE(p_way->get_id(), way.id);
+		QCOMPARE((QVector<long long>{p_first->get_id(), p_second->get_id()}), way.nodes);
+
+		const Map_Snapshot::Relation rel = snapshot.get_relations().value(p_rel->get_id());
+		QCOMPARE(2, rel.members.size());
+		QCOMPARE(Map_Snapshot::NODE, rel.members[0].type);
+		QCOMPARE(p_first->get_id(), rel.members[0].id);
+		QCOMPARE(QString("label"), rel.members[0].role);
+		QCOMPARE(Map_Snapshot::WAY, rel.members[1].type);
+		QCOMPARE(QString("outer"), rel.members[1].role);
+
+		QCOMPARE(QString("First"), snapshot.get_nodes().value(p_first->get_id()).tags.value("name"));
+		QCOMPARE(50.0, snapshot.get_nodes().value(p_first->get_id()).lat);
+	}
+
+	/* Edits after the snapshot must not show through the shared containers */
+	void constructor___isolated_from_edits() {
+		Osm_Map			map;
+		Osm_Node*		p_first = new Osm_Node(50.0, 7.0);
+		Osm_Node*		p_second = new Osm_Node(50.001, 7.0);
+		Osm_Way*		p_way = new Osm_Way;
+
+		p_first->set_tag("name", "Before");
+		p_way->push_node(p_first);
+		p_way->push_node(p_second);
+		map.add(p_way);
+
+		Map_Snapshot snapshot(map);
+		Map_Snapshot copy(snapshot);
+		p_first->set_tag("name", "After");
+		p_first->set_lat(51.0);
+		p_way->push_node(new Osm_Node(50.002, 7.0));
+		map.add(new Osm_Node(49.0, 6.0));
+
+		QCOMPARE(2, snapshot.get_nodes().count());
+		QCOMPARE(2, snapshot.get_ways().value(p_way->get_id()).nodes.size());
+		const Map_Snapshot::Node node = copy.get_nodes().value(p_first->get_id());
+		QCOMPARE(QString("Before"), node.tags.value("name"));
+		QCOMPARE(50.0, node.lat);
+		QCOMPARE(QString("50"), node.attrs.value("lat"));
+		QCOMPARE(QString("After"), p_first->get_tag_value("name"));
+	}
+
+	void shared_table___copies() {
+		Shared_Table<int>	table;
+		int					sum = 0;
+
+		for (int i = -500; i < 1500; ++i) {
+			table.insert(i, i * 2);
+		}
+		table.insert(7, 70);
+		QCOMPARE(2000, table.count());
+
+		Shared_Table<int> copy(table);
+		QVERIFY(table.remove(7));
+		QVERIFY(!table.remove(7));
+		table.insert(5000, 1);
+		table.insert(-3, 0);
+		QCOMPARE(2000, table.count());
+		QCOMPARE(2000, copy.count());
+		QVERIFY(!table.contains(7));
+		QCOMPARE(70, copy.value(7));
+		QCOMPARE(-6, copy.value(-3));
+		QVERIFY(!copy.contains(5000));
+		QCOMPARE(0, copy.value(5000));
+
+		copy.for_each([&sum](int value) {
+			sum += value;
+		});
+		QCOMPARE(999 * 2000 + 56, sum);
+		copy.clear();
+		QCOMPARE(0, copy.count());
+		QCOMPARE(1, table.value(5000));
+	}
+
+	void constructor___empty() {
+		Osm_Map			map;
+
+		QVERIFY(Map_Snapshot().is_empty());
+		QVERIFY(Map_Snapshot(map).is_empty());
+	}
+};
+
+QTEST_MAIN(Test_Map_Snapshot)
+#include "test_map_snapshot.moc"
@@ -0,0 +1,127 @@
+#include <QString>
+#include <QtTest>
+#include "osm_elements.h"
+using namespace ns_osm;
+
+class Test_Map_Versioner : public QObject
+{
+	Q_OBJECT
+private slots:
+	void get_snapshot___follows_edits() {
+		Osm_Map			map;
+		Map_Versioner	versioner;
+		Osm_Node*		p_first = new Osm_Node(50.0, 7.0);
+		Osm_Node*		p_second = new Osm_Node(50.001, 7.0);
+		Osm_Way*		p_way = new Osm_Way;
+
+		p_way->push_node(p_first);
+		p_way->push_node(p_second);
+		map.add(p_way);
+		versioner.follow(map);
+		QVERIFY(versioner.is_following());
+
+		Map_Snapshot before = versioner.get_snapshot();
+		QCOMPARE(2, before.get_nodes().count());
+		QCOMPARE(1, before.get_ways().count());
+
+		Osm_Node* p_third = new Osm_Node(50.002, 7.0);
+		p_way->push_node(p_third);
+		p_first->set_lat(51.0);
+		map.set_tags(*p_second, {{"name", "Second"}}, QStringList());
+
+		Map_Snapshot after = versioner.get_snapshot();
+		QVERIFY(after.get_version() > before.get_version());
+		QCOMPARE(3, after.get_nodes().count());
+		QCOMPARE(3, after.get_ways().value(p_way->get_id()).nodes.size());
+		QCOMPARE(51.0, after.get_nodes().value(p_first->get_id()).lat);
+		QCOMPARE(QString("Second"), after.get_nodes().value(p_second->get_id()).tags.value("name"));
+
+		/* The older snapshot still shows the map as it was */
+		QCOMPARE(2, before.get_nodes().count());
+		QCOMPARE(2, before.get_ways().value(p_way->get_id()).nodes.size());
+		QCOMPARE(50.0, before.get_nodes().value(p_first->get_id()).lat);
+		QVERIFY(before.get_nodes().value(p_second->get_id()).tags.isEmpty());
+
+		map.remove(p_way);
+		Map_Snapshot removed = versioner.get_snapshot();
+		QVERIFY(!removed.get_ways().contains(p_way->get_id()));
+		QCOMPARE(1, after.get_ways().count());
+	}
+
+	/* A batched edit is one event listing every element, and one version */
+	void get_snapshot___batched_tags() {
+		Osm_Map			map;
+		Map_Versioner	versioner;
+		Osm_Node*		p_first = new Osm_Node(50.0, 7.0);
+		Osm_Node*		p_second = new Osm_Node(50.001, 7.0);
+		quint64			version;
+
+		map.add(p_first);
+		map.add(p_second);
+		versioner.follow(map);
+		versioner.get_snapshot();
+		version = versioner.get_version();
+		map.set_tag(QList<Osm_Info*>{p_first, p_second}, "highway", "crossing");
+		QCOMPARE(version + 1, versioner.get_version());
+
+		Map_Snapshot snapshot = versioner.get_snapshot();
+		QCOMPARE(QString("crossing"), snapshot.get_nodes().value(p_first->get_id()).tags.value("highway"));
+		QCOMPARE(QString("crossing"), snapshot.get_nodes().value(p_second->get_id()).tags.value("highway"));
+	}
+
+	void get_snapshot___cleared_and_deleted() {
+		Osm_Map*		p_map = new Osm_Map;
+		Map_Versioner	versioner;
+
+		p_map->add(new Osm_Node(50.0, 7.0));
+		versioner.follow(*p_map);
+		Map_Snapshot full = versioner.get_snapshot();
+		p_map->clear();
+		QVERIFY(versioner.get_snapshot().is_empty());
+		QCOMPARE(1, full.get_nodes().count());
+
+		delete p_map;
+		QVERIFY(!versioner.is_following());
+		QVERIFY(versioner.get_snapshot().is_empty());
+	}
+
+	/* A snapshot read on another thread while the map is edited */
+	void get_snapshot___concurrent_reader() {
+		Osm_Map			map;
+		Map_Versioner	versioner;
+		QList<Osm_Node*> nodes;
+
+		for (int i = 0; i < 2000; ++i) {
+			nodes.push_back(new Osm_Node(50.0 + i * 1e-4, 7.0));
+			map.add(nodes.back());
+		}
+		versioner.follow(map);
+
+		struct Reader : QRunnable {
+			Map_Snapshot	snapshot;
+			int				n_unmoved = 0;
+			void run() override {
+				for (int round = 0; round < 50; ++round) {
+					snapshot.get_nodes().for_each([this](const Map_Snapshot::Node& node) {
+						n_unmoved += (node.lon == 7.0 ? 1 : 0);
+					});
+				}
+			}
+		};
+		QThreadPool	pool;
+		Reader		reader;
+
+		reader.setAutoDelete(false);
+		reader.snapshot = versioner.get_snapshot();
+		pool.start(&reader);
+		for (Osm_Node* p_node : nodes) {
+			p_node->set_lon(8.0);
+		}
+		pool.waitForDone();
+		QCOMPARE(2000 * 50, reader.n_unmoved);
+		QCOMPARE(8.0, versioner.get_snapshot().get_nodes().value(nodes.front()->get_id()).lon);
+	}
+};
+
+QTEST_MAIN(Test_Map_Versioner)
+#include "test_map_versioner.moc"
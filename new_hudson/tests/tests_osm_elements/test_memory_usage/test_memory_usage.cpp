@@ -0,0 +1,76 @@
+#include <QString>
+#include <QtTest>
+#include "osm_elements.h"
+using namespace ns_osm;
+
+class Test_Memory_Usage : public QObject
+{
+	Q_OBJECT
+private slots:
+	void get_memory_usage___categories() {
+		Osm_Map			map;
+		Osm_Node*		p_first = new Osm_Node(50.0, 7.0);
+		Osm_Node*		p_second = new Osm_Node(50.001, 7.0);
+		Osm_Way*		p_way = new Osm_Way;
+		Osm_Relation*	p_rel = new Osm_Relation;
+
+		p_way->push_node(p_first);
+		p_way->push_node(p_second);
+		p_rel->add(p_way, "outer");
+		map.add(p_way);
+		map.add(p_rel);
+
+		Memory_Usage before = map.get_memory_usage();
+		QCOMPARE(2LL, before.count_elements(Memory_Usage::NODE));
+		QCOMPARE(1LL, before.count_elements(Memory_Usage::WAY));
+		QCOMPARE(1LL, before.count_elements(Memory_Usage::RELATION));
+		QVERIFY(before.get_bytes(Memory_Usage::NODE, Memory_Usage::OBJECT) >= 2 * static_cast<qint64>(sizeof(Osm_Node)));
+		QVERIFY(before.get_bytes(Memory_Usage::NODE, Memory_Usage::SUBSCRIPTIONS) > 0);
+		QVERIFY(before.get_bytes(Memory_Usage::WAY, Memory_Usage::MEMBERS) > 0);
+		QVERIFY(before.get_bytes(Memory_Usage::RELATION, Memory_Usage::MEMBERS) > 0);
+		QVERIFY(before.get_bytes(Memory_Usage::MAP, Memory_Usage::INDEXES) > 0);
+		QCOMPARE(0LL, before.get_bytes(Memory_Usage::VIEW));
+
+		p_first->set_tag("name", "A rather long name for a node");
+		Memory_Usage after = map.get_memory_usage();
+		QVERIFY(after.get_bytes(Memory_Usage::NODE, Memory_Usage::TAGS)
+		        > before.get_bytes(Memory_Usage::NODE, Memory_Usage::TAGS) + 56);
+		QVERIFY(after.get_bytes(Memory_Usage::MAP, Memory_Usage::INDEXES)
+		        > before.get_bytes(Memory_Usage::MAP, Memory_Usage::INDEXES));
+		QCOMPARE(after.get_total(), after.get_bytes(Memory_Usage::NODE) + after.get_bytes(Memory_Usage::WAY)
+		         + after.get_bytes(Memory_Usage::RELATION) + after.get_bytes(Memory_Usage::MAP));
+	}
+
+	void to_text___rows() {
+		Osm_Map			map;
+		Memory_Usage	usage;
+
+		map.add(new Osm_Node(50.0, 7.0));
+		usage += map.get_memory_usage();
+		usage += map.get_memory_usage();
+		QCOMPARE(2LL, usage.count_elements(Memory_Usage::NODE));
+
+		QStringList lines = usage.to_text().split('\n', QString::SkipEmptyParts);
+		QCOMPARE(4, lines.size()); /* Header, nodes, map, total */
+		QVERIFY(lines[0].startsWith("kind\telements\tobject"));
+		QVERIFY(lines[1].startsWith("nodes\t2\t"));
+		QCOMPARE(Memory_Usage::CATEGORY_COUNT + 3, lines[1].split('\t').size());
+		QVERIFY(lines[3].endsWith(QString::number(usage.get_total())));
+	}
+
+	/* A ceiling to catch regressions in the per-node footprint */
+	void get_memory_usage___per_node() {
+		Osm_Map map;
+
+		for (int i = 0; i < 10000; ++i) {
+			map.add(new Osm_Node(50.0 + i * 0.00001, 7.0));
+		}
+		Memory_Usage usage = map.get_memory_usage();
+		QVERIFY(usage.get_bytes(Memory_Usage::NODE) / 10000 < 2048);
+		QVERIFY(usage.get_bytes(Memory_Usage::MAP, Memory_Usage::INDEXES) / 10000 < 256);
+	}
+};
+
+QTEST_MAIN(Test_Memory_Usage)
+
+#include "test_memory_usage.moc"
@@ -0,0 +1,139 @@
+#include <QString>
+#include <QtTest>
+#include "osm_elements.h"
+using namespace ns_osm;
+
+class Test_Node_Merger : public QObject
+{
+	Q_OBJECT
+private slots:
+	void merge___rewires_members() {
+		Osm_Map			map;
+		Node_Merger		merger;
+		Osm_Node*		p_known = new Osm_Node("10", "50.0", "7.0");
+		Osm_Node*		p_near = new Osm_Node(50.0, 7.0000003);
+		Osm_Node*		p_close = new Osm_Node(50.0000003, 7.0);
+		Osm_Node*		p_far = new Osm_Node(50.001, 7.0);
+		Osm_Way*		p_way = new Osm_Way;
+		Osm_Way*		p_short = new Osm_Way;
+		Osm_Relation*	p_rel = new Osm_Relation;
+
+		p_known->set_tag("name", "Markt");
+		p_near->set_tag("name", "Marktplatz");
+		p_near->set_tag("ref", "1");
+		p_way->push_node(p_near);
+		p_way->push_node(p_far);
+		p_short->push_node(p_known);
+		p_short->push_node(p_close);
+		p_short->push_node(p_far);
+		p_rel->add(p_near, "stop");
+		map.add(p_known);
+		map.add(p_way);
+		map.add(p_short);
+		map.add(p_rel);
+		QCOMPARE(4, map.count_nodes());
+
+		QVector<QVector<Osm_Node*>> groups = merger.find(map);
+		QCOMPARE(1, groups.size());
+		QCOMPARE(3, groups.front().size());
+		QCOMPARE(p_known, groups.front().front());
+
+		QCOMPARE(2, merger.merge(map));
+		QCOMPARE(2, map.count_nodes());
+		QCOMPARE(p_known, p_way->get_nodes_list().front());
+		QCOMPARE(2, p_short->get_nodes_list().size());
+		QCOMPARE(2u, p_short->get_size());
+		QCOMPARE(true, p_rel->has(p_known));
+		QCOMPARE(QString("stop"), p_rel->get_role(p_known));
+		QCOMPARE(QString("Markt"), p_known->get_tag_value("name"));
+		QCOMPARE(QString("1"), p_known->get_tag_value("ref"));
+		QCOMPARE(1, map.find_nodes("ref").size());
+		QCOMPARE(0, merger.merge(map));
+	}
+
+	void merge___one_node_way_removed() {
+		Osm_Map			map;
+		Node_Merger		merger;
+		Osm_Node*		p_first = new Osm_Node("10", "50.0", "7.0");
+		Osm_Node*		p_second = new Osm_Node(50.0, 7.0000003);
+		Osm_Node*		p_far = new Osm_Node(50.001, 7.0);
+		Osm_Way*		p_stub = new Osm_Way;
+		Osm_Way*		p_kept = new Osm_Way;
+		Osm_Way*		p_other = new Osm_Way;
+
+		p_stub->push_node(p_first);
+		p_stub->push_node(p_second);
+		p_other->push_node(p_first);
+		p_other->push_node(p_far);
+		map.add(p_stub);
+		map.add(p_other);
+		QCOMPARE(1, merger.merge(map));
+		QCOMPARE(1, map.count_ways());
+		QCOMPARE(true, map.has(p_other));
+		QCOMPARE(true, map.has(p_first));
+
+		/* Kept on request, with its one node */
+		map.set_remove_one_node_ways(false);
+		Osm_Node* p_twin = new Osm_Node(50.001, 7.0000003);
+		p_kept->push_node(p_far);
+		p_kept->push_node(p_twin);
+		map.add(p_kept);
+		QCOMPARE(1, merger.merge(map));
+		QCOMPARE(true, map.has(p_kept));
+		QCOMPARE(1u, p_kept->get_size());
+	}
+
+	void find___chain_split_at_tolerance() {
+		const int				N = 10;
+		Osm_Map					map;
+		Node_Merger				merger;
+		QVector<Osm_Node*>		nodes;
+
+		/* 0.039 m apart: each node is near its neighbours, not the ones beyond */
+		for (int i = 0; i < N; ++i) {
+			nodes.push_back(new Osm_Node(50.0 + i * 0.00000035, 7.0));
+			map.add(nodes.back());
+		}
+		QVector<QVector<Osm_Node*>> groups = merger.find(map);
+		QCOMPARE(N / 2, groups.size());
+		for (auto it = groups.cbegin(); it != groups.cend(); ++it) {
+			QCOMPARE(2, it->size());
+		}
+		QCOMPARE(nodes[0], groups.back().front());
+		QCOMPARE(nodes[1], groups.back().back());
+
+		QCOMPARE(N / 2, merger.merge(map));
+		QCOMPARE(N / 2, map.count_nodes());
+	}
+
+	void find___many_nodes() {
+		const int		N = 20000;
+		Osm_Map			map;
+		Node_Merger		merger;
+
+		for (int i = 0; i < N; ++i) {
+			double lat = 50.0 + (i / 200) * 0.0001;
+			double lon = 7.0 + (i % 200) * 0.0001;
+			map.add(new Osm_Node(lat, lon));
+			map.add(new Osm_Node(lat + 0.0000001, lon));
+		}
+		QCOMPARE(N, merger.find(map).size());
+		merger.set_tolerance(0.001);
+		QCOMPARE(0.01, merger.get_tolerance());
+		merger.set_tolerance(20.0);
+		QVector<QVector<Osm_Node*>> groups = merger.find(map);
+		QVERIFY(groups.size() > 1);
+		for (auto it = groups.cbegin(); it != groups.cend(); ++it) {
+			for (auto it_node = it->cbegin() + 1; it_node != it->cend(); ++it_node) {
+				QVERIFY(Geo::haversine(it->front()->get_lat(), it->front()->get_lon(),
+				                                 (*it_node)->get_lat(), (*it_node)->get_lon()) <= 20.0);
+			}
+		}
+		merger.set_tolerance(0.05);
+		QCOMPARE(N, merger.merge(map));
+		QCOMPARE(N, map.count_nodes());
+	}
+};
+
+QTEST_MAIN(Test_Node_Merger)
+#include "test_node_merger.moc"
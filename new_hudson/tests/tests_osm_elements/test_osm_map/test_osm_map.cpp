@@ -3,6 +3,39 @@
 #include "osm_elements.h"
 using namespace ns_osm;
 
+class Map_Event_Counter : public Osm_Subscriber {
+public:
+	int			n_tag_updates = 0;
+	int			n_node_updates = 0;
+	int			n_way_updates = 0;
+	int			n_relation_updates = 0;
+	int			n_node_adds = 0;
+	int			n_reloads = 0;
+	Osm_Object*	p_tag_subject = nullptr;
+	Meta::Ids	tag_ids;
+
+	void	handle_event_update	(Osm_Object&) override {
+		if (get_meta().get_event() == MAP_TAGS_UPDATED) {
+			n_tag_updates++;
+			p_tag_subject = get_meta().get_subject();
+			tag_ids = get_meta().get_ids();
+		} else if (get_meta().get_event() == MAP_NODE_UPDATED) {
+			n_node_updates++;
+		} else if (get_meta().get_event() == MAP_WAY_UPDATED) {
+			n_way_updates++;
+		} else if (get_meta().get_event() == MAP_RELATION_UPDATED) {
+			n_relation_updates++;
+		} else if (get_meta().get_event() == MAP_NODE_ADDED) {
+			n_node_adds++;
+		} else if (get_meta().get_event() == MAP_RELOADED) {
+			n_reloads++;
+		}
+	}
+	        Map_Event_Counter	(Osm_Map& map) {
+		subscribe(map);
+	}
+};
+
 class Test_Osm_Map : public QObject
 {
 	Q_OBJECT
@@ -147,6 +180,218 @@ private slots:
 			delete ap_relations[i];
 		}
 	}
+
+	void set_tag___batched() {
+		const int N_NODES = 10000;
+		Osm_Map map;
+		Map_Event_Counter counter(map);
+		QList<Osm_Info*> nodes;
+		QElapsedTimer timer;
+
+		for (int i = 0; i < N_NODES; ++i) {
+			Osm_Node* p_node = new Osm_Node(i * 0.001, i * 0.001);
+			if (i % 2) {
+				p_node->set_tag("building", "house");
+			}
+			map.add(p_node);
+			nodes.push_back(p_node);
+		}
+
+		timer.start();
+		map.set_tag(nodes, "building", "yes");
+		QVERIFY(timer.elapsed() < 1000);
+		QCOMPARE(1, counter.n_tag_updates);
+		QCOMPARE(0, counter.n_node_updates);
+		QCOMPARE(N_NODES, counter.tag_ids.nodes.size());
+		QCOMPARE(nodes.front()->get_id(), counter.tag_ids.nodes.front());
+		QCOMPARE(nullptr, counter.p_tag_subject);
+		QCOMPARE(N_NODES, map.find_nodes("building", "yes").size());
+		QCOMPARE(0, map.find_nodes("building", "house").size());
+		for (auto it = nodes.cbegin(); it != nodes.cend(); ++it) {
+			QCOMPARE(QString("yes"), (*it)->get_tag_value("building"));
+		}
+
+		/* Nothing to change, nothing to report */
+		map.set_tag(nodes, "building", "yes");
+		QCOMPARE(1, counter.n_tag_updates);
+
+		QCOMPARE(0, map.rename_tag(nodes, "building", "amenity"));
+		QCOMPARE(2, counter.n_tag_updates);
+		QCOMPARE(N_NODES, counter.tag_ids.count());
+		QCOMPARE(QString("yes"), nodes.front()->get_tag_value("amenity"));
+		QCOMPARE(false, nodes.front()->get_tag_map().contains("building"));
+		QCOMPARE(0, map.find_nodes("building").size());
+		QCOMPARE(N_NODES, map.find_nodes("amenity").size());
+
+		map.remove_tag(nodes, "amenity");
+		QCOMPARE(3, counter.n_tag_updates);
+		QCOMPARE(N_NODES, counter.tag_ids.nodes.size());
+		QCOMPARE(true, nodes.back()->get_tag_map().isEmpty());
+	}
+
+	void rename_tag___conflict_skipped() {
+		Osm_Map				map;
+		Map_Event_Counter	counter(map);
+		Osm_Node*			p_clash = new Osm_Node(1.0, 1.0);
+		Osm_Node*			p_free = new Osm_Node(2.0, 2.0);
+
+		p_clash->set_tag("nmae", "Old");
+		p_clash->set_tag("name", "Kept");
+		p_free->set_tag("nmae", "Moved");
+		map.add(p_clash);
+		map.add(p_free);
+
+		QCOMPARE(1, map.rename_tag(QList<Osm_Info*>() << p_clash << p_free, "nmae", "name"));
+		QCOMPARE(QString("Kept"), p_clash->get_tag_value("name"));
+		QCOMPARE(QString("Old"), p_clash->get_tag_value("nmae"));
+		QCOMPARE(QString("Moved"), p_free->get_tag_value("name"));
+		QCOMPARE(false, p_free->get_tag_map().contains("nmae"));
+		QCOMPARE(1, counter.n_tag_updates);
+		QCOMPARE(QVector<long long>{p_free->get_id()}, counter.tag_ids.nodes);
+	}
+
+	void take___one_reload() {
+		Osm_Map				map;
+		Osm_Map				loaded;
+		Map_Event_Counter	counter(map);
+		Osm_Node*			p_cafe = new Osm_Node(1.0, 1.0);
+		Osm_Way*			p_way = new Osm_Way;
+
+		p_cafe->set_tag("amenity", "cafe");
+		p_way->push_node(p_cafe);
+		p_way->push_node(new Osm_Node(2.0, 2.0));
+		loaded.add(p_way);
+
+		map.take(loaded);
+		QCOMPARE(1, counter.n_reloads);
+		QCOMPARE(0, counter.n_node_adds);
+		QCOMPARE(2, map.count_nodes());
+		QCOMPARE(1, map.count_ways());
+		QCOMPARE(0, loaded.count_nodes());
+		QCOMPARE(0, loaded.count_ways());
+		QCOMPARE(p_cafe, map.find_nodes("amenity", "cafe").front());
+		QCOMPARE(true, loaded.get_tag_index().find(Tag_Index::NODE, "amenity").isEmpty());
+
+		/* The elements now report to the map they moved to */
+		p_cafe->set_lat(1.5);
+		QCOMPARE(1, counter.n_node_updates);
+		p_cafe->set_tag("amenity", "bar");
+		QCOMPARE(1, map.find_nodes("amenity", "bar").size());
+		QCOMPARE(true, map.find_nodes("amenity", "cafe").isEmpty());
+		QCOMPARE(2, p_cafe->count_subscribers()); /* The map and the way */
+	}
+
+	void node_moved___no_parent_updates() {
+		Osm_Map				map;
+		Map_Event_Counter	counter(map);
+		Osm_Node*			p_node = new Osm_Node(1.0, 1.0);
+		Osm_Way*			p_way = new Osm_Way;
+		Osm_Relation*		p_rel = new Osm_Relation;
+
+		p_way->push_node(p_node);
+		p_way->push_node(new Osm_Node(2.0, 2.0));
+		p_rel->add(p_node);
+		p_rel->add(p_way);
+		map.add(p_rel);
+
+		p_node->set_lat(1.5);
+		QCOMPARE(1, counter.n_node_updates);
+		QCOMPARE(0, counter.n_way_updates);
+		QCOMPARE(0, counter.n_relation_updates);
+
+		p_way->push_node(new Osm_Node(3.0, 3.0));
+		QCOMPARE(1, counter.n_way_updates);
+		QCOMPARE(0, counter.n_relation_updates);
+		p_rel->set_role(p_node, "stop");
+		QCOMPARE(1, counter.n_relation_updates);
+	}
+
+	void freeze___edits_refused() {
+		Osm_Map		map;
+		Osm_Node*	p_node = new Osm_Node(1.0, 1.0);
+		Osm_Node*	p_late = new Osm_Node(2.0, 2.0);
+
+		map.add(p_node);
+		map.freeze();
+		map.freeze();
+		map.add(p_late);
+		map.remove(p_node);
+		map.set_tag({p_node}, "amenity", "cafe");
+		QCOMPARE(1, map.count_nodes());
+		QCOMPARE(false, map.has(p_late));
+		QCOMPARE(false, p_node->get_tag_map().contains("amenity"));
+		map.thaw();
+		QCOMPARE(true, map.is_frozen());
+		map.thaw();
+		QCOMPARE(false, map.is_frozen());
+		map.add(p_late);
+		QCOMPARE(2, map.count_nodes());
+	}
+
+	void find_nodes___tag_index() {
+		Osm_Map		map;
+		Osm_Node*	p_shop = new Osm_Node(1.0, 1.0);
+		Osm_Node*	p_cafe = new Osm_Node(2.0, 2.0);
+		Osm_Node*	p_plain = new Osm_Node(3.0, 3.0);
+		Osm_Way*	p_way = new Osm_Way;
+
+		/* Tags set before add are indexed by add */
+		p_shop->set_tag("amenity", "shop");
+		map.add(p_shop);
+		map.add(p_cafe);
+		map.add(p_plain);
+		map.add(p_way);
+		p_cafe->set_tag("amenity", "cafe");
+		p_way->set_tag("amenity", "cafe");
+
+		QCOMPARE(2, map.find_nodes("amenity").size());
+		QCOMPARE(1, map.find_nodes("amenity", "cafe").size());
+		QCOMPARE(p_cafe, map.find_nodes("amenity", "cafe").front());
+		QCOMPARE(p_way, map.find_ways("amenity", "cafe").front());
+		QCOMPARE(0, map.find_relations("amenity").size());
+
+		p_cafe->set_tag("amenity", "bar");
+		QCOMPARE(0, map.find_nodes("amenity", "cafe").size());
+		QCOMPARE(1, map.find_nodes("amenity", "bar").size());
+
+		p_shop->remove_tag("amenity");
+		QCOMPARE(1, map.find_nodes("amenity").size());
+		p_cafe->clear_tags();
+		QCOMPARE(0, map.find_nodes("amenity").size());
+
+		map.rename_tag(QList<Osm_Info*>() << p_way, "amenity", "shop");
+		QCOMPARE(0, map.find_ways("amenity").size());
+		QCOMPARE(p_way, map.find_ways("shop", "cafe").front());
+
+		map.remove(p_way);
+		QCOMPARE(0, map.find_ways("shop").size());
+		QCOMPARE(true, map.get_tag_index().find(Tag_Index::WAY, "shop").isEmpty());
+
+		/* Postings nobody holds any more are gone, not left empty */
+		QCOMPARE(true, map.get_tag_index().m_by_key.isEmpty());
+		QCOMPARE(true, map.get_tag_index().m_by_tag.isEmpty());
+	}
+
+	void begin_batch___load() {
+		const int	N = 1000;
+		Osm_Map		map;
+		Osm_Way*	p_way = new Osm_Way;
+
+		for (int i = 0; i < N; ++i) {
+			Osm_Node* p_node = new Osm_Node(1.0, i * 0.001);
+			p_node->set_tag("barrier", i % 2 == 0 ? "gate" : "bollard");
+			p_way->push_node(p_node);
+		}
+		map.begin_batch();
+		map.add(p_way);
+		QCOMPARE(0, map.find_nodes("barrier").size());
+		map.end_batch();
+
+		const QVector<long long>& ids = map.get_tag_index().find(Tag_Index::NODE, "barrier");
+		QCOMPARE(N, ids.size());
+		QVERIFY(std::is_sorted(ids.cbegin(), ids.cend()));
+		QCOMPARE(N / 2, map.find_nodes("barrier", "gate").size());
+	}
 };
 
 QTEST_MAIN(Test_Osm_Map)
@@ -0,0 +1,149 @@
+#include <QString>
+#include <QtTest>
+#include "osm_elements.h"
+using namespace ns_osm;
+
+/* Brute force stand-in for a view's spatial index */
+class Counting_Index : public Spatial_Index {
+public:
+	Osm_Map&	m_map;
+	int			n_calls = 0;
+
+	void		find				(const QRectF& geo_rect,
+	                                 QVector<Osm_Node*>& nodes,
+	                                 QVector<Osm_Way*>& ways) override {
+		n_calls++;
+		for (auto it = m_map.cnbegin(); it != m_map.cnend(); ++it) {
+			if (geo_rect.contains(QPointF((*it)->get_lon(), (*it)->get_lat()))) {
+				nodes.push_back(*it);
+			}
+		}
+		for (auto it = m_map.cwbegin(); it != m_map.cwend(); ++it) {
+			ways.push_back(*it);
+		}
+	}
+	            Counting_Index		(Osm_Map& map) : m_map(map) {}
+};
+
+class Test_Osm_Query : public QObject
+{
+	Q_OBJECT
+private:
+	Osm_Map*	mp_map;
+	Osm_Way*	mp_named;
+	Osm_Way*	mp_unnamed;
+	Osm_Way*	mp_far;
+	Osm_Node*	mp_shop;
+private slots:
+	void init() {
+		mp_map = new Osm_Map;
+		mp_named = new Osm_Way;
+		mp_unnamed = new Osm_Way;
+		mp_far = new Osm_Way;
+		mp_shop = new Osm_Node(50.75, 7.15);
+
+		mp_named->push_node(new Osm_Node(50.71, 7.11));
+		mp_named->push_node(new Osm_Node(50.72, 7.12));
+		mp_named->set_tag("highway", "residential");
+		mp_named->set_tag("name", "Main Street");
+		mp_unnamed->push_node(new Osm_Node(50.73, 7.13));
+		mp_unnamed->push_node(new Osm_Node(50.74, 7.14));
+		mp_unnamed->set_tag("highway", "residential");
+		mp_far->push_node(new Osm_Node(10.0, 10.0));
+		mp_far->push_node(new Osm_Node(10.1, 10.1));
+		mp_far->set_tag("highway", "residential");
+		mp_shop->set_tag("shop", "bakery");
+		mp_map->add(mp_named);
+		mp_map->add(mp_unnamed);
+		mp_map->add(mp_far);
+		mp_map->add(mp_shop);
+	}
+
+	void cleanup() {
+		delete mp_map;
+	}
+
+	void compile___errors() {
+		Osm_Query query;
+
+		QCOMPARE(false, query.is_valid());
+		QCOMPARE(false, query.compile(""));
+		QCOMPARE(false, query.compile("street[name]"));
+		QCOMPARE(false, query.compile("way[name"));
+		QCOMPARE(false, query.compile("way(1,2,3)"));
+		QCOMPARE(false, query.compile("way(50,7,40,8)"));
+		QCOMPARE(false, query.compile("way[name~\"(\"]"));
+		QCOMPARE(false, query.compile("way[name=\"open]"));
+		QCOMPARE(false, query.get_error().isEmpty());
+		QCOMPARE(true, query.compile("nwr[name]; >;"));
+		QCOMPARE(true, query.get_error().isEmpty());
+	}
+
+	void run___tags_and_bbox() {
+		Osm_Query query("way[highway=residential][!name](50.7,7.1,50.8,7.2)");
+		Osm_Query::Result result;
+
+		QVERIFY(query.is_valid());
+		QVERIFY(query.explain(*mp_map).front().contains("tag index"));
+		result = query.run(*mp_map);
+		QCOMPARE(1, result.size());
+		QCOMPARE(true, result.ways.contains(mp_unnamed->get_id()));
+	}
+
+	void run___tag_operators() {
+		QCOMPARE(3, Osm_Query("way[highway]").run(*mp_map).size());
+		QCOMPARE(2, Osm_Query("way[name!=\"Main Street\"]").run(*mp_map).size());
+		QCOMPARE(1, Osm_Query("way[name~\"^Main\"]").run(*mp_map).size());
+		QCOMPARE(2, Osm_Query("way[name!~Main]").run(*mp_map).size());
+		QCOMPARE(1, Osm_Query("nwr[shop=bakery]").run(*mp_map).nodes.size());
+	}
+
+	void run___polygon() {
+		/* Triangle around the unnamed way only */
+		Osm_Query query("way(poly:\"50.725 7.125 50.745 7.125 50.745 7.16\")");
+		Osm_Query::Result result = query.run(*mp_map);
+
+		QCOMPARE(1, result.size());
+		QCOMPARE(true, result.ways.contains(mp_unnamed->get_id()));
+	}
+
+	void run___recursion() {
+		Osm_Query::Result result = Osm_Query("way[name]; >").run(*mp_map);
+
+		QCOMPARE(1, result.ways.size());
+		QCOMPARE(2, result.nodes.size());
+		for (auto it = mp_named->get_nodes_list().cbegin(); it != mp_named->get_nodes_list().cend(); ++it) {
+			QCOMPARE(true, result.nodes.contains((*it)->get_id()));
+		}
+	}
+
+	void run___spatial_index() {
+		Counting_Index index(*mp_map);
+		Osm_Query query("node(50.7,7.1,50.8,7.2)");
+		Osm_Query::Result result;
+
+		QVERIFY(query.explain(*mp_map).front().contains("scan"));
+		query.set_spatial_index(&index);
+		QVERIFY(query.explain(*mp_map).front().contains("spatial index"));
+		result = query.run(*mp_map);
+		QCOMPARE(1, index.n_calls);
+		QCOMPARE(5, result.nodes.size());
+	}
+
+	void run___parallel_scan() {
+		const int N_NODES = 40000;
+		Osm_Map map;
+		Osm_Query query("node(-1,-1,9.99975,9.99975)");
+		Osm_Query::Result result;
+
+		for (int i = 0; i < N_NODES; ++i) {
+			map.add(new Osm_Node(i * 0.0005, i * 0.0005));
+		}
+		QVERIFY(query.explain(map).front().contains("parallel scan"));
+		result = query.run(map);
+		QCOMPARE(20000, result.nodes.size());
+	}
+};
+
+QTEST_MAIN(Test_Osm_Query)
+#include "test_osm_query.moc"
@@ -0,0 +1,184 @@
+#include <QString>
+#include <QtTest>
+#include "osm_elements.h"
+using namespace ns_osm;
+
+class Test_Routing_Graph : public QObject
+{
+	Q_OBJECT
+private slots:
+	void build___junctions_and_shape() {
+		Osm_Map		map;
+		Osm_Way*	p_way_a = new Osm_Way;
+		Osm_Way*	p_way_b = new Osm_Way;
+		Osm_Node*	p_n1 = new Osm_Node(50.0, 7.0);
+		Osm_Node*	p_n2 = new Osm_Node(50.0, 7.001);
+		Osm_Node*	p_n3 = new Osm_Node(50.0, 7.002);
+		Osm_Node*	p_n4 = new Osm_Node(50.001, 7.002);
+		Osm_Way*	p_building = new Osm_Way;
+
+		p_way_a->push_node(p_n1);
+		p_way_a->push_node(p_n2);
+		p_way_a->push_node(p_n3);
+		p_way_a->set_tag("highway", "residential");
+		p_way_b->push_node(p_n3);
+		p_way_b->push_node(p_n4);
+		p_way_b->set_tag("highway", "residential");
+		p_building->push_node(new Osm_Node(50.0, 7.0005));
+		p_building->push_node(new Osm_Node(50.0005, 7.0005));
+		p_building->set_tag("building", "yes");
+		map.add(p_way_a);
+		map.add(p_way_b);
+		map.add(p_building);
+
+		Routing_Graph graph(map);
+		QCOMPARE(3, graph.count_vertices());
+		QCOMPARE(4, graph.count_edges());
+		QCOMPARE(false, graph.has_vertex(p_n2->get_id()));
+		QCOMPARE(p_n4->get_id(), graph.nearest_vertex(50.0011, 7.0021));
+
+		Routing_Graph::Path path = graph.find_path(p_n1->get_id(), p_n4->get_id());
+		QCOMPARE(4, path.nodes.size());
+		QCOMPARE(p_n2->get_id(), path.nodes[1]);
+		/* About 255 m at 30 km/h */
+		QVERIFY(path.cost > 29.0 && path.cost < 32.0);
+
+		path = graph.find_path(p_n4->get_id(), p_n1->get_id());
+		QCOMPARE(p_n2->get_id(), path.nodes[2]);
+	}
+
+	void find_path___oneway() {
+		Osm_Map		map;
+		Osm_Way*	p_way = new Osm_Way;
+		Osm_Node*	p_n1 = new Osm_Node(50.0, 7.0);
+		Osm_Node*	p_n2 = new Osm_Node(50.0, 7.001);
+
+		p_way->push_node(p_n1);
+		p_way->push_node(p_n2);
+		p_way->set_tag("highway", "primary");
+		p_way->set_tag("oneway", "yes");
+		map.add(p_way);
+
+		Routing_Graph graph(map);
+		QCOMPARE(false, graph.find_path(p_n1->get_id(), p_n2->get_id()).is_empty());
+		QCOMPARE(true, graph.find_path(p_n2->get_id(), p_n1->get_id()).is_empty());
+		graph.contract();
+		QCOMPARE(true, graph.find_path(p_n2->get_id(), p_n1->get_id(), Routing_Graph::CONTRACTION_HIERARCHY).is_empty());
+	}
+
+	void follow___edits() {
+		Osm_Map		map;
+		Osm_Way*	p_way_a = new Osm_Way;
+		Osm_Way*	p_way_b = new Osm_Way;
+		Osm_Node*	p_n1 = new Osm_Node(50.0, 7.0);
+		Osm_Node*	p_n2 = new Osm_Node(50.0, 7.001);
+		Osm_Node*	p_n3 = new Osm_Node(50.0, 7.002);
+		Osm_Node*	p_n4 = new Osm_Node(50.0, 7.003);
+		Osm_Node*	p_n5 = new Osm_Node(50.001, 7.001);
+		Osm_Node*	p_n6 = new Osm_Node(50.0, 7.0015);
+		Routing_Graph	graph;
+		double		cost;
+
+		p_way_a->push_node(p_n1);
+		p_way_a->push_node(p_n2);
+		p_way_a->push_node(p_n3);
+		p_way_a->set_tag("highway", "residential");
+		map.add(p_way_a);
+		graph.follow(map);
+		QCOMPARE(true, graph.is_following());
+		QCOMPARE(2, graph.count_vertices());
+
+		/* Extending moves the end vertex */
+		p_way_a->push_node(p_n4);
+		QCOMPARE(2, graph.count_vertices());
+		QCOMPARE(false, graph.has_vertex(p_n3->get_id()));
+		QCOMPARE(4, graph.find_path(p_n1->get_id(), p_n4->get_id()).nodes.size());
+
+		/* A new way splits the edges at the junction */
+		p_way_b->push_node(p_n2);
+		p_way_b->push_node(p_n5);
+		p_way_b->set_tag("highway", "residential");
+		map.add(p_way_b);
+		QCOMPARE(4, graph.count_vertices());
+		QCOMPARE(6, graph.count_edges());
+		QCOMPARE(1, graph.count_components());
+		QCOMPARE(3, graph.find_path(p_n1->get_id(), p_n5->get_id()).nodes.size());
+
+		/* Inserted nodes only become shape */
+		p_way_a->insert_node_between(p_n6, p_n2, p_n3);
+		QCOMPARE(6, graph.count_edges());
+		QCOMPARE(p_n6->get_id(), graph.find_path(p_n2->get_id(), p_n4->get_id()).nodes[1]);
+
+		/* Moving a shape node changes the weight */
+		cost = graph.find_path(p_n2->get_id(), p_n4->get_id()).cost;
+		p_n6->set_lat(50.001);
+		QVERIFY(graph.find_path(p_n2->get_id(), p_n4->get_id()).cost > cost + 1.0);
+
+		/* Removing the crossing way merges the edges again */
+		map.remove(p_way_b);
+		QCOMPARE(2, graph.count_vertices());
+		QCOMPARE(2, graph.count_edges());
+		QCOMPARE(false, graph.has_vertex(p_n2->get_id()));
+		QCOMPARE(5, graph.find_path(p_n1->get_id(), p_n4->get_id()).nodes.size());
+
+		/* Tags through the map are followed too */
+		map.set_tags(*p_way_a, {{"oneway", "yes"}}, QStringList());
+		QCOMPARE(true, graph.find_path(p_n4->get_id(), p_n1->get_id()).is_empty());
+		map.set_tags(*p_way_a, {{"highway", "proposed"}}, QStringList());
+		QCOMPARE(0, graph.count_edges());
+
+		graph.unfollow();
+		QCOMPARE(false, graph.is_following());
+	}
+
+	void find_path___algorithms_agree() {
+		const int			N = 30;
+		Osm_Map				map;
+		QVector<long long>	ids;
+		QVector<Osm_Node*>	nodes;
+
+		for (int i = 0; i < N * N; ++i) {
+			nodes.push_back(new Osm_Node(50.0 + (i / N) * 0.001, 7.0 + (i % N) * 0.0015));
+			ids.push_back(nodes.back()->get_id());
+		}
+		for (int row = 0; row < N; ++row) {
+			Osm_Way* p_way = new Osm_Way;
+			for (int col = 0; col < N; ++col) {
+				p_way->push_node(nodes[row * N + col]);
+			}
+			p_way->set_tag("highway", (row % 5 == 0 ? "primary" : "residential"));
+			if (row % 7 == 3) {
+				p_way->set_tag("oneway", "yes");
+			}
+			map.add(p_way);
+		}
+		for (int col = 0; col < N; ++col) {
+			Osm_Way* p_way = new Osm_Way;
+			for (int row = 0; row < N; ++row) {
+				p_way->push_node(nodes[row * N + col]);
+			}
+			p_way->set_tag("highway", (col % 4 == 0 ? "secondary" : "residential"));
+			map.add(p_way);
+		}
+
+		Routing_Graph graph(map);
+		QCOMPARE(N * N, graph.count_vertices());
+		graph.contract();
+		QCOMPARE(true, graph.is_contracted());
+		for (int k = 0; k < 60; ++k) {
+			long long from = ids[(k * 37) % ids.size()];
+			long long to = ids[(k * 101 + 13) % ids.size()];
+			Routing_Graph::Path dijkstra = graph.find_path(from, to, Routing_Graph::DIJKSTRA);
+			Routing_Graph::Path a_star = graph.find_path(from, to, Routing_Graph::A_STAR);
+			Routing_Graph::Path ch = graph.find_path(from, to, Routing_Graph::CONTRACTION_HIERARCHY);
+			QCOMPARE(false, dijkstra.is_empty());
+			QVERIFY(qAbs(dijkstra.cost - a_star.cost) < 1e-6);
+			QVERIFY(qAbs(dijkstra.cost - ch.cost) < 1e-6);
+			QCOMPARE(from, ch.nodes.front());
+			QCOMPARE(to, ch.nodes.back());
+		}
+	}
+};
+
+QTEST_MAIN(Test_Routing_Graph)
+#include "test_routing_graph.moc"
@@ -0,0 +1,134 @@
+#include <QString>
+#include <QtTest>
+#include "osm_elements.h"
+using namespace ns_osm;
+
+/* Counts the partitions it saw the map frozen in */
+class Frozen_Rule : public Validator::Rule {
+public:
+	QAtomicInt* mp_n_frozen;
+
+	QString get_name() const override {
+		return "frozen";
+	}
+	void check(const Validator::Partition& partition, QVector<Validator::Issue>&) const override {
+		if (partition.p_map->is_frozen()) {
+			mp_n_frozen->ref();
+		}
+	}
+};
+
+class Test_Validator : public QObject
+{
+	Q_OBJECT
+private:
+	Osm_Way* make_way(Osm_Map& map, const QVector<QPointF>& points, const QString& highway) {
+		Osm_Way* p_way = new Osm_Way;
+		for (auto it = points.cbegin(); it != points.cend(); ++it) {
+			p_way->push_node(new Osm_Node(it->y(), it->x()));
+		}
+		if (!highway.isEmpty()) {
+			p_way->set_tag("highway", highway);
+		}
+		map.add(p_way);
+		return p_way;
+	}
+
+	int count_rule(const QVector<Validator::Issue>& issues, const QString& rule) {
+		int n_issues = 0;
+		for (auto it = issues.cbegin(); it != issues.cend(); ++it) {
+			n_issues += (it->rule == rule ? 1 : 0);
+		}
+		return n_issues;
+	}
+private slots:
+	void run___default_rules() {
+		Osm_Map						map;
+		Validator					validator;
+		Osm_Relation*				p_rel = new Osm_Relation;
+		Osm_Way*					p_outside = new Osm_Way;
+		Osm_Way*					p_bridge;
+		QVector<Validator::Issue>	issues;
+
+		map.add(new Osm_Node(51.0, 8.0));
+		map.add(new Osm_Node(51.0, 8.0));
+		/* Bowtie */
+		make_way(map, {QPointF(7.0, 50.0), QPointF(7.001, 50.001), QPointF(7.001, 50.0), QPointF(7.0, 50.001)}, "");
+		/* Plain crossing, and one on a bridge */
+		make_way(map, {QPointF(7.01, 50.0), QPointF(7.02, 50.0)}, "residential");
+		make_way(map, {QPointF(7.015, 49.99), QPointF(7.015, 50.01)}, "residential");
+		p_bridge = make_way(map, {QPointF(7.017, 49.99), QPointF(7.017, 50.01)}, "primary");
+		map.set_tags(*p_bridge, {{"bridge", "yes"}, {"layer", "1"}}, QStringList());
+		/* Single node way */
+		make_way(map, {QPointF(7.03, 50.0)}, "residential");
+		/* Member the map never learns about */
+		p_outside->push_node(new Osm_Node(50.0, 7.04));
+		p_outside->push_node(new Osm_Node(50.0, 7.05));
+		map.add(p_rel);
+		map.unsubscribe(*p_rel);
+		p_rel->add(p_outside);
+
+		validator.add_default_rules();
+		QCOMPARE(5, validator.count_rules());
+		issues = validator.run(map);
+		QCOMPARE(1, count_rule(issues, "duplicate_node"));
+		QCOMPARE(1, count_rule(issues, "self_intersection"));
+		QCOMPARE(1, count_rule(issues, "crossing_highways"));
+		QCOMPARE(1, count_rule(issues, "way_limits"));
+		QCOMPARE(1, count_rule(issues, "relation_members"));
+		QCOMPARE(Validator::ERROR, issues.front().severity);
+		for (auto it = issues.cbegin(); it != issues.cend(); ++it) {
+			if (it->rule == "crossing_highways") {
+				QVERIFY(qAbs(it->lat - 50.0) < 1e-9 && qAbs(it->lon - 7.015) < 1e-9);
+			}
+			if (it->rule == "relation_members") {
+				QCOMPARE(true, it->ways.contains(p_outside->get_id()));
+			}
+		}
+		delete p_outside;
+	}
+
+	void run___partitions_agree() {
+		const int					N = 20;
+		Osm_Map						map;
+		Validator					validator;
+		QVector<Validator::Issue>	single;
+		QVector<Validator::Issue>	partitioned;
+
+		for (int i = 0; i < N; ++i) {
+			make_way(map, {QPointF(7.0, 50.0 + i * 0.001), QPointF(7.02, 50.0 + i * 0.001)}, "residential");
+			make_way(map, {QPointF(7.0005 + i * 0.001, 49.9995), QPointF(7.0005 + i * 0.001, 50.0195)}, "residential");
+		}
+		validator.add_rule(new Crossing_Highways_Rule);
+		QCOMPARE(1, validator.count_partitions(map));
+		single = validator.run(map);
+		validator.set_partition_size(1);
+		QVERIFY(validator.count_partitions(map) > 1);
+		partitioned = validator.run(map);
+		QCOMPARE(N * N, single.size());
+		QCOMPARE(single.size(), partitioned.size());
+		for (int i = 0; i < single.size(); ++i) {
+			QCOMPARE(single[i].ways, partitioned[i].ways);
+		}
+	}
+
+	void run___map_frozen() {
+		Osm_Map			map;
+		Validator		validator;
+		Frozen_Rule*	p_rule = new Frozen_Rule;
+		QAtomicInt		n_frozen;
+
+		for (int i = 0; i < 10; ++i) {
+			make_way(map, {QPointF(7.0 + i, 50.0), QPointF(7.5 + i, 50.5)}, "residential");
+		}
+		p_rule->mp_n_frozen = &n_frozen;
+		validator.add_rule(p_rule);
+		validator.set_partition_size(1);
+		validator.run(map);
+		QCOMPARE(validator.count_partitions(map), n_frozen.load());
+		QVERIFY(!map.is_frozen());
+	}
+};
+
+QTEST_MAIN(Test_Validator)
+#include "test_validator.moc"
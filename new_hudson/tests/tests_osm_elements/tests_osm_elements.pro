@@ -7,6 +7,18 @@ SUBDIRS += \
     test_referential_integrity \
     test_osm_object \
     test_osm_map \
+    test_osm_query \
+    test_routing_graph \
+    test_validator \
+    test_live_validator \
+    test_node_merger \
+    test_map_generator \
+    test_event_trace \
+    test_memory_usage \
+    test_map_snapshot \
+    test_map_versioner \
+    test_id_allocator \
+    test_id_hash \
 
 test_osm_node.subdirs = test_osm_node
 test_osm_way.subdirs = test_osm_way